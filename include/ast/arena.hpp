@@ -0,0 +1,80 @@
+#ifndef AST_ARENA_HPP
+#define AST_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Bump-pointer allocator that owns every node of one translation unit.
+// Nodes are placement-constructed into large chunks, so siblings end up next
+// to each other in memory and the whole tree is released at once together with
+// the arena. Only nodes that are not trivially destructible (those holding
+// strings or vectors) are recorded and destroyed on release.
+class ASTArena
+{
+private:
+    struct Chunk
+    {
+        Chunk *next;
+        std::size_t size;
+    };
+
+    struct Destructor
+    {
+        void (*destroy)(void *);
+        void *object;
+        Destructor *next;
+    };
+
+    static constexpr std::size_t defaultChunkSize = 64 * 1024;
+
+    Chunk *chunks_;
+    char *cursor_;
+    char *end_;
+    Destructor *destructors_;
+    std::size_t bytesAllocated_;
+
+    void *allocateSlow(std::size_t size, std::size_t alignment);
+
+public:
+    ASTArena() : chunks_(nullptr), cursor_(nullptr), end_(nullptr), destructors_(nullptr), bytesAllocated_(0) {}
+    ~ASTArena();
+
+    ASTArena(const ASTArena &) = delete;
+    ASTArena &operator=(const ASTArena &) = delete;
+
+    std::size_t getBytesAllocated() const { return bytesAllocated_; }
+
+    void *allocate(std::size_t size, std::size_t alignment)
+    {
+        std::uintptr_t aligned = (reinterpret_cast<std::uintptr_t>(cursor_) + alignment - 1) & ~(alignment - 1);
+        if (cursor_ && aligned + size <= reinterpret_cast<std::uintptr_t>(end_))
+        {
+            cursor_ = reinterpret_cast<char *>(aligned + size);
+            bytesAllocated_ += size;
+            return reinterpret_cast<void *>(aligned);
+        }
+        return allocateSlow(size, alignment);
+    }
+
+    template <typename T, typename... Args>
+    T *make(Args &&...args)
+    {
+        void *memory = allocate(sizeof(T), alignof(T));
+        T *object = new (memory) T(std::forward<Args>(args)...);
+
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            void *record = allocate(sizeof(Destructor), alignof(Destructor));
+            destructors_ = new (record) Destructor{[](void *ptr)
+                                                   { static_cast<T *>(ptr)->~T(); },
+                                                   object, destructors_};
+        }
+
+        return object;
+    }
+};
+
+#endif // AST_ARENA_HPP
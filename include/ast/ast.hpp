@@ -5,7 +5,12 @@
 #include <iostream>
 #include <vector>
 #include <memory>
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallString.h"
+#include "arena.hpp"
 #include "node.hpp"
+#include "symbol.hpp"
 #include "types.hpp"
 
 class ASTStatementList : public ASTNode
@@ -17,13 +22,6 @@ private:
 public:
     ASTStatementList(std::size_t lineNumber) : statements_(), lineNumber_(lineNumber) {}
     ASTStatementList(ASTNodePtr statement, std::size_t lineNumber) : statements_({statement}), lineNumber_(lineNumber) {}
-    ~ASTStatementList()
-    {
-        for (auto &statement : statements_)
-        {
-            delete statement;
-        }
-    }
     NodeType getType() const override { return NodeType::StatementList; }
     const ASTNodeList &getStatements() const { return statements_; }
     void addStatement(ASTNodePtr statement) { statements_.push_back(statement); }
@@ -40,28 +38,35 @@ public:
     }
 };
 
-class ASTProgram : public ASTNode
+// Root of a translation unit. The program owns the arena every other node of
+// the tree lives in, so deleting the program releases the whole tree.
+class ASTProgram final : public ASTNode
 {
 private:
+    ASTArena arena_;
     ASTStatementList *statementList_;
+    std::uint32_t fileId_;
 
 public:
-    ASTProgram()
-    {
-        statementList_ = new ASTStatementList(0);
-    }
-    ~ASTProgram()
+    ASTProgram() : fileId_(0)
     {
-        delete statementList_;
+        statementList_ = arena_.make<ASTStatementList>(0);
     }
+    ~ASTProgram() = default;
 
     NodeType getType() const override { return NodeType::Program; }
 
+    ASTArena &getArena() { return arena_; }
+
     ASTStatementList *getStatementList()
     {
         return statementList_;
     }
 
+    // Id of the SourceBuffer the node ranges of this tree refer to.
+    std::uint32_t getFileId() const { return fileId_; }
+    void setFileId(std::uint32_t fileId) { fileId_ = fileId; }
+
     // TODO
     nlohmann::json jsonify() const override {}
 
@@ -88,25 +93,42 @@ enum class ASTStorageClassSpecifier
 {
     Extern,
     Inline,
+    // One instance of the variable per thread.
+    ThreadLocal,
+    // A thread_local variable defined in another module.
+    ExternThreadLocal,
 };
 
 const std::string formatAccessSpecifier(ASTAccessSpecifier accessSpecifier);
 void printAccessSpecifier(ASTAccessSpecifier accessSpecifier);
 
+// An integer literal keeps its exact value up to 128 bits; the semantic stage
+// gives it the narrowest type that holds it.
 class ASTIntegerLiteral : public ASTNode
 {
+public:
+    // The two 64-bit words of the value, low word first, stored apart from an
+    // APInt so the node stays trivially destructible.
+    struct Value
+    {
+        std::uint64_t words[2];
+    };
+
 private:
-    int value_;
+    Value value_;
 
 public:
-    ASTIntegerLiteral(int value) : value_(value) {}
+    ASTIntegerLiteral(Value value) : value_(value) {}
     NodeType getType() const override { return NodeType::IntegerLiteral; }
-    int getValue() const { return value_; }
+    llvm::APInt getValue() const { return llvm::APInt(128, llvm::ArrayRef<std::uint64_t>(value_.words)); }
 
     void print(int indent) const override
     {
+        llvm::SmallString<40> digits;
+        getValue().toStringUnsigned(digits);
+
         printIndent(indent);
-        std::cout << "IntegerLiteral: " << value_;
+        std::cout << "IntegerLiteral: " << digits.str().str();
     }
 };
 
@@ -138,12 +160,16 @@ public:
 class ASTFloatLiteral : public ASTNode
 {
 private:
-    float value_;
+    // Read at the precision of the literal, so a float32 one holds a float exactly.
+    double value_;
+    bool isFloat32_;
 
 public:
-    ASTFloatLiteral(float value) : value_(value) {}
+    ASTFloatLiteral(double value, bool isFloat32) : value_(value), isFloat32_(isFloat32) {}
     NodeType getType() const override { return NodeType::FloatLiteral; }
-    float getValue() const { return value_; }
+    double getValue() const { return value_; }
+    // Written with an f suffix, otherwise the literal is a float64.
+    bool isFloat32() const { return isFloat32_; }
 
     void print(int indent) const override
     {
@@ -172,15 +198,21 @@ public:
 class ASTIdentifier : public ASTNode
 {
 private:
-    std::string name_;
+    Symbol name_;
     std::size_t lineNumber_;
+    mutable const semantic::Declaration *declaration_ = nullptr;
 
 public:
-    ASTIdentifier(std::string name, std::size_t lineNumber) : name_(name), lineNumber_(lineNumber) {}
+    ASTIdentifier(Symbol name, std::size_t lineNumber) : name_(name), lineNumber_(lineNumber) {}
     NodeType getType() const override { return NodeType::Identifier; }
-    const std::string &getName() const { return name_; }
+    const std::string &getName() const { return name_.str(); }
+    Symbol getSymbol() const { return name_; }
     std::size_t getLineNumber() const { return lineNumber_; }
 
+    // Set by the semantic stage to what the name refers to.
+    const semantic::Declaration *getDeclaration() const { return declaration_; }
+    void setDeclaration(const semantic::Declaration *declaration) const { declaration_ = declaration; }
+
     void print(int indent) const override
     {
         printIndent(indent);
@@ -215,17 +247,13 @@ public:
 
     ASTBinaryExpression(ASTNodePtr left, Operator op, ASTNodePtr right, std::size_t lineNumber)
         : left_(left), op_(op), right_(right), lineNumber_(lineNumber) {}
-    ~ASTBinaryExpression()
-    {
-        delete left_;
-        delete right_;
-    }
 
     NodeType getType() const override { return NodeType::BinaryExpression; }
 
     ASTNodePtr getLeft() const { return left_; }
     Operator getOperator() const { return op_; }
     ASTNodePtr getRight() const { return right_; }
+    std::string getOperatorString() const { return formatOperator(op_); }
     std::size_t getLineNumber() const { return lineNumber_; }
 
     void print(int indent) const override
@@ -308,15 +336,12 @@ public:
 
     ASTUnaryExpression(Operator op, ASTNodePtr operand, std::size_t lineNumber)
         : op_(op), operand_(operand), lineNumber_(lineNumber) {}
-    ~ASTUnaryExpression()
-    {
-        delete operand_;
-    }
 
     NodeType getType() const override { return NodeType::UnaryExpression; }
 
     Operator getOperator() const { return op_; }
     ASTNodePtr getOperand() const { return operand_; }
+    std::string getOperatorString() const { return formatOperator(op_); }
     std::size_t getLineNumber() const { return lineNumber_; }
 
     void print(int indent) const override
@@ -371,14 +396,10 @@ private:
 public:
     ASTCastExpression(ASTTypeSpecifier targetType, ASTNodePtr expression, std::size_t lineNumber)
         : expression_(expression), targetType_(targetType), lineNumber_(lineNumber) {}
-    ~ASTCastExpression()
-    {
-        delete expression_;
-    }
 
     NodeType getType() const override { return NodeType::CastExpression; }
     ASTNodePtr getExpression() const { return expression_; }
-    ASTTypeSpecifier getTargetType() const { return targetType_; }
+    const ASTTypeSpecifier &getTargetType() const { return targetType_; }
     std::size_t getLineNumber() const { return lineNumber_; }
 
     void print(int indent) const override
@@ -400,13 +421,13 @@ public:
 class ASTImportStatement : public ASTNode
 {
 private:
-    std::vector<std::string> modulePath_;
+    std::vector<Symbol> modulePath_;
     std::size_t lineNumber_;
 
 public:
-    ASTImportStatement(std::vector<std::string> modulePath, std::size_t lineNumber) : modulePath_(modulePath), lineNumber_(lineNumber) {}
+    ASTImportStatement(std::vector<Symbol> modulePath, std::size_t lineNumber) : modulePath_(modulePath), lineNumber_(lineNumber) {}
     NodeType getType() const override { return NodeType::ImportStatement; }
-    const std::vector<std::string> &getModulePath() const { return modulePath_; }
+    const std::vector<Symbol> &getModulePath() const { return modulePath_; }
     std::size_t getLineNumber() const { return lineNumber_; }
 
     void print(int indent) const override
@@ -428,13 +449,13 @@ public:
 class ASTImportedSymbolAccess : public ASTNode
 {
 private:
-    std::vector<std::string> symbolPath_;
+    std::vector<Symbol> symbolPath_;
     std::size_t lineNumber_;
 
 public:
-    ASTImportedSymbolAccess(std::vector<std::string> symbolPath, std::size_t lineNumber) : symbolPath_(symbolPath), lineNumber_(lineNumber) {}
+    ASTImportedSymbolAccess(std::vector<Symbol> symbolPath, std::size_t lineNumber) : symbolPath_(symbolPath), lineNumber_(lineNumber) {}
     NodeType getType() const override { return NodeType::ImportedSymbolAccess; }
-    const std::vector<std::string> &getSymbolPath() const { return symbolPath_; }
+    const std::vector<Symbol> &getSymbolPath() const { return symbolPath_; }
     std::size_t getLineNumber() const { return lineNumber_; }
 
     void print(int indent) const override
@@ -456,17 +477,18 @@ public:
 class ASTTypeDefStatement : public ASTNode
 {
 private:
-    std::string name_;
+    Symbol name_;
     ASTTypeSpecifier type_;
     ASTAccessSpecifier accessSpecifier_;
     std::size_t lineNumber_;
 
 public:
-    ASTTypeDefStatement(std::string name, ASTTypeSpecifier type, std::size_t lineNumber, ASTAccessSpecifier accessSpecifier = ASTAccessSpecifier::Default)
+    ASTTypeDefStatement(Symbol name, ASTTypeSpecifier type, std::size_t lineNumber, ASTAccessSpecifier accessSpecifier = ASTAccessSpecifier::Default)
         : name_(name), type_(type), accessSpecifier_(accessSpecifier), lineNumber_(lineNumber) {}
 
     NodeType getType() const override { return NodeType::TypeDefStatement; }
-    const std::string &getName() const { return name_; }
+    const std::string &getName() const { return name_.str(); }
+    Symbol getSymbol() const { return name_; }
     const ASTTypeSpecifier &getTypeSpecifier() const { return type_; }
     ASTAccessSpecifier getAccessSpecifier() const { return accessSpecifier_; }
     std::size_t getLineNumber() const { return lineNumber_; }
@@ -492,21 +514,18 @@ public:
 class ASTFunctionParameter : public ASTNode
 {
 private:
-    std::string param_name_;
+    Symbol param_name_;
     ASTTypeSpecifier param_type_;
     ASTNodePtr default_value_;
 
 public:
-    ASTFunctionParameter(std::string param_name, ASTTypeSpecifier param_type, ASTNodePtr default_value = nullptr)
+    ASTFunctionParameter(Symbol param_name, ASTTypeSpecifier param_type, ASTNodePtr default_value = nullptr)
         : param_name_(param_name), param_type_(param_type), default_value_(default_value) {}
-    ~ASTFunctionParameter()
-    {
-        delete default_value_;
-    }
 
     NodeType getType() const override { return NodeType::FunctionParameter; }
-    const std::string &getParamName() const { return param_name_; }
-    ASTTypeSpecifier getParamType() const { return param_type_; }
+    const std::string &getParamName() const { return param_name_.str(); }
+    Symbol getParamSymbol() const { return param_name_; }
+    const ASTTypeSpecifier &getParamType() const { return param_type_; }
     ASTNodePtr getDefaultValue() const { return default_value_; }
 
     void print(int indent) const override
@@ -538,13 +557,6 @@ private:
 public:
     ASTFunctionParameters(std::vector<ASTFunctionParameter> parameters, std::optional<ASTTypeSpecifier *> typed_variadic = std::nullopt, bool is_variadic = false)
         : parameters_(parameters), typed_variadic_(typed_variadic), is_variadic_(is_variadic) {}
-    ~ASTFunctionParameters()
-    {
-        if (typed_variadic_.has_value())
-        {
-            delete typed_variadic_.value();
-        }
-    }
 
     NodeType getType() const override { return NodeType::FunctionParameter; }
     const std::vector<ASTFunctionParameter> &getList() const { return parameters_; }
@@ -608,19 +620,10 @@ public:
                           std::optional<ASTStorageClassSpecifier> storageClassSpecifier = std::nullopt)
         : expr_(expr), parameters_(parameters), body_(body),
           accessSpecifier_(accessSpecifier), returnType_(returnType), storageClassSpecifier_(storageClassSpecifier), lineNumber_(lineNumber) {}
-    ~ASTFunctionDefinition()
-    {
-        delete expr_;
-        delete body_;
-        if (returnType_.has_value())
-        {
-            delete returnType_.value();
-        }
-    }
 
     NodeType getType() const override { return NodeType::FunctionDefinition; }
     ASTNodePtr getExpr() const { return expr_; }
-    ASTFunctionParameters getParameters() const { return parameters_; }
+    const ASTFunctionParameters &getParameters() const { return parameters_; }
     std::optional<ASTTypeSpecifier *> getReturnType() const { return returnType_; }
     ASTNodePtr getBody() const { return body_; }
     ASTAccessSpecifier getAccessSpecifier() const { return accessSpecifier_; }
@@ -662,6 +665,12 @@ public:
             case ASTStorageClassSpecifier::Inline:
                 std::cout << "Inline";
                 break;
+            case ASTStorageClassSpecifier::ThreadLocal:
+                std::cout << "Thread Local";
+                break;
+            case ASTStorageClassSpecifier::ExternThreadLocal:
+                std::cout << "Extern Thread Local";
+                break;
             default:
                 std::cout << "Unknown";
                 break;
@@ -694,18 +703,10 @@ public:
                            std::optional<ASTStorageClassSpecifier> storageClassSpecifier = std::nullopt)
         : expr_(expr), parameters_(parameters),
           accessSpecifier_(accessSpecifier), returnType_(returnType), storageClassSpecifier_(storageClassSpecifier), lineNumber_(lineNumber) {}
-    ~ASTFunctionDeclaration()
-    {
-        delete expr_;
-        if (returnType_.has_value())
-        {
-            delete returnType_.value();
-        }
-    }
 
     NodeType getType() const override { return NodeType::FunctionDeclaration; }
     ASTNodePtr getExpr() const { return expr_; }
-    ASTFunctionParameters getParameters() const { return parameters_; }
+    const ASTFunctionParameters &getParameters() const { return parameters_; }
     std::optional<ASTTypeSpecifier *> getReturnType() const { return returnType_; }
     ASTAccessSpecifier getAccessSpecifier() const { return accessSpecifier_; }
     std::optional<ASTStorageClassSpecifier> getStorageClassSpecifier() const { return storageClassSpecifier_; }
@@ -746,6 +747,12 @@ public:
             case ASTStorageClassSpecifier::Inline:
                 std::cout << "Inline";
                 break;
+            case ASTStorageClassSpecifier::ThreadLocal:
+                std::cout << "Thread Local";
+                break;
+            case ASTStorageClassSpecifier::ExternThreadLocal:
+                std::cout << "Extern Thread Local";
+                break;
             default:
                 std::cout << "Unknown";
                 break;
@@ -754,38 +761,29 @@ public:
         }
     }
 
-    static ASTFunctionDeclaration *fromFunctionDefinition(const ASTFunctionDefinition &functionDefinition, std::size_t lineNumber)
+    static ASTFunctionDeclaration *fromFunctionDefinition(ASTArena &arena, const ASTFunctionDefinition &functionDefinition, std::size_t lineNumber)
     {
-        return new ASTFunctionDeclaration(functionDefinition.getExpr(), functionDefinition.getParameters(), functionDefinition.getReturnType(), lineNumber, functionDefinition.getAccessSpecifier(), functionDefinition.getStorageClassSpecifier());
+        ASTFunctionDeclaration *declaration = arena.make<ASTFunctionDeclaration>(functionDefinition.getExpr(), functionDefinition.getParameters(), functionDefinition.getReturnType(), lineNumber, functionDefinition.getAccessSpecifier(), functionDefinition.getStorageClassSpecifier());
+        declaration->setRange(functionDefinition.getRange());
+        return declaration;
     }
 };
 
 class ASTVariableDeclaration : public ASTNode
 {
 private:
-    std::string name_;
+    Symbol name_;
     std::optional<ASTTypeSpecifier *> type_;
     std::optional<ASTNodePtr> initializer_;
     std::size_t lineNumber_;
 
 public:
-    ASTVariableDeclaration(std::string name, std::optional<ASTTypeSpecifier *> type, std::size_t lineNumber, std::optional<ASTNodePtr> initializer = std::nullopt)
+    ASTVariableDeclaration(Symbol name, std::optional<ASTTypeSpecifier *> type, std::size_t lineNumber, std::optional<ASTNodePtr> initializer = std::nullopt)
         : name_(name), type_(type), initializer_(initializer), lineNumber_(lineNumber) {}
-    ~ASTVariableDeclaration()
-    {
-        if (initializer_.has_value())
-        {
-            delete initializer_.value();
-        }
-
-        if (type_.has_value())
-        {
-            delete type_.value();
-        }
-    }
 
     NodeType getType() const override { return NodeType::VariableDeclaration; }
-    const std::string &getName() const { return name_; }
+    const std::string &getName() const { return name_.str(); }
+    Symbol getSymbol() const { return name_; }
     std::optional<ASTTypeSpecifier *> getTypeValue() const { return type_; }
     std::optional<ASTNodePtr> getInitializer() const { return initializer_; }
     std::size_t getLineNumber() const { return lineNumber_; }
@@ -818,7 +816,7 @@ public:
 class ASTGlobalVariableDeclaration : public ASTNode
 {
 private:
-    std::string name_;
+    Symbol name_;
     std::optional<ASTTypeSpecifier *> type_;
     std::optional<ASTNodePtr> initializer_;
     ASTAccessSpecifier accessSpecifier_;
@@ -826,27 +824,18 @@ private:
     std::size_t lineNumber_;
 
 public:
-    ASTGlobalVariableDeclaration(std::string name, std::optional<ASTTypeSpecifier *> type, std::optional<ASTNodePtr> initializer, std::size_t lineNumber, ASTAccessSpecifier accessSpecifier = ASTAccessSpecifier::Default, std::optional<ASTStorageClassSpecifier> storageClassSpecifier = std::nullopt)
+    ASTGlobalVariableDeclaration(Symbol name, std::optional<ASTTypeSpecifier *> type, std::optional<ASTNodePtr> initializer, std::size_t lineNumber, ASTAccessSpecifier accessSpecifier = ASTAccessSpecifier::Default, std::optional<ASTStorageClassSpecifier> storageClassSpecifier = std::nullopt)
         : name_(name), type_(type), initializer_(initializer), accessSpecifier_(accessSpecifier), storageClassSpecifier_(storageClassSpecifier), lineNumber_(lineNumber) {}
-    ~ASTGlobalVariableDeclaration()
-    {
-        if (initializer_.has_value())
-        {
-            delete initializer_.value();
-        }
-
-        if (type_.has_value())
-        {
-            delete type_.value();
-        }
-    }
 
-    NodeType getType() const override { return NodeType::VariableDeclaration; }
-    const std::string &getName() const { return name_; }
+    NodeType getType() const override { return NodeType::GlobalVariableDeclaration; }
+    const std::string &getName() const { return name_.str(); }
+    Symbol getSymbol() const { return name_; }
     std::optional<ASTTypeSpecifier *> getTypeValue() const { return type_; }
     std::optional<ASTNodePtr> getInitializer() const { return initializer_; }
     ASTAccessSpecifier getAccessSpecifier() const { return accessSpecifier_; }
     std::optional<ASTStorageClassSpecifier> getStorageClassSpecifier() const { return storageClassSpecifier_; }
+    bool isExtern() const { return storageClassSpecifier_ == ASTStorageClassSpecifier::Extern || storageClassSpecifier_ == ASTStorageClassSpecifier::ExternThreadLocal; }
+    bool isThreadLocal() const { return storageClassSpecifier_ == ASTStorageClassSpecifier::ThreadLocal || storageClassSpecifier_ == ASTStorageClassSpecifier::ExternThreadLocal; }
     std::size_t getLineNumber() const { return lineNumber_; }
 
     void print(int indent) const override
@@ -879,6 +868,12 @@ public:
             case ASTStorageClassSpecifier::Inline:
                 std::cout << "Inline";
                 break;
+            case ASTStorageClassSpecifier::ThreadLocal:
+                std::cout << "Thread Local";
+                break;
+            case ASTStorageClassSpecifier::ExternThreadLocal:
+                std::cout << "Extern Thread Local";
+                break;
             default:
                 std::cout << "Unknown";
                 break;
@@ -899,17 +894,18 @@ public:
 class ASTStructField : public ASTNode
 {
 private:
-    std::string name_;
+    Symbol name_;
     ASTTypeSpecifier type_;
     ASTAccessSpecifier accessSpecifier_;
     std::size_t lineNumber_;
 
 public:
-    ASTStructField(std::string name, ASTTypeSpecifier type, std::size_t lineNumber, ASTAccessSpecifier accessSpecifier = ASTAccessSpecifier::Default)
+    ASTStructField(Symbol name, ASTTypeSpecifier type, std::size_t lineNumber, ASTAccessSpecifier accessSpecifier = ASTAccessSpecifier::Default)
         : name_(name), type_(type), accessSpecifier_(accessSpecifier), lineNumber_(lineNumber) {}
 
     NodeType getType() const override { return NodeType::StructField; }
-    const std::string &getName() const { return name_; }
+    const std::string &getName() const { return name_.str(); }
+    Symbol getSymbol() const { return name_; }
     const ASTTypeSpecifier &getTypeSpecifier() const { return type_; }
     ASTAccessSpecifier getAccessSpecifier() const { return accessSpecifier_; }
     std::size_t getLineNumber() const { return lineNumber_; }
@@ -931,23 +927,58 @@ public:
     }
 };
 
+// Layout control written between `struct` and the name, e.g. `struct [[packed, align(16)]] Header`.
+// The semantic stage checks the names and evaluates the argument.
+class ASTStructAttribute : public ASTNode
+{
+private:
+    Symbol name_;
+    std::optional<ASTNodePtr> argument_;
+    std::size_t lineNumber_;
+
+public:
+    ASTStructAttribute(Symbol name, std::optional<ASTNodePtr> argument, std::size_t lineNumber)
+        : name_(name), argument_(argument), lineNumber_(lineNumber) {}
+
+    NodeType getType() const override { return NodeType::StructAttribute; }
+    const std::string &getName() const { return name_.str(); }
+    Symbol getSymbol() const { return name_; }
+    std::optional<ASTNodePtr> getArgument() const { return argument_; }
+    std::size_t getLineNumber() const { return lineNumber_; }
+
+    void print(int indent) const override
+    {
+        printIndent(indent);
+        std::cout << "StructAttribute: " << name_ << std::endl;
+
+        if (argument_.has_value())
+        {
+            printIndent(indent + 1);
+            std::cout << "Argument:" << std::endl;
+            argument_.value()->print(indent + 2);
+        }
+    }
+};
+
 class ASTStructDefinition : public ASTNode
 {
 private:
-    std::optional<std::string> name_;
+    std::optional<Symbol> name_;
     std::vector<ASTStructField> members_;
     std::vector<ASTFunctionDefinition> methods_;
+    std::vector<ASTStructAttribute> attributes_;
     ASTAccessSpecifier accessSpecifier_;
     std::size_t lineNumber_;
 
 public:
-    ASTStructDefinition(std::optional<std::string> name, std::vector<ASTStructField> members, std::vector<ASTFunctionDefinition> methods, std::size_t lineNumber, ASTAccessSpecifier accessSpecifier = ASTAccessSpecifier::Default)
-        : name_(name), members_(members), methods_(methods), accessSpecifier_(accessSpecifier), lineNumber_(lineNumber) {}
+    ASTStructDefinition(std::optional<Symbol> name, std::vector<ASTStructField> members, std::vector<ASTFunctionDefinition> methods, std::size_t lineNumber, ASTAccessSpecifier accessSpecifier = ASTAccessSpecifier::Default, std::vector<ASTStructAttribute> attributes = {})
+        : name_(name), members_(members), methods_(methods), attributes_(attributes), accessSpecifier_(accessSpecifier), lineNumber_(lineNumber) {}
 
     NodeType getType() const override { return NodeType::StructDefinition; }
-    const std::optional<std::string> &getName() const { return name_; }
+    const std::optional<Symbol> &getName() const { return name_; }
     const std::vector<ASTStructField> &getMembers() const { return members_; }
     const std::vector<ASTFunctionDefinition> &getMethods() const { return methods_; }
+    const std::vector<ASTStructAttribute> &getAttributes() const { return attributes_; }
     ASTAccessSpecifier getAccessSpecifier() const { return accessSpecifier_; }
     std::size_t getLineNumber() const { return lineNumber_; }
 
@@ -965,6 +996,11 @@ public:
         printIndent(indent + 1);
         printAccessSpecifier(accessSpecifier_);
 
+        for (const auto &attribute : attributes_)
+        {
+            attribute.print(indent + 1);
+        }
+
         printIndent(indent + 1);
         std::cout << "Members:" << std::endl;
         for (const auto &member : members_)
@@ -984,24 +1020,18 @@ public:
 class ASTStructInitialization : public ASTNode
 {
 private:
-    std::string structName_;
-    std::vector<std::pair<std::string, ASTNodePtr>> fieldInitializers_;
+    Symbol structName_;
+    std::vector<std::pair<Symbol, ASTNodePtr>> fieldInitializers_;
     std::size_t lineNumber_;
 
 public:
-    ASTStructInitialization(std::string structName, std::vector<std::pair<std::string, ASTNodePtr>> fieldInitializers, std::size_t lineNumber)
+    ASTStructInitialization(Symbol structName, std::vector<std::pair<Symbol, ASTNodePtr>> fieldInitializers, std::size_t lineNumber)
         : structName_(structName), fieldInitializers_(fieldInitializers), lineNumber_(lineNumber) {}
-    ~ASTStructInitialization()
-    {
-        for (auto &&item : fieldInitializers_)
-        {
-            delete item.second;
-        }
-    }
 
     NodeType getType() const override { return NodeType::StructInitialization; }
-    const std::string &getStructName() const { return structName_; }
-    const std::vector<std::pair<std::string, ASTNodePtr>> &getFieldInitializers() const { return fieldInitializers_; }
+    const std::string &getStructName() const { return structName_.str(); }
+    Symbol getStructSymbol() const { return structName_; }
+    const std::vector<std::pair<Symbol, ASTNodePtr>> &getFieldInitializers() const { return fieldInitializers_; }
     std::size_t getLineNumber() const { return lineNumber_; }
 
     void print(int indent) const override
@@ -1034,12 +1064,6 @@ private:
 public:
     ASTConditionalExpression(ASTNodePtr condition, ASTNodePtr trueExpression, ASTNodePtr falseExpression, std::size_t lineNumber)
         : condition_(condition), trueExpression_(trueExpression), falseExpression_(falseExpression), lineNumber_(lineNumber) {}
-    ~ASTConditionalExpression()
-    {
-        delete condition_;
-        delete trueExpression_;
-        delete falseExpression_;
-    }
 
     NodeType getType() const override { return NodeType::ConditionalExpression; }
     ASTNodePtr getCondition() const { return condition_; }
@@ -1087,11 +1111,6 @@ public:
 
     ASTAssignment(ASTNodePtr left, Operator op, ASTNodePtr right, std::size_t lineNumber)
         : left_(left), op_(op), right_(right), lineNumber_(lineNumber) {}
-    ~ASTAssignment()
-    {
-        delete left_;
-        delete right_;
-    }
 
     NodeType getType() const override { return NodeType::AssignmentExpression; }
 
@@ -1161,14 +1180,6 @@ private:
 public:
     ASTFunctionCall(ASTNodePtr expr, std::vector<ASTNodePtr> arguments, std::size_t lineNumber)
         : expr_(expr), arguments_(arguments), lineNumber_(lineNumber) {}
-    ~ASTFunctionCall()
-    {
-        for (auto &&argument : arguments_)
-        {
-            delete argument;
-        }
-        delete expr_;
-    }
 
     NodeType getType() const override { return NodeType::FunctionCall; }
     ASTNodePtr getExpr() const { return expr_; }
@@ -1197,22 +1208,25 @@ class ASTFieldAccess : public ASTNode
 {
 private:
     ASTNodePtr operand_;
-    std::string field_name_;
+    Symbol field_name_;
     std::size_t lineNumber_;
+    mutable int fieldIndex_ = -1;
 
 public:
-    ASTFieldAccess(ASTNodePtr operand, std::string field_name, std::size_t lineNumber)
+    ASTFieldAccess(ASTNodePtr operand, Symbol field_name, std::size_t lineNumber)
         : operand_(operand), field_name_(field_name), lineNumber_(lineNumber) {}
-    ~ASTFieldAccess()
-    {
-        delete operand_;
-    }
 
     NodeType getType() const override { return NodeType::FieldAccess; }
     ASTNodePtr getOperand() const { return operand_; }
-    const std::string &getFieldName() const { return field_name_; }
+    const std::string &getFieldName() const { return field_name_.str(); }
+    Symbol getFieldSymbol() const { return field_name_; }
     std::size_t getLineNumber() const { return lineNumber_; }
 
+    // Set by the semantic stage: index of the struct field, or of the enum
+    // variant when the operand names an enum.
+    int getFieldIndex() const { return fieldIndex_; }
+    void setFieldIndex(int index) const { fieldIndex_ = index; }
+
     void print(int indent) const override
     {
         printIndent(indent);
@@ -1230,7 +1244,7 @@ private:
 public:
     ASTPointerFieldAccess(ASTFieldAccess field_access, std::size_t lineNumber) : field_access_(field_access), lineNumber_(lineNumber) {}
     NodeType getType() const override { return NodeType::PointerFieldAccess; }
-    ASTFieldAccess getFieldAccess() const { return field_access_; }
+    const ASTFieldAccess &getFieldAccess() const { return field_access_; }
     std::size_t getLineNumber() const { return lineNumber_; }
 
     void print(int indent) const override
@@ -1241,17 +1255,44 @@ public:
     }
 };
 
+// `operand[index]`: an element of the memory a pointer points into, or a
+// row of a soa struct, which is only ever used to reach one of its fields.
+class ASTIndexAccess : public ASTNode
+{
+private:
+    ASTNodePtr operand_;
+    ASTNodePtr index_;
+    std::size_t lineNumber_;
+
+public:
+    ASTIndexAccess(ASTNodePtr operand, ASTNodePtr index, std::size_t lineNumber)
+        : operand_(operand), index_(index), lineNumber_(lineNumber) {}
+
+    NodeType getType() const override { return NodeType::IndexAccess; }
+    ASTNodePtr getOperand() const { return operand_; }
+    ASTNodePtr getIndex() const { return index_; }
+    std::size_t getLineNumber() const { return lineNumber_; }
+
+    void print(int indent) const override
+    {
+        printIndent(indent);
+        std::cout << "IndexAccess: " << std::endl;
+        operand_->print(indent + 1);
+        index_->print(indent + 1);
+    }
+};
+
 class ASTEnumVariantItem
 {
 private:
-    std::optional<std::string> name_;
+    std::optional<Symbol> name_;
     ASTTypeSpecifier type_;
     std::size_t lineNumber_;
 
 public:
-    ASTEnumVariantItem(std::optional<std::string> name, ASTTypeSpecifier type, std::size_t lineNumber) : name_(name), type_(type), lineNumber_(lineNumber) {}
+    ASTEnumVariantItem(std::optional<Symbol> name, ASTTypeSpecifier type, std::size_t lineNumber) : name_(name), type_(type), lineNumber_(lineNumber) {}
 
-    const std::optional<std::string> &getName() const { return name_; }
+    const std::optional<Symbol> &getName() const { return name_; }
     const ASTTypeSpecifier &getTypeSpecifier() const { return type_; }
     std::size_t getLineNumber() const { return lineNumber_; }
 };
@@ -1259,16 +1300,17 @@ public:
 class ASTEnumVariant : public ASTNode
 {
 private:
-    std::string name_;
+    Symbol name_;
     std::vector<ASTEnumVariantItem> items_;
     std::size_t lineNumber_;
 
 public:
-    ASTEnumVariant(std::string name, std::vector<ASTEnumVariantItem> items, std::size_t lineNumber)
+    ASTEnumVariant(Symbol name, std::vector<ASTEnumVariantItem> items, std::size_t lineNumber)
         : name_(name), items_(items), lineNumber_(lineNumber) {}
 
     NodeType getType() const override { return NodeType::EnumVariant; }
-    const std::string &getName() const { return name_; }
+    const std::string &getName() const { return name_.str(); }
+    Symbol getSymbol() const { return name_; }
     const std::vector<ASTEnumVariantItem> &getItems() const { return items_; }
     std::size_t getLineNumber() const { return lineNumber_; }
 
@@ -1301,17 +1343,17 @@ public:
 class ASTEnumDefinition : public ASTNode
 {
 private:
-    std::optional<std::string> name_;
+    std::optional<Symbol> name_;
     std::vector<ASTEnumVariant> variants_;
-    std::vector<std::pair<std::string, std::optional<ASTNodePtr>>> fields_;
+    std::vector<std::pair<Symbol, std::optional<ASTNodePtr>>> fields_;
     std::vector<ASTFunctionDefinition> methods_;
     ASTAccessSpecifier accessSpecifier_;
     std::size_t lineNumber_;
 
 public:
-    ASTEnumDefinition(std::optional<std::string> name,
+    ASTEnumDefinition(std::optional<Symbol> name,
                       std::vector<ASTEnumVariant> variants,
-                      std::vector<std::pair<std::string, std::optional<ASTNodePtr>>> fields,
+                      std::vector<std::pair<Symbol, std::optional<ASTNodePtr>>> fields,
                       std::vector<ASTFunctionDefinition> methods,
                       std::size_t lineNumber,
                       ASTAccessSpecifier accessSpecifier = ASTAccessSpecifier::Default)
@@ -1319,21 +1361,11 @@ public:
         : name_(name), variants_(variants), fields_(fields), methods_(methods), accessSpecifier_(accessSpecifier), lineNumber_(lineNumber)
     {
     }
-    ~ASTEnumDefinition()
-    {
-        for (auto &&item : fields_)
-        {
-            if (item.second.has_value())
-            {
-                delete item.second.value();
-            }
-        }
-    }
 
     NodeType getType() const override { return NodeType::EnumDefinition; }
-    const std::optional<std::string> &getName() const { return name_; }
+    const std::optional<Symbol> &getName() const { return name_; }
     const std::vector<ASTEnumVariant> &getVariants() const { return variants_; }
-    const std::vector<std::pair<std::string, std::optional<ASTNodePtr>>> &getFields() const { return fields_; }
+    const std::vector<std::pair<Symbol, std::optional<ASTNodePtr>>> &getFields() const { return fields_; }
     const std::vector<ASTFunctionDefinition> &getMethods() const { return methods_; }
     ASTAccessSpecifier getAccessSpecifier() const { return accessSpecifier_; }
     std::size_t getLineNumber() const { return lineNumber_; }
@@ -1390,13 +1422,6 @@ private:
 
 public:
     ASTReturnStatement(std::optional<ASTNodePtr> expression, std::size_t lineNumber) : expression_(expression), lineNumber_(lineNumber) {}
-    ~ASTReturnStatement()
-    {
-        if (expression_.has_value())
-        {
-            delete expression_.value();
-        }
-    }
 
     NodeType getType() const override { return NodeType::ReturnStatement; }
     const std::optional<ASTNodePtr> &getExpr() const { return expression_; }
@@ -1466,22 +1491,6 @@ private:
 public:
     ASTForStatement(std::optional<ASTNodePtr> initializer, std::optional<ASTNodePtr> condition, std::optional<ASTNodePtr> increment, ASTNodePtr body, std::size_t lineNumber)
         : initializer_(initializer), condition_(condition), increment_(increment), body_(body), lineNumber_(lineNumber) {}
-    ~ASTForStatement()
-    {
-        if (initializer_.has_value())
-        {
-            delete initializer_.value();
-        }
-        if (condition_.has_value())
-        {
-            delete condition_.value();
-        }
-        if (increment_.has_value())
-        {
-            delete increment_.value();
-        }
-        delete body_;
-    }
 
     NodeType getType() const override { return NodeType::ForStatement; }
     std::optional<ASTNodePtr> getInitializer() const { return initializer_; }
@@ -1533,15 +1542,6 @@ private:
 public:
     ASTIfStatement(ASTNodePtr condition, ASTNodePtr thenBranch, std::size_t lineNumber, std::optional<ASTNodePtr> elseBranch = std::nullopt)
         : condition_(condition), thenBranch_(thenBranch), elseBranch_(elseBranch), lineNumber_(lineNumber) {}
-    ~ASTIfStatement()
-    {
-        delete condition_;
-        delete thenBranch_;
-        if (elseBranch_.has_value())
-        {
-            delete elseBranch_.value();
-        }
-    }
 
     NodeType getType() const override { return NodeType::IfStatement; }
     ASTNodePtr getCondition() const { return condition_; }
@@ -1572,4 +1572,85 @@ public:
     }
 };
 
+// `case a, b: body`, or `default: body` when there are no labels. A label
+// is a constant, or a variant of the enum switched on. `Enum.Variant(x, y)`
+// also binds the payload of the variant to new locals `x` and `y`.
+class ASTSwitchCase : public ASTNode
+{
+private:
+    std::vector<ASTNodePtr> labels_;
+    ASTNodePtr body_;
+    std::size_t lineNumber_;
+
+public:
+    ASTSwitchCase(std::vector<ASTNodePtr> labels, ASTNodePtr body, std::size_t lineNumber)
+        : labels_(std::move(labels)), body_(body), lineNumber_(lineNumber) {}
+
+    NodeType getType() const override { return NodeType::SwitchCase; }
+    const std::vector<ASTNodePtr> &getLabels() const { return labels_; }
+    bool isDefault() const { return labels_.empty(); }
+    ASTNodePtr getBody() const { return body_; }
+    std::size_t getLineNumber() const { return lineNumber_; }
+
+    void print(int indent) const override
+    {
+        printIndent(indent);
+        std::cout << (isDefault() ? "Default:" : "Case:") << std::endl;
+
+        for (ASTNodePtr label : labels_)
+        {
+            label->print(indent + 1);
+        }
+
+        printIndent(indent + 1);
+        std::cout << "Body:" << std::endl;
+        body_->print(indent + 2);
+    }
+};
+
+// Cases never fall through into each other, `break` leaves the switch.
+class ASTSwitchStatement : public ASTNode
+{
+private:
+    ASTNodePtr subject_;
+    std::vector<ASTSwitchCase> cases_;
+    std::size_t lineNumber_;
+
+public:
+    ASTSwitchStatement(ASTNodePtr subject, std::vector<ASTSwitchCase> cases, std::size_t lineNumber)
+        : subject_(subject), cases_(std::move(cases)), lineNumber_(lineNumber) {}
+
+    NodeType getType() const override { return NodeType::SwitchStatement; }
+    ASTNodePtr getSubject() const { return subject_; }
+    const std::vector<ASTSwitchCase> &getCases() const { return cases_; }
+    std::size_t getLineNumber() const { return lineNumber_; }
+
+    void print(int indent) const override
+    {
+        printIndent(indent);
+        std::cout << "SwitchStatement:" << std::endl;
+
+        printIndent(indent + 1);
+        std::cout << "Subject:" << std::endl;
+        subject_->print(indent + 2);
+
+        for (const ASTSwitchCase &switchCase : cases_)
+        {
+            switchCase.print(indent + 1);
+        }
+    }
+};
+
+// Nodes that only hold scalars and child pointers are released together with
+// their arena without running any destructor.
+static_assert(std::is_trivially_destructible_v<ASTIntegerLiteral>);
+static_assert(std::is_trivially_destructible_v<ASTBinaryExpression>);
+static_assert(std::is_trivially_destructible_v<ASTUnaryExpression>);
+static_assert(std::is_trivially_destructible_v<ASTCastExpression>);
+static_assert(std::is_trivially_destructible_v<ASTIfStatement>);
+static_assert(std::is_trivially_destructible_v<ASTForStatement>);
+static_assert(std::is_trivially_destructible_v<ASTIdentifier>);
+static_assert(std::is_trivially_destructible_v<ASTVariableDeclaration>);
+static_assert(std::is_trivially_destructible_v<ASTFieldAccess>);
+
 #endif
\ No newline at end of file
@@ -4,6 +4,13 @@
 #include <nlohmann/json.hpp>
 #include <iostream>
 #include <vector>
+#include "util/source_range.hpp"
+
+namespace semantic
+{
+    class Type;
+    struct Declaration;
+}
 
 class ASTNode
 {
@@ -13,6 +20,7 @@ public:
         Program,
         StatementList,
         VariableDeclaration,
+        GlobalVariableDeclaration,
         IntegerLiteral,
         BoolLiteral,
         FloatLiteral,
@@ -28,6 +36,7 @@ public:
         FunctionParameter,
         TypeDefStatement,
         StructDefinition,
+        StructAttribute,
         StructField,
         StructInitialization,
         ConditionalExpression,
@@ -36,6 +45,7 @@ public:
         FunctionCall,
         FieldAccess,
         PointerFieldAccess,
+        IndexAccess,
         EnumVariant,
         EnumDefinition,
         ReturnStatement,
@@ -43,15 +53,30 @@ public:
         BreakStatement,
         ForStatement,
         IfStatement,
+        SwitchStatement,
+        SwitchCase,
     };
 
-    virtual ~ASTNode() = default;
     virtual NodeType getType() const = 0;
 
     virtual void print(int) const = 0;
     virtual nlohmann::json jsonify() const {}
 
+    // Bytes of the source file the node was parsed from, set by the parser.
+    // Lines and columns are resolved through the file's LineTable.
+    const util::SourceRange &getRange() const { return range_; }
+    void setRange(const util::SourceRange &range) { range_ = range; }
+
+    // Set by the semantic stage: the type of an expression, the type a type
+    // specifier denotes, or the declared type of a declaration.
+    const semantic::Type *getSemanticType() const { return semanticType_; }
+    void setSemanticType(const semantic::Type *type) const { semanticType_ = type; }
+
 protected:
+    // Nodes are owned by an ASTArena and never deleted through a base pointer,
+    // which keeps leaf nodes trivially destructible.
+    ~ASTNode() = default;
+
     void printIndent(int indent) const
     {
         for (int i = 0; i < indent; ++i)
@@ -59,6 +84,13 @@ protected:
             std::cout << "  ";
         }
     }
+
+private:
+    util::SourceRange range_;
+
+    // Annotations leave the parsed tree as it is, so they may be set on nodes
+    // that are only reachable through const accessors.
+    mutable const semantic::Type *semanticType_ = nullptr;
 };
 
 using ASTNodePtr = ASTNode *;
@@ -0,0 +1,48 @@
+#ifndef AST_SYMBOL_HPP
+#define AST_SYMBOL_HPP
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// Handle to a string interned in the process-wide SymbolTable. Identifiers,
+// type names and module paths are stored as symbols, so comparing or hashing
+// them is an integer operation and every distinct spelling is stored once.
+//
+// Symbol is trivially constructible so it can live in the Bison %union;
+// value-initialize it (Symbol{}) to get the empty symbol.
+class Symbol
+{
+private:
+    std::uint32_t id_;
+
+    explicit Symbol(std::uint32_t id) : id_(id) {}
+    friend class SymbolTable;
+
+public:
+    Symbol() = default;
+
+    static Symbol intern(std::string_view text);
+
+    std::uint32_t getId() const { return id_; }
+    bool empty() const { return id_ == 0; }
+    const std::string &str() const;
+
+    bool operator==(const Symbol &other) const { return id_ == other.id_; }
+    bool operator!=(const Symbol &other) const { return id_ != other.id_; }
+    bool operator<(const Symbol &other) const { return id_ < other.id_; }
+};
+
+inline bool operator==(const Symbol &symbol, std::string_view text) { return symbol.str() == text; }
+
+inline std::ostream &operator<<(std::ostream &os, const Symbol &symbol) { return os << symbol.str(); }
+
+template <>
+struct std::hash<Symbol>
+{
+    std::size_t operator()(const Symbol &symbol) const noexcept { return symbol.getId(); }
+};
+
+#endif // AST_SYMBOL_HPP
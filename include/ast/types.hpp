@@ -47,10 +47,6 @@ public:
             throw std::runtime_error("Internal type " + formatInternalType() + " cannot have a inner value.");
         }
     }
-    ~ASTTypeSpecifier()
-    {
-        delete inner_;
-    }
 
     NodeType getType() const override { return NodeType::TypeSpecifier; }
     ASTInternalType getTypeValue() const { return type_; }
@@ -0,0 +1,50 @@
+#ifndef CODEGEN_LLVM_CACHE_HPP
+#define CODEGEN_LLVM_CACHE_HPP
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "options.hpp"
+#include "util/diagnostics.hpp"
+
+const std::string CACHE_DIR = "cache";
+
+// Content-addressed store of compiled modules under `<build-dir>/cache`.
+//
+// An entry is keyed by a BLAKE3 hash of everything that affects the emitted
+// file: the source bytes, module name, compiler build and LLVM version, target
+// triple, output kind and optimization options. On a hit the stored file is
+// copied to the output path and the module is neither parsed nor lowered, so
+// the diagnostics the module produced are stored next to it and replayed.
+class CodeGenLLVM_Cache
+{
+private:
+    std::string cacheDirectory_;
+
+    std::string getEntryPath(const std::string &key) const { return cacheDirectory_ + "/" + key; }
+    std::string getDiagnosticsPath(const std::string &key) const { return getEntryPath(key) + ".diag"; }
+
+public:
+    explicit CodeGenLLVM_Cache(const std::string &buildDirectory);
+
+    static std::string computeKey(std::string_view sourceContent,
+                                  const std::string &moduleName,
+                                  const std::string &triple,
+                                  const CodeGenLLVM_Options &opts);
+
+    // Copy the entry to `outputFilePath` and report its diagnostics against `source`. Returns false on a miss.
+    bool restore(const std::string &key,
+                 const std::string &outputFilePath,
+                 const std::shared_ptr<util::SourceBuffer> &source,
+                 util::DiagnosticEngine &diagnostics) const;
+
+    // Publish a freshly emitted file along with the diagnostics of its module. Entries are
+    // written to a unique temporary file and renamed into place, so concurrent writers never
+    // expose a partial entry.
+    void store(const std::string &key,
+               const std::string &outputFilePath,
+               const std::vector<util::Diagnostic> &moduleDiagnostics) const;
+};
+
+#endif // CODEGEN_LLVM_CACHE_HPP
@@ -8,24 +8,33 @@
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h"
+#include "llvm/IR/LegacyPassManager.h"
 #include "llvm/MC/TargetRegistry.h"
 #include "llvm/TargetParser/Host.h"
 #include <llvm/IR/LLVMContext.h>
 #include "llvm/IR/Module.h"
 #include "llvm/IR/IRBuilder.h"
 #include "ast/ast.hpp"
+#include "util/source_buffer.hpp"
+#include "util/diagnostics.hpp"
+#include "semantic/constant.hpp"
+#include "semantic/types.hpp"
 #include "options.hpp"
 #include "values.hpp"
 #include "types.hpp"
+#include "layout.hpp"
 #include "scope.hpp"
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 void new_codegen_llvm(CodeGenLLVM_Options);
+int run_codegen_llvm(CodeGenLLVM_Options);
 
 struct FuncTableItem;
 struct GlobalVarTableItem;
-using FuncTable = std::map<std::string, FuncTableItem>;
-using GlobalVarTable = std::map<std::string, GlobalVarTableItem>;
+using FuncTable = std::unordered_map<Symbol, FuncTableItem>;
+using GlobalVarTable = std::unordered_map<Symbol, GlobalVarTableItem>;
 
 class CodeGenLLVM_Module
 {
@@ -34,45 +43,137 @@ private:
     llvm::LLVMContext &context_;
     llvm::IRBuilder<> builder_;
     std::string filePath_;
-    std::shared_ptr<std::string> fileContent_;
+    std::shared_ptr<util::SourceBuffer> fileContent_;
+    util::DiagnosticEngine &diagnostics_;
 
     FuncTable funcTable_;
     GlobalVarTable globalVarTable_;
+    CodeGenLLVM_TypeTable typeTable_;
+
+    // Structs and enums lowered so far, in the order they were first needed.
+    std::unordered_map<const semantic::Type *, CodeGenLLVM_StructLayout> structLayouts_;
+    std::unordered_map<const semantic::Type *, CodeGenLLVM_EnumLayout> enumLayouts_;
+    std::vector<const semantic::Type *> layoutOrder_;
+    // Alignment of each struct and enum LLVM type, which can exceed the ABI one.
+    std::unordered_map<const llvm::Type *, std::uint64_t> typeAlignments_;
+
+    // Function being lowered: its declared return type and the blocks
+    // `continue` and `break` jump to in each enclosing loop.
+    struct LoopTargets
+    {
+        llvm::BasicBlock *continueBlock;
+        llvm::BasicBlock *breakBlock;
+    };
+    const semantic::Type *returnType_ = nullptr;
+    std::vector<LoopTargets> loops_;
+    // Placeholder at the end of the allocas in the entry block, removed once the body is done.
+    llvm::Instruction *allocaInsertPoint_ = nullptr;
+
+    // What the module ends up in, nullopt when it runs in the JIT. Picks the TLS model.
+    std::optional<CodeGenLLVM_OutputKind> outputKind_;
+
+    // String literals emitted so far, by contents.
+    std::unordered_map<std::string, llvm::GlobalVariable *> strings_;
 
 public:
-    CodeGenLLVM_Module(llvm::LLVMContext &context, const std::string &moduleName, const std::string &filePath, std::shared_ptr<std::string> fileContent)
-        : module_(std::make_unique<llvm::Module>(moduleName, context)), context_(context), builder_(context), filePath_(filePath), fileContent_(fileContent)
+    CodeGenLLVM_Module(llvm::LLVMContext &context, const std::string &moduleName, const std::string &filePath, std::shared_ptr<util::SourceBuffer> fileContent, util::DiagnosticEngine &diagnostics)
+        : module_(std::make_unique<llvm::Module>(moduleName, context)), context_(context), builder_(context), filePath_(filePath), fileContent_(fileContent), diagnostics_(diagnostics), typeTable_(context)
     {
     }
 
     llvm::Module *getModule() { return module_.get(); }
+    std::unique_ptr<llvm::Module> releaseModule() { return std::move(module_); }
     llvm::LLVMContext &getContext() { return context_; }
     void buildProgramIR(ASTProgram *program);
+    void setOutputKind(std::optional<CodeGenLLVM_OutputKind> outputKind) { outputKind_ = outputKind; }
     const std::string &getFilePath() const { return filePath_; }
-    std::shared_ptr<std::string> getFileContent() const { return fileContent_; }
+    std::string_view getFileContent() const { return fileContent_->getText(); }
 
     // Types
+    CodeGenLLVM_TypeTable &getTypeTable() { return typeTable_; }
+    // Lower the semantic type the analyzer annotated a node with. The node is used for diagnostics.
     std::shared_ptr<CodeGenLLVM_Type> compileType(ASTNodePtr nodePtr);
+    std::shared_ptr<CodeGenLLVM_Type> compileType(const semantic::Type *type, ASTNodePtr nodePtr);
+    // Layout of a struct type, lowered the first time it is needed.
+    const CodeGenLLVM_StructLayout &getStructLayout(const semantic::Type *structType, ASTNodePtr nodePtr);
+    // Layout of an enum type, lowered the first time it is needed.
+    const CodeGenLLVM_EnumLayout &getEnumLayout(const semantic::Type *enumType, ASTNodePtr nodePtr);
+    // Values a value of the type never holds, if any are known.
+    std::optional<CodeGenLLVM_Niche> getTypeNiche(const semantic::Type *type, ASTNodePtr nodePtr);
+    // ABI alignment of a type, raised by `align(N)` for structs.
+    llvm::Align getTypeAlignment(llvm::Type *type);
+    // Size, alignment and holes of every struct and enum lowered so far, for --emit-layout.
+    std::string getLayoutReport() const;
 
     // Statements
     void compileStmt(OptionalScopePtr scope, ASTNodePtr nodePtr);
     void compileStmts(OptionalScopePtr scope, ASTNodeList nodeList);
     void compileGlobalVariableDeclaration(ASTNodePtr nodePtr);
+    llvm::GlobalValue::ThreadLocalMode getThreadLocalMode(bool isDefinition) const;
     void compileVariableDeclaration(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    llvm::FunctionType *compileFunctionType(const semantic::Type *funcType, ASTNodePtr nodePtr);
+    void declareFunction(ASTNodePtr nodePtr);
     void compileFunctionDefinition(ASTNodePtr nodePtr);
+    void compileIfStatement(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    void compileForStatement(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    void compileSwitchStatement(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    void compileReturnStatement(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    void compileBranch(OptionalScopePtr scope, ASTNodePtr nodePtr, llvm::BasicBlock *nextBlock);
+    bool isBlockTerminated();
     llvm::AllocaInst *createZeroInitializedAlloca(
         const std::string &name,
         std::shared_ptr<CodeGenLLVM_Type> type,
         std::optional<llvm::Value *> init,
         std::size_t lineNumber);
     llvm::Value *createZeroInitializedValue(std::shared_ptr<CodeGenLLVM_Type> type, std::size_t lineNumber);
+    llvm::Constant *compileConstant(const semantic::ConstantValue &value);
 
     // Expressions
     std::shared_ptr<CodeGenLLVM_EValue> compileExpr(OptionalScopePtr scope, ASTNodePtr nodePtr);
     std::shared_ptr<CodeGenLLVM_EValue> compileIntegerLiteral(ASTNodePtr nodePtr);
     std::shared_ptr<CodeGenLLVM_EValue> compileFloatLiteral(ASTNodePtr nodePtr);
     std::shared_ptr<CodeGenLLVM_EValue> compileStringLiteral(ASTNodePtr nodePtr);
+    // Address of the pooled copy of a string literal.
+    llvm::Constant *getStringConstant(const std::string &value);
+    // Point literals that end another one into it, once the module is done.
+    void mergeStringSuffixes();
     std::shared_ptr<CodeGenLLVM_EValue> compileBoolLiteral(ASTNodePtr nodePtr);
+    std::shared_ptr<CodeGenLLVM_EValue> compileIdentifier(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    std::shared_ptr<CodeGenLLVM_EValue> compileBinaryExpression(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    std::shared_ptr<CodeGenLLVM_EValue> compileLogicalExpression(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    std::shared_ptr<CodeGenLLVM_EValue> compileUnaryExpression(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    std::shared_ptr<CodeGenLLVM_EValue> compileIncrement(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    std::shared_ptr<CodeGenLLVM_EValue> compileAssignment(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    std::shared_ptr<CodeGenLLVM_EValue> compileConditionalExpression(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    std::shared_ptr<CodeGenLLVM_EValue> compileCastExpression(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    std::shared_ptr<CodeGenLLVM_EValue> compileFunctionCall(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    std::shared_ptr<CodeGenLLVM_EValue> compileFieldAccess(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    std::shared_ptr<CodeGenLLVM_EValue> compileIndexAccess(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    llvm::Value *compileIndex(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    llvm::Value *compileAddress(OptionalScopePtr scope, ASTNodePtr nodePtr, std::shared_ptr<CodeGenLLVM_Type> type, std::size_t lineNumber);
+    std::shared_ptr<CodeGenLLVM_EValue> compileStructInitialization(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    std::shared_ptr<CodeGenLLVM_EValue> compileEnumVariant(OptionalScopePtr scope, const ASTFieldAccess *variantAccess, const std::vector<ASTNodePtr> &arguments);
+    llvm::Value *compileEnumCaseValue(llvm::Value *address, const CodeGenLLVM_EnumLayout &layout);
+    llvm::Value *getVariantPayloadAddress(llvm::Value *address, const CodeGenLLVM_EnumLayout &layout);
+    llvm::Value *promoteVariadicArgument(llvm::Value *value, const semantic::Type *type);
+    llvm::Value *compileBinaryOperation(
+        ASTBinaryExpression::Operator op,
+        llvm::Value *lhs,
+        const semantic::Type *lhsType,
+        llvm::Value *rhs,
+        const semantic::Type *rhsType,
+        ASTNodePtr nodePtr);
+    llvm::Value *compileStringEquality(llvm::Value *lhs, llvm::Value *rhs);
+    llvm::Value *compileEnumEquality(llvm::Value *lhs, llvm::Value *rhs, const semantic::Type *enumType, ASTNodePtr nodePtr);
+
+    // Load the value of an lvalue; rvalues are returned as they are.
+    std::shared_ptr<CodeGenLLVM_Value> loadValue(const std::shared_ptr<CodeGenLLVM_EValue> &evalue);
+    // Compile an expression as a value converted to `type`, or left as it is when `type` is nullptr.
+    std::shared_ptr<CodeGenLLVM_Value> compileRValue(OptionalScopePtr scope, ASTNodePtr nodePtr, const semantic::Type *type);
+    llvm::Value *convertValue(llvm::Value *value, const semantic::Type *from, const semantic::Type *to, ASTNodePtr nodePtr);
+    // Compile an expression to an i1 that is true when its value is non-zero.
+    llvm::Value *compileCondition(OptionalScopePtr scope, ASTNodePtr nodePtr);
+    llvm::Value *createIsTrue(llvm::Value *value, const semantic::Type *type);
 };
 
 struct FuncTableItem
@@ -99,13 +200,15 @@ struct GlobalVarTableItem
 class CodeGenLLVM_Context
 {
 private:
-    llvm::LLVMContext context_;
+    std::unique_ptr<llvm::LLVMContext> context_;
     std::map<std::string, CodeGenLLVM_Module *> modules_;
     llvm::TargetMachine *targetMachine_;
     std::string triple_;
+    std::optional<CodeGenLLVM_OutputKind> outputKind_;
 
 public:
-    CodeGenLLVM_Context()
+    CodeGenLLVM_Context(CodeGenLLVM_OptimizationLevel optimizationLevel = CodeGenLLVM_OptimizationLevel::O0, std::optional<CodeGenLLVM_OutputKind> outputKind = std::nullopt)
+        : context_(std::make_unique<llvm::LLVMContext>()), outputKind_(outputKind)
     {
         llvm::InitializeNativeTarget();
         llvm::InitializeNativeTargetAsmPrinter();
@@ -122,13 +225,16 @@ public:
         }
 
         llvm::TargetOptions options;
-        auto RM = std::optional<llvm::Reloc::Model>();
+        // emitted objects end up in PIE executables and shared libraries.
+        auto RM = std::optional<llvm::Reloc::Model>(llvm::Reloc::PIC_);
         llvm::TargetMachine *targetMachine = target->createTargetMachine(
             triple_,
             "generic",
             "",
             options,
-            RM);
+            RM,
+            std::nullopt,
+            getCodeGenOptLevel(optimizationLevel));
 
         targetMachine_ = targetMachine;
     }
@@ -141,20 +247,53 @@ public:
         delete targetMachine_;
     }
 
-    llvm::LLVMContext &getContext() { return context_; }
+    llvm::LLVMContext &getContext() { return *context_; }
+    const std::string &getTriple() const { return triple_; }
+
+    // Hand the LLVMContext over to a new owner (e.g. the JIT). Every module must be removed first.
+    std::unique_ptr<llvm::LLVMContext> releaseContext() { return std::move(context_); }
     const std::map<std::string, CodeGenLLVM_Module *> &getModules() const { return modules_; }
 
-    CodeGenLLVM_Module *createModule(const std::string &moduleName, const std::string &filePath, std::shared_ptr<std::string> fileContent)
+    CodeGenLLVM_Module *createModule(const std::string &moduleName, const std::string &filePath, std::shared_ptr<util::SourceBuffer> fileContent, util::DiagnosticEngine &diagnostics)
     {
-        CodeGenLLVM_Module *module = new CodeGenLLVM_Module(context_, moduleName, filePath, fileContent);
+        CodeGenLLVM_Module *module = new CodeGenLLVM_Module(*context_, moduleName, filePath, fileContent, diagnostics);
         module->getModule()->setTargetTriple(triple_);
         module->getModule()->setDataLayout(targetMachine_->createDataLayout());
+        module->setOutputKind(outputKind_);
 
         modules_.emplace(moduleName, module);
         return modules_.at(moduleName);
     }
 
+    void removeModule(const std::string &moduleName)
+    {
+        auto it = modules_.find(moduleName);
+        if (it != modules_.end())
+        {
+            delete it->second;
+            modules_.erase(it);
+        }
+    }
+
+    static llvm::CodeGenOptLevel getCodeGenOptLevel(CodeGenLLVM_OptimizationLevel optimizationLevel);
+
+    // Run the -O pipeline (or the custom --passes pipeline) over the module in place.
+    void optimizeModule(CodeGenLLVM_Module *module, const CodeGenLLVM_Options &opts);
+
+    // Execute `main` of the module in-process. Functions are compiled lazily on first call.
+    int runModuleJIT(const std::string &moduleName, CodeGenLLVM_Module *module);
+
+    static std::string getModuleOutputFilePath(const std::string &outputPath, const std::string &moduleName, CodeGenLLVM_OutputKind outputKind);
+
     void saveIR(const std::string &outputPath);
+    void saveModuleIR(const std::string &moduleName, CodeGenLLVM_Module *module, const std::string &outputPath);
+
+    // Lower modules to object files or assembly with the context's target machine.
+    void saveNative(const std::string &outputPath, CodeGenLLVM_OutputKind outputKind);
+    void saveModuleNative(const std::string &moduleName, CodeGenLLVM_Module *module, const std::string &outputPath, CodeGenLLVM_OutputKind outputKind);
+
+    // Dispatch on the output kind to one of the functions above.
+    void saveModule(const std::string &moduleName, CodeGenLLVM_Module *module, const std::string &outputPath, CodeGenLLVM_OutputKind outputKind);
 };
 
 #endif // CODEGEN_LLVM_HPP
\ No newline at end of file
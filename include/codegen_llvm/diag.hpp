@@ -1,10 +1,23 @@
 #ifndef CODEGEN_LLVM_DIAG_HPP
 #define CODEGEN_LLVM_DIAG_HPP
 
-#include "util/util.hpp"
+#include "util/diagnostics.hpp"
 
-#define DISPLAY_DIAG(line, msg)                            \
-    util::displayErrorPanel(filePath_, *fileContent_, line, msg); \
-    exit(1)
+// Lowering cannot continue past an invalid construct, so the error is printed
+// together with everything reported so far and compilation stops.
+#define DISPLAY_DIAG(line, msg)                      \
+    do                                               \
+    {                                                \
+        diagnostics_.error(fileContent_, line, msg); \
+        diagnostics_.abort();                        \
+    } while (0)
+
+// Same as DISPLAY_DIAG, pointing at the source range of `node`.
+#define DISPLAY_DIAG_AT(node, msg)                                 \
+    do                                                             \
+    {                                                              \
+        diagnostics_.error(fileContent_, (node)->getRange(), msg); \
+        diagnostics_.abort();                                      \
+    } while (0)
 
 #endif // CODEGEN_LLVM_DIAG_HPP
@@ -0,0 +1,118 @@
+#ifndef CODEGEN_LLVM_LAYOUT_HPP
+#define CODEGEN_LLVM_LAYOUT_HPP
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "llvm/IR/DerivedTypes.h"
+#include "ast/symbol.hpp"
+#include "types.hpp"
+
+namespace semantic
+{
+    class Type;
+}
+
+// Memory layout chosen for a struct. Fields may be stored in another order
+// than declared and explicit padding elements may be inserted, so the LLVM
+// element a field lives in is looked up here instead of assumed. For a soa
+// struct every element is a column: an array holding the field of each row.
+struct CodeGenLLVM_StructLayout
+{
+    struct Field
+    {
+        Symbol name;
+        const semantic::Type *type;
+        // Index of the field, or of its column, in the llvm::StructType.
+        unsigned element;
+        // Of the field, or of the whole column.
+        std::uint64_t offset;
+        std::uint64_t size;
+        std::uint64_t alignment;
+    };
+
+    const semantic::Type *structType = nullptr;
+    std::shared_ptr<CodeGenLLVM_Type> type;
+    // In declaration order, indexed like semantic::Type::getFields().
+    std::vector<Field> fields;
+    std::uint64_t size = 0;
+    std::uint64_t alignment = 1;
+    // Rows of a soa struct, 0 for a plain struct.
+    std::uint64_t soaCapacity = 0;
+
+    llvm::StructType *getLLVMType() const { return llvm::cast<llvm::StructType>(type->getLLVMType()); }
+
+    // Bytes between fields and after the last one.
+    std::uint64_t getPadding() const
+    {
+        std::uint64_t used = 0;
+        for (const Field &field : fields)
+        {
+            used += field.size;
+        }
+        return size - used;
+    }
+};
+
+// Values a type never holds, at a fixed place inside it. An enum stores the
+// tag of its variants without a payload there instead of in a field of its own.
+struct CodeGenLLVM_Niche
+{
+    // Byte offset and width of the integer or pointer holding the values.
+    std::uint64_t offset = 0;
+    unsigned bits = 0;
+    bool isPointer = false;
+    // The values are start, start + 1, ..., start + count - 1, wrapping
+    // around at the width.
+    std::uint64_t start = 0;
+    std::uint64_t count = 0;
+};
+
+struct CodeGenLLVM_EnumLayout
+{
+    enum class Kind
+    {
+        // No variant has a payload: the enum is just its tag, an integer.
+        Tag,
+        // { tag, payload } where the payload is as large as the largest variant.
+        Tagged,
+        // Only one variant has a payload, the others are told apart by values
+        // of its niche. The enum is the payload of that variant.
+        Niche,
+    };
+
+    struct Variant
+    {
+        // Of the payload of the variant, nullptr when it has none.
+        llvm::StructType *payloadType = nullptr;
+        // Index in payloadType of each payload value.
+        std::vector<unsigned> elements;
+        std::uint64_t size = 0;
+        std::uint64_t alignment = 1;
+        // Value matched by a switch on the enum: the tag, which is the
+        // discriminant less that of the first variant, or for a niche
+        // layout, the position among the variants without a payload.
+        std::uint64_t caseValue = 0;
+    };
+
+    const semantic::Type *enumType = nullptr;
+    std::shared_ptr<CodeGenLLVM_Type> type;
+    Kind kind = Kind::Tag;
+    std::vector<Variant> variants;
+    std::uint64_t size = 0;
+    std::uint64_t alignment = 1;
+
+    // Type of caseValue. For Tag and Tagged also the tag itself, at offset 0.
+    llvm::IntegerType *tagType = nullptr;
+    // Tagged: element and offset of the payload storage.
+    unsigned payloadElement = 0;
+    std::uint64_t payloadOffset = 0;
+    // Niche: the variant with a payload and where the others are stored.
+    unsigned dataful = 0;
+    CodeGenLLVM_Niche niche;
+    // Values the enum never holds, for an enum holding this one.
+    std::optional<CodeGenLLVM_Niche> spareNiche;
+};
+
+#endif // CODEGEN_LLVM_LAYOUT_HPP
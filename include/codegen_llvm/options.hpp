@@ -1,12 +1,17 @@
 #ifndef CODEGEN_LLVM_OPTIONS_HPP
 #define CODEGEN_LLVM_OPTIONS_HPP
 
+#include <optional>
+#include <string>
 #include <vector>
 
+const std::string CYRUS_VERSION = "1.0.0";
+
 const std::string LLVMIR_DIR = "llvmir";
 const std::string DYLIB_DIR = "dylib";
 const std::string STATICLIB_DIR = "staticlib";
 const std::string OBJ_DIR = "objects";
+const std::string ASM_DIR = "asm";
 
 enum class CodeGenLLVM_OutputKind
 {
@@ -18,13 +23,28 @@ enum class CodeGenLLVM_OutputKind
     LLVMIR,
 };
 
+enum class CodeGenLLVM_OptimizationLevel
+{
+    O0,
+    O1,
+    O2,
+    O3,
+    Os,
+};
+
 class CodeGenLLVM_Options
 {
 private:
     std::optional<std::string> outputPath_;
     std::optional<std::string> buildDirectory_;
     std::optional<std::string> inputFile_;
+    std::optional<std::string> projectDirectory_;
+    std::optional<std::size_t> jobs_;
     CodeGenLLVM_OutputKind outputKind_;
+    CodeGenLLVM_OptimizationLevel optimizationLevel_ = CodeGenLLVM_OptimizationLevel::O0;
+    std::optional<std::string> passPipeline_;
+    std::size_t errorLimit_ = 20;
+    bool emitLayout_ = false;
 
 public:
     std::optional<std::string> getOutputPath() const { return outputPath_; }
@@ -36,8 +56,29 @@ public:
     const std::optional<std::string> getInputFile() const { return inputFile_; }
     void setInputFile(const std::string &inputFile) { inputFile_ = inputFile; }
 
+    const std::optional<std::string> getProjectDirectory() const { return projectDirectory_; }
+    void setProjectDirectory(const std::string &projectDirectory) { projectDirectory_ = projectDirectory; }
+
+    std::optional<std::size_t> getJobs() const { return jobs_; }
+    void setJobs(std::size_t jobs) { jobs_ = jobs; }
+
     CodeGenLLVM_OutputKind getOutputKind() const { return outputKind_; }
     void setOutputKind(const CodeGenLLVM_OutputKind &outputKind) { outputKind_ = outputKind; }
+
+    CodeGenLLVM_OptimizationLevel getOptimizationLevel() const { return optimizationLevel_; }
+    void setOptimizationLevel(CodeGenLLVM_OptimizationLevel optimizationLevel) { optimizationLevel_ = optimizationLevel; }
+
+    // Textual new pass manager pipeline (e.g. `function(mem2reg,instcombine)`) that replaces the -O pipeline.
+    const std::optional<std::string> &getPassPipeline() const { return passPipeline_; }
+    void setPassPipeline(const std::string &passPipeline) { passPipeline_ = passPipeline; }
+
+    // Number of errors after which compilation stops, 0 for no limit.
+    std::size_t getErrorLimit() const { return errorLimit_; }
+    void setErrorLimit(std::size_t errorLimit) { errorLimit_ = errorLimit; }
+
+    // Print the size, alignment and padding of every struct of each compiled module.
+    bool getEmitLayout() const { return emitLayout_; }
+    void setEmitLayout(bool emitLayout) { emitLayout_ = emitLayout; }
 };
 
 #endif // CODEGEN_LLVM_OPTIONS_HPP
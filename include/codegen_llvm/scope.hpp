@@ -1,61 +1,151 @@
 #ifndef CODEGEN_LLVM_SCOPE_HPP
 #define CODEGEN_LLVM_SCOPE_HPP
 
-#include <map>
-#include <string>
+#include <cstdint>
+#include <vector>
 #include <optional>
 #include <memory>
 #include "values.hpp"
 #include "diag.hpp"
+#include "ast/symbol.hpp"
 
 class Scope;
 
 using ScopePtr = Scope *;
 using OptionalScopePtr = std::optional<Scope *>;
 
-#define SCOPE_REQUIRED(line)                                                          \
-    if (!scopeOpt)                                                                    \
-    {                                                                                 \
-        DISPLAY_DIAG(line, "(Error) Scope is required to compile this instruction."); \
-    }
+#define SCOPE_REQUIRED(line)                                                              \
+    do                                                                                    \
+    {                                                                                     \
+        if (!scopeOpt)                                                                    \
+        {                                                                                 \
+            DISPLAY_DIAG(line, "(Error) Scope is required to compile this instruction."); \
+        }                                                                                 \
+    } while (0)
 
 #define SCOPE scopeOpt.value()
 
+// Symbol table for the locals of a single function.
+//
+// All nested block levels share one flat record stack. An open-addressing
+// index maps each symbol to its innermost live record, and every record
+// remembers the record it shadows, so leaving a level just unwinds the
+// stack down to that level's marker and restores the shadowed bindings.
 class Scope
 {
 private:
-    std::optional<ScopePtr> parent_;
-    std::map<std::string, std::shared_ptr<CodeGenLLVM_EValue>> records_;
+    static constexpr std::uint32_t npos = UINT32_MAX;
+
+    struct Record
+    {
+        Symbol name;
+        std::uint32_t shadowed;
+        std::shared_ptr<CodeGenLLVM_EValue> value;
+    };
+
+    struct Slot
+    {
+        std::uint32_t symbolId;
+        std::uint32_t recordIndex;
+    };
+
+    std::vector<Record> records_;
+    std::vector<std::uint32_t> levels_;
+    std::vector<Slot> slots_;
+    std::size_t usedSlots_;
+
+    Slot *findSlot(std::uint32_t symbolId)
+    {
+        std::size_t mask = slots_.size() - 1;
+        for (std::size_t i = symbolId & mask;; i = (i + 1) & mask)
+        {
+            if (slots_[i].symbolId == symbolId || slots_[i].symbolId == npos)
+            {
+                return &slots_[i];
+            }
+        }
+    }
+
+    const Slot *findSlot(std::uint32_t symbolId) const
+    {
+        return const_cast<Scope *>(this)->findSlot(symbolId);
+    }
+
+    void grow()
+    {
+        std::vector<Slot> oldSlots(slots_.size() * 2, Slot{npos, npos});
+        oldSlots.swap(slots_);
+        for (const Slot &slot : oldSlots)
+        {
+            if (slot.symbolId != npos)
+            {
+                *findSlot(slot.symbolId) = slot;
+            }
+        }
+    }
 
 public:
-    Scope(std::optional<ScopePtr> parent = std::nullopt) : parent_(parent) {}
+    Scope() : slots_(64, Slot{npos, npos}), usedSlots_(0) { levels_.push_back(0); }
 
-    std::optional<std::shared_ptr<CodeGenLLVM_EValue>> getRecord(const std::string &name) const
+    // Enter a nested block. Records added until the matching popLevel may
+    // shadow records from enclosing levels.
+    void pushLevel()
     {
-        if (records_.count(name))
+        levels_.push_back(static_cast<std::uint32_t>(records_.size()));
+    }
+
+    void popLevel()
+    {
+        std::uint32_t marker = levels_.back();
+        levels_.pop_back();
+
+        while (records_.size() > marker)
         {
-            return records_.at(name);
+            Record &record = records_.back();
+            findSlot(record.name.getId())->recordIndex = record.shadowed;
+            records_.pop_back();
         }
-        if (parent_)
+    }
+
+    std::size_t getDepth() const { return levels_.size() - 1; }
+
+    CodeGenLLVM_EValue *getRecord(Symbol name) const
+    {
+        const Slot *slot = findSlot(name.getId());
+        if (slot->symbolId == npos || slot->recordIndex == npos)
         {
-            return parent_.value()->getRecord(name);
+            return nullptr;
         }
-        return std::nullopt;
+        return records_[slot->recordIndex].value.get();
     }
 
-    void setRecord(const std::string &name, std::shared_ptr<CodeGenLLVM_EValue> evalue)
+    bool isDeclaredInCurrentLevel(Symbol name) const
     {
-        records_[name] = evalue;
+        const Slot *slot = findSlot(name.getId());
+        return slot->symbolId != npos && slot->recordIndex != npos && slot->recordIndex >= levels_.back();
     }
 
-    ScopePtr clone() const
+    void setRecord(Symbol name, std::shared_ptr<CodeGenLLVM_EValue> evalue)
     {
-        ScopePtr clonedScope = new Scope(this->parent_);
-        for (const auto &[name, value] : records_)
+        Slot *slot = findSlot(name.getId());
+        if (slot->symbolId == npos)
         {
-            clonedScope->setRecord(name, value);
+            if ((usedSlots_ + 1) * 2 > slots_.size())
+            {
+                grow();
+                slot = findSlot(name.getId());
+            }
+            slot->symbolId = name.getId();
+            ++usedSlots_;
         }
-        return clonedScope;
+        else if (slot->recordIndex != npos && slot->recordIndex >= levels_.back())
+        {
+            records_[slot->recordIndex].value = std::move(evalue);
+            return;
+        }
+
+        records_.push_back(Record{name, slot->recordIndex, std::move(evalue)});
+        slot->recordIndex = static_cast<std::uint32_t>(records_.size() - 1);
     }
 };
 
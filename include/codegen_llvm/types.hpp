@@ -1,7 +1,9 @@
 #ifndef CODEGEN_LLVM_TYPES_HPP
 #define CODEGEN_LLVM_TYPES_HPP
 
+#include <array>
 #include <memory>
+#include <unordered_map>
 #include <variant>
 #include "llvm/IR/Type.h"
 #include "llvm/IR/IRBuilder.h"
@@ -32,6 +34,7 @@ public:
         Void,
         String,
         Struct,
+        Enum,
         Function,
         Reference,
         Pointer,
@@ -40,30 +43,21 @@ public:
 
 private:
     TypeKind typeKind_;
-    bool isConst_ = false;
+    bool isConst_;
 
     std::variant<llvm::Type *, std::shared_ptr<CodeGenLLVM_Type>> payload_;
 
 public:
-    CodeGenLLVM_Type(llvm::Type *llvmType, TypeKind kind)
-        : typeKind_(kind), payload_(llvmType) {}
+    // Types are immutable and should only be created by CodeGenLLVM_TypeTable,
+    // which hands out one canonical instance per distinct type.
+    CodeGenLLVM_Type(llvm::Type *llvmType, TypeKind kind, bool isConst = false)
+        : typeKind_(kind), isConst_(isConst), payload_(llvmType) {}
 
-    CodeGenLLVM_Type(std::shared_ptr<CodeGenLLVM_Type> nested, TypeKind kind)
-        : typeKind_(kind), payload_(std::move(nested)) {}
-
-    static std::shared_ptr<CodeGenLLVM_Type> createPointerType(std::shared_ptr<CodeGenLLVM_Type> pointee)
-    {
-        return std::make_shared<CodeGenLLVM_Type>(std::move(pointee), TypeKind::Pointer);
-    }
-
-    static std::shared_ptr<CodeGenLLVM_Type> createReferenceType(std::shared_ptr<CodeGenLLVM_Type> pointee)
-    {
-        return std::make_shared<CodeGenLLVM_Type>(std::move(pointee), TypeKind::Reference);
-    }
+    CodeGenLLVM_Type(std::shared_ptr<CodeGenLLVM_Type> nested, TypeKind kind, bool isConst = false)
+        : typeKind_(kind), isConst_(isConst), payload_(std::move(nested)) {}
 
     TypeKind getKind() const { return typeKind_; }
     bool isConst() const { return isConst_; }
-    void setConst() { isConst_ = true; }
 
     llvm::Type *getLLVMType() const
     {
@@ -73,9 +67,8 @@ public:
         }
         else if (typeKind_ == TypeKind::Pointer || typeKind_ == TypeKind::Reference)
         {
-            auto nested = std::get<std::shared_ptr<CodeGenLLVM_Type>>(payload_);
-            auto pointeeLLVM = nested->getLLVMType();
-            return llvm::PointerType::getUnqual(pointeeLLVM);
+            auto &nested = std::get<std::shared_ptr<CodeGenLLVM_Type>>(payload_);
+            return llvm::PointerType::getUnqual(nested->getLLVMType());
         }
         return nullptr;
     }
@@ -86,27 +79,52 @@ public:
             return std::get<std::shared_ptr<CodeGenLLVM_Type>>(payload_);
         return nullptr;
     }
+};
 
-    // Clone method
-    std::shared_ptr<CodeGenLLVM_Type> clone() const
+// Per-module owner of canonical types. Asking twice for the same type returns
+// the same instance, so two types are equal iff their pointers are equal.
+class CodeGenLLVM_TypeTable
+{
+private:
+    using TypeKind = CodeGenLLVM_Type::TypeKind;
+
+    struct DerivedKey
     {
-        if (std::holds_alternative<llvm::Type *>(payload_))
-        {
-            auto copy = std::make_shared<CodeGenLLVM_Type>(std::get<llvm::Type *>(payload_), typeKind_);
-            if (isConst_)
-                copy->setConst();
-            return copy;
-        }
-        else if (std::holds_alternative<std::shared_ptr<CodeGenLLVM_Type>>(payload_))
+        const CodeGenLLVM_Type *base;
+        TypeKind kind;
+
+        bool operator==(const DerivedKey &other) const { return base == other.base && kind == other.kind; }
+    };
+
+    struct DerivedKeyHash
+    {
+        std::size_t operator()(const DerivedKey &key) const noexcept
         {
-            auto nestedClone = std::get<std::shared_ptr<CodeGenLLVM_Type>>(payload_)->clone();
-            auto copy = std::make_shared<CodeGenLLVM_Type>(nestedClone, typeKind_);
-            if (isConst_)
-                copy->setConst();
-            return copy;
+            return std::hash<const void *>{}(key.base) ^ (static_cast<std::size_t>(key.kind) << 1);
         }
-        return nullptr;
-    }
+    };
+
+    std::array<std::shared_ptr<CodeGenLLVM_Type>, static_cast<std::size_t>(TypeKind::Error) + 1> primitives_;
+    std::unordered_map<DerivedKey, std::shared_ptr<CodeGenLLVM_Type>, DerivedKeyHash> derived_;
+    std::unordered_map<const CodeGenLLVM_Type *, std::shared_ptr<CodeGenLLVM_Type>> constVariants_;
+
+    const std::shared_ptr<CodeGenLLVM_Type> &getDerivedType(const std::shared_ptr<CodeGenLLVM_Type> &base, TypeKind kind);
+
+public:
+    explicit CodeGenLLVM_TypeTable(llvm::LLVMContext &context);
+
+    // Int, Float, Bool, String, Void, ... Returns nullptr for kinds that are
+    // built from other types (pointers, references, structs, functions).
+    const std::shared_ptr<CodeGenLLVM_Type> &getPrimitiveType(TypeKind kind) const { return primitives_[static_cast<std::size_t>(kind)]; }
+
+    const std::shared_ptr<CodeGenLLVM_Type> &getPointerType(const std::shared_ptr<CodeGenLLVM_Type> &pointee);
+    const std::shared_ptr<CodeGenLLVM_Type> &getReferenceType(const std::shared_ptr<CodeGenLLVM_Type> &pointee);
+    const std::shared_ptr<CodeGenLLVM_Type> &getConstType(const std::shared_ptr<CodeGenLLVM_Type> &type);
+
+    // Every struct is a distinct type, the caller keeps the only instance.
+    std::shared_ptr<CodeGenLLVM_Type> createStructType(llvm::StructType *structType) const { return std::make_shared<CodeGenLLVM_Type>(structType, TypeKind::Struct); }
+    // Every enum is a distinct type as well, even when it is lowered to a plain integer.
+    std::shared_ptr<CodeGenLLVM_Type> createEnumType(llvm::Type *enumType) const { return std::make_shared<CodeGenLLVM_Type>(enumType, TypeKind::Enum); }
 };
 
 #endif // CODEGEN_LLVM_TYPES_HPP
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "types.hpp"
 #include <llvm/IR/Value.h>
+#include <llvm/Support/Alignment.h>
 #include <memory>
 
 class CodeGenLLVM_Value
@@ -29,8 +30,8 @@ public:
         RValue
     };
 
-    CodeGenLLVM_EValue(std::shared_ptr<CodeGenLLVM_Value> value, ValueCategory category)
-        : value_(std::move(value)), category_(category) {}
+    CodeGenLLVM_EValue(std::shared_ptr<CodeGenLLVM_Value> value, ValueCategory category, llvm::MaybeAlign alignment = llvm::MaybeAlign())
+        : value_(std::move(value)), category_(category), alignment_(alignment) {}
     ~CodeGenLLVM_EValue() = default;
 
     bool isLValue() const { return category_ == ValueCategory::LValue; }
@@ -38,9 +39,15 @@ public:
 
     std::shared_ptr<CodeGenLLVM_Value> asValue() const { return value_; }
 
+    // Alignment of an lvalue's address when it is below the ABI alignment of
+    // its type, e.g. a field of a packed struct. Loads and stores through the
+    // address must use it.
+    llvm::MaybeAlign getAlignment() const { return alignment_; }
+
 private:
     std::shared_ptr<CodeGenLLVM_Value> value_;
     ValueCategory category_;
+    llvm::MaybeAlign alignment_;
 };
 
 #endif // CODEGEN_LLVM_VALUES_HPP
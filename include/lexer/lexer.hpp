@@ -5,14 +5,14 @@
 #include <string>
 #include "parser/cyrus.tab.hpp"
 
-extern FILE *yyin;
-extern int yylineno;
-extern char *yytext;
-extern char *yyerrormsg;
-extern char *yyfilename;
-extern int yylex(void);
-extern void set_lex_only_option(int);
-extern int yylex_destroy(void);
+extern int yylex_init_extra(ParserContext *userDefined, yyscan_t *scanner);
+extern int yylex_destroy(yyscan_t scanner);
+extern int yylex(YYSTYPE *lval, YYLTYPE *lloc, yyscan_t scanner);
+extern void yyset_in(FILE *input, yyscan_t scanner);
+extern struct yy_buffer_state *yy_scan_buffer(char *base, size_t size, yyscan_t scanner);
+extern int yyget_lineno(yyscan_t scanner);
+extern char *yyget_text(yyscan_t scanner);
+extern void yyrestore_hold_char(yyscan_t scanner);
 
 class Token
 {
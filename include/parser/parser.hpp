@@ -1,10 +1,83 @@
 #ifndef PARSER_HPP
 #define PARSER_HPP
 
+#include <cstdio>
+#include <memory>
+#include <string>
 #include "ast/ast.hpp"
+#include "util/source_buffer.hpp"
+#include "util/diagnostics.hpp"
+#include "parser/cyrus.tab.hpp"
 
-extern ASTNodePtr astProgram;
+// Owns the state of one reentrant lexer/parser run. Every file gets its own
+// context so several files can be parsed at the same time on different threads.
+class ParserContext
+{
+private:
+    std::string fileName_;
+    yyscan_t scanner_;
+    std::shared_ptr<util::SourceBuffer> source_;
+    ASTProgram *program_;
+    util::DiagnosticEngine *diagnostics_;
+    std::string errorMsg_;
+    int errorLineNumber_;
+    std::size_t errorCount_;
+    util::SourceRange tokenRange_;
+    bool lexOnly_;
 
-std::pair<std::shared_ptr<std::string>, ASTProgram *> parseProgram(const std::string &inputFile);
+public:
+    // Without a diagnostic engine only the first error is kept, see getErrorMessage().
+    ParserContext(const std::string &fileName, bool lexOnly = false, util::DiagnosticEngine *diagnostics = nullptr);
+    ~ParserContext();
+
+    ParserContext(const ParserContext &) = delete;
+    ParserContext &operator=(const ParserContext &) = delete;
+
+    const std::string &getFileName() const { return fileName_; }
+    bool isLexOnly() const { return lexOnly_; }
+
+    void setInput(FILE *input);
+    // Scan the buffer in place; the context keeps it alive while lexing.
+    void setInput(std::shared_ptr<util::SourceBuffer> source);
+    int parse();
+    int lex(YYSTYPE *lval);
+    const char *getTokenText() const;
+    int getLineNumber() const;
+    // Byte range of the current token in the input.
+    util::SourceRange getTokenRange() const { return tokenRange_; }
+    // Called by the lexer for every match; returns the range of the matched text.
+    util::SourceRange advanceToken(std::size_t length)
+    {
+        tokenRange_ = util::SourceRange{tokenRange_.end, tokenRange_.end + static_cast<std::uint32_t>(length)};
+        return tokenRange_;
+    }
+
+    ASTProgram *getProgram() const { return program_; }
+    void setProgram(ASTProgram *program);
+    ASTProgram *releaseProgram();
+
+    // Constructs a node covering `range` inside the arena of the program being parsed.
+    template <typename T, typename... Args>
+    T *make(const util::SourceRange &range, Args &&...args)
+    {
+        T *node = program_->getArena().make<T>(std::forward<Args>(args)...);
+        if constexpr (std::is_base_of_v<ASTNode, T>)
+        {
+            node->setRange(range);
+        }
+        return node;
+    }
+
+    bool hasError() const { return errorCount_ > 0; }
+    std::size_t getErrorCount() const { return errorCount_; }
+    const std::string &getErrorMessage() const { return errorMsg_; }
+    int getErrorLineNumber() const { return errorLineNumber_; }
+    // Record an error at the current token. Parsing continues wherever the grammar can recover.
+    void reportError(const std::string &msg);
+};
+
+// Every syntax error is reported to `diagnostics`; the program is null if there was any.
+std::pair<std::shared_ptr<util::SourceBuffer>, ASTProgram *> parseProgram(std::shared_ptr<util::SourceBuffer> source, util::DiagnosticEngine &diagnostics);
+std::pair<std::shared_ptr<util::SourceBuffer>, ASTProgram *> parseProgram(const std::string &inputFile, util::DiagnosticEngine &diagnostics);
 
 #endif // PARSER_HPP
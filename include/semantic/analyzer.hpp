@@ -0,0 +1,169 @@
+#ifndef SEMANTIC_ANALYZER_HPP
+#define SEMANTIC_ANALYZER_HPP
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ast/ast.hpp"
+#include "semantic/declaration.hpp"
+#include "semantic/types.hpp"
+#include "util/diagnostics.hpp"
+#include "util/source_buffer.hpp"
+
+namespace semantic
+{
+    // Declarations and types of one analyzed module.
+    // The AST is annotated with pointers into it, so it has to outlive every
+    // consumer of the tree, i.e. code generation.
+    class Module
+    {
+    private:
+        TypeTable types_;
+
+        std::mutex mutex_;
+        std::deque<Declaration> declarations_;
+        std::unordered_map<Symbol, Declaration *> globals_;
+
+    public:
+        TypeTable &getTypeTable() { return types_; }
+
+        // Thread-safe, declarations of locals are created while bodies are analyzed.
+        Declaration *createDeclaration(Declaration::Kind kind, Symbol name, const Type *type, const ASTNode *node);
+
+        // Returns the existing declaration if the name is already taken, otherwise nullptr.
+        Declaration *addGlobal(Declaration *declaration);
+        Declaration *lookupGlobal(Symbol name) const;
+    };
+
+    // Locals visible at a point of a function body.
+    class LocalScope
+    {
+    private:
+        std::vector<const Declaration *> declarations_;
+        std::vector<std::size_t> levels_;
+
+    public:
+        LocalScope() { levels_.push_back(0); }
+
+        void pushLevel() { levels_.push_back(declarations_.size()); }
+        void popLevel()
+        {
+            declarations_.resize(levels_.back());
+            levels_.pop_back();
+        }
+
+        const Declaration *lookup(Symbol name) const;
+        bool isDeclaredInCurrentLevel(Symbol name) const;
+        void declare(const Declaration *declaration) { declarations_.push_back(declaration); }
+    };
+
+    // State of the function body being analyzed. Bodies only share the module,
+    // so each can be analyzed on its own.
+    struct FunctionState
+    {
+        const Declaration *function;
+        const Type *returnType;
+        LocalScope scope;
+        std::size_t loopDepth = 0;
+        std::size_t switchDepth = 0;
+    };
+
+    class Analyzer
+    {
+    private:
+        enum class ResolveState
+        {
+            Unresolved,
+            Resolving,
+            Resolved,
+        };
+
+        Module &module_;
+        TypeTable &types_;
+        std::shared_ptr<util::SourceBuffer> source_;
+        util::DiagnosticEngine &diagnostics_;
+        std::atomic<std::size_t> errorCount_;
+
+        // Module level declarations in source order, and how far each got.
+        std::vector<Declaration *> globals_;
+        std::unordered_map<const Declaration *, ResolveState> resolveStates_;
+
+        void error(const ASTNode *node, const std::string &message);
+
+        // Declarations
+        void declareGlobal(ASTNodePtr node);
+        Declaration *declare(Declaration::Kind kind, Symbol name, const ASTNode *node, const Type *type = nullptr);
+        void resolveDeclaration(Declaration *declaration);
+        void resolveTypeAlias(Declaration *declaration);
+        void resolveStruct(Declaration *declaration);
+        Type::Layout resolveStructLayout(const ASTStructDefinition *structDef);
+        std::optional<std::uint64_t> evaluateAttributeArgument(const ASTStructAttribute &attribute);
+        void resolveEnum(Declaration *declaration);
+        void checkStructCycles(Declaration *declaration);
+        static bool holdsReference(const Type *type);
+        void checkSoaColumns(Declaration *declaration);
+        static const ASTFunctionParameters &getFunctionParameters(const Declaration *function);
+        void resolveFunction(Declaration *declaration);
+        void resolveGlobalVariable(Declaration *declaration);
+        void analyzeFunctionBody(const Declaration *declaration);
+        const Declaration *lookup(FunctionState *fn, Symbol name);
+
+        // Types
+        const Type *resolveType(FunctionState *fn, const ASTTypeSpecifier *typeSpecifier);
+        const Type *resolveTypeName(FunctionState *fn, Symbol name, const ASTNode *node);
+        bool isAssignable(const Type *from, const Type *to) const;
+        bool checkAssignable(const ASTNode *node, const Type *from, const Type *to, const std::string &context);
+        bool checkLiteralFits(const ASTNode *node, const Type *to);
+        const Type *getIntegerLiteralType(const llvm::APInt &value);
+        static bool isEqualityComparable(const Type *type);
+        bool checkBindable(const ASTNode *node, const Type *from, const Type *reference, const std::string &context);
+
+        // Statements
+        void analyzeStmt(FunctionState &fn, ASTNodePtr node);
+        void analyzeStmts(FunctionState &fn, const ASTNodeList &nodes);
+        void analyzeVariableDeclaration(FunctionState &fn, ASTNodePtr node);
+        void analyzeReturnStatement(FunctionState &fn, ASTNodePtr node);
+        bool completesNormally(const ASTNode *node) const;
+        void analyzeIfStatement(FunctionState &fn, ASTNodePtr node);
+        void analyzeForStatement(FunctionState &fn, ASTNodePtr node);
+        void analyzeSwitchStatement(FunctionState &fn, ASTNodePtr node);
+        int analyzeVariantLabel(FunctionState &fn, ASTNodePtr label, const Type *enumType, std::vector<const Declaration *> &bindings);
+        void analyzeCondition(FunctionState &fn, ASTNodePtr node);
+
+        // Expressions
+        const Type *analyzeExpr(FunctionState *fn, ASTNodePtr node);
+        const Type *analyzeIdentifier(FunctionState *fn, ASTNodePtr node);
+        const Type *analyzeBinaryExpression(FunctionState *fn, ASTNodePtr node);
+        const Type *analyzeUnaryExpression(FunctionState *fn, ASTNodePtr node);
+        const Type *analyzeAssignment(FunctionState *fn, ASTNodePtr node);
+        const Type *analyzeConditionalExpression(FunctionState *fn, ASTNodePtr node);
+        const Type *analyzeCastExpression(FunctionState *fn, ASTNodePtr node);
+        const Type *analyzeFunctionCall(FunctionState *fn, ASTNodePtr node);
+        const Type *analyzeFieldAccess(FunctionState *fn, const ASTNode *node, const ASTFieldAccess *fieldAccess, bool throughPointer);
+        const Type *lookupEnumType(FunctionState *fn, ASTNodePtr node);
+        const Type *analyzeEnumVariant(FunctionState *fn, const ASTFieldAccess *fieldAccess, const std::vector<ASTNodePtr> *arguments);
+        const Type *analyzeStructInitialization(FunctionState *fn, ASTNodePtr node);
+        const Type *analyzeIndexAccess(FunctionState *fn, ASTNodePtr node, bool asRow);
+        bool isSoaRow(const ASTNode *node) const;
+        bool isLValue(const ASTNode *node) const;
+        bool isPackedField(const ASTNode *node) const;
+        bool checkModifiable(const ASTNode *node, const Type *type);
+
+    public:
+        Analyzer(Module &module, std::shared_ptr<util::SourceBuffer> source, util::DiagnosticEngine &diagnostics)
+            : module_(module), types_(module.getTypeTable()), source_(std::move(source)), diagnostics_(diagnostics), errorCount_(0) {}
+
+        void analyzeProgram(ASTProgram *program);
+        std::size_t getErrorCount() const { return errorCount_; }
+    };
+
+    // Resolve names and check types of `program`, annotating the tree in place.
+    // Errors go to `diagnostics`; returns false if the program has any.
+    bool analyzeProgram(ASTProgram *program, Module &module, std::shared_ptr<util::SourceBuffer> source, util::DiagnosticEngine &diagnostics);
+} // namespace semantic
+
+#endif // SEMANTIC_ANALYZER_HPP
@@ -0,0 +1,70 @@
+#ifndef SEMANTIC_CONSTANT_HPP
+#define SEMANTIC_CONSTANT_HPP
+
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+#include "llvm/ADT/APFloat.h"
+#include "llvm/ADT/APInt.h"
+#include "semantic/types.hpp"
+
+class ASTNode;
+
+namespace semantic
+{
+    // Value of an expression known at compile time. Integers and bools are kept
+    // at the exact width of their type, so folding wraps exactly like the
+    // generated code would, up to 128 bits.
+    class ConstantValue
+    {
+    private:
+        const Type *type_;
+        std::variant<llvm::APInt, llvm::APFloat> value_;
+
+    public:
+        ConstantValue(const Type *type, llvm::APInt value) : type_(type->getUnqualified()), value_(std::move(value)) {}
+        ConstantValue(const Type *type, llvm::APFloat value) : type_(type->getUnqualified()), value_(std::move(value)) {}
+
+        const Type *getType() const { return type_; }
+
+        // Integers, chars, bytes and bools.
+        bool isInteger() const { return std::holds_alternative<llvm::APInt>(value_); }
+        const llvm::APInt &getInteger() const { return std::get<llvm::APInt>(value_); }
+        const llvm::APFloat &getFloat() const { return std::get<llvm::APFloat>(value_); }
+
+        bool isTrue() const { return isInteger() ? !getInteger().isZero() : !getFloat().isZero(); }
+    };
+
+    const llvm::fltSemantics &getFloatSemantics(const Type *type);
+
+    // Folds analyzed expressions: literals, const globals with a constant
+    // initializer, and unary, binary, cast and conditional expressions over
+    // them. Operands are converted the same way the analyzer typed them.
+    class ConstantEvaluator
+    {
+    private:
+        std::vector<const ASTNode *> evaluating_;
+        const ASTNode *errorNode_ = nullptr;
+        std::string error_;
+
+        std::nullopt_t fail(const ASTNode *node, const std::string &message);
+
+        std::optional<ConstantValue> evaluateExpr(const ASTNode *node);
+        std::optional<ConstantValue> evaluateIdentifier(const ASTNode *node);
+        std::optional<ConstantValue> evaluateUnary(const ASTNode *node);
+        std::optional<ConstantValue> evaluateBinary(const ASTNode *node);
+        std::optional<ConstantValue> evaluateConditional(const ASTNode *node);
+        std::optional<ConstantValue> convert(const ASTNode *node, const ConstantValue &value, const Type *type);
+
+    public:
+        // Evaluate `node` and convert the result to `type`. Returns nullopt when
+        // the expression is not constant, getErrorNode() and getError() tell why.
+        std::optional<ConstantValue> evaluate(const ASTNode *node, const Type *type);
+
+        const ASTNode *getErrorNode() const { return errorNode_; }
+        const std::string &getError() const { return error_; }
+    };
+} // namespace semantic
+
+#endif // SEMANTIC_CONSTANT_HPP
@@ -0,0 +1,41 @@
+#ifndef SEMANTIC_DECLARATION_HPP
+#define SEMANTIC_DECLARATION_HPP
+
+#include <string>
+#include "ast/symbol.hpp"
+#include "semantic/types.hpp"
+
+class ASTNode;
+
+namespace semantic
+{
+    // A name introduced by the program. Identifiers are annotated with the
+    // declaration they resolve to.
+    struct Declaration
+    {
+        enum class Kind
+        {
+            GlobalVariable,
+            LocalVariable,
+            Parameter,
+            Function,
+            TypeAlias,
+            Struct,
+            Enum,
+        };
+
+        Kind kind;
+        Symbol name;
+        // Declared type of a variable or function, or the type a type declaration names.
+        // Null until module level declarations are resolved.
+        const Type *type;
+        const ASTNode *node;
+
+        bool isType() const { return kind == Kind::TypeAlias || kind == Kind::Struct || kind == Kind::Enum; }
+        bool isVariable() const { return kind == Kind::GlobalVariable || kind == Kind::LocalVariable || kind == Kind::Parameter; }
+    };
+
+    const std::string formatDeclarationKind(Declaration::Kind kind);
+} // namespace semantic
+
+#endif // SEMANTIC_DECLARATION_HPP
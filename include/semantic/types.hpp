@@ -0,0 +1,189 @@
+#ifndef SEMANTIC_TYPES_HPP
+#define SEMANTIC_TYPES_HPP
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "ast/symbol.hpp"
+
+class ASTNode;
+
+namespace semantic
+{
+    // Type of a declaration or expression as resolved by the semantic stage.
+    // Types are created and interned by a TypeTable, so two types are equal iff
+    // their pointers are equal.
+    class Type
+    {
+    public:
+        enum class Kind
+        {
+            Int8,
+            Int16,
+            Int32,
+            Int64,
+            Int128,
+            UInt8,
+            UInt16,
+            UInt32,
+            UInt64,
+            UInt128,
+            Int,
+            UInt,
+            Float32,
+            Float64,
+            Float128,
+            Char,
+            Byte,
+            Bool,
+            Void,
+            String,
+            Error,
+            Pointer,
+            Reference,
+            Struct,
+            Enum,
+            Function,
+            // Type of an expression that failed to check. It is compatible with
+            // everything so one mistake is reported once.
+            Invalid,
+        };
+
+        struct Field
+        {
+            Symbol name;
+            const Type *type;
+        };
+
+        // Enumerators without a payload are variants with an empty payload.
+        struct Variant
+        {
+            Symbol name;
+            std::vector<const Type *> payload;
+            // Tag value: given with `= value`, or one more than the variant before.
+            std::int64_t discriminant = 0;
+        };
+
+        // Layout controls of a struct, from its attributes.
+        struct Layout
+        {
+            // No padding between fields, the struct is byte aligned.
+            bool packed = false;
+            // Fields may be stored in another order than declared to save padding.
+            bool reorder = false;
+            // Minimum alignment in bytes, 0 for the natural one.
+            std::uint64_t alignment = 0;
+            // Number of rows of a soa struct, 0 for a plain struct. A soa
+            // struct stores each field in a column of this many elements.
+            std::uint64_t soaCapacity = 0;
+        };
+
+    private:
+        Kind kind_;
+        bool isConst_;
+        const Type *unqualified_;
+
+        // Pointee, referee or return type.
+        const Type *element_;
+
+        // Structs and enums.
+        Symbol name_;
+        const ASTNode *declaration_;
+        std::vector<Field> fields_;
+        std::vector<Variant> variants_;
+        Layout layout_;
+
+        // Functions.
+        std::vector<const Type *> params_;
+        bool isVariadic_;
+
+        friend class TypeTable;
+
+    public:
+        explicit Type(Kind kind, const Type *element = nullptr)
+            : kind_(kind), isConst_(false), unqualified_(this), element_(element), name_(), declaration_(nullptr), isVariadic_(false) {}
+
+        Kind getKind() const { return kind_; }
+        bool is(Kind kind) const { return kind_ == kind; }
+        bool isConst() const { return isConst_; }
+        const Type *getUnqualified() const { return unqualified_; }
+
+        const Type *getElementType() const { return element_; }
+        const Type *getReturnType() const { return element_; }
+        const std::vector<const Type *> &getParamTypes() const { return unqualified_->params_; }
+        bool isVariadic() const { return unqualified_->isVariadic_; }
+
+        Symbol getName() const { return name_; }
+        const ASTNode *getDeclaration() const { return declaration_; }
+
+        // Bodies of structs and enums are filled in after every type name of the
+        // module is known, so they can refer to each other.
+        const std::vector<Field> &getFields() const { return unqualified_->fields_; }
+        void setFields(std::vector<Field> fields) { fields_ = std::move(fields); }
+        const std::vector<Variant> &getVariants() const { return unqualified_->variants_; }
+        void setVariants(std::vector<Variant> variants) { variants_ = std::move(variants); }
+        const Layout &getLayout() const { return unqualified_->layout_; }
+        void setLayout(Layout layout) { layout_ = layout; }
+
+        // Index into getFields() / getVariants(), or -1.
+        int findField(Symbol name) const;
+        int findVariant(Symbol name) const;
+
+        bool isInteger() const;
+        bool isSigned() const;
+        bool isFloat() const;
+        bool isArithmetic() const { return isInteger() || isFloat(); }
+        // Values that can be tested for truth.
+        bool isScalar() const { return isArithmetic() || kind_ == Kind::Bool || kind_ == Kind::Pointer; }
+        bool isInvalid() const { return kind_ == Kind::Invalid; }
+
+        // Width of integer and floating point types in bits.
+        unsigned getBitWidth() const;
+
+        std::string toString() const;
+    };
+
+    // Owner of the types of a module. Interning is thread-safe, so function
+    // bodies can be analyzed concurrently against the same table.
+    class TypeTable
+    {
+    private:
+        std::mutex mutex_;
+        std::deque<Type> types_;
+        std::array<const Type *, static_cast<std::size_t>(Type::Kind::Invalid) + 1> primitives_;
+        std::map<std::pair<const Type *, Type::Kind>, const Type *> derived_;
+        std::map<const Type *, const Type *> constVariants_;
+        std::map<std::tuple<const Type *, std::vector<const Type *>, bool>, const Type *> functions_;
+
+    public:
+        TypeTable();
+
+        TypeTable(const TypeTable &) = delete;
+        TypeTable &operator=(const TypeTable &) = delete;
+
+        // Kinds without a payload only: integers, floats, char, byte, bool, void, string, error and invalid.
+        const Type *getPrimitiveType(Type::Kind kind) const { return primitives_[static_cast<std::size_t>(kind)]; }
+        const Type *getInvalidType() const { return getPrimitiveType(Type::Kind::Invalid); }
+
+        const Type *getPointerType(const Type *pointee);
+        const Type *getReferenceType(const Type *referee);
+        const Type *getConstType(const Type *type);
+        const Type *getFunctionType(const Type *returnType, const std::vector<const Type *> &params, bool isVariadic);
+
+        // Every struct and enum definition is a distinct type.
+        Type *createStructType(Symbol name, const ASTNode *declaration);
+        Type *createEnumType(Symbol name, const ASTNode *declaration);
+    };
+
+    // Type both operands of an arithmetic operation are converted to. The wider
+    // operand wins; floats win over integers, and unsigned wins over signed of
+    // the same width.
+    const Type *getCommonArithmeticType(const Type *lhs, const Type *rhs);
+} // namespace semantic
+
+#endif // SEMANTIC_TYPES_HPP
@@ -0,0 +1,78 @@
+#ifndef UTIL_DIAGNOSTICS_HPP
+#define UTIL_DIAGNOSTICS_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "util/source_buffer.hpp"
+#include "util/source_range.hpp"
+
+namespace util
+{
+    enum class DiagnosticSeverity
+    {
+        Warning,
+        Error,
+    };
+
+    struct Diagnostic
+    {
+        DiagnosticSeverity severity;
+        std::shared_ptr<SourceBuffer> source;
+        int lineNumber;
+        SourceRange range;
+        std::string message;
+    };
+
+    // Collects the diagnostics of a whole compiler invocation so every problem is reported in one run.
+    // Reporting is thread-safe; diagnostics are printed grouped by file and in source order on flush().
+    class DiagnosticEngine
+    {
+    public:
+        static constexpr std::size_t DEFAULT_ERROR_LIMIT = 20;
+
+    private:
+        std::mutex mutex_;
+        std::vector<Diagnostic> diagnostics_;
+        std::size_t errorCount_;
+        std::size_t warningCount_;
+        std::size_t errorLimit_;
+
+        void flushLocked();
+
+    public:
+        // An error limit of 0 disables the limit.
+        explicit DiagnosticEngine(std::size_t errorLimit = DEFAULT_ERROR_LIMIT)
+            : errorCount_(0), warningCount_(0), errorLimit_(errorLimit) {}
+
+        DiagnosticEngine(const DiagnosticEngine &) = delete;
+        DiagnosticEngine &operator=(const DiagnosticEngine &) = delete;
+
+        // Reaching the error limit prints everything collected so far and exits.
+        void report(DiagnosticSeverity severity, std::shared_ptr<SourceBuffer> source, int lineNumber, const std::string &message, SourceRange range = {});
+        void error(std::shared_ptr<SourceBuffer> source, int lineNumber, const std::string &message, SourceRange range = {});
+        // The line is looked up from where the range begins.
+        void error(std::shared_ptr<SourceBuffer> source, SourceRange range, const std::string &message);
+        void warning(std::shared_ptr<SourceBuffer> source, int lineNumber, const std::string &message, SourceRange range = {});
+
+        std::size_t getErrorCount();
+        std::size_t getWarningCount();
+        bool hasErrors() { return getErrorCount() > 0; }
+        std::size_t getErrorLimit() const { return errorLimit_; }
+        // The diagnostics not flushed yet, in the order flush() prints them.
+        std::vector<Diagnostic> getDiagnostics();
+
+        // Print and drop every collected diagnostic.
+        void flush();
+
+        // Flush and exit for an error that leaves nothing sensible to continue with.
+        [[noreturn]] void abort();
+
+        // Flush, then exit if any error was reported.
+        void exitOnErrors();
+    };
+} // namespace util
+
+#endif // UTIL_DIAGNOSTICS_HPP
@@ -0,0 +1,35 @@
+#ifndef UTIL_LINE_TABLE_HPP
+#define UTIL_LINE_TABLE_HPP
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace util
+{
+    // Byte offset of the first character of every line in a text, so that a
+    // line can be sliced out in O(1) and an offset mapped back to its line
+    // in O(log n) without splitting the whole text.
+    class LineTable
+    {
+    private:
+        std::string_view text_;
+        std::vector<std::size_t> lineOffsets_;
+
+    public:
+        explicit LineTable(std::string_view text);
+
+        std::size_t getLineCount() const { return lineOffsets_.size(); }
+
+        // Byte offset of the first character of a 1-based line.
+        std::size_t getLineOffset(std::size_t lineNumber) const { return lineOffsets_[lineNumber - 1]; }
+
+        // 1-based line without its line terminator. Out-of-range lines are empty.
+        std::string_view getLine(std::size_t lineNumber) const;
+
+        // 1-based line containing the byte at `offset`.
+        std::size_t getLineNumber(std::size_t offset) const;
+    };
+} // namespace util
+
+#endif // UTIL_LINE_TABLE_HPP
@@ -0,0 +1,61 @@
+#ifndef UTIL_SOURCE_BUFFER_HPP
+#define UTIL_SOURCE_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include "util/line_table.hpp"
+
+namespace util
+{
+    // Contents of one source file, loaded once and shared by the lexer,
+    // diagnostics and codegen.
+    //
+    // Regular files are mapped copy-on-write with at least two trailing NUL
+    // bytes, which is the layout Flex's yy_scan_buffer scans in place. The
+    // scanner briefly writes NULs into the buffer while it runs, so views
+    // returned by getText() are only meaningful once scanning is finished.
+    class SourceBuffer
+    {
+    private:
+        std::string fileName_;
+        std::uint32_t fileId_;
+        char *data_;
+        std::size_t size_;
+        std::size_t mappedSize_;
+        bool mapped_;
+
+        mutable std::once_flag lineTableOnce_;
+        mutable std::unique_ptr<LineTable> lineTable_;
+
+        SourceBuffer(std::string fileName, char *data, std::size_t size, std::size_t mappedSize, bool mapped);
+
+    public:
+        // Exits with an error message if the file cannot be read.
+        static std::shared_ptr<SourceBuffer> open(const std::string &fileName);
+        static std::shared_ptr<SourceBuffer> fromString(const std::string &fileName, std::string_view content);
+
+        ~SourceBuffer();
+
+        SourceBuffer(const SourceBuffer &) = delete;
+        SourceBuffer &operator=(const SourceBuffer &) = delete;
+
+        const std::string &getFileName() const { return fileName_; }
+        // Unique within the process, so a SourceRange plus this id locates any node.
+        std::uint32_t getFileId() const { return fileId_; }
+        std::string_view getText() const { return std::string_view(data_, size_); }
+        std::size_t getSize() const { return size_; }
+
+        // Built on first use, so it must not be requested while the buffer is being scanned.
+        const LineTable &getLineTable() const;
+
+        // Writable buffer for yy_scan_buffer, including the two terminating NULs.
+        char *getScanBuffer() { return data_; }
+        std::size_t getScanBufferSize() const { return size_ + 2; }
+    };
+} // namespace util
+
+#endif // UTIL_SOURCE_BUFFER_HPP
@@ -0,0 +1,22 @@
+#ifndef UTIL_SOURCE_RANGE_HPP
+#define UTIL_SOURCE_RANGE_HPP
+
+#include <cstdint>
+
+namespace util
+{
+    // Half-open byte range [begin, end) into a SourceBuffer. An empty range,
+    // e.g. of an empty grammar rule, marks the position between two bytes.
+    // A default-constructed range marks no position at all.
+    struct SourceRange
+    {
+        std::uint32_t begin = 0;
+        std::uint32_t end = 0;
+
+        bool isValid() const { return end > begin; }
+        bool hasPosition() const { return end >= begin && end != 0; }
+        std::uint32_t getLength() const { return end - begin; }
+    };
+} // namespace util
+
+#endif // UTIL_SOURCE_RANGE_HPP
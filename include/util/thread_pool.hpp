@@ -0,0 +1,62 @@
+#ifndef UTIL_THREAD_POOL_HPP
+#define UTIL_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util
+{
+    // Fixed-size pool where every worker owns a deque of tasks. A worker pops
+    // its own newest task first and steals the oldest task of another worker
+    // when its own deque runs dry, so uneven workloads still keep all cores busy.
+    class ThreadPool
+    {
+    public:
+        // Tasks receive the index of the worker running them, which callers
+        // use to pick per-worker state such as an LLVM context.
+        using Task = std::function<void(std::size_t workerIndex)>;
+
+    private:
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue>> queues_;
+        std::vector<std::thread> workers_;
+
+        std::mutex mutex_;
+        std::condition_variable wakeCondition_;
+        std::condition_variable doneCondition_;
+        std::size_t queuedTasks_;
+        std::size_t pendingTasks_;
+        std::size_t nextQueue_;
+        bool stopping_;
+
+        void workerLoop(std::size_t workerIndex);
+        bool popTask(std::size_t workerIndex, Task &task);
+
+    public:
+        explicit ThreadPool(std::size_t workerCount);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        std::size_t getWorkerCount() const { return workers_.size(); }
+
+        void submit(Task task);
+        void wait();
+
+        static std::size_t defaultWorkerCount();
+    };
+} // namespace util
+
+#endif // UTIL_THREAD_POOL_HPP
@@ -1,24 +1,33 @@
 #ifndef UTIL_HPP
 #define UTIL_HPP
 
+#include <iostream>
 #include <string>
+#include <string_view>
 #include <cstdio>
 #include <vector>
+#include "util/source_range.hpp"
 
 namespace util
 {
+    class LineTable;
+
     bool hasFileExtension(const std::string &filename, const std::string &expectedExtension);
     void checkInputFileExtension(const std::string &filename);
-    std::vector<std::string> split(const std::string &str, char delimiter);
+    std::vector<std::string_view> split(std::string_view str, char delimiter);
     void printColoredText(const std::string &text,
                           const std::string &foregroundColor,
-                          const std::string &backgroundColor);
-    std::string readFileContent(const std::string &inputFile);
+                          const std::string &backgroundColor,
+                          std::ostream &stream = std::cout);
     std::string getFileNameWithStem(const std::string &filePath);
     bool isDirectory(const std::string &path);
     void ensureDirectoryExists(const std::string &path);
+    std::vector<std::string> collectSourceFiles(const std::string &directory);
+    std::string getModuleNameFromPath(const std::string &rootDirectory, const std::string &filePath);
     void isValidModuleName(const std::string &moduleName, const std::string &fileName);
-    void displayErrorPanel(const std::string &fileName, const std::string &fileContent, const int errorLineNumber, const std::string &errorMsg);
+    void displayErrorPanel(const std::string &fileName, std::string_view fileContent, const int errorLineNumber, const std::string &errorMsg);
+    void displayErrorPanel(const std::string &fileName, const LineTable &lines, const int errorLineNumber, const std::string &errorMsg);
+    void displayDiagnosticPanel(const std::string &fileName, const LineTable &lines, const int lineNumber, SourceRange range, const std::string &severity, const std::string &msg);
 } // namespace util
 
 #endif // UTIL_HPP
\ No newline at end of file
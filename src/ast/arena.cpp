@@ -0,0 +1,42 @@
+#include <cstdlib>
+#include <iostream>
+#include "ast/arena.hpp"
+
+ASTArena::~ASTArena()
+{
+    // destroy in reverse construction order, then drop the chunks wholesale.
+    for (Destructor *destructor = destructors_; destructor; destructor = destructor->next)
+    {
+        destructor->destroy(destructor->object);
+    }
+
+    Chunk *chunk = chunks_;
+    while (chunk)
+    {
+        Chunk *next = chunk->next;
+        std::free(chunk);
+        chunk = next;
+    }
+}
+
+void *ASTArena::allocateSlow(std::size_t size, std::size_t alignment)
+{
+    std::size_t payloadSize = size + alignment > defaultChunkSize ? size + alignment : defaultChunkSize;
+    std::size_t chunkSize = sizeof(Chunk) + payloadSize;
+
+    Chunk *chunk = static_cast<Chunk *>(std::malloc(chunkSize));
+    if (!chunk)
+    {
+        std::cerr << "(Error) Failed to allocate memory for syntax tree." << std::endl;
+        std::exit(1);
+    }
+
+    chunk->next = chunks_;
+    chunk->size = chunkSize;
+    chunks_ = chunk;
+
+    cursor_ = reinterpret_cast<char *>(chunk + 1);
+    end_ = reinterpret_cast<char *>(chunk) + chunkSize;
+
+    return allocate(size, alignment);
+}
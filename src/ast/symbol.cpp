@@ -0,0 +1,123 @@
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include "ast/symbol.hpp"
+
+// Strings are stored in fixed-size blocks that never move once allocated,
+// so `Symbol::str()` can read them without taking a lock. Lookups by text
+// are split across shards to keep parser threads from contending.
+class SymbolTable
+{
+private:
+    static constexpr std::size_t blockBits = 12;
+    static constexpr std::size_t blockSize = std::size_t(1) << blockBits;
+    static constexpr std::size_t maxBlocks = std::size_t(1) << 16;
+    static constexpr std::size_t shardCount = 16;
+
+    struct Shard
+    {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string_view, std::uint32_t> ids;
+    };
+
+    std::array<std::atomic<std::string *>, maxBlocks> blocks_;
+    std::array<Shard, shardCount> shards_;
+    std::atomic<std::uint32_t> nextId_;
+    std::mutex blockMutex_;
+
+    std::string &slot(std::uint32_t id)
+    {
+        std::size_t blockIndex = id >> blockBits;
+        std::string *block = blocks_[blockIndex].load(std::memory_order_acquire);
+        if (!block)
+        {
+            std::lock_guard<std::mutex> lock(blockMutex_);
+            block = blocks_[blockIndex].load(std::memory_order_relaxed);
+            if (!block)
+            {
+                block = new std::string[blockSize];
+                blocks_[blockIndex].store(block, std::memory_order_release);
+            }
+        }
+        return block[id & (blockSize - 1)];
+    }
+
+public:
+    SymbolTable() : nextId_(0)
+    {
+        for (auto &block : blocks_)
+        {
+            block.store(nullptr, std::memory_order_relaxed);
+        }
+
+        // id 0 is the empty string, which is what a value-initialized Symbol refers to.
+        intern("");
+    }
+
+    ~SymbolTable()
+    {
+        for (auto &block : blocks_)
+        {
+            delete[] block.load(std::memory_order_relaxed);
+        }
+    }
+
+    static SymbolTable &instance()
+    {
+        static SymbolTable table;
+        return table;
+    }
+
+    std::uint32_t intern(std::string_view text)
+    {
+        Shard &shard = shards_[std::hash<std::string_view>{}(text) % shardCount];
+
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.ids.find(text);
+            if (it != shard.ids.end())
+            {
+                return it->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.ids.find(text);
+        if (it != shard.ids.end())
+        {
+            return it->second;
+        }
+
+        std::uint32_t id = nextId_.fetch_add(1, std::memory_order_relaxed);
+        if ((id >> blockBits) >= maxBlocks)
+        {
+            std::cerr << "(Error) Symbol table is full." << std::endl;
+            std::exit(1);
+        }
+
+        std::string &stored = slot(id);
+        stored.assign(text);
+        shard.ids.emplace(std::string_view(stored), id);
+        return id;
+    }
+
+    const std::string &lookup(std::uint32_t id)
+    {
+        return blocks_[id >> blockBits].load(std::memory_order_acquire)[id & (blockSize - 1)];
+    }
+};
+
+Symbol Symbol::intern(std::string_view text)
+{
+    return Symbol(SymbolTable::instance().intern(text));
+}
+
+const std::string &Symbol::str() const
+{
+    return SymbolTable::instance().lookup(id_);
+}
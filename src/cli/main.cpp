@@ -4,10 +4,14 @@
 #include <string>
 #include <vector>
 #include <cstdio>
+#include <cctype>
+#include <cstdlib>
+#include <limits>
 #include <map>
 #include "util/argh.h"
 #include "lexer/lexer.hpp"
 #include "util/util.hpp"
+#include "util/diagnostics.hpp"
 #include "parser/parser.hpp"
 #include "parser/cyrus.tab.hpp"
 #include "codegen_llvm/options.hpp"
@@ -15,6 +19,21 @@
 
 void compileCommandHelp();
 void llvmIRCommandHelp();
+void compileObjCommandHelp();
+void compileAsmCommandHelp();
+void runCommandHelp();
+
+static void setJobs(CodeGenLLVM_Options &opts, const std::string &value)
+{
+    char *end = nullptr;
+    long jobs = std::strtol(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || jobs <= 0 || jobs > std::numeric_limits<int>::max())
+    {
+        std::cerr << "(Error) Invalid number of jobs '" << value << "'." << std::endl;
+        exit(1);
+    }
+    opts.setJobs(static_cast<int>(jobs));
+}
 
 CodeGenLLVM_Options collectCompilerOptions(argh::parser &cmdl, CodeGenLLVM_OutputKind outputKind)
 {
@@ -39,10 +58,51 @@ CodeGenLLVM_Options collectCompilerOptions(argh::parser &cmdl, CodeGenLLVM_Outpu
             opts.setOutputPath(param.second);
         if (param.first == "build-dir")
             opts.setBuildDirectory(param.second);
+        if (param.first == "j" || param.first == "jobs")
+            setJobs(opts, param.second);
+        if (param.first == "passes")
+            opts.setPassPipeline(param.second);
+        if (param.first == "error-limit")
+        {
+            char *end = nullptr;
+            long errorLimit = std::strtol(param.second.c_str(), &end, 10);
+            if (param.second.empty() || *end != '\0' || errorLimit < 0)
+            {
+                std::cerr << "(Error) Invalid error limit '" << param.second << "'." << std::endl;
+                exit(1);
+            }
+            opts.setErrorLimit(errorLimit);
+        }
+    }
+
+    const std::map<std::string, CodeGenLLVM_OptimizationLevel> optimizationLevels = {
+        {"O0", CodeGenLLVM_OptimizationLevel::O0},
+        {"O1", CodeGenLLVM_OptimizationLevel::O1},
+        {"O2", CodeGenLLVM_OptimizationLevel::O2},
+        {"O3", CodeGenLLVM_OptimizationLevel::O3},
+        {"Os", CodeGenLLVM_OptimizationLevel::Os},
+    };
+    for (auto &flag : cmdl.flags())
+    {
+        auto it = optimizationLevels.find(flag);
+        if (it != optimizationLevels.end())
+            opts.setOptimizationLevel(it->second);
+        if (flag == "emit-layout")
+            opts.setEmitLayout(true);
+        // `-j4`, like make; `-j 4` and `-j=4` arrive as params.
+        if (flag.size() > 1 && flag[0] == 'j' && std::isdigit(static_cast<unsigned char>(flag[1])))
+            setJobs(opts, flag.substr(1));
     }
 
-    util::checkInputFileExtension(cmdl[2]);
-    opts.setInputFile(cmdl[2]);
+    if (util::isDirectory(cmdl[2]))
+    {
+        opts.setProjectDirectory(cmdl[2]);
+    }
+    else
+    {
+        util::checkInputFileExtension(cmdl[2]);
+        opts.setInputFile(cmdl[2]);
+    }
 
     opts.setOutputKind(outputKind);
 
@@ -121,52 +181,38 @@ void compileStaticlibCommand(argh::parser &cmdl)
 
 void compileObjCommand(argh::parser &cmdl)
 {
-    // std::string inputFile = cmdl[2];
-    // util::checkInputFileExtension(inputFile);
-
-    // ASTProgram *program = parseProgram(inputFile);
-
-    // std::string fileName = util::getFileNameWithStem(inputFile);
-    // util::isValidModuleName(fileName, inputFile);
-
-    // CodeGenCOptions opts = collectCodeGenCOptions(cmdl);
-
-    // std::string headModuleName = fileName;
-    // CodeGenCModule *headModule = new CodeGenCModule(opts, headModuleName);
-
-    // CodeGenCSourceFile *sourceFile = new CodeGenCSourceFile(program, headModuleName);
-    // headModule->addSourceFile(sourceFile);
+    if (cmdl[{"-h", "--help"}])
+    {
+        compileObjCommandHelp();
+        exit(1);
+    }
 
-    // CodeGenC *codegen_c = new CodeGenC(headModule, CodeGenC::OutputKind::ObjectFile, opts);
-    // codegen_c->generate();
-    // codegen_c->compile();
+    CodeGenLLVM_Options opts = collectCompilerOptions(cmdl, CodeGenLLVM_OutputKind::ObjectFile);
+    new_codegen_llvm(opts);
 }
 
 void compileAsmCommand(argh::parser &cmdl)
 {
-    // std::string inputFile = cmdl[2];
-    // util::checkInputFileExtension(inputFile);
-
-    // ASTProgram *program = parseProgram(inputFile);
-
-    // std::string fileName = util::getFileNameWithStem(inputFile);
-    // util::isValidModuleName(fileName, inputFile);
-
-    // CodeGenCOptions opts = collectCodeGenCOptions(cmdl);
-
-    // std::string headModuleName = fileName;
-    // CodeGenCModule *headModule = new CodeGenCModule(opts, headModuleName);
-
-    // CodeGenCSourceFile *sourceFile = new CodeGenCSourceFile(program, headModuleName);
-    // headModule->addSourceFile(sourceFile);
+    if (cmdl[{"-h", "--help"}])
+    {
+        compileAsmCommandHelp();
+        exit(1);
+    }
 
-    // CodeGenC *codegen_c = new CodeGenC(headModule, CodeGenC::OutputKind::Assembly, opts);
-    // codegen_c->generate();
-    // codegen_c->compile();
+    CodeGenLLVM_Options opts = collectCompilerOptions(cmdl, CodeGenLLVM_OutputKind::Assembly);
+    new_codegen_llvm(opts);
 }
 
 void runCommand(argh::parser &cmdl)
 {
+    if (cmdl[{"-h", "--help"}])
+    {
+        runCommandHelp();
+        exit(1);
+    }
+
+    CodeGenLLVM_Options opts = collectCompilerOptions(cmdl, CodeGenLLVM_OutputKind::Executable);
+    std::exit(run_codegen_llvm(opts));
 }
 
 void parseOnlyCommand(argh::parser &cmdl)
@@ -181,7 +227,9 @@ void parseOnlyCommand(argh::parser &cmdl)
     std::string inputFile = cmdl[2];
     util::checkInputFileExtension(inputFile);
 
-    auto [_, program] = parseProgram(inputFile);
+    util::DiagnosticEngine diagnostics;
+    auto [_, program] = parseProgram(inputFile, diagnostics);
+    diagnostics.exitOnErrors();
 
     if (program)
     {
@@ -208,26 +256,21 @@ void lexOnlyCommand(argh::parser &cmdl)
     std::string inputFile = cmdl[2];
     util::checkInputFileExtension(inputFile);
 
-    yyin = nullptr;
-    yyin = fopen(inputFile.c_str(), "r");
-    if (!yyin)
-    {
-        std::cerr << "(Error) Could not open file '" << inputFile << "'." << std::endl;
-        std::exit(1);
-    }
-
-    yyfilename = (char *)inputFile.c_str();
+    util::DiagnosticEngine diagnostics;
+    ParserContext ctx(inputFile, true, &diagnostics);
+    ctx.setInput(util::SourceBuffer::open(inputFile));
 
+    YYSTYPE lval;
     int token_kind;
-    while ((token_kind = yylex()))
+    while ((token_kind = ctx.lex(&lval)))
     {
         yytokentype tokenType = static_cast<yytokentype>(token_kind);
-        Token token(yytext, tokenType);
+        Token token(ctx.getTokenText(), tokenType);
 
         std::cout << "Token: " << token.visit() << std::endl;
     }
 
-    yylex_destroy();
+    diagnostics.exitOnErrors();
 }
 
 void helpCommand()
@@ -249,12 +292,15 @@ void helpCommand()
 
 void versionCommand()
 {
-    std::cout << "Cyrus v1.0.0" << std::endl;
+    std::cout << "Cyrus v" << CYRUS_VERSION << std::endl;
 }
 
 int main(int argc, char *argv[])
 {
-    argh::parser cmdl(argc, argv);
+    // registered, so `-j 4` takes the next argument as its value instead of leaving it positional.
+    argh::parser cmdl;
+    cmdl.add_params({"-j", "--jobs"});
+    cmdl.parse(argc, argv);
 
     if (argc > 1)
     {
@@ -297,24 +343,80 @@ int main(int argc, char *argv[])
 
 void compileCommandHelp()
 {
-    std::cout << "Usage: cyrus compile <input_file> [options]" << std::endl;
+    std::cout << "Usage: cyrus compile <input_file|project_dir> [options]" << std::endl;
     std::cout << std::endl;
-    std::cout << "Compile a Cyrus source file." << std::endl;
+    std::cout << "Compile a Cyrus source file, or every module of a project directory." << std::endl;
     std::cout << "Options:" << std::endl;
     std::cout << "  -o, --output=<dirpath>       Specify the output directory for the final executable." << std::endl;
     std::cout << "      --build-dir=<dirpath>    Specify the directory to store intermediate build files" << std::endl;
     std::cout << "                               such as object files and LLVM IR." << std::endl;
+    std::cout << "  -j, --jobs <n>               Number of modules compiled in parallel (defaults to the core count)." << std::endl;
+    std::cout << "  -O0, -O1, -O2, -O3, -Os      Optimization level (defaults to -O0)." << std::endl;
+    std::cout << "      --passes=<pipeline>      Run a custom pass pipeline instead of the -O pipeline." << std::endl;
+    std::cout << "      --error-limit=<n>        Stop after this many errors (defaults to 20, 0 for no limit)." << std::endl;
+    std::cout << "      --emit-layout            Print the size, alignment and padding of every struct." << std::endl;
     std::cout << "  -h, --help                   Display this help message." << std::endl;
 }
 
 void llvmIRCommandHelp()
 {
-    std::cout << "Usage: cyrus llvmir <input_file> [options]" << std::endl;
+    std::cout << "Usage: cyrus llvmir <input_file|project_dir> [options]" << std::endl;
     std::cout << std::endl;
     std::cout << "Compile Cyrus source files into llvm-ir." << std::endl;
     std::cout << "Options:" << std::endl;
     std::cout << "  -o, --output=<dirpath>       Specify the output directory for the llvm-ir files." << std::endl;
     std::cout << "      --build-dir=<dirpath>    Specify the directory to store intermediate build files" << std::endl;
     std::cout << "                               such as object files and LLVM IR." << std::endl;
+    std::cout << "  -j, --jobs <n>               Number of modules compiled in parallel (defaults to the core count)." << std::endl;
+    std::cout << "  -O0, -O1, -O2, -O3, -Os      Optimization level (defaults to -O0)." << std::endl;
+    std::cout << "      --passes=<pipeline>      Run a custom pass pipeline instead of the -O pipeline." << std::endl;
+    std::cout << "      --error-limit=<n>        Stop after this many errors (defaults to 20, 0 for no limit)." << std::endl;
+    std::cout << "      --emit-layout            Print the size, alignment and padding of every struct." << std::endl;
     std::cout << "  -h, --help                   Display this help message." << std::endl;
-}
\ No newline at end of file
+}
+
+void compileObjCommandHelp()
+{
+    std::cout << "Usage: cyrus compile-obj <input_file|project_dir> [options]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Compile Cyrus source files into native object files." << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  -o, --output=<dirpath>       Specify the output directory for the object files." << std::endl;
+    std::cout << "      --build-dir=<dirpath>    Specify the directory to store intermediate build files" << std::endl;
+    std::cout << "                               such as object files and LLVM IR." << std::endl;
+    std::cout << "  -j, --jobs <n>               Number of modules compiled in parallel (defaults to the core count)." << std::endl;
+    std::cout << "  -O0, -O1, -O2, -O3, -Os      Optimization level (defaults to -O0)." << std::endl;
+    std::cout << "      --passes=<pipeline>      Run a custom pass pipeline instead of the -O pipeline." << std::endl;
+    std::cout << "      --error-limit=<n>        Stop after this many errors (defaults to 20, 0 for no limit)." << std::endl;
+    std::cout << "      --emit-layout            Print the size, alignment and padding of every struct." << std::endl;
+    std::cout << "  -h, --help                   Display this help message." << std::endl;
+}
+
+void compileAsmCommandHelp()
+{
+    std::cout << "Usage: cyrus compile-asm <input_file|project_dir> [options]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Compile Cyrus source files into native assembly." << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  -o, --output=<dirpath>       Specify the output directory for the assembly files." << std::endl;
+    std::cout << "      --build-dir=<dirpath>    Specify the directory to store intermediate build files" << std::endl;
+    std::cout << "                               such as object files and LLVM IR." << std::endl;
+    std::cout << "  -j, --jobs <n>               Number of modules compiled in parallel (defaults to the core count)." << std::endl;
+    std::cout << "  -O0, -O1, -O2, -O3, -Os      Optimization level (defaults to -O0)." << std::endl;
+    std::cout << "      --passes=<pipeline>      Run a custom pass pipeline instead of the -O pipeline." << std::endl;
+    std::cout << "      --error-limit=<n>        Stop after this many errors (defaults to 20, 0 for no limit)." << std::endl;
+    std::cout << "      --emit-layout            Print the size, alignment and padding of every struct." << std::endl;
+    std::cout << "  -h, --help                   Display this help message." << std::endl;
+}
+
+void runCommandHelp()
+{
+    std::cout << "Usage: cyrus run <input_file> [options]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Compile a Cyrus source file in memory and execute its main function." << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  -O0, -O1, -O2, -O3, -Os      Optimization level (defaults to -O0)." << std::endl;
+    std::cout << "      --passes=<pipeline>      Run a custom pass pipeline instead of the -O pipeline." << std::endl;
+    std::cout << "      --error-limit=<n>        Stop after this many errors (defaults to 20, 0 for no limit)." << std::endl;
+    std::cout << "  -h, --help                   Display this help message." << std::endl;
+}
@@ -0,0 +1,178 @@
+#include <iostream>
+#include "util/util.hpp"
+#include "codegen_llvm/cache.hpp"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/BLAKE3.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/ADT/StringExtras.h"
+
+CodeGenLLVM_Cache::CodeGenLLVM_Cache(const std::string &buildDirectory)
+    : cacheDirectory_(buildDirectory + "/" + CACHE_DIR)
+{
+    util::ensureDirectoryExists(cacheDirectory_);
+}
+
+// the executable identifies the build of the compiler: every rebuild relinks it,
+// while an unchanged binary keeps its entries across reconfigures.
+static const std::string &getExecutableStamp()
+{
+    static const std::string stamp = []
+    {
+        static int anchor;
+        std::string path = llvm::sys::fs::getMainExecutable(nullptr, &anchor);
+        llvm::sys::fs::file_status status;
+        if (path.empty() || llvm::sys::fs::status(path, status))
+        {
+            return std::string();
+        }
+        return std::to_string(status.getSize()) + ":" + std::to_string(status.getLastModificationTime().time_since_epoch().count());
+    }();
+    return stamp;
+}
+
+// Each diagnostic is a header line "<severity> <line> <begin> <end> <message length>" followed by the message.
+static std::string serializeDiagnostics(const std::vector<util::Diagnostic> &moduleDiagnostics)
+{
+    std::string text;
+    llvm::raw_string_ostream out(text);
+    for (const util::Diagnostic &diagnostic : moduleDiagnostics)
+    {
+        out << static_cast<int>(diagnostic.severity) << ' ' << diagnostic.lineNumber << ' '
+            << diagnostic.range.begin << ' ' << diagnostic.range.end << ' ' << diagnostic.message.size() << '\n'
+            << diagnostic.message << '\n';
+    }
+    return out.str();
+}
+
+static bool parseDiagnostics(llvm::StringRef text, const std::shared_ptr<util::SourceBuffer> &source, std::vector<util::Diagnostic> &moduleDiagnostics)
+{
+    while (!text.empty())
+    {
+        auto [header, rest] = text.split('\n');
+        llvm::SmallVector<llvm::StringRef, 5> fields;
+        header.split(fields, ' ');
+
+        int severity, lineNumber;
+        util::SourceRange range;
+        std::size_t length;
+        if (fields.size() != 5 || fields[0].getAsInteger(10, severity) || fields[1].getAsInteger(10, lineNumber) ||
+            fields[2].getAsInteger(10, range.begin) || fields[3].getAsInteger(10, range.end) ||
+            fields[4].getAsInteger(10, length) || rest.size() <= length || rest[length] != '\n' ||
+            (severity != static_cast<int>(util::DiagnosticSeverity::Warning) && severity != static_cast<int>(util::DiagnosticSeverity::Error)))
+        {
+            return false;
+        }
+
+        moduleDiagnostics.push_back(util::Diagnostic{static_cast<util::DiagnosticSeverity>(severity), source, lineNumber, range, rest.take_front(length).str()});
+        text = rest.drop_front(length + 1);
+    }
+    return true;
+}
+
+// Let `write` fill a temporary file next to `path`, then rename it into place.
+static bool publishFile(const std::string &path, llvm::function_ref<bool(llvm::StringRef tempPath)> write)
+{
+    int fd;
+    llvm::SmallString<128> tempPath;
+    if (llvm::sys::fs::createUniqueFile(path + "-%%%%%%%%.tmp", fd, tempPath))
+    {
+        return false;
+    }
+    llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+
+    if (!write(tempPath) || llvm::sys::fs::rename(tempPath, path))
+    {
+        llvm::sys::fs::remove(tempPath);
+        return false;
+    }
+    return true;
+}
+
+std::string CodeGenLLVM_Cache::computeKey(std::string_view sourceContent,
+                                          const std::string &moduleName,
+                                          const std::string &triple,
+                                          const CodeGenLLVM_Options &opts)
+{
+    llvm::BLAKE3 hasher;
+
+    // every field is terminated so that adjacent fields cannot be confused with each other.
+    auto addField = [&hasher](llvm::StringRef field)
+    {
+        hasher.update(field);
+        hasher.update(llvm::StringRef("\0", 1));
+    };
+
+    addField(CYRUS_VERSION);
+    addField(getExecutableStamp());
+    addField(LLVM_VERSION_STRING);
+    addField(triple);
+    addField(moduleName);
+    addField(std::to_string(static_cast<int>(opts.getOutputKind())));
+    addField(std::to_string(static_cast<int>(opts.getOptimizationLevel())));
+    addField(opts.getPassPipeline().value_or(""));
+    addField(sourceContent);
+
+    return llvm::toHex(hasher.final(), true);
+}
+
+bool CodeGenLLVM_Cache::restore(const std::string &key,
+                                const std::string &outputFilePath,
+                                const std::shared_ptr<util::SourceBuffer> &source,
+                                util::DiagnosticEngine &diagnostics) const
+{
+    std::string entryPath = getEntryPath(key);
+    if (!llvm::sys::fs::exists(entryPath))
+    {
+        return false;
+    }
+
+    // the diagnostics are published before the entry, so an entry without them is damaged.
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> diagnosticsFile = llvm::MemoryBuffer::getFile(getDiagnosticsPath(key));
+    std::vector<util::Diagnostic> moduleDiagnostics;
+    if (!diagnosticsFile || !parseDiagnostics((*diagnosticsFile)->getBuffer(), source, moduleDiagnostics))
+    {
+        return false;
+    }
+
+    if (llvm::sys::fs::copy_file(entryPath, outputFilePath))
+    {
+        return false;
+    }
+
+    for (util::Diagnostic &diagnostic : moduleDiagnostics)
+    {
+        diagnostics.report(diagnostic.severity, diagnostic.source, diagnostic.lineNumber, diagnostic.message, diagnostic.range);
+    }
+    return true;
+}
+
+void CodeGenLLVM_Cache::store(const std::string &key,
+                              const std::string &outputFilePath,
+                              const std::vector<util::Diagnostic> &moduleDiagnostics) const
+{
+    // a cache that cannot be written only costs speed, never correctness.
+    std::string serialized = serializeDiagnostics(moduleDiagnostics);
+    bool published = publishFile(getDiagnosticsPath(key), [&serialized](llvm::StringRef tempPath)
+                                 {
+                                     std::error_code error;
+                                     llvm::raw_fd_ostream out(tempPath, error);
+                                     if (error)
+                                     {
+                                         return false;
+                                     }
+                                     out << serialized;
+                                     out.close();
+                                     bool failed = out.has_error();
+                                     out.clear_error();
+                                     return !failed; });
+    if (!published)
+    {
+        return;
+    }
+
+    publishFile(getEntryPath(key), [&outputFilePath](llvm::StringRef tempPath)
+                { return !llvm::sys::fs::copy_file(outputFilePath, tempPath); });
+}
@@ -1,62 +1,244 @@
 #include <memory>
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include "util/util.hpp"
 #include "parser/parser.hpp"
+#include "semantic/analyzer.hpp"
+#include "util/thread_pool.hpp"
+#include "util/diagnostics.hpp"
 #include "codegen_llvm/compiler.hpp"
+#include "codegen_llvm/cache.hpp"
 #include <llvm/Support/FileSystem.h>
+#include <llvm/ADT/SmallVector.h>
 
-void new_codegen_llvm(CodeGenLLVM_Options opts)
+static const std::string &getOutputKindDirectory(CodeGenLLVM_OutputKind outputKind)
 {
-    CodeGenLLVM_Context context;
+    switch (outputKind)
+    {
+    case CodeGenLLVM_OutputKind::ObjectFile:
+        return OBJ_DIR;
+    case CodeGenLLVM_OutputKind::Assembly:
+        return ASM_DIR;
+    default:
+        return LLVMIR_DIR;
+    }
+}
 
-    if (opts.getInputFile().has_value())
+static const char *getOutputKindDescription(CodeGenLLVM_OutputKind outputKind)
+{
+    switch (outputKind)
     {
-        // compiler triggered to compile single files
-        std::string filePath = opts.getInputFile().value();
-        auto [fileContent, program] = parseProgram(filePath);
+    case CodeGenLLVM_OutputKind::ObjectFile:
+        return "Object files";
+    case CodeGenLLVM_OutputKind::Assembly:
+        return "Assembly files";
+    default:
+        return "LLVM IR files";
+    }
+}
 
-        std::string moduleName = util::getFileNameWithStem(filePath);
-        util::isValidModuleName(moduleName, filePath);
-        CodeGenLLVM_Module *module = context.createModule(moduleName, filePath, fileContent);
+static std::string resolveOutputPath(const CodeGenLLVM_Options &opts)
+{
+    if (opts.getOutputPath().has_value())
+    {
+        return opts.getOutputPath().value();
+    }
+    else if (opts.getBuildDirectory().has_value())
+    {
+        return opts.getBuildDirectory().value() + "/" + getOutputKindDirectory(opts.getOutputKind());
+    }
 
-        module->buildProgramIR(program);
+    std::cerr << "(Error) Output path is not specified." << std::endl;
+    std::cerr << "        Build directory is not specified too. Consider to specify one these options to continue compilation." << std::endl;
+    exit(1);
+}
 
-        std::string outputPath;
-        if (opts.getOutputPath().has_value())
-        {
-            outputPath = opts.getOutputPath().value();
-        }
-        else if (opts.getBuildDirectory().has_value())
-        {
-            outputPath = opts.getBuildDirectory().value() + "/" + LLVMIR_DIR;
-        }
-        else
-        {
-            std::cerr << "(Error) Output path is not specified." << std::endl;
-            std::cerr << "        Build directory is not specified too. Consider to specify one these options to continue compilation." << std::endl;
-            exit(1);
-        }
+static void checkOutputKind(const CodeGenLLVM_Options &opts)
+{
+    switch (opts.getOutputKind())
+    {
+    case CodeGenLLVM_OutputKind::LLVMIR:
+    case CodeGenLLVM_OutputKind::ObjectFile:
+    case CodeGenLLVM_OutputKind::Assembly:
+        break;
+    default:
+        std::cerr << "(Error) Unsupported output kind." << std::endl;
+        exit(1);
+    }
+}
 
-        switch (opts.getOutputKind())
-        {
-        case CodeGenLLVM_OutputKind::LLVMIR:
+// Modules are compiled in parallel, the report of each one is printed in one piece.
+static void printLayoutReport(const std::string &moduleName, const std::string &report)
+{
+    static std::mutex outputMutex;
+    if (report.empty())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(outputMutex);
+    std::cout << "Module '" << moduleName << "':" << std::endl
+              << report << std::flush;
+}
+
+// Lower a single source file into `outputPath` and release its module afterwards.
+// Returns true when the output was restored from the cache instead.
+// A module with syntax or semantic errors is skipped; the errors are left in `diagnostics`.
+static bool compileModule(CodeGenLLVM_Context &context,
+                          const CodeGenLLVM_Options &opts,
+                          util::DiagnosticEngine &diagnostics,
+                          const std::optional<CodeGenLLVM_Cache> &cache,
+                          const std::string &moduleName,
+                          const std::string &filePath,
+                          const std::string &outputPath)
+{
+    std::string outputFilePath = CodeGenLLVM_Context::getModuleOutputFilePath(outputPath, moduleName, opts.getOutputKind());
+
+    std::shared_ptr<util::SourceBuffer> source = util::SourceBuffer::open(filePath);
+
+    // a restored module is never lowered, so there would be no layout to print.
+    std::string cacheKey;
+    if (cache.has_value() && !opts.getEmitLayout())
+    {
+        cacheKey = CodeGenLLVM_Cache::computeKey(source->getText(), moduleName, context.getTriple(), opts);
+        if (cache->restore(cacheKey, outputFilePath, source, diagnostics))
         {
-            context.saveIR(outputPath);
-            std::cout << "(Success) LLVM IR files are saved to " << outputPath << std::endl;
+            return true;
         }
-        break;
-        default:
+    }
+
+    auto [fileContent, program] = parseProgram(source, diagnostics);
+    if (!program)
+    {
+        return false;
+    }
+
+    // the types the program is annotated with are owned by the semantic module.
+    semantic::Module semanticModule;
+    if (!semantic::analyzeProgram(program, semanticModule, fileContent, diagnostics))
+    {
+        delete program;
+        return false;
+    }
+    CodeGenLLVM_Module *module = context.createModule(moduleName, filePath, fileContent, diagnostics);
+
+    module->buildProgramIR(program);
+    if (opts.getEmitLayout())
+    {
+        printLayoutReport(moduleName, module->getLayoutReport());
+    }
+    context.optimizeModule(module, opts);
+
+    // write and drop the module right away so memory stays bounded by the number of workers.
+    context.saveModule(moduleName, module, outputPath, opts.getOutputKind());
+    context.removeModule(moduleName);
+
+    // no key is computed when the layout is printed, and an entry under an empty key would be served to every module.
+    if (cache.has_value() && !cacheKey.empty())
+    {
+        // the engine is shared by every module, so keep only what this module reported.
+        std::vector<util::Diagnostic> moduleDiagnostics = diagnostics.getDiagnostics();
+        std::erase_if(moduleDiagnostics, [&source](const util::Diagnostic &diagnostic)
+                      { return diagnostic.source != source; });
+        cache->store(cacheKey, outputFilePath, moduleDiagnostics);
+    }
+    return false;
+}
+
+static std::optional<CodeGenLLVM_Cache> openCache(const CodeGenLLVM_Options &opts)
+{
+    if (opts.getBuildDirectory().has_value())
+    {
+        return CodeGenLLVM_Cache(opts.getBuildDirectory().value());
+    }
+    return std::nullopt;
+}
+
+static void compileProject(const CodeGenLLVM_Options &opts)
+{
+    const std::string projectDirectory = opts.getProjectDirectory().value();
+    const std::vector<std::string> sourceFiles = util::collectSourceFiles(projectDirectory);
+    if (sourceFiles.empty())
+    {
+        std::cerr << "(Error) No source files found in '" << projectDirectory << "'." << std::endl;
+        exit(1);
+    }
+
+    checkOutputKind(opts);
+    const std::string outputPath = resolveOutputPath(opts);
+    util::ensureDirectoryExists(outputPath);
+    const std::optional<CodeGenLLVM_Cache> cache = openCache(opts);
+
+    std::size_t jobs = opts.getJobs().value_or(util::ThreadPool::defaultWorkerCount());
+    jobs = std::max<std::size_t>(1, std::min(jobs, sourceFiles.size()));
+
+    // LLVMContext is not thread-safe, so every worker lowers its modules into a context of its own.
+    // Contexts are created up front because target initialization must not race.
+    std::vector<std::unique_ptr<CodeGenLLVM_Context>> contexts;
+    for (std::size_t i = 0; i < jobs; ++i)
+    {
+        contexts.push_back(std::make_unique<CodeGenLLVM_Context>(opts.getOptimizationLevel(), opts.getOutputKind()));
+    }
+
+    util::DiagnosticEngine diagnostics(opts.getErrorLimit());
+    std::atomic<std::size_t> cachedModules = 0;
+    {
+        util::ThreadPool pool(jobs);
+        for (const auto &filePath : sourceFiles)
         {
-            std::cerr << "(Error) Unsupported output kind." << std::endl;
-            exit(1);
-        }
-        break;
+            pool.submit([&contexts, &projectDirectory, &outputPath, &opts, &diagnostics, &cache, &cachedModules, filePath](std::size_t workerIndex)
+                        {
+                            std::string moduleName = util::getModuleNameFromPath(projectDirectory, filePath);
+                            util::isValidModuleName(moduleName, filePath);
+
+                            if (compileModule(*contexts[workerIndex], opts, diagnostics, cache, moduleName, filePath, outputPath))
+                            {
+                                cachedModules.fetch_add(1, std::memory_order_relaxed);
+                            } });
         }
+        pool.wait();
+    }
+    diagnostics.exitOnErrors();
+
+    std::cout << "(Success) " << getOutputKindDescription(opts.getOutputKind()) << " of " << sourceFiles.size() << " modules are saved to " << outputPath;
+    if (cachedModules > 0)
+    {
+        std::cout << " (" << cachedModules << " up to date)";
+    }
+    std::cout << std::endl;
+}
+
+void new_codegen_llvm(CodeGenLLVM_Options opts)
+{
+    if (opts.getInputFile().has_value())
+    {
+        // compiler triggered to compile single files
+        checkOutputKind(opts);
+        CodeGenLLVM_Context context(opts.getOptimizationLevel(), opts.getOutputKind());
+
+        std::string filePath = opts.getInputFile().value();
+        std::string moduleName = util::getFileNameWithStem(filePath);
+        util::isValidModuleName(moduleName, filePath);
+
+        std::string outputPath = resolveOutputPath(opts);
+        util::ensureDirectoryExists(outputPath);
+
+        util::DiagnosticEngine diagnostics(opts.getErrorLimit());
+        bool cached = compileModule(context, opts, diagnostics, openCache(opts), moduleName, filePath, outputPath);
+        diagnostics.exitOnErrors();
+
+        std::cout << "(Success) " << getOutputKindDescription(opts.getOutputKind()) << " are saved to " << outputPath << (cached ? " (up to date)" : "") << std::endl;
+    }
+    else if (opts.getProjectDirectory().has_value())
+    {
+        // compiler triggered to compile every module of a project directory
+        compileProject(opts);
     }
     else
     {
-        // compiler gonna get options from a configuration file
-        std::cerr << "(Error) Compile with Project.toml is not supported yet." << std::endl;
+        std::cerr << "(Error) Neither an input file nor a project directory is specified." << std::endl;
         exit(1);
     }
 }
@@ -67,18 +249,100 @@ void CodeGenLLVM_Context::saveIR(const std::string &outputPath)
 
     for (auto &&module : modules_)
     {
-        std::string moduleName = module.first;
-        std::string filePath = outputPath + "/" + moduleName + ".ll";
-        std::error_code ec;
-        llvm::raw_fd_ostream dest(filePath, ec, llvm::sys::fs::OF_None);
+        saveModuleIR(module.first, module.second, outputPath);
+    }
+}
 
-        if (ec)
-        {
-            llvm::errs() << "(Error) Could not open file: " << ec.message();
-            exit(1);
-        }
+// nested module names (e.g. `net::http`) are flattened into a single file name.
+static std::string getModuleFileName(const std::string &moduleName)
+{
+    std::string fileName = moduleName;
+    for (std::size_t pos = fileName.find("::"); pos != std::string::npos; pos = fileName.find("::", pos + 1))
+    {
+        fileName.replace(pos, 2, ".");
+    }
+    return fileName;
+}
 
-        module.second->getModule()->print(dest, nullptr);
+std::string CodeGenLLVM_Context::getModuleOutputFilePath(const std::string &outputPath, const std::string &moduleName, CodeGenLLVM_OutputKind outputKind)
+{
+    std::string extension = ".ll";
+    if (outputKind == CodeGenLLVM_OutputKind::ObjectFile)
+    {
+        extension = ".o";
+    }
+    else if (outputKind == CodeGenLLVM_OutputKind::Assembly)
+    {
+        extension = ".s";
+    }
+    return outputPath + "/" + getModuleFileName(moduleName) + extension;
+}
+
+void CodeGenLLVM_Context::saveModuleIR(const std::string &moduleName, CodeGenLLVM_Module *module, const std::string &outputPath)
+{
+    std::string filePath = getModuleOutputFilePath(outputPath, moduleName, CodeGenLLVM_OutputKind::LLVMIR);
+    std::error_code ec;
+    llvm::raw_fd_ostream dest(filePath, ec, llvm::sys::fs::OF_None);
+
+    if (ec)
+    {
+        llvm::errs() << "(Error) Could not open file: " << ec.message();
+        exit(1);
+    }
+
+    module->getModule()->print(dest, nullptr);
+}
+
+void CodeGenLLVM_Context::saveNative(const std::string &outputPath, CodeGenLLVM_OutputKind outputKind)
+{
+    util::ensureDirectoryExists(outputPath);
+
+    for (auto &&module : modules_)
+    {
+        saveModuleNative(module.first, module.second, outputPath, outputKind);
+    }
+}
+
+void CodeGenLLVM_Context::saveModuleNative(const std::string &moduleName, CodeGenLLVM_Module *module, const std::string &outputPath, CodeGenLLVM_OutputKind outputKind)
+{
+    bool isObject = outputKind == CodeGenLLVM_OutputKind::ObjectFile;
+    llvm::CodeGenFileType fileType = isObject ? llvm::CodeGenFileType::ObjectFile : llvm::CodeGenFileType::AssemblyFile;
+
+    // the code generator writes into memory and the file is written in one go,
+    // so a failed emission never leaves a truncated object behind.
+    llvm::SmallVector<char, 0> buffer;
+    llvm::raw_svector_ostream stream(buffer);
+
+    llvm::legacy::PassManager passManager;
+    if (targetMachine_->addPassesToEmitFile(passManager, stream, nullptr, fileType))
+    {
+        llvm::errs() << "(Error) Target machine cannot emit a file of this type.\n";
+        exit(1);
+    }
+    passManager.run(*module->getModule());
+
+    std::string filePath = getModuleOutputFilePath(outputPath, moduleName, outputKind);
+    std::error_code ec;
+    llvm::raw_fd_ostream dest(filePath, ec, isObject ? llvm::sys::fs::OF_None : llvm::sys::fs::OF_Text);
+
+    if (ec)
+    {
+        llvm::errs() << "(Error) Could not open file: " << ec.message();
+        exit(1);
+    }
+
+    dest.write(buffer.data(), buffer.size());
+}
+
+void CodeGenLLVM_Context::saveModule(const std::string &moduleName, CodeGenLLVM_Module *module, const std::string &outputPath, CodeGenLLVM_OutputKind outputKind)
+{
+    if (outputKind == CodeGenLLVM_OutputKind::LLVMIR)
+    {
+        saveModuleIR(moduleName, module, outputPath);
+    }
+    else
+    {
+        saveModuleNative(moduleName, module, outputPath, outputKind);
     }
 }
 
@@ -86,13 +350,40 @@ void CodeGenLLVM_Module::buildProgramIR(ASTProgram *program)
 {
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
+    // structs and enums are laid out in source order, whether or not anything uses them.
     for (auto &&statement : statementsList)
     {
-        switch (statement->getType())
+        if (statement->getType() == ASTNode::NodeType::StructDefinition)
+        {
+            getStructLayout(statement->getSemanticType(), statement);
+        }
+        else if (statement->getType() == ASTNode::NodeType::EnumDefinition)
+        {
+            getEnumLayout(statement->getSemanticType(), statement);
+        }
+    }
+
+    // globals come first, so function bodies can use globals declared after them.
+    for (auto &&statement : statementsList)
+    {
+        if (statement->getType() == ASTNode::NodeType::GlobalVariableDeclaration)
         {
-        case ASTNode::NodeType::VariableDeclaration:
             compileGlobalVariableDeclaration(statement);
-            break;
+        }
+    }
+
+    for (auto &&statement : statementsList)
+    {
+        if (statement->getType() == ASTNode::NodeType::FunctionDefinition || statement->getType() == ASTNode::NodeType::FunctionDeclaration)
+        {
+            declareFunction(statement);
+        }
+    }
+
+    for (auto &&statement : statementsList)
+    {
+        switch (statement->getType())
+        {
         case ASTNode::NodeType::FunctionDefinition:
             compileFunctionDefinition(statement);
             break;
@@ -102,12 +393,12 @@ void CodeGenLLVM_Module::buildProgramIR(ASTProgram *program)
             exit(1);
         }
         default:
-            statement->print(0);
-            compileStmt(std::nullopt, statement);
+            // types, imports and extern declarations have no code of their own.
             break;
         }
     }
 
+    mergeStringSuffixes();
     delete program;
 }
 
@@ -118,8 +409,14 @@ llvm::AllocaInst* CodeGenLLVM_Module::createZeroInitializedAlloca(
     std::optional<llvm::Value*> init, 
     std::size_t lineNumber)
 {
-    llvm::AllocaInst *alloca = builder_.CreateAlloca(type->getLLVMType(), nullptr, name);
+    // every alloca lives in the entry block, however deep the declaration is
+    // nested, so mem2reg and SROA can turn the local into SSA registers and a
+    // loop body does not grow the stack on each iteration.
+    llvm::IRBuilder<> allocaBuilder(allocaInsertPoint_);
+    llvm::AllocaInst *alloca = allocaBuilder.CreateAlloca(type->getLLVMType(), nullptr, name);
+    alloca->setAlignment(std::max(alloca->getAlign(), getTypeAlignment(type->getLLVMType())));
 
+    // the store stays at the declaration, an initializer replaces the zero.
     if (init.has_value())
     {
         builder_.CreateStore(init.value(), alloca);
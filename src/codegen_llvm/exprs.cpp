@@ -2,15 +2,29 @@
 #include "codegen_llvm/values.hpp"
 #include "codegen_llvm/compiler.hpp"
 #include "codegen_llvm/scope.hpp"
+#include "codegen_llvm/diag.hpp"
+#include "semantic/declaration.hpp"
 #include <llvm/IR/IRBuilder.h>
 #include <memory>
 
+static std::shared_ptr<CodeGenLLVM_EValue> makeRValue(llvm::Value *value, std::shared_ptr<CodeGenLLVM_Type> type)
+{
+    auto valPtr = std::make_shared<CodeGenLLVM_Value>(value, std::move(type));
+    return std::make_shared<CodeGenLLVM_EValue>(valPtr, CodeGenLLVM_EValue::ValueCategory::RValue);
+}
+
+// An lvalue is the address of the object, typed as a pointer to it.
+static std::shared_ptr<CodeGenLLVM_EValue> makeLValue(llvm::Value *address, std::shared_ptr<CodeGenLLVM_Type> pointerType)
+{
+    auto valPtr = std::make_shared<CodeGenLLVM_Value>(address, std::move(pointerType));
+    return std::make_shared<CodeGenLLVM_EValue>(valPtr, CodeGenLLVM_EValue::ValueCategory::LValue);
+}
+
 std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileIntegerLiteral(ASTNodePtr nodePtr)
 {
     auto intLiteral = static_cast<ASTIntegerLiteral *>(nodePtr);
-    auto astType = std::make_unique<ASTTypeSpecifier>(ASTTypeSpecifier::ASTInternalType::Int);
-    auto type = compileType(astType.get());
-    auto value = llvm::ConstantInt::get(type->getLLVMType(), intLiteral->getValue());
+    auto type = compileType(nodePtr->getSemanticType(), nodePtr);
+    auto value = llvm::ConstantInt::get(type->getLLVMType(), intLiteral->getValue().zextOrTrunc(nodePtr->getSemanticType()->getBitWidth()));
     auto valPtr = std::make_shared<CodeGenLLVM_Value>(value, type);
     return std::make_shared<CodeGenLLVM_EValue>(valPtr, CodeGenLLVM_EValue::ValueCategory::RValue);
 }
@@ -18,8 +32,7 @@ std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileIntegerLiteral(AS
 std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileFloatLiteral(ASTNodePtr nodePtr)
 {
     auto floatLiteral = static_cast<ASTFloatLiteral *>(nodePtr);
-    auto astType = std::make_unique<ASTTypeSpecifier>(ASTTypeSpecifier::ASTInternalType::Float32);
-    auto type = compileType(astType.get());
+    auto type = compileType(nodePtr->getSemanticType(), nodePtr);
     auto value = llvm::ConstantFP::get(type->getLLVMType(), floatLiteral->getValue());
     auto valPtr = std::make_shared<CodeGenLLVM_Value>(value, type);
     return std::make_shared<CodeGenLLVM_EValue>(valPtr, CodeGenLLVM_EValue::ValueCategory::RValue);
@@ -28,9 +41,8 @@ std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileFloatLiteral(ASTN
 std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileStringLiteral(ASTNodePtr nodePtr)
 {
     auto stringLiteral = static_cast<ASTStringLiteral *>(nodePtr);
-    auto astType = std::make_unique<ASTTypeSpecifier>(ASTTypeSpecifier::ASTInternalType::String);
-    auto type = compileType(astType.get());
-    auto value = builder_.CreateGlobalStringPtr(stringLiteral->getValue());
+    auto &type = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::String);
+    auto value = getStringConstant(stringLiteral->getValue());
     auto valPtr = std::make_shared<CodeGenLLVM_Value>(value, type);
     return std::make_shared<CodeGenLLVM_EValue>(valPtr, CodeGenLLVM_EValue::ValueCategory::RValue);
 }
@@ -38,14 +50,876 @@ std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileStringLiteral(AST
 std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileBoolLiteral(ASTNodePtr nodePtr)
 {
     auto boolLiteral = static_cast<ASTBoolLiteral *>(nodePtr);
-    auto astType = std::make_unique<ASTTypeSpecifier>(ASTTypeSpecifier::ASTInternalType::Bool);
-    auto type = compileType(astType.get());
+    auto &type = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::Bool);
     int boolValue = boolLiteral->getValue() ? 1 : 0;
     auto value = llvm::ConstantInt::get(type->getLLVMType(), boolValue);
     auto valPtr = std::make_shared<CodeGenLLVM_Value>(value, type);
     return std::make_shared<CodeGenLLVM_EValue>(valPtr, CodeGenLLVM_EValue::ValueCategory::RValue);
 }
 
+std::shared_ptr<CodeGenLLVM_Value> CodeGenLLVM_Module::loadValue(const std::shared_ptr<CodeGenLLVM_EValue> &evalue)
+{
+    if (evalue->isRValue())
+    {
+        return evalue->asValue();
+    }
+
+    std::shared_ptr<CodeGenLLVM_Type> type = evalue->asValue()->getValueType()->getNestedType();
+    llvm::Value *value = builder_.CreateAlignedLoad(type->getLLVMType(), evalue->asValue()->getLLVMValue(), evalue->getAlignment());
+    return std::make_shared<CodeGenLLVM_Value>(value, type);
+}
+
+std::shared_ptr<CodeGenLLVM_Value> CodeGenLLVM_Module::compileRValue(OptionalScopePtr scope, ASTNodePtr nodePtr, const semantic::Type *type)
+{
+    std::shared_ptr<CodeGenLLVM_Value> value = loadValue(compileExpr(scope, nodePtr));
+    const semantic::Type *from = nodePtr->getSemanticType();
+
+    if (!type || from->getUnqualified() == type->getUnqualified())
+    {
+        return value;
+    }
+
+    llvm::Value *converted = convertValue(value->getLLVMValue(), from, type, nodePtr);
+    return std::make_shared<CodeGenLLVM_Value>(converted, compileType(type, nodePtr));
+}
+
+llvm::Value *CodeGenLLVM_Module::createIsTrue(llvm::Value *value, const semantic::Type *type)
+{
+    type = type->getUnqualified();
+
+    if (type->is(semantic::Type::Kind::Bool))
+    {
+        return value;
+    }
+    if (type->isFloat())
+    {
+        return builder_.CreateFCmpUNE(value, llvm::ConstantFP::get(value->getType(), 0.0));
+    }
+    if (type->is(semantic::Type::Kind::Pointer))
+    {
+        return builder_.CreateIsNotNull(value);
+    }
+    return builder_.CreateICmpNE(value, llvm::ConstantInt::get(value->getType(), 0));
+}
+
+llvm::Value *CodeGenLLVM_Module::compileCondition(OptionalScopePtr scope, ASTNodePtr nodePtr)
+{
+    std::shared_ptr<CodeGenLLVM_Value> value = compileRValue(scope, nodePtr, nullptr);
+    return createIsTrue(value->getLLVMValue(), nodePtr->getSemanticType());
+}
+
+// Implicit conversions between arithmetic types and the explicit casts the analyzer allows.
+llvm::Value *CodeGenLLVM_Module::convertValue(llvm::Value *value, const semantic::Type *from, const semantic::Type *to, ASTNodePtr nodePtr)
+{
+    using Kind = semantic::Type::Kind;
+    from = from->getUnqualified();
+    to = to->getUnqualified();
+
+    if (from == to)
+    {
+        return value;
+    }
+
+    if (to->is(Kind::Bool))
+    {
+        return createIsTrue(value, from);
+    }
+
+    llvm::Type *llvmType = compileType(to, nodePtr)->getLLVMType();
+    bool fromInteger = from->isInteger() || from->is(Kind::Bool);
+
+    if (to->isInteger())
+    {
+        if (fromInteger)
+        {
+            return builder_.CreateIntCast(value, llvmType, from->isSigned());
+        }
+        if (from->isFloat())
+        {
+            return to->isSigned() ? builder_.CreateFPToSI(value, llvmType) : builder_.CreateFPToUI(value, llvmType);
+        }
+        if (from->is(Kind::Pointer))
+        {
+            return builder_.CreatePtrToInt(value, llvmType);
+        }
+    }
+    else if (to->isFloat())
+    {
+        if (fromInteger)
+        {
+            return from->isSigned() ? builder_.CreateSIToFP(value, llvmType) : builder_.CreateUIToFP(value, llvmType);
+        }
+        if (from->isFloat())
+        {
+            return builder_.CreateFPCast(value, llvmType);
+        }
+    }
+    else if (to->is(Kind::Pointer))
+    {
+        if (from->is(Kind::Pointer))
+        {
+            return value;
+        }
+        if (fromInteger)
+        {
+            return builder_.CreateIntToPtr(value, llvmType);
+        }
+    }
+
+    DISPLAY_DIAG_AT(nodePtr, "Cannot convert '" + from->toString() + "' to '" + to->toString() + "' in code generation.");
+    return nullptr;
+}
+
+std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileIdentifier(OptionalScopePtr scopeOpt, ASTNodePtr nodePtr)
+{
+    ASTIdentifier *identifier = static_cast<ASTIdentifier *>(nodePtr);
+    const semantic::Declaration *declaration = identifier->getDeclaration();
+    std::shared_ptr<CodeGenLLVM_EValue> evalue = nullptr;
+
+    switch (declaration->kind)
+    {
+    case semantic::Declaration::Kind::LocalVariable:
+    case semantic::Declaration::Kind::Parameter:
+    {
+        SCOPE_REQUIRED(identifier->getLineNumber());
+        CodeGenLLVM_EValue *record = SCOPE->getRecord(identifier->getSymbol());
+        if (!record)
+        {
+            DISPLAY_DIAG_AT(identifier, "Variable '" + identifier->getName() + "' has no storage.");
+        }
+        evalue = std::make_shared<CodeGenLLVM_EValue>(*record);
+        break;
+    }
+    case semantic::Declaration::Kind::GlobalVariable:
+    {
+        const GlobalVarTableItem &global = globalVarTable_.at(identifier->getSymbol());
+        llvm::Value *address = global.globalVar;
+
+        // the address of a thread local differs per thread, so it must not be reused across a thread switch.
+        if (global.globalVar->isThreadLocal())
+        {
+            address = builder_.CreateThreadLocalAddress(global.globalVar);
+        }
+        evalue = makeLValue(address, typeTable_.getPointerType(global.codegenType));
+        break;
+    }
+    default:
+        DISPLAY_DIAG_AT(identifier, "Using '" + identifier->getName() + "' as a value is not supported by code generation yet.");
+        return nullptr;
+    }
+
+    // a reference variable stores the address of the object it refers to.
+    if (declaration->type->is(semantic::Type::Kind::Reference))
+    {
+        std::shared_ptr<CodeGenLLVM_Value> address = loadValue(evalue);
+        evalue = makeLValue(address->getLLVMValue(), typeTable_.getPointerType(address->getValueType()->getNestedType()));
+    }
+    return evalue;
+}
+
+llvm::Value *CodeGenLLVM_Module::compileBinaryOperation(
+    ASTBinaryExpression::Operator op,
+    llvm::Value *lhs,
+    const semantic::Type *lhsType,
+    llvm::Value *rhs,
+    const semantic::Type *rhsType,
+    ASTNodePtr nodePtr)
+{
+    using Operator = ASTBinaryExpression::Operator;
+    using Kind = semantic::Type::Kind;
+    lhsType = lhsType->getUnqualified();
+    rhsType = rhsType->getUnqualified();
+
+    if (lhsType->is(Kind::Pointer) || rhsType->is(Kind::Pointer))
+    {
+        bool bothPointers = lhsType->is(Kind::Pointer) && rhsType->is(Kind::Pointer);
+        const semantic::Type *pointerType = lhsType->is(Kind::Pointer) ? lhsType : rhsType;
+        llvm::Type *elementType = compileType(pointerType->getElementType(), nodePtr)->getLLVMType();
+
+        // void* moves in bytes.
+        if (elementType->isVoidTy())
+        {
+            elementType = builder_.getInt8Ty();
+        }
+
+        if ((op == Operator::Add || op == Operator::Subtract) && !bothPointers)
+        {
+            bool pointerOnLeft = lhsType->is(Kind::Pointer);
+            llvm::Value *pointer = pointerOnLeft ? lhs : rhs;
+            llvm::Value *index = pointerOnLeft ? rhs : lhs;
+            const semantic::Type *indexType = pointerOnLeft ? rhsType : lhsType;
+
+            llvm::Value *offset = builder_.CreateIntCast(index, builder_.getInt64Ty(), indexType->isSigned());
+            if (op == Operator::Subtract)
+            {
+                offset = builder_.CreateNeg(offset);
+            }
+            return builder_.CreateInBoundsGEP(elementType, pointer, offset);
+        }
+
+        switch (op)
+        {
+        case Operator::Subtract:
+            return builder_.CreatePtrDiff(elementType, lhs, rhs);
+        case Operator::Equal:
+            return builder_.CreateICmpEQ(lhs, rhs);
+        case Operator::NotEqual:
+            return builder_.CreateICmpNE(lhs, rhs);
+        case Operator::LessThan:
+            return builder_.CreateICmpULT(lhs, rhs);
+        case Operator::LessEqual:
+            return builder_.CreateICmpULE(lhs, rhs);
+        case Operator::GreaterThan:
+            return builder_.CreateICmpUGT(lhs, rhs);
+        case Operator::GreaterEqual:
+            return builder_.CreateICmpUGE(lhs, rhs);
+        default:
+            break;
+        }
+    }
+    else if (lhsType->isArithmetic() || lhsType->is(Kind::Bool))
+    {
+        // shifts keep the type of the left operand, everything else works in the common type.
+        bool isShift = op == Operator::LeftShift || op == Operator::RightShift;
+        const semantic::Type *type = isShift ? lhsType : semantic::getCommonArithmeticType(lhsType, rhsType);
+        lhs = convertValue(lhs, lhsType, type, nodePtr);
+        rhs = convertValue(rhs, rhsType, type, nodePtr);
+
+        if (type->isFloat())
+        {
+            switch (op)
+            {
+            case Operator::Add:
+                return builder_.CreateFAdd(lhs, rhs);
+            case Operator::Subtract:
+                return builder_.CreateFSub(lhs, rhs);
+            case Operator::Multiply:
+                return builder_.CreateFMul(lhs, rhs);
+            case Operator::Divide:
+                return builder_.CreateFDiv(lhs, rhs);
+            case Operator::Remainder:
+                return builder_.CreateFRem(lhs, rhs);
+            case Operator::Equal:
+                return builder_.CreateFCmpOEQ(lhs, rhs);
+            case Operator::NotEqual:
+                return builder_.CreateFCmpUNE(lhs, rhs);
+            case Operator::LessThan:
+                return builder_.CreateFCmpOLT(lhs, rhs);
+            case Operator::LessEqual:
+                return builder_.CreateFCmpOLE(lhs, rhs);
+            case Operator::GreaterThan:
+                return builder_.CreateFCmpOGT(lhs, rhs);
+            case Operator::GreaterEqual:
+                return builder_.CreateFCmpOGE(lhs, rhs);
+            default:
+                break;
+            }
+        }
+        else
+        {
+            bool isSigned = type->isSigned();
+            switch (op)
+            {
+            case Operator::Add:
+                return builder_.CreateAdd(lhs, rhs);
+            case Operator::Subtract:
+                return builder_.CreateSub(lhs, rhs);
+            case Operator::Multiply:
+                return builder_.CreateMul(lhs, rhs);
+            case Operator::Divide:
+                return isSigned ? builder_.CreateSDiv(lhs, rhs) : builder_.CreateUDiv(lhs, rhs);
+            case Operator::Remainder:
+                return isSigned ? builder_.CreateSRem(lhs, rhs) : builder_.CreateURem(lhs, rhs);
+            case Operator::LeftShift:
+                return builder_.CreateShl(lhs, rhs);
+            case Operator::RightShift:
+                return isSigned ? builder_.CreateAShr(lhs, rhs) : builder_.CreateLShr(lhs, rhs);
+            case Operator::BitwiseAnd:
+                return builder_.CreateAnd(lhs, rhs);
+            case Operator::BitwiseOr:
+                return builder_.CreateOr(lhs, rhs);
+            case Operator::BitwiseXor:
+                return builder_.CreateXor(lhs, rhs);
+            case Operator::Equal:
+                return builder_.CreateICmpEQ(lhs, rhs);
+            case Operator::NotEqual:
+                return builder_.CreateICmpNE(lhs, rhs);
+            case Operator::LessThan:
+                return isSigned ? builder_.CreateICmpSLT(lhs, rhs) : builder_.CreateICmpULT(lhs, rhs);
+            case Operator::LessEqual:
+                return isSigned ? builder_.CreateICmpSLE(lhs, rhs) : builder_.CreateICmpULE(lhs, rhs);
+            case Operator::GreaterThan:
+                return isSigned ? builder_.CreateICmpSGT(lhs, rhs) : builder_.CreateICmpUGT(lhs, rhs);
+            case Operator::GreaterEqual:
+                return isSigned ? builder_.CreateICmpSGE(lhs, rhs) : builder_.CreateICmpUGE(lhs, rhs);
+            default:
+                break;
+            }
+        }
+    }
+
+    else if ((lhsType->is(Kind::String) || lhsType->is(Kind::Enum)) && (op == Operator::Equal || op == Operator::NotEqual))
+    {
+        llvm::Value *equal = lhsType->is(Kind::String) ? compileStringEquality(lhs, rhs) : compileEnumEquality(lhs, rhs, lhsType, nodePtr);
+        return op == Operator::Equal ? equal : builder_.CreateNot(equal);
+    }
+
+    DISPLAY_DIAG_AT(nodePtr, "Operands of type '" + lhsType->toString() + "' and '" + rhsType->toString() + "' are not supported by code generation yet.");
+    return nullptr;
+}
+
+// Strings compare by their characters. The same pointer, null included, is
+// equal without a call, and a null string equals no other string.
+llvm::Value *CodeGenLLVM_Module::compileStringEquality(llvm::Value *lhs, llvm::Value *rhs)
+{
+    llvm::Function *func = builder_.GetInsertBlock()->getParent();
+    llvm::BasicBlock *entryBlock = builder_.GetInsertBlock();
+    llvm::BasicBlock *compareBlock = llvm::BasicBlock::Create(context_, "str.cmp", func);
+    llvm::BasicBlock *endBlock = llvm::BasicBlock::Create(context_, "str.end", func);
+
+    llvm::Value *samePointer = builder_.CreateICmpEQ(lhs, rhs);
+    llvm::Value *eitherNull = builder_.CreateOr(builder_.CreateIsNull(lhs), builder_.CreateIsNull(rhs));
+    builder_.CreateCondBr(builder_.CreateOr(samePointer, eitherNull), endBlock, compareBlock);
+
+    builder_.SetInsertPoint(compareBlock);
+    llvm::Type *pointerType = llvm::PointerType::getUnqual(context_);
+    llvm::FunctionCallee strcmp = module_->getOrInsertFunction("strcmp", builder_.getInt32Ty(), pointerType, pointerType);
+    llvm::Value *sameCharacters = builder_.CreateICmpEQ(builder_.CreateCall(strcmp, {lhs, rhs}), builder_.getInt32(0));
+    builder_.CreateBr(endBlock);
+
+    builder_.SetInsertPoint(endBlock);
+    llvm::PHINode *phi = builder_.CreatePHI(builder_.getInt1Ty(), 2);
+    phi->addIncoming(samePointer, entryBlock);
+    phi->addIncoming(sameCharacters, compareBlock);
+    return phi;
+}
+
+// Enums are equal when they hold the same variant and its payloads are equal
+// item by item. The analyzer only allows payloads that can be compared.
+llvm::Value *CodeGenLLVM_Module::compileEnumEquality(llvm::Value *lhs, llvm::Value *rhs, const semantic::Type *enumType, ASTNodePtr nodePtr)
+{
+    const CodeGenLLVM_EnumLayout &layout = getEnumLayout(enumType, nodePtr);
+    if (layout.kind == CodeGenLLVM_EnumLayout::Kind::Tag)
+    {
+        return builder_.CreateICmpEQ(lhs, rhs);
+    }
+
+    // case values and payloads are read from memory, like in a switch.
+    llvm::Value *lhsAddress = createZeroInitializedAlloca("lhs.tmp", layout.type, lhs, 0);
+    llvm::Value *rhsAddress = createZeroInitializedAlloca("rhs.tmp", layout.type, rhs, 0);
+    llvm::Value *lhsCase = compileEnumCaseValue(lhsAddress, layout);
+    llvm::Value *rhsCase = compileEnumCaseValue(rhsAddress, layout);
+
+    llvm::Function *func = builder_.GetInsertBlock()->getParent();
+    llvm::BasicBlock *entryBlock = builder_.GetInsertBlock();
+    llvm::BasicBlock *payloadBlock = llvm::BasicBlock::Create(context_, "enum.eq.payload", func);
+    llvm::BasicBlock *endBlock = llvm::BasicBlock::Create(context_, "enum.eq.end", func);
+    std::vector<std::pair<llvm::Value *, llvm::BasicBlock *>> results = {{builder_.getFalse(), entryBlock}, {builder_.getTrue(), payloadBlock}};
+
+    builder_.CreateCondBr(builder_.CreateICmpEQ(lhsCase, rhsCase), payloadBlock, endBlock);
+    builder_.SetInsertPoint(payloadBlock);
+    llvm::SwitchInst *switchInst = builder_.CreateSwitch(lhsCase, endBlock);
+
+    const std::vector<semantic::Type::Variant> &variants = enumType->getVariants();
+    for (std::size_t i = 0; i < variants.size(); ++i)
+    {
+        const CodeGenLLVM_EnumLayout::Variant &variant = layout.variants[i];
+        if (variants[i].payload.empty())
+        {
+            continue;
+        }
+
+        llvm::BasicBlock *variantBlock = llvm::BasicBlock::Create(context_, "enum.eq." + variants[i].name.str(), func, endBlock);
+        switchInst->addCase(llvm::ConstantInt::get(layout.tagType, variant.caseValue), variantBlock);
+        builder_.SetInsertPoint(variantBlock);
+
+        llvm::Value *lhsPayload = getVariantPayloadAddress(lhsAddress, layout);
+        llvm::Value *rhsPayload = getVariantPayloadAddress(rhsAddress, layout);
+        llvm::Value *equal = builder_.getTrue();
+        for (std::size_t j = 0; j < variants[i].payload.size(); ++j)
+        {
+            const semantic::Type *itemType = variants[i].payload[j];
+            llvm::Type *llvmItemType = compileType(itemType, nodePtr)->getLLVMType();
+            llvm::Value *lhsItem = builder_.CreateLoad(llvmItemType, builder_.CreateStructGEP(variant.payloadType, lhsPayload, variant.elements[j]));
+            llvm::Value *rhsItem = builder_.CreateLoad(llvmItemType, builder_.CreateStructGEP(variant.payloadType, rhsPayload, variant.elements[j]));
+            equal = builder_.CreateAnd(equal, compileBinaryOperation(ASTBinaryExpression::Operator::Equal, lhsItem, itemType, rhsItem, itemType, nodePtr));
+        }
+
+        results.emplace_back(equal, builder_.GetInsertBlock());
+        builder_.CreateBr(endBlock);
+    }
+
+    builder_.SetInsertPoint(endBlock);
+    llvm::PHINode *phi = builder_.CreatePHI(builder_.getInt1Ty(), results.size());
+    for (const auto &[value, block] : results)
+    {
+        phi->addIncoming(value, block);
+    }
+    return phi;
+}
+
+std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileBinaryExpression(OptionalScopePtr scope, ASTNodePtr nodePtr)
+{
+    ASTBinaryExpression *expr = static_cast<ASTBinaryExpression *>(nodePtr);
+    ASTBinaryExpression::Operator op = expr->getOperator();
+
+    if (op == ASTBinaryExpression::Operator::LogicalAnd || op == ASTBinaryExpression::Operator::LogicalOr)
+    {
+        return compileLogicalExpression(scope, expr);
+    }
+
+    std::shared_ptr<CodeGenLLVM_Value> lhs = compileRValue(scope, expr->getLeft(), nullptr);
+    std::shared_ptr<CodeGenLLVM_Value> rhs = compileRValue(scope, expr->getRight(), nullptr);
+    llvm::Value *value = compileBinaryOperation(
+        op,
+        lhs->getLLVMValue(),
+        expr->getLeft()->getSemanticType(),
+        rhs->getLLVMValue(),
+        expr->getRight()->getSemanticType(),
+        expr);
+
+    return makeRValue(value, compileType(expr));
+}
+
+// `a && b` and `a || b` only evaluate `b` when `a` does not decide the result.
+std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileLogicalExpression(OptionalScopePtr scope, ASTNodePtr nodePtr)
+{
+    ASTBinaryExpression *expr = static_cast<ASTBinaryExpression *>(nodePtr);
+    bool isAnd = expr->getOperator() == ASTBinaryExpression::Operator::LogicalAnd;
+    llvm::Function *func = builder_.GetInsertBlock()->getParent();
+
+    llvm::Value *lhs = compileCondition(scope, expr->getLeft());
+    llvm::BasicBlock *lhsBlock = builder_.GetInsertBlock();
+    llvm::BasicBlock *rhsBlock = llvm::BasicBlock::Create(context_, isAnd ? "and.rhs" : "or.rhs", func);
+    llvm::BasicBlock *endBlock = llvm::BasicBlock::Create(context_, isAnd ? "and.end" : "or.end", func);
+
+    if (isAnd)
+    {
+        builder_.CreateCondBr(lhs, rhsBlock, endBlock);
+    }
+    else
+    {
+        builder_.CreateCondBr(lhs, endBlock, rhsBlock);
+    }
+
+    builder_.SetInsertPoint(rhsBlock);
+    llvm::Value *rhs = compileCondition(scope, expr->getRight());
+    llvm::BasicBlock *rhsEndBlock = builder_.GetInsertBlock();
+    builder_.CreateBr(endBlock);
+
+    builder_.SetInsertPoint(endBlock);
+    llvm::PHINode *phi = builder_.CreatePHI(builder_.getInt1Ty(), 2);
+    phi->addIncoming(builder_.getInt1(!isAnd), lhsBlock);
+    phi->addIncoming(rhs, rhsEndBlock);
+
+    return makeRValue(phi, compileType(expr));
+}
+
+std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileUnaryExpression(OptionalScopePtr scope, ASTNodePtr nodePtr)
+{
+    using Operator = ASTUnaryExpression::Operator;
+    ASTUnaryExpression *expr = static_cast<ASTUnaryExpression *>(nodePtr);
+    const semantic::Type *type = expr->getSemanticType();
+
+    switch (expr->getOperator())
+    {
+    case Operator::Plus:
+        return makeRValue(compileRValue(scope, expr->getOperand(), type)->getLLVMValue(), compileType(expr));
+    case Operator::Negate:
+    {
+        llvm::Value *value = compileRValue(scope, expr->getOperand(), type)->getLLVMValue();
+        return makeRValue(type->isFloat() ? builder_.CreateFNeg(value) : builder_.CreateNeg(value), compileType(expr));
+    }
+    case Operator::BitwiseNot:
+        return makeRValue(builder_.CreateNot(compileRValue(scope, expr->getOperand(), type)->getLLVMValue()), compileType(expr));
+    case Operator::LogicalNot:
+        return makeRValue(builder_.CreateNot(compileCondition(scope, expr->getOperand())), compileType(expr));
+    case Operator::AddressOf:
+        return makeRValue(compileExpr(scope, expr->getOperand())->asValue()->getLLVMValue(), compileType(expr));
+    case Operator::Dereference:
+    {
+        llvm::Value *address = compileRValue(scope, expr->getOperand(), nullptr)->getLLVMValue();
+        return makeLValue(address, typeTable_.getPointerType(compileType(expr)));
+    }
+    case Operator::PreIncrement:
+    case Operator::PreDecrement:
+    case Operator::PostIncrement:
+    case Operator::PostDecrement:
+        return compileIncrement(scope, expr);
+    default:
+        DISPLAY_DIAG_AT(expr, "Unary operator '" + expr->getOperatorString() + "' is not supported by code generation yet.");
+        return nullptr;
+    }
+}
+
+std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileIncrement(OptionalScopePtr scope, ASTNodePtr nodePtr)
+{
+    using Operator = ASTUnaryExpression::Operator;
+    ASTUnaryExpression *expr = static_cast<ASTUnaryExpression *>(nodePtr);
+    bool isIncrement = expr->getOperator() == Operator::PreIncrement || expr->getOperator() == Operator::PostIncrement;
+    bool isPrefix = expr->getOperator() == Operator::PreIncrement || expr->getOperator() == Operator::PreDecrement;
+
+    std::shared_ptr<CodeGenLLVM_EValue> target = compileExpr(scope, expr->getOperand());
+    llvm::Value *current = loadValue(target)->getLLVMValue();
+    const semantic::Type *type = expr->getOperand()->getSemanticType()->getUnqualified();
+    llvm::Value *updated = nullptr;
+
+    if (type->is(semantic::Type::Kind::Pointer))
+    {
+        llvm::Type *elementType = compileType(type->getElementType(), expr)->getLLVMType();
+        updated = builder_.CreateInBoundsGEP(elementType->isVoidTy() ? builder_.getInt8Ty() : elementType, current, builder_.getInt64(isIncrement ? 1 : -1));
+    }
+    else if (type->isFloat())
+    {
+        updated = builder_.CreateFAdd(current, llvm::ConstantFP::get(current->getType(), isIncrement ? 1.0 : -1.0));
+    }
+    else
+    {
+        updated = builder_.CreateAdd(current, llvm::ConstantInt::get(current->getType(), isIncrement ? 1 : -1, true));
+    }
+
+    builder_.CreateAlignedStore(updated, target->asValue()->getLLVMValue(), target->getAlignment());
+    return makeRValue(isPrefix ? updated : current, compileType(expr));
+}
+
+static ASTBinaryExpression::Operator getCompoundOperator(ASTAssignment::Operator op)
+{
+    switch (op)
+    {
+    case ASTAssignment::Operator::AddAssign:
+        return ASTBinaryExpression::Operator::Add;
+    case ASTAssignment::Operator::SubtractAssign:
+        return ASTBinaryExpression::Operator::Subtract;
+    case ASTAssignment::Operator::MultiplyAssign:
+        return ASTBinaryExpression::Operator::Multiply;
+    case ASTAssignment::Operator::DivideAssign:
+        return ASTBinaryExpression::Operator::Divide;
+    case ASTAssignment::Operator::RemainderAssign:
+        return ASTBinaryExpression::Operator::Remainder;
+    case ASTAssignment::Operator::LeftShiftAssign:
+        return ASTBinaryExpression::Operator::LeftShift;
+    case ASTAssignment::Operator::RightShiftAssign:
+        return ASTBinaryExpression::Operator::RightShift;
+    case ASTAssignment::Operator::BitwiseAndAssign:
+        return ASTBinaryExpression::Operator::BitwiseAnd;
+    case ASTAssignment::Operator::BitwiseXorAssign:
+        return ASTBinaryExpression::Operator::BitwiseXor;
+    default:
+        return ASTBinaryExpression::Operator::BitwiseOr;
+    }
+}
+
+std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileAssignment(OptionalScopePtr scope, ASTNodePtr nodePtr)
+{
+    ASTAssignment *expr = static_cast<ASTAssignment *>(nodePtr);
+    std::shared_ptr<CodeGenLLVM_EValue> target = compileExpr(scope, expr->getLeft());
+    const semantic::Type *targetType = expr->getLeft()->getSemanticType()->getUnqualified();
+    llvm::Value *value = nullptr;
+
+    if (expr->getOperator() == ASTAssignment::Operator::Assign)
+    {
+        value = compileRValue(scope, expr->getRight(), targetType)->getLLVMValue();
+    }
+    else
+    {
+        // `a op= b` is `a = a op b` with `a` evaluated once.
+        ASTBinaryExpression::Operator op = getCompoundOperator(expr->getOperator());
+        llvm::Value *current = loadValue(target)->getLLVMValue();
+        llvm::Value *rhs = compileRValue(scope, expr->getRight(), nullptr)->getLLVMValue();
+        const semantic::Type *rhsType = expr->getRight()->getSemanticType()->getUnqualified();
+
+        bool keepsTargetType = op == ASTBinaryExpression::Operator::LeftShift ||
+                               op == ASTBinaryExpression::Operator::RightShift ||
+                               targetType->is(semantic::Type::Kind::Pointer);
+        const semantic::Type *resultType = keepsTargetType ? targetType : semantic::getCommonArithmeticType(targetType, rhsType);
+
+        llvm::Value *result = compileBinaryOperation(op, current, targetType, rhs, rhsType, expr);
+        value = convertValue(result, resultType, targetType, expr);
+    }
+
+    builder_.CreateAlignedStore(value, target->asValue()->getLLVMValue(), target->getAlignment());
+    return makeRValue(value, compileType(targetType, expr));
+}
+
+std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileConditionalExpression(OptionalScopePtr scope, ASTNodePtr nodePtr)
+{
+    ASTConditionalExpression *expr = static_cast<ASTConditionalExpression *>(nodePtr);
+    const semantic::Type *type = expr->getSemanticType();
+    llvm::Function *func = builder_.GetInsertBlock()->getParent();
+
+    llvm::Value *condition = compileCondition(scope, expr->getCondition());
+    llvm::BasicBlock *trueBlock = llvm::BasicBlock::Create(context_, "cond.true", func);
+    llvm::BasicBlock *falseBlock = llvm::BasicBlock::Create(context_, "cond.false", func);
+    llvm::BasicBlock *endBlock = llvm::BasicBlock::Create(context_, "cond.end", func);
+    builder_.CreateCondBr(condition, trueBlock, falseBlock);
+
+    builder_.SetInsertPoint(trueBlock);
+    llvm::Value *trueValue = compileRValue(scope, expr->getTrueExpression(), type)->getLLVMValue();
+    llvm::BasicBlock *trueEndBlock = builder_.GetInsertBlock();
+    builder_.CreateBr(endBlock);
+
+    builder_.SetInsertPoint(falseBlock);
+    llvm::Value *falseValue = compileRValue(scope, expr->getFalseExpression(), type)->getLLVMValue();
+    llvm::BasicBlock *falseEndBlock = builder_.GetInsertBlock();
+    builder_.CreateBr(endBlock);
+
+    builder_.SetInsertPoint(endBlock);
+    std::shared_ptr<CodeGenLLVM_Type> codegenType = compileType(expr);
+    llvm::PHINode *phi = builder_.CreatePHI(codegenType->getLLVMType(), 2);
+    phi->addIncoming(trueValue, trueEndBlock);
+    phi->addIncoming(falseValue, falseEndBlock);
+
+    return makeRValue(phi, codegenType);
+}
+
+std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileCastExpression(OptionalScopePtr scope, ASTNodePtr nodePtr)
+{
+    ASTCastExpression *expr = static_cast<ASTCastExpression *>(nodePtr);
+    llvm::Value *value = compileRValue(scope, expr->getExpression(), expr->getSemanticType())->getLLVMValue();
+    return makeRValue(value, compileType(expr));
+}
+
+std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileFieldAccess(OptionalScopePtr scope, ASTNodePtr nodePtr)
+{
+    bool throughPointer = nodePtr->getType() == ASTNode::NodeType::PointerFieldAccess;
+    const ASTFieldAccess *fieldAccess = throughPointer ? &static_cast<ASTPointerFieldAccess *>(nodePtr)->getFieldAccess() : static_cast<ASTFieldAccess *>(nodePtr);
+
+    // `Enum.Variant`: the operand names the enum, the field the variant.
+    if (!throughPointer && fieldAccess->getOperand()->getSemanticType()->getUnqualified()->is(semantic::Type::Kind::Enum))
+    {
+        return compileEnumVariant(scope, fieldAccess, {});
+    }
+
+    const semantic::Type *structType = fieldAccess->getOperand()->getSemanticType();
+    if (structType->is(semantic::Type::Kind::Reference))
+    {
+        structType = structType->getElementType();
+    }
+    if (throughPointer)
+    {
+        structType = structType->getElementType();
+    }
+
+    const CodeGenLLVM_StructLayout &layout = getStructLayout(structType, nodePtr);
+    const CodeGenLLVM_StructLayout::Field &field = layout.fields[fieldAccess->getFieldIndex()];
+    std::shared_ptr<CodeGenLLVM_Type> fieldType = compileType(nodePtr);
+
+    llvm::Value *fieldAddress = nullptr;
+    llvm::MaybeAlign alignment;
+    if (layout.soaCapacity)
+    {
+        // `table[i].field` is element i of the column of `field`.
+        ASTIndexAccess *row = static_cast<ASTIndexAccess *>(fieldAccess->getOperand());
+        llvm::Value *table = compileAddress(scope, row->getOperand(), layout.type, row->getLineNumber());
+        llvm::Value *index = compileIndex(scope, row->getIndex());
+        fieldAddress = builder_.CreateInBoundsGEP(layout.getLLVMType(), table, {builder_.getInt64(0), builder_.getInt32(field.element), index}, fieldAccess->getFieldName());
+    }
+    else
+    {
+        llvm::Value *address = nullptr;
+        llvm::Align structAlignment(layout.alignment);
+        if (throughPointer)
+        {
+            address = compileRValue(scope, fieldAccess->getOperand(), nullptr)->getLLVMValue();
+        }
+        else
+        {
+            std::shared_ptr<CodeGenLLVM_EValue> operand = compileExpr(scope, fieldAccess->getOperand());
+
+            // a temporary struct, e.g. one returned by a call, has no address.
+            if (operand->isRValue())
+            {
+                llvm::Value *value = builder_.CreateExtractValue(operand->asValue()->getLLVMValue(), {field.element}, fieldAccess->getFieldName());
+                return makeRValue(value, fieldType);
+            }
+
+            address = operand->asValue()->getLLVMValue();
+            if (operand->getAlignment())
+            {
+                structAlignment = *operand->getAlignment();
+            }
+        }
+
+        // a field of a packed struct may sit below the alignment of its type.
+        llvm::Align fieldAlignment = llvm::commonAlignment(structAlignment, field.offset);
+        if (fieldAlignment < module_->getDataLayout().getABITypeAlign(fieldType->getLLVMType()))
+        {
+            alignment = fieldAlignment;
+        }
+        fieldAddress = builder_.CreateStructGEP(layout.getLLVMType(), address, field.element, fieldAccess->getFieldName());
+    }
+
+    auto valPtr = std::make_shared<CodeGenLLVM_Value>(fieldAddress, typeTable_.getPointerType(fieldType));
+    auto evalue = std::make_shared<CodeGenLLVM_EValue>(valPtr, CodeGenLLVM_EValue::ValueCategory::LValue, alignment);
+
+    // a reference field stores the address of the object it refers to.
+    if (field.type->is(semantic::Type::Kind::Reference))
+    {
+        std::shared_ptr<CodeGenLLVM_Value> referee = loadValue(evalue);
+        evalue = makeLValue(referee->getLLVMValue(), typeTable_.getPointerType(referee->getValueType()->getNestedType()));
+    }
+    return evalue;
+}
+
+// `pointer[i]`. A row of a soa struct never gets here, compileFieldAccess
+// indexes the column of the field instead.
+std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileIndexAccess(OptionalScopePtr scope, ASTNodePtr nodePtr)
+{
+    ASTIndexAccess *access = static_cast<ASTIndexAccess *>(nodePtr);
+    std::shared_ptr<CodeGenLLVM_Type> elementType = compileType(access);
+
+    llvm::Value *pointer = compileRValue(scope, access->getOperand(), nullptr)->getLLVMValue();
+    llvm::Value *index = compileIndex(scope, access->getIndex());
+    llvm::Value *address = builder_.CreateInBoundsGEP(elementType->getLLVMType(), pointer, index, "arrayidx");
+    return makeLValue(address, typeTable_.getPointerType(elementType));
+}
+
+// An index as the i64 GEP operand, extended by the signedness of its type.
+llvm::Value *CodeGenLLVM_Module::compileIndex(OptionalScopePtr scope, ASTNodePtr nodePtr)
+{
+    llvm::Value *index = compileRValue(scope, nodePtr, nullptr)->getLLVMValue();
+    return builder_.CreateIntCast(index, builder_.getInt64Ty(), nodePtr->getSemanticType()->getUnqualified()->isSigned(), "idxprom");
+}
+
+// The address of an aggregate. A temporary, e.g. one returned by a call, is
+// spilled to the stack first so it can be indexed at run time.
+llvm::Value *CodeGenLLVM_Module::compileAddress(OptionalScopePtr scope, ASTNodePtr nodePtr, std::shared_ptr<CodeGenLLVM_Type> type, std::size_t lineNumber)
+{
+    std::shared_ptr<CodeGenLLVM_EValue> evalue = compileExpr(scope, nodePtr);
+    if (evalue->isLValue())
+    {
+        return evalue->asValue()->getLLVMValue();
+    }
+    return createZeroInitializedAlloca("agg.tmp", type, evalue->asValue()->getLLVMValue(), lineNumber);
+}
+
+std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileStructInitialization(OptionalScopePtr scope, ASTNodePtr nodePtr)
+{
+    ASTStructInitialization *init = static_cast<ASTStructInitialization *>(nodePtr);
+    const semantic::Type *structType = init->getSemanticType();
+    const CodeGenLLVM_StructLayout &layout = getStructLayout(structType, init);
+
+    // fields left out, and the padding, are zero.
+    llvm::Value *value = llvm::Constant::getNullValue(layout.getLLVMType());
+    for (const auto &[fieldName, fieldValue] : init->getFieldInitializers())
+    {
+        const CodeGenLLVM_StructLayout::Field &field = layout.fields[structType->findField(fieldName)];
+
+        llvm::Value *fieldLLVMValue = nullptr;
+        if (field.type->is(semantic::Type::Kind::Reference))
+        {
+            fieldLLVMValue = compileExpr(scope, fieldValue)->asValue()->getLLVMValue();
+        }
+        else
+        {
+            fieldLLVMValue = compileRValue(scope, fieldValue, field.type)->getLLVMValue();
+        }
+        value = builder_.CreateInsertValue(value, fieldLLVMValue, {field.element});
+    }
+
+    return makeRValue(value, layout.type);
+}
+
+// `Enum.Variant` or `Enum.Variant(a, b)`. The variant is built in a
+// temporary, the niche and payload stores land at byte offsets that
+// insertvalue cannot reach; SROA turns it back into registers.
+std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileEnumVariant(OptionalScopePtr scope, const ASTFieldAccess *variantAccess, const std::vector<ASTNodePtr> &arguments)
+{
+    const semantic::Type *enumType = variantAccess->getOperand()->getSemanticType()->getUnqualified();
+    const CodeGenLLVM_EnumLayout &layout = getEnumLayout(enumType, const_cast<ASTFieldAccess *>(variantAccess));
+    unsigned index = variantAccess->getFieldIndex();
+    const CodeGenLLVM_EnumLayout::Variant &variant = layout.variants[index];
+    const std::vector<const semantic::Type *> &payload = enumType->getVariants()[index].payload;
+
+    if (layout.kind == CodeGenLLVM_EnumLayout::Kind::Tag)
+    {
+        return makeRValue(llvm::ConstantInt::get(layout.tagType, variant.caseValue), layout.type);
+    }
+
+    // the payload is evaluated first, it may read another variant of the same enum.
+    std::vector<llvm::Value *> values;
+    for (std::size_t i = 0; i < payload.size(); ++i)
+    {
+        if (payload[i]->is(semantic::Type::Kind::Reference))
+        {
+            values.push_back(compileExpr(scope, arguments[i])->asValue()->getLLVMValue());
+        }
+        else
+        {
+            values.push_back(compileRValue(scope, arguments[i], payload[i])->getLLVMValue());
+        }
+    }
+
+    llvm::AllocaInst *temp = createZeroInitializedAlloca("variant.tmp", layout.type, std::nullopt, variantAccess->getLineNumber());
+    if (layout.kind == CodeGenLLVM_EnumLayout::Kind::Tagged)
+    {
+        builder_.CreateStore(llvm::ConstantInt::get(layout.tagType, variant.caseValue), builder_.CreateStructGEP(layout.type->getLLVMType(), temp, 0));
+    }
+    else if (index != layout.dataful)
+    {
+        llvm::Type *nicheType = builder_.getIntNTy(layout.niche.bits);
+        llvm::Constant *value = llvm::ConstantInt::get(nicheType, layout.niche.start + variant.caseValue);
+        if (layout.niche.isPointer)
+        {
+            value = llvm::ConstantExpr::getIntToPtr(value, llvm::PointerType::getUnqual(context_));
+        }
+        llvm::Value *nicheAddress = builder_.CreateConstInBoundsGEP1_64(builder_.getInt8Ty(), temp, layout.niche.offset);
+        builder_.CreateAlignedStore(value, nicheAddress, llvm::commonAlignment(llvm::Align(layout.alignment), layout.niche.offset));
+    }
+
+    llvm::Value *payloadAddress = getVariantPayloadAddress(temp, layout);
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        builder_.CreateStore(values[i], builder_.CreateStructGEP(variant.payloadType, payloadAddress, variant.elements[i]));
+    }
+
+    llvm::Value *value = builder_.CreateAlignedLoad(layout.type->getLLVMType(), temp, llvm::Align(layout.alignment), variantAccess->getFieldName());
+    return makeRValue(value, layout.type);
+}
+
+// The value a switch over the enum dispatches on, see CodeGenLLVM_EnumLayout::Variant::caseValue.
+llvm::Value *CodeGenLLVM_Module::compileEnumCaseValue(llvm::Value *address, const CodeGenLLVM_EnumLayout &layout)
+{
+    llvm::Align alignment(layout.alignment);
+    switch (layout.kind)
+    {
+    case CodeGenLLVM_EnumLayout::Kind::Tag:
+    case CodeGenLLVM_EnumLayout::Kind::Tagged:
+        return builder_.CreateAlignedLoad(layout.tagType, address, alignment, "tag");
+    case CodeGenLLVM_EnumLayout::Kind::Niche:
+        break;
+    }
+
+    std::uint64_t others = layout.variants.size() - 1;
+    if (others == 0)
+    {
+        return llvm::ConstantInt::get(layout.tagType, 0);
+    }
+
+    // a niche value is one of the other variants, anything else is the payload.
+    llvm::Value *nicheAddress = builder_.CreateConstInBoundsGEP1_64(builder_.getInt8Ty(), address, layout.niche.offset);
+    llvm::Type *loadType = layout.niche.isPointer ? static_cast<llvm::Type *>(llvm::PointerType::getUnqual(context_)) : layout.tagType;
+    llvm::Value *niche = builder_.CreateAlignedLoad(loadType, nicheAddress, llvm::commonAlignment(alignment, layout.niche.offset), "niche");
+    if (layout.niche.isPointer)
+    {
+        niche = builder_.CreatePtrToInt(niche, layout.tagType);
+    }
+
+    llvm::Value *position = builder_.CreateSub(niche, llvm::ConstantInt::get(layout.tagType, layout.niche.start), "variant");
+    llvm::Value *isOther = builder_.CreateICmpULT(position, llvm::ConstantInt::get(layout.tagType, others));
+    return builder_.CreateSelect(isOther, position, llvm::ConstantInt::get(layout.tagType, others), "tag");
+}
+
+llvm::Value *CodeGenLLVM_Module::getVariantPayloadAddress(llvm::Value *address, const CodeGenLLVM_EnumLayout &layout)
+{
+    if (layout.kind == CodeGenLLVM_EnumLayout::Kind::Tagged)
+    {
+        return builder_.CreateStructGEP(layout.type->getLLVMType(), address, layout.payloadElement, "payload");
+    }
+    // the payload of a niche layout is the whole enum.
+    return address;
+}
+
 std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileExpr(OptionalScopePtr scope, ASTNodePtr nodePtr)
 {
     switch (nodePtr->getType())
@@ -58,8 +932,29 @@ std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileExpr(OptionalScop
         return compileStringLiteral(nodePtr);
     case ASTNode::NodeType::BoolLiteral:
         return compileBoolLiteral(nodePtr);
+    case ASTNode::NodeType::Identifier:
+        return compileIdentifier(scope, nodePtr);
+    case ASTNode::NodeType::BinaryExpression:
+        return compileBinaryExpression(scope, nodePtr);
+    case ASTNode::NodeType::UnaryExpression:
+        return compileUnaryExpression(scope, nodePtr);
+    case ASTNode::NodeType::AssignmentExpression:
+        return compileAssignment(scope, nodePtr);
+    case ASTNode::NodeType::ConditionalExpression:
+        return compileConditionalExpression(scope, nodePtr);
+    case ASTNode::NodeType::CastExpression:
+        return compileCastExpression(scope, nodePtr);
+    case ASTNode::NodeType::FunctionCall:
+        return compileFunctionCall(scope, nodePtr);
+    case ASTNode::NodeType::FieldAccess:
+    case ASTNode::NodeType::PointerFieldAccess:
+        return compileFieldAccess(scope, nodePtr);
+    case ASTNode::NodeType::StructInitialization:
+        return compileStructInitialization(scope, nodePtr);
+    case ASTNode::NodeType::IndexAccess:
+        return compileIndexAccess(scope, nodePtr);
     default:
-        std::cerr << "(Error) Unknown expression type." << std::endl;
-        exit(1);
+        DISPLAY_DIAG_AT(nodePtr, "Expression is not supported by code generation yet.");
+        return nullptr;
     }
-}
\ No newline at end of file
+}
@@ -3,57 +3,77 @@
 #include "codegen_llvm/compiler.hpp"
 #include "codegen_llvm/types.hpp"
 #include "codegen_llvm/diag.hpp"
+#include "semantic/declaration.hpp"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Type.h"
+#include "llvm/IR/CFG.h"
+#include "llvm/IR/Instructions.h"
 
 #define DEFAULT_FUNCTION_LINKAGE llvm::GlobalValue::LinkageTypes::InternalLinkage
 
-void CodeGenLLVM_Module::compileFunctionDefinition(ASTNodePtr node)
+// Functions nothing outside the module can call use fastcc, which lets LLVM
+// pass more arguments in registers and drop the C convention's callee-saved
+// spills. Anything C can see, varargs and main keep the C convention.
+static bool canUseFastCallingConv(const llvm::Function *func)
 {
-    Scope *scope = new Scope();
+    return func->hasLocalLinkage() && !func->isVarArg() && func->getName() != "main";
+}
 
-    ASTFunctionDefinition *funcDef = static_cast<ASTFunctionDefinition *>(node);
-    std::string funcName = static_cast<ASTIdentifier *>(funcDef->getExpr())->getName();
-    ASTFunctionParameters params = funcDef->getParameters();
-    std::optional<ASTStorageClassSpecifier> storageClass = funcDef->getStorageClassSpecifier();
-    ASTStatementList *body = static_cast<ASTStatementList *>(funcDef->getBody());
-    bool exported = false;
+llvm::FunctionType *CodeGenLLVM_Module::compileFunctionType(const semantic::Type *funcType, ASTNodePtr nodePtr)
+{
+    llvm::Type *returnType = compileType(funcType->getReturnType(), nodePtr)->getLLVMType();
 
-    if (funcTable_.find(funcName) != funcTable_.end())
+    // references are passed as the address of the object.
+    std::vector<llvm::Type *> paramTypes;
+    for (const semantic::Type *paramType : funcType->getParamTypes())
     {
-        // funcDef->getLineNumber()
-        DISPLAY_DIAG(1, "Function '" + funcName + "' is already defined in this module.");
+        paramTypes.push_back(compileType(paramType, nodePtr)->getLLVMType());
     }
 
-    llvm::Type *returnType;
-    if (funcDef->getReturnType().has_value())
+    return llvm::FunctionType::get(returnType, paramTypes, funcType->isVariadic());
+}
+
+// Declare every function before any body is compiled, so calls can refer to
+// functions defined further down and to themselves.
+void CodeGenLLVM_Module::declareFunction(ASTNodePtr node)
+{
+    ASTIdentifier *funcName = nullptr;
+    ASTAccessSpecifier accessSpecifier = ASTAccessSpecifier::Default;
+    std::optional<ASTStorageClassSpecifier> storageClass;
+    const ASTFunctionParameters *params = nullptr;
+
+    if (node->getType() == ASTNode::NodeType::FunctionDeclaration)
     {
-        std::shared_ptr<CodeGenLLVM_Type> codegenType = compileType(funcDef->getReturnType().value());
-        returnType = codegenType->getLLVMType();
+        ASTFunctionDeclaration *funcDecl = static_cast<ASTFunctionDeclaration *>(node);
+        funcName = static_cast<ASTIdentifier *>(funcDecl->getExpr());
+        accessSpecifier = funcDecl->getAccessSpecifier();
+        storageClass = funcDecl->getStorageClassSpecifier();
+        params = &funcDecl->getParameters();
     }
     else
     {
-        returnType = llvm::Type::getVoidTy(context_);
+        ASTFunctionDefinition *funcDef = static_cast<ASTFunctionDefinition *>(node);
+        funcName = static_cast<ASTIdentifier *>(funcDef->getExpr());
+        accessSpecifier = funcDef->getAccessSpecifier();
+        storageClass = funcDef->getStorageClassSpecifier();
+        params = &funcDef->getParameters();
     }
 
-    // Function parameters
-    std::vector<llvm::Type *> paramTypes;
-    bool isVariadic = false;
+    llvm::FunctionType *funcType = compileFunctionType(node->getSemanticType(), node);
+    llvm::Function *func = llvm::Function::Create(funcType, DEFAULT_FUNCTION_LINKAGE, funcName->getName(), module_.get());
+    bool exported = false;
 
     // Function linkage
 
-    if (storageClass.has_value() && storageClass.value() == ASTStorageClassSpecifier::Extern)
+    if (node->getType() == ASTNode::NodeType::FunctionDeclaration)
     {
-        DISPLAY_DIAG(funcDef->getLineNumber(), "Function definition cannot get an extern storage class.");
+        // an extern function is defined in another module or in C.
+        func->setLinkage(llvm::GlobalValue::LinkageTypes::ExternalLinkage);
     }
-
-    llvm::FunctionType *funcType = llvm::FunctionType::get(returnType, paramTypes, isVariadic);
-    llvm::Function *func = llvm::Function::Create(funcType, DEFAULT_FUNCTION_LINKAGE, funcName, module_.get());
-
-    if (storageClass.has_value() && storageClass.value() == ASTStorageClassSpecifier::Inline)
+    else if (storageClass.has_value() && storageClass.value() == ASTStorageClassSpecifier::Inline)
     {
-        if (funcDef->getAccessSpecifier() == ASTAccessSpecifier::Public)
+        if (accessSpecifier == ASTAccessSpecifier::Public)
         {
             func->setLinkage(llvm::GlobalValue::LinkageTypes::AvailableExternallyLinkage);
         }
@@ -64,25 +84,170 @@ void CodeGenLLVM_Module::compileFunctionDefinition(ASTNodePtr node)
 
         func->addFnAttr(llvm::Attribute::AlwaysInline);
     }
-    else if (funcDef->getAccessSpecifier() == ASTAccessSpecifier::Public)
+    else if (accessSpecifier == ASTAccessSpecifier::Public)
     {
         exported = true;
         func->setLinkage(llvm::GlobalValue::LinkageTypes::ExternalLinkage);
     }
 
+    // Cyrus has no exceptions, and C functions do not unwind either.
+    func->setDoesNotThrow();
+    if (canUseFastCallingConv(func))
+    {
+        func->setCallingConv(llvm::CallingConv::Fast);
+    }
+
+    for (std::size_t i = 0; i < params->getList().size(); ++i)
+    {
+        func->getArg(i)->setName(params->getList()[i].getParamName());
+    }
+
+    // add to func table
+    funcTable_[funcName->getSymbol()] = FuncTableItem(func, *params, exported);
+}
+
+void CodeGenLLVM_Module::compileFunctionDefinition(ASTNodePtr node)
+{
+    ASTFunctionDefinition *funcDef = static_cast<ASTFunctionDefinition *>(node);
+    Symbol funcName = static_cast<ASTIdentifier *>(funcDef->getExpr())->getSymbol();
+    const std::vector<ASTFunctionParameter> &params = funcDef->getParameters().getList();
+    ASTStatementList *body = static_cast<ASTStatementList *>(funcDef->getBody());
+
+    const semantic::Type *semanticType = funcDef->getSemanticType();
+    llvm::Function *func = funcTable_.at(funcName).llvmFunc;
+    llvm::Type *returnType = func->getReturnType();
+
     // Construct function body
 
     llvm::BasicBlock *entryBlock = llvm::BasicBlock::Create(context_, "entry", func);
     builder_.SetInsertPoint(entryBlock);
+    allocaInsertPoint_ = new llvm::BitCastInst(llvm::UndefValue::get(builder_.getInt32Ty()), builder_.getInt32Ty(), "allocapt", entryBlock);
+
+    // Parameters are spilled to entry allocas like any other local, so they can
+    // be assigned to; mem2reg turns the ones that never are back into the
+    // incoming SSA values.
+    Scope scope;
+    for (std::size_t i = 0; i < params.size(); ++i)
+    {
+        const ASTFunctionParameter &param = params[i];
+        std::shared_ptr<CodeGenLLVM_Type> paramType = compileType(semanticType->getParamTypes()[i], funcDef);
+        llvm::AllocaInst *alloca = createZeroInitializedAlloca(param.getParamName() + ".addr", paramType, func->getArg(i), funcDef->getLineNumber());
 
-    compileStmts(scope, body->getStatements());
+        auto value = std::make_shared<CodeGenLLVM_Value>(alloca, typeTable_.getPointerType(paramType));
+        scope.setRecord(param.getParamSymbol(), std::make_shared<CodeGenLLVM_EValue>(value, CodeGenLLVM_EValue::ValueCategory::LValue));
+    }
 
-    // TODO
-    // Track block termination for function.
-    // But before achieve this functionality, add function to func_table.
+    returnType_ = semanticType->getReturnType();
+    compileStmts(&scope, body->getStatements());
 
-    // add to func table
-    funcTable_[funcName] = FuncTableItem(func, params, exported);
+    // falling off the end of the body.
+    if (!isBlockTerminated())
+    {
+        llvm::BasicBlock *lastBlock = builder_.GetInsertBlock();
+        if (lastBlock != entryBlock && llvm::pred_empty(lastBlock))
+        {
+            builder_.CreateUnreachable();
+        }
+        else if (returnType->isVoidTy())
+        {
+            builder_.CreateRetVoid();
+        }
+        else if (funcName.str() == "main")
+        {
+            // like in C, main returns 0 when it ends without a return.
+            builder_.CreateRet(llvm::Constant::getNullValue(returnType));
+        }
+        else
+        {
+            // the analyzer has checked that every path returns a value.
+            builder_.CreateUnreachable();
+        }
+    }
+
+    allocaInsertPoint_->eraseFromParent();
+    allocaInsertPoint_ = nullptr;
+}
+
+// Arguments passed through `...` get the C default argument promotions, so C
+// functions like printf read them back with va_arg as they expect.
+llvm::Value *CodeGenLLVM_Module::promoteVariadicArgument(llvm::Value *value, const semantic::Type *type)
+{
+    llvm::Type *llvmType = value->getType();
+
+    if (llvmType->isHalfTy() || llvmType->isFloatTy())
+    {
+        return builder_.CreateFPExt(value, builder_.getDoubleTy());
+    }
+    if (llvmType->isIntegerTy() && llvmType->getIntegerBitWidth() < 32)
+    {
+        return builder_.CreateIntCast(value, builder_.getInt32Ty(), type->getUnqualified()->isSigned());
+    }
+    return value;
+}
+
+std::shared_ptr<CodeGenLLVM_EValue> CodeGenLLVM_Module::compileFunctionCall(OptionalScopePtr scope, ASTNodePtr nodePtr)
+{
+    ASTFunctionCall *call = static_cast<ASTFunctionCall *>(nodePtr);
+
+    // `Enum.Variant(...)` builds a variant with a payload.
+    if (call->getExpr()->getType() == ASTNode::NodeType::FieldAccess)
+    {
+        const ASTFieldAccess *fieldAccess = static_cast<ASTFieldAccess *>(call->getExpr());
+        if (fieldAccess->getOperand()->getSemanticType()->getUnqualified()->is(semantic::Type::Kind::Enum))
+        {
+            return compileEnumVariant(scope, fieldAccess, call->getArguments());
+        }
+    }
+
+    if (call->getExpr()->getType() != ASTNode::NodeType::Identifier)
+    {
+        DISPLAY_DIAG_AT(call, "Only functions called by name are supported by code generation yet.");
+        return nullptr;
+    }
+
+    // calls are always direct, the analyzer resolved the callee to a function of this module.
+    ASTIdentifier *callee = static_cast<ASTIdentifier *>(call->getExpr());
+    const FuncTableItem &function = funcTable_.at(callee->getSymbol());
+    const semantic::Type *funcType = callee->getDeclaration()->type;
+    const std::vector<const semantic::Type *> &paramTypes = funcType->getParamTypes();
+    const std::vector<ASTNodePtr> &arguments = call->getArguments();
+
+    std::vector<llvm::Value *> values;
+    for (std::size_t i = 0; i < paramTypes.size(); ++i)
+    {
+        // parameters left out take their default value, evaluated at the call.
+        ASTNodePtr argument = i < arguments.size() ? arguments[i] : function.params.getList()[i].getDefaultValue();
+
+        if (paramTypes[i]->is(semantic::Type::Kind::Reference))
+        {
+            values.push_back(compileExpr(scope, argument)->asValue()->getLLVMValue());
+        }
+        else
+        {
+            values.push_back(compileRValue(scope, argument, paramTypes[i])->getLLVMValue());
+        }
+    }
+
+    const std::optional<ASTTypeSpecifier *> &variadicType = function.params.getTypedVariadic();
+    for (std::size_t i = paramTypes.size(); i < arguments.size(); ++i)
+    {
+        const semantic::Type *type = variadicType.has_value() ? variadicType.value()->getSemanticType() : arguments[i]->getSemanticType();
+        llvm::Value *value = compileRValue(scope, arguments[i], type)->getLLVMValue();
+        values.push_back(promoteVariadicArgument(value, type));
+    }
+
+    llvm::CallInst *result = builder_.CreateCall(function.llvmFunc, values);
+    result->setCallingConv(function.llvmFunc->getCallingConv());
+
+    std::shared_ptr<CodeGenLLVM_Type> returnType = compileType(funcType->getReturnType(), call);
+
+    // a reference is returned as the address of the object.
+    if (funcType->getReturnType()->is(semantic::Type::Kind::Reference))
+    {
+        auto valPtr = std::make_shared<CodeGenLLVM_Value>(result, typeTable_.getPointerType(returnType->getNestedType()));
+        return std::make_shared<CodeGenLLVM_EValue>(valPtr, CodeGenLLVM_EValue::ValueCategory::LValue);
+    }
 
-    delete scope;
-}
\ No newline at end of file
+    auto valPtr = std::make_shared<CodeGenLLVM_Value>(result, returnType);
+    return std::make_shared<CodeGenLLVM_EValue>(valPtr, CodeGenLLVM_EValue::ValueCategory::RValue);
+}
@@ -0,0 +1,109 @@
+#include <iostream>
+#include "util/util.hpp"
+#include "util/diagnostics.hpp"
+#include "parser/parser.hpp"
+#include "semantic/analyzer.hpp"
+#include "codegen_llvm/compiler.hpp"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include "llvm/Support/Error.h"
+
+static void exitOnJITError(llvm::Error error)
+{
+    if (error)
+    {
+        std::cerr << "(Error) JIT: " << llvm::toString(std::move(error)) << std::endl;
+        exit(1);
+    }
+}
+
+int run_codegen_llvm(CodeGenLLVM_Options opts)
+{
+    if (!opts.getInputFile().has_value())
+    {
+        std::cerr << "(Error) Only a single source file can be executed." << std::endl;
+        exit(1);
+    }
+
+    CodeGenLLVM_Context context(opts.getOptimizationLevel());
+
+    std::string filePath = opts.getInputFile().value();
+    util::DiagnosticEngine diagnostics(opts.getErrorLimit());
+    auto [fileContent, program] = parseProgram(filePath, diagnostics);
+    diagnostics.exitOnErrors();
+
+    semantic::Module semanticModule;
+    semantic::analyzeProgram(program, semanticModule, fileContent, diagnostics);
+    diagnostics.exitOnErrors();
+
+    std::string moduleName = util::getFileNameWithStem(filePath);
+    util::isValidModuleName(moduleName, filePath);
+    CodeGenLLVM_Module *module = context.createModule(moduleName, filePath, fileContent, diagnostics);
+
+    module->buildProgramIR(program);
+
+    llvm::Function *mainFunc = module->getModule()->getFunction("main");
+    if (!mainFunc || mainFunc->isDeclaration())
+    {
+        std::cerr << "(Error) Function 'main' is not defined in '" << filePath << "'." << std::endl;
+        exit(1);
+    }
+
+    // functions are internal unless exported, but the JIT can only look up external symbols.
+    // do this before optimizing so the pipeline does not drop an unreferenced main.
+    mainFunc->setLinkage(llvm::GlobalValue::LinkageTypes::ExternalLinkage);
+
+    context.optimizeModule(module, opts);
+
+    return context.runModuleJIT(moduleName, module);
+}
+
+int CodeGenLLVM_Context::runModuleJIT(const std::string &moduleName, CodeGenLLVM_Module *module)
+{
+    llvm::Function *mainFunc = module->getModule()->getFunction("main");
+    bool mainReturnsInt = mainFunc->getReturnType()->isIntegerTy(32);
+
+    // the JIT owns both the module and the context it was built in from here on.
+    std::unique_ptr<llvm::Module> llvmModule = module->releaseModule();
+    removeModule(moduleName);
+    llvm::orc::ThreadSafeModule threadSafeModule(std::move(llvmModule), llvm::orc::ThreadSafeContext(releaseContext()));
+
+    auto jitOrError = llvm::orc::LLLazyJITBuilder().create();
+    if (!jitOrError)
+    {
+        exitOnJITError(jitOrError.takeError());
+    }
+    std::unique_ptr<llvm::orc::LLLazyJIT> jit = std::move(jitOrError.get());
+
+    // resolve calls into libc and the rest of the host process.
+    auto processSymbols = llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(jit->getDataLayout().getGlobalPrefix());
+    if (!processSymbols)
+    {
+        exitOnJITError(processSymbols.takeError());
+    }
+    jit->getMainJITDylib().addGenerator(std::move(processSymbols.get()));
+
+    // addLazyIRModule only emits stubs; each function body is compiled the first time it is called.
+    exitOnJITError(jit->addLazyIRModule(std::move(threadSafeModule)));
+    exitOnJITError(jit->initialize(jit->getMainJITDylib()));
+
+    auto mainAddress = jit->lookup("main");
+    if (!mainAddress)
+    {
+        exitOnJITError(mainAddress.takeError());
+    }
+
+    int exitCode = 0;
+    if (mainReturnsInt)
+    {
+        exitCode = mainAddress->toPtr<int (*)()>()();
+    }
+    else
+    {
+        mainAddress->toPtr<void (*)()>()();
+    }
+
+    exitOnJITError(jit->deinitialize(jit->getMainJITDylib()));
+    return exitCode;
+}
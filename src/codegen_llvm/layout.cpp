@@ -0,0 +1,480 @@
+#include <algorithm>
+#include <sstream>
+#include "codegen_llvm/compiler.hpp"
+#include "codegen_llvm/layout.hpp"
+#include "semantic/types.hpp"
+#include "llvm/IR/DataLayout.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/Support/MathExtras.h"
+
+namespace
+{
+    // Appends elements to the body of an llvm::StructType, each at an offset
+    // we chose, padding explicitly wherever LLVM would place it elsewhere.
+    class ElementPlacer
+    {
+    private:
+        const llvm::DataLayout &dataLayout_;
+        llvm::Type *byteType_;
+        bool packed_;
+        std::vector<llvm::Type *> elements_;
+        std::uint64_t offset_ = 0;
+        // the alignment LLVM gives the struct by itself.
+        std::uint64_t llvmAlignment_ = 1;
+
+    public:
+        ElementPlacer(const llvm::DataLayout &dataLayout, llvm::Type *byteType, bool packed)
+            : dataLayout_(dataLayout), byteType_(byteType), packed_(packed) {}
+
+        // Place `type` at the next multiple of `alignment`. Returns its element index.
+        unsigned place(llvm::Type *type, std::uint64_t alignment, std::uint64_t &offset)
+        {
+            std::uint64_t abiAlignment = packed_ ? 1 : dataLayout_.getABITypeAlign(type).value();
+            offset = llvm::alignTo(offset_, alignment);
+
+            if (offset != llvm::alignTo(offset_, abiAlignment))
+            {
+                elements_.push_back(llvm::ArrayType::get(byteType_, offset - offset_));
+            }
+
+            elements_.push_back(type);
+            offset_ = offset + dataLayout_.getTypeAllocSize(type);
+            llvmAlignment_ = std::max(llvmAlignment_, abiAlignment);
+            return elements_.size() - 1;
+        }
+
+        // Pad the tail to a multiple of `alignment`. Returns the size.
+        std::uint64_t finish(std::uint64_t alignment)
+        {
+            std::uint64_t size = llvm::alignTo(offset_, alignment);
+            if (size != llvm::alignTo(offset_, llvmAlignment_))
+            {
+                elements_.push_back(llvm::ArrayType::get(byteType_, size - offset_));
+            }
+            return size;
+        }
+
+        const std::vector<llvm::Type *> &getElements() const { return elements_; }
+    };
+} // namespace
+
+// Fields are placed one after the other, each at the next offset that is a
+// multiple of its alignment, the way C does it. On top of that:
+//
+//  - `packed` drops the alignment of every field to one, so there is no padding.
+//  - `align(N)` raises the alignment of the struct, and its size to a multiple of N.
+//  - `reorder` places the fields by decreasing alignment. Every size is a
+//    multiple of its alignment, so this leaves no holes between fields.
+//  - `soa(N)` replaces every field with a column of N of them. With `align`,
+//    each column starts on that alignment, so loops over a column can use
+//    aligned vector loads.
+//
+// LLVM pads an element up to its ABI alignment on its own; anything beyond
+// that, which only happens for fields of an over-aligned struct type and for
+// the tail of an over-aligned struct, becomes an explicit byte array.
+const CodeGenLLVM_StructLayout &CodeGenLLVM_Module::getStructLayout(const semantic::Type *structType, ASTNodePtr nodePtr)
+{
+    structType = structType->getUnqualified();
+    auto found = structLayouts_.find(structType);
+    if (found != structLayouts_.end())
+    {
+        return found->second;
+    }
+
+    // the struct is registered before its fields are lowered, so a field can point back to it.
+    llvm::StructType *llvmType = llvm::StructType::create(context_, "struct." + structType->getName().str());
+    CodeGenLLVM_StructLayout &layout = structLayouts_[structType];
+    layout.structType = structType;
+    layout.type = typeTable_.createStructType(llvmType);
+    layout.soaCapacity = structType->getLayout().soaCapacity;
+    layoutOrder_.push_back(structType);
+
+    const semantic::Type::Layout &attributes = structType->getLayout();
+    const llvm::DataLayout &dataLayout = module_->getDataLayout();
+    const std::vector<semantic::Type::Field> &fields = structType->getFields();
+
+    std::vector<llvm::Type *> fieldTypes;
+    std::vector<unsigned> order;
+    for (unsigned i = 0; i < fields.size(); ++i)
+    {
+        llvm::Type *fieldType = compileType(fields[i].type, nodePtr)->getLLVMType();
+        std::uint64_t alignment = attributes.packed ? 1 : getTypeAlignment(fieldType).value();
+        if (attributes.soaCapacity)
+        {
+            fieldType = llvm::ArrayType::get(fieldType, attributes.soaCapacity);
+            alignment = std::max(alignment, attributes.alignment);
+        }
+
+        fieldTypes.push_back(fieldType);
+        layout.fields.push_back(CodeGenLLVM_StructLayout::Field{fields[i].name, fields[i].type, 0, 0, dataLayout.getTypeAllocSize(fieldType), alignment});
+        order.push_back(i);
+    }
+
+    // the sort is stable, so fields of the same alignment keep their declared order.
+    if (attributes.reorder)
+    {
+        std::stable_sort(order.begin(), order.end(), [&layout](unsigned lhs, unsigned rhs)
+                         { return layout.fields[lhs].alignment > layout.fields[rhs].alignment; });
+    }
+
+    ElementPlacer placer(dataLayout, builder_.getInt8Ty(), attributes.packed);
+    for (unsigned index : order)
+    {
+        CodeGenLLVM_StructLayout::Field &field = layout.fields[index];
+        field.element = placer.place(fieldTypes[index], field.alignment, field.offset);
+        layout.alignment = std::max(layout.alignment, field.alignment);
+    }
+
+    layout.alignment = std::max(layout.alignment, attributes.alignment);
+    layout.size = placer.finish(layout.alignment);
+    typeAlignments_[llvmType] = layout.alignment;
+
+    llvmType->setBody(placer.getElements(), attributes.packed);
+    return layout;
+}
+
+llvm::Align CodeGenLLVM_Module::getTypeAlignment(llvm::Type *type)
+{
+    auto found = typeAlignments_.find(type);
+    if (found != typeAlignments_.end())
+    {
+        return llvm::Align(found->second);
+    }
+    return module_->getDataLayout().getABITypeAlign(type);
+}
+
+// An enum without payloads is an integer holding the tag of its variant, the
+// narrowest one that fits every discriminant. Tags count from the first
+// variant, whose tag is 0, so zero-initialized memory always holds a valid
+// value: an enum declared without an initializer is its first variant. With
+// payloads there are two layouts:
+//
+//  - When only one variant has a payload and some value inside it is never
+//    held (a null reference, a spare tag of a nested enum), the other
+//    variants are stored as those values. The enum is then exactly as
+//    large as the payload, like an optional reference in Rust.
+//  - Otherwise a tag is followed by storage for the largest payload. The
+//    storage is an array of integers as wide as its alignment, so LLVM sees
+//    no padding inside it; each variant views it through its own struct type.
+const CodeGenLLVM_EnumLayout &CodeGenLLVM_Module::getEnumLayout(const semantic::Type *enumType, ASTNodePtr nodePtr)
+{
+    enumType = enumType->getUnqualified();
+    auto found = enumLayouts_.find(enumType);
+    if (found != enumLayouts_.end())
+    {
+        return found->second;
+    }
+
+    const std::vector<semantic::Type::Variant> &variants = enumType->getVariants();
+    const llvm::DataLayout &dataLayout = module_->getDataLayout();
+    std::string name = "enum." + enumType->getName().str();
+
+    CodeGenLLVM_EnumLayout &layout = enumLayouts_[enumType];
+    layout.enumType = enumType;
+    layout.variants.resize(variants.size());
+    layoutOrder_.push_back(enumType);
+
+    std::int64_t minimum = 0;
+    std::int64_t maximum = 0;
+    std::vector<unsigned> dataful;
+    for (unsigned i = 0; i < variants.size(); ++i)
+    {
+        minimum = i == 0 ? variants[i].discriminant : std::min(minimum, variants[i].discriminant);
+        maximum = i == 0 ? variants[i].discriminant : std::max(maximum, variants[i].discriminant);
+        if (!variants[i].payload.empty())
+        {
+            dataful.push_back(i);
+        }
+    }
+
+    // the tag only has to tell the discriminants apart, so its width follows their range.
+    std::uint64_t range = static_cast<std::uint64_t>(maximum) - static_cast<std::uint64_t>(minimum);
+    unsigned tagBits = 8;
+    while (tagBits < 64 && range > llvm::maxUIntN(tagBits))
+    {
+        tagBits *= 2;
+    }
+    layout.tagType = llvm::IntegerType::get(context_, tagBits);
+
+    std::uint64_t first = variants.empty() ? 0 : static_cast<std::uint64_t>(variants.front().discriminant);
+    for (unsigned i = 0; i < variants.size(); ++i)
+    {
+        layout.variants[i].caseValue = (static_cast<std::uint64_t>(variants[i].discriminant) - first) & llvm::maxUIntN(tagBits);
+    }
+
+    // tags past the largest discriminant, wrapping around to the smallest, are never held.
+    std::optional<CodeGenLLVM_Niche> tagNiche;
+    std::uint64_t spare = llvm::maxUIntN(tagBits) - range;
+    if (spare > 0)
+    {
+        std::uint64_t start = (static_cast<std::uint64_t>(maximum) - first + 1) & llvm::maxUIntN(tagBits);
+        tagNiche = CodeGenLLVM_Niche{0, tagBits, false, start, spare};
+    }
+
+    if (dataful.empty())
+    {
+        layout.kind = CodeGenLLVM_EnumLayout::Kind::Tag;
+        layout.type = typeTable_.createEnumType(layout.tagType);
+        layout.size = dataLayout.getTypeAllocSize(layout.tagType);
+        layout.alignment = dataLayout.getABITypeAlign(layout.tagType).value();
+        layout.spareNiche = tagNiche;
+        return layout;
+    }
+
+    // the enum is registered before the payloads are lowered, so a payload can point back to it.
+    llvm::StructType *llvmType = llvm::StructType::create(context_, name);
+    layout.type = typeTable_.createEnumType(llvmType);
+
+    // place the payload of each variant on its own, and find the largest niche inside it.
+    std::vector<std::vector<llvm::Type *>> payloadBodies(variants.size());
+    std::optional<CodeGenLLVM_Niche> payloadNiche;
+    for (unsigned i : dataful)
+    {
+        CodeGenLLVM_EnumLayout::Variant &variant = layout.variants[i];
+        ElementPlacer placer(dataLayout, builder_.getInt8Ty(), false);
+
+        for (const semantic::Type *itemType : variants[i].payload)
+        {
+            llvm::Type *llvmItemType = compileType(itemType, nodePtr)->getLLVMType();
+            std::uint64_t alignment = getTypeAlignment(llvmItemType).value();
+            std::uint64_t offset = 0;
+            variant.elements.push_back(placer.place(llvmItemType, alignment, offset));
+            variant.alignment = std::max(variant.alignment, alignment);
+
+            std::optional<CodeGenLLVM_Niche> itemNiche = dataful.size() == 1 ? getTypeNiche(itemType, nodePtr) : std::nullopt;
+            if (itemNiche.has_value() && (!payloadNiche.has_value() || itemNiche->count > payloadNiche->count))
+            {
+                itemNiche->offset += offset;
+                payloadNiche = itemNiche;
+            }
+        }
+
+        variant.size = placer.finish(variant.alignment);
+        payloadBodies[i] = placer.getElements();
+    }
+
+    std::uint64_t others = variants.size() - dataful.size();
+    if (dataful.size() == 1 && (others == 0 || (payloadNiche.has_value() && payloadNiche->count >= others)))
+    {
+        layout.kind = CodeGenLLVM_EnumLayout::Kind::Niche;
+        layout.dataful = dataful.front();
+        CodeGenLLVM_EnumLayout::Variant &payload = layout.variants[layout.dataful];
+
+        // the other variants are numbered in order, the dataful one comes after them.
+        std::uint64_t position = 0;
+        for (unsigned i = 0; i < variants.size(); ++i)
+        {
+            layout.variants[i].caseValue = i == layout.dataful ? others : position++;
+        }
+
+        if (payloadNiche.has_value())
+        {
+            layout.niche = *payloadNiche;
+            if (payloadNiche->count > others)
+            {
+                layout.spareNiche = CodeGenLLVM_Niche{payloadNiche->offset, payloadNiche->bits, payloadNiche->isPointer,
+                                                      payloadNiche->start + others, payloadNiche->count - others};
+            }
+        }
+        layout.tagType = llvm::IntegerType::get(context_, std::max(8u, layout.niche.bits));
+
+        llvmType->setBody(payloadBodies[layout.dataful]);
+        payload.payloadType = llvmType;
+        layout.size = payload.size;
+        layout.alignment = payload.alignment;
+        typeAlignments_[llvmType] = layout.alignment;
+        return layout;
+    }
+
+    layout.kind = CodeGenLLVM_EnumLayout::Kind::Tagged;
+    layout.spareNiche = tagNiche;
+
+    std::uint64_t storageSize = 0;
+    std::uint64_t storageAlignment = 1;
+    for (unsigned i : dataful)
+    {
+        CodeGenLLVM_EnumLayout::Variant &variant = layout.variants[i];
+        variant.payloadType = llvm::StructType::create(context_, payloadBodies[i], name + "." + variants[i].name.str());
+        typeAlignments_[variant.payloadType] = variant.alignment;
+        storageSize = std::max(storageSize, variant.size);
+        storageAlignment = std::max(storageAlignment, variant.alignment);
+    }
+    storageSize = llvm::alignTo(storageSize, storageAlignment);
+
+    // LLVM only keeps integers of the right width at their natural alignment;
+    // for any other width the placer pads the byte array instead.
+    llvm::Type *storageType = llvm::ArrayType::get(builder_.getInt8Ty(), storageSize);
+    if (storageAlignment <= 16)
+    {
+        llvm::Type *wordType = llvm::IntegerType::get(context_, storageAlignment * 8);
+        if (dataLayout.getABITypeAlign(wordType).value() == storageAlignment)
+        {
+            storageType = llvm::ArrayType::get(wordType, storageSize / storageAlignment);
+        }
+    }
+
+    ElementPlacer placer(dataLayout, builder_.getInt8Ty(), false);
+    std::uint64_t tagOffset = 0;
+    placer.place(layout.tagType, dataLayout.getABITypeAlign(layout.tagType).value(), tagOffset);
+    layout.payloadElement = placer.place(storageType, storageAlignment, layout.payloadOffset);
+
+    layout.alignment = std::max(dataLayout.getABITypeAlign(layout.tagType).value(), storageAlignment);
+    layout.size = placer.finish(layout.alignment);
+    llvmType->setBody(placer.getElements());
+    typeAlignments_[llvmType] = layout.alignment;
+    return layout;
+}
+
+// Niches come from references and from the spare tags of enums. A reference
+// is never null, the analyzer rejects memory holding one that starts out
+// zero, so its niche is that single value. Its misaligned values are not
+// used: the alignment of the referee needs its layout, which may be the one
+// being computed. Raw pointers have no niche, a cast gives them any value,
+// null included. Booleans have none either: LLVM keeps only their lowest bit
+// when copying them.
+std::optional<CodeGenLLVM_Niche> CodeGenLLVM_Module::getTypeNiche(const semantic::Type *type, ASTNodePtr nodePtr)
+{
+    type = type->getUnqualified();
+    switch (type->getKind())
+    {
+    case semantic::Type::Kind::Reference:
+        return CodeGenLLVM_Niche{0, module_->getDataLayout().getPointerSizeInBits(), true, 0, 1};
+    case semantic::Type::Kind::Struct:
+    {
+        const CodeGenLLVM_StructLayout &layout = getStructLayout(type, nodePtr);
+        if (layout.soaCapacity)
+        {
+            return std::nullopt;
+        }
+
+        std::optional<CodeGenLLVM_Niche> best;
+        for (const CodeGenLLVM_StructLayout::Field &field : layout.fields)
+        {
+            std::optional<CodeGenLLVM_Niche> niche = getTypeNiche(field.type, nodePtr);
+            if (niche.has_value() && (!best.has_value() || niche->count > best->count))
+            {
+                niche->offset += field.offset;
+                best = niche;
+            }
+        }
+        return best;
+    }
+    case semantic::Type::Kind::Enum:
+        return getEnumLayout(type, nodePtr).spareNiche;
+    default:
+        return std::nullopt;
+    }
+}
+
+static void printEnumLayout(std::ostream &report, const CodeGenLLVM_EnumLayout &layout)
+{
+    report << "enum " << layout.enumType->getName() << ": size " << layout.size << ", align " << layout.alignment << ", ";
+    switch (layout.kind)
+    {
+    case CodeGenLLVM_EnumLayout::Kind::Tag:
+        report << "tag i" << layout.tagType->getBitWidth() << "\n";
+        break;
+    case CodeGenLLVM_EnumLayout::Kind::Tagged:
+        report << "tag i" << layout.tagType->getBitWidth() << " at 0, payload at "
+               << layout.payloadOffset << "\n";
+        break;
+    case CodeGenLLVM_EnumLayout::Kind::Niche:
+        report << "no tag, other variants in the niche of " << layout.enumType->getVariants()[layout.dataful].name
+               << " at offset " << layout.niche.offset << "\n";
+        break;
+    }
+
+    const std::vector<semantic::Type::Variant> &variants = layout.enumType->getVariants();
+    for (std::size_t i = 0; i < variants.size(); ++i)
+    {
+        const CodeGenLLVM_EnumLayout::Variant &variant = layout.variants[i];
+        report << "    " << variants[i].name << " = " << static_cast<std::int64_t>(variant.caseValue);
+        if (variant.payloadType)
+        {
+            report << " (payload size " << variant.size << ", align " << variant.alignment << ")";
+        }
+        report << "\n";
+    }
+}
+
+std::string CodeGenLLVM_Module::getLayoutReport() const
+{
+    std::ostringstream report;
+
+    for (const semantic::Type *layoutType : layoutOrder_)
+    {
+        auto enumLayout = enumLayouts_.find(layoutType);
+        if (enumLayout != enumLayouts_.end())
+        {
+            printEnumLayout(report, enumLayout->second);
+            continue;
+        }
+
+        const semantic::Type *structType = layoutType;
+        const CodeGenLLVM_StructLayout &layout = structLayouts_.at(structType);
+        const semantic::Type::Layout &attributes = structType->getLayout();
+
+        std::vector<std::string> attributeNames;
+        if (attributes.packed)
+        {
+            attributeNames.push_back("packed");
+        }
+        if (attributes.alignment)
+        {
+            attributeNames.push_back("align(" + std::to_string(attributes.alignment) + ")");
+        }
+        if (attributes.soaCapacity)
+        {
+            attributeNames.push_back("soa(" + std::to_string(attributes.soaCapacity) + ")");
+        }
+        if (attributes.reorder)
+        {
+            attributeNames.push_back("reorder");
+        }
+
+        report << "struct " << structType->getName();
+        for (std::size_t i = 0; i < attributeNames.size(); ++i)
+        {
+            report << (i == 0 ? " [[" : ", ") << attributeNames[i] << (i + 1 == attributeNames.size() ? "]]" : "");
+        }
+
+        std::uint64_t padding = layout.getPadding();
+        report << ": size " << layout.size << ", align " << layout.alignment << ", " << padding << " bytes of padding";
+        if (layout.size != 0)
+        {
+            report << " (" << padding * 100 / layout.size << "%)";
+        }
+        report << "\n";
+
+        // fields in memory order, with the holes between them.
+        std::vector<const CodeGenLLVM_StructLayout::Field *> fields;
+        for (const CodeGenLLVM_StructLayout::Field &field : layout.fields)
+        {
+            fields.push_back(&field);
+        }
+        std::stable_sort(fields.begin(), fields.end(), [](const auto *lhs, const auto *rhs)
+                         { return lhs->offset < rhs->offset; });
+
+        std::uint64_t end = 0;
+        for (const CodeGenLLVM_StructLayout::Field *field : fields)
+        {
+            if (field->offset > end)
+            {
+                report << "    " << end << ": hole of " << field->offset - end << " bytes\n";
+            }
+            report << "    " << field->offset << ": " << field->name << " ";
+            if (layout.soaCapacity)
+            {
+                report << "column of " << layout.soaCapacity << " ";
+            }
+            report << field->type->toString() << " (size " << field->size << ", align " << field->alignment << ")\n";
+            end = field->offset + field->size;
+        }
+
+        if (layout.size > end)
+        {
+            report << "    " << end << ": tail padding of " << layout.size - end << " bytes\n";
+        }
+    }
+    return report.str();
+}
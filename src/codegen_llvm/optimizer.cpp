@@ -0,0 +1,76 @@
+#include <iostream>
+#include "codegen_llvm/compiler.hpp"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Passes/OptimizationLevel.h"
+#include "llvm/Support/Error.h"
+
+llvm::CodeGenOptLevel CodeGenLLVM_Context::getCodeGenOptLevel(CodeGenLLVM_OptimizationLevel optimizationLevel)
+{
+    switch (optimizationLevel)
+    {
+    case CodeGenLLVM_OptimizationLevel::O0:
+        return llvm::CodeGenOptLevel::None;
+    case CodeGenLLVM_OptimizationLevel::O1:
+        return llvm::CodeGenOptLevel::Less;
+    case CodeGenLLVM_OptimizationLevel::O3:
+        return llvm::CodeGenOptLevel::Aggressive;
+    default:
+        return llvm::CodeGenOptLevel::Default;
+    }
+}
+
+static llvm::OptimizationLevel getPassBuilderLevel(CodeGenLLVM_OptimizationLevel optimizationLevel)
+{
+    switch (optimizationLevel)
+    {
+    case CodeGenLLVM_OptimizationLevel::O0:
+        return llvm::OptimizationLevel::O0;
+    case CodeGenLLVM_OptimizationLevel::O1:
+        return llvm::OptimizationLevel::O1;
+    case CodeGenLLVM_OptimizationLevel::O2:
+        return llvm::OptimizationLevel::O2;
+    case CodeGenLLVM_OptimizationLevel::O3:
+        return llvm::OptimizationLevel::O3;
+    case CodeGenLLVM_OptimizationLevel::Os:
+        return llvm::OptimizationLevel::Os;
+    }
+    return llvm::OptimizationLevel::O0;
+}
+
+void CodeGenLLVM_Context::optimizeModule(CodeGenLLVM_Module *module, const CodeGenLLVM_Options &opts)
+{
+    // -O0 without a custom pipeline leaves the module exactly as IRBuilder produced it.
+    if (opts.getOptimizationLevel() == CodeGenLLVM_OptimizationLevel::O0 && !opts.getPassPipeline().has_value())
+    {
+        return;
+    }
+
+    llvm::LoopAnalysisManager loopAnalysisManager;
+    llvm::FunctionAnalysisManager functionAnalysisManager;
+    llvm::CGSCCAnalysisManager cgsccAnalysisManager;
+    llvm::ModuleAnalysisManager moduleAnalysisManager;
+
+    // passing the target machine lets the pipeline use target-specific cost models.
+    llvm::PassBuilder passBuilder(targetMachine_);
+    passBuilder.registerModuleAnalyses(moduleAnalysisManager);
+    passBuilder.registerCGSCCAnalyses(cgsccAnalysisManager);
+    passBuilder.registerFunctionAnalyses(functionAnalysisManager);
+    passBuilder.registerLoopAnalyses(loopAnalysisManager);
+    passBuilder.crossRegisterProxies(loopAnalysisManager, functionAnalysisManager, cgsccAnalysisManager, moduleAnalysisManager);
+
+    llvm::ModulePassManager modulePassManager;
+    if (opts.getPassPipeline().has_value())
+    {
+        if (llvm::Error error = passBuilder.parsePassPipeline(modulePassManager, opts.getPassPipeline().value()))
+        {
+            std::cerr << "(Error) Invalid pass pipeline '" << opts.getPassPipeline().value() << "': " << llvm::toString(std::move(error)) << std::endl;
+            exit(1);
+        }
+    }
+    else
+    {
+        modulePassManager = passBuilder.buildPerModuleDefaultPipeline(getPassBuilderLevel(opts.getOptimizationLevel()));
+    }
+
+    modulePassManager.run(*module->getModule(), moduleAnalysisManager);
+}
@@ -1,16 +1,48 @@
 #include "ast/ast.hpp"
 #include "codegen_llvm/compiler.hpp"
 #include "codegen_llvm/scope.hpp"
+#include "codegen_llvm/diag.hpp"
+#include "semantic/constant.hpp"
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/CFG.h>
 
-void CodeGenLLVM_Module::compileStmt(OptionalScopePtr scope, ASTNodePtr nodePtr)
+void CodeGenLLVM_Module::compileStmt(OptionalScopePtr scopeOpt, ASTNodePtr nodePtr)
 {
     switch (nodePtr->getType())
     {
     case ASTNode::NodeType::VariableDeclaration:
-        compileVariableDeclaration(scope, nodePtr);
+        compileVariableDeclaration(scopeOpt, nodePtr);
+        break;
+    case ASTNode::NodeType::StatementList:
+    {
+        ASTStatementList *block = static_cast<ASTStatementList *>(nodePtr);
+        SCOPE_REQUIRED(block->getLineNumber());
+        SCOPE->pushLevel();
+        compileStmts(scopeOpt, block->getStatements());
+        SCOPE->popLevel();
+        break;
+    }
+    case ASTNode::NodeType::IfStatement:
+        compileIfStatement(scopeOpt, nodePtr);
+        break;
+    case ASTNode::NodeType::ForStatement:
+        compileForStatement(scopeOpt, nodePtr);
+        break;
+    case ASTNode::NodeType::SwitchStatement:
+        compileSwitchStatement(scopeOpt, nodePtr);
+        break;
+    case ASTNode::NodeType::ReturnStatement:
+        compileReturnStatement(scopeOpt, nodePtr);
+        break;
+    case ASTNode::NodeType::BreakStatement:
+        builder_.CreateBr(loops_.back().breakBlock);
+        break;
+    case ASTNode::NodeType::ContinueStatement:
+        builder_.CreateBr(loops_.back().continueBlock);
         break;
     default:
+        // an expression evaluated for its side effects.
+        compileExpr(scopeOpt, nodePtr);
         break;
     }
 }
@@ -19,6 +51,283 @@ void CodeGenLLVM_Module::compileStmts(OptionalScopePtr scope, ASTNodeList nodeLi
 {
     for (auto &&statement : nodeList)
     {
+        // statements after a return, break or continue can never run.
+        if (isBlockTerminated())
+        {
+            break;
+        }
         compileStmt(scope, statement);
     }
-}
\ No newline at end of file
+}
+
+bool CodeGenLLVM_Module::isBlockTerminated()
+{
+    return builder_.GetInsertBlock()->getTerminator() != nullptr;
+}
+
+// A branch that is not a block still gets a level of its own, like in the analyzer.
+void CodeGenLLVM_Module::compileBranch(OptionalScopePtr scopeOpt, ASTNodePtr nodePtr, llvm::BasicBlock *nextBlock)
+{
+    SCOPE->pushLevel();
+    compileStmt(scopeOpt, nodePtr);
+    SCOPE->popLevel();
+
+    if (!isBlockTerminated())
+    {
+        builder_.CreateBr(nextBlock);
+    }
+}
+
+void CodeGenLLVM_Module::compileIfStatement(OptionalScopePtr scopeOpt, ASTNodePtr nodePtr)
+{
+    ASTIfStatement *ifStmt = static_cast<ASTIfStatement *>(nodePtr);
+    SCOPE_REQUIRED(ifStmt->getLineNumber());
+    llvm::Function *func = builder_.GetInsertBlock()->getParent();
+
+    llvm::Value *condition = compileCondition(scopeOpt, ifStmt->getCondition());
+    llvm::BasicBlock *thenBlock = llvm::BasicBlock::Create(context_, "if.then", func);
+    llvm::BasicBlock *elseBlock = nullptr;
+    llvm::BasicBlock *endBlock = llvm::BasicBlock::Create(context_, "if.end", func);
+
+    if (ifStmt->getElseBranch().has_value())
+    {
+        elseBlock = llvm::BasicBlock::Create(context_, "if.else", func, endBlock);
+        builder_.CreateCondBr(condition, thenBlock, elseBlock);
+    }
+    else
+    {
+        builder_.CreateCondBr(condition, thenBlock, endBlock);
+    }
+
+    builder_.SetInsertPoint(thenBlock);
+    compileBranch(scopeOpt, ifStmt->getThenBranch(), endBlock);
+
+    if (elseBlock)
+    {
+        builder_.SetInsertPoint(elseBlock);
+        compileBranch(scopeOpt, ifStmt->getElseBranch().value(), endBlock);
+    }
+
+    // when every branch leaves the function or the loop, nothing follows the if.
+    if (llvm::pred_empty(endBlock))
+    {
+        endBlock->eraseFromParent();
+        return;
+    }
+    builder_.SetInsertPoint(endBlock);
+}
+
+// Loops are emitted in the shape LLVM's loop passes expect: the block before
+// the loop falls into a single header, the body jumps to a single latch that
+// holds the increment and branches back, and `break` leaves through one exit.
+//
+//     preheader -> for.cond -> for.body -> for.inc -> for.cond
+//                     \-> for.end
+void CodeGenLLVM_Module::compileForStatement(OptionalScopePtr scopeOpt, ASTNodePtr nodePtr)
+{
+    ASTForStatement *forStmt = static_cast<ASTForStatement *>(nodePtr);
+    SCOPE_REQUIRED(forStmt->getLineNumber());
+    llvm::Function *func = builder_.GetInsertBlock()->getParent();
+
+    // the loop variable is visible in the header and the body only.
+    SCOPE->pushLevel();
+
+    if (forStmt->getInitializer().has_value() && forStmt->getInitializer().value())
+    {
+        compileStmt(scopeOpt, forStmt->getInitializer().value());
+    }
+
+    llvm::BasicBlock *headerBlock = llvm::BasicBlock::Create(context_, "for.cond", func);
+    llvm::BasicBlock *bodyBlock = llvm::BasicBlock::Create(context_, "for.body", func);
+    llvm::BasicBlock *latchBlock = llvm::BasicBlock::Create(context_, "for.inc", func);
+    llvm::BasicBlock *exitBlock = llvm::BasicBlock::Create(context_, "for.end", func);
+
+    builder_.CreateBr(headerBlock);
+    builder_.SetInsertPoint(headerBlock);
+
+    if (forStmt->getCondition().has_value() && forStmt->getCondition().value())
+    {
+        llvm::Value *condition = compileCondition(scopeOpt, forStmt->getCondition().value());
+        builder_.CreateCondBr(condition, bodyBlock, exitBlock);
+    }
+    else
+    {
+        builder_.CreateBr(bodyBlock);
+    }
+
+    builder_.SetInsertPoint(bodyBlock);
+    loops_.push_back(LoopTargets{latchBlock, exitBlock});
+    compileBranch(scopeOpt, forStmt->getBody(), latchBlock);
+    loops_.pop_back();
+
+    builder_.SetInsertPoint(latchBlock);
+    if (forStmt->getIncrement().has_value() && forStmt->getIncrement().value())
+    {
+        compileExpr(scopeOpt, forStmt->getIncrement().value());
+    }
+    builder_.CreateBr(headerBlock);
+
+    SCOPE->popLevel();
+    builder_.SetInsertPoint(exitBlock);
+}
+
+// `Enum.Variant` in a case label, on its own or as `Enum.Variant(a, b)`.
+static const ASTFieldAccess *getLabelVariant(ASTNodePtr label)
+{
+    if (label->getType() == ASTNode::NodeType::FunctionCall)
+    {
+        label = static_cast<ASTFunctionCall *>(label)->getExpr();
+    }
+    return static_cast<ASTFieldAccess *>(label);
+}
+
+// All cases hang off one LLVM switch, which the backend turns into a jump
+// table when the values are dense and into a tree of compares otherwise.
+// There is no fallthrough: every case ends by jumping past the switch.
+//
+//     switch -> switch.case ... -> switch.end
+//            -> switch.default or switch.end
+void CodeGenLLVM_Module::compileSwitchStatement(OptionalScopePtr scopeOpt, ASTNodePtr nodePtr)
+{
+    ASTSwitchStatement *switchStmt = static_cast<ASTSwitchStatement *>(nodePtr);
+    SCOPE_REQUIRED(switchStmt->getLineNumber());
+    llvm::Function *func = builder_.GetInsertBlock()->getParent();
+
+    const semantic::Type *subjectType = switchStmt->getSubject()->getSemanticType();
+    if (subjectType->is(semantic::Type::Kind::Reference))
+    {
+        subjectType = subjectType->getElementType();
+    }
+    subjectType = subjectType->getUnqualified();
+
+    // an enum is switched on in memory, the case values and payloads are read from it.
+    const CodeGenLLVM_EnumLayout *layout = nullptr;
+    llvm::Value *subjectAddress = nullptr;
+    llvm::Value *condition = nullptr;
+    if (subjectType->is(semantic::Type::Kind::Enum))
+    {
+        layout = &getEnumLayout(subjectType, switchStmt);
+        subjectAddress = compileAddress(scopeOpt, switchStmt->getSubject(), layout->type, switchStmt->getLineNumber());
+        condition = compileEnumCaseValue(subjectAddress, *layout);
+    }
+    else
+    {
+        condition = compileRValue(scopeOpt, switchStmt->getSubject(), subjectType)->getLLVMValue();
+    }
+
+    const std::vector<ASTSwitchCase> &cases = switchStmt->getCases();
+    llvm::BasicBlock *endBlock = llvm::BasicBlock::Create(context_, "switch.end", func);
+    llvm::BasicBlock *defaultBlock = endBlock;
+    std::vector<llvm::BasicBlock *> caseBlocks;
+    std::size_t coveredVariants = 0;
+
+    for (const ASTSwitchCase &switchCase : cases)
+    {
+        caseBlocks.push_back(llvm::BasicBlock::Create(context_, switchCase.isDefault() ? "switch.default" : "switch.case", func, endBlock));
+        if (switchCase.isDefault())
+        {
+            defaultBlock = caseBlocks.back();
+        }
+        coveredVariants += switchCase.getLabels().size();
+    }
+
+    // every variant has a case, so no other value can reach the default.
+    if (layout && defaultBlock == endBlock && coveredVariants == layout->variants.size())
+    {
+        defaultBlock = llvm::BasicBlock::Create(context_, "switch.unreachable", func, endBlock);
+        llvm::IRBuilder<> unreachableBuilder(defaultBlock);
+        unreachableBuilder.CreateUnreachable();
+    }
+
+    llvm::SwitchInst *switchInst = builder_.CreateSwitch(condition, defaultBlock, coveredVariants);
+    for (std::size_t i = 0; i < cases.size(); ++i)
+    {
+        for (ASTNodePtr label : cases[i].getLabels())
+        {
+            llvm::ConstantInt *value = nullptr;
+            if (layout)
+            {
+                const CodeGenLLVM_EnumLayout::Variant &variant = layout->variants[getLabelVariant(label)->getFieldIndex()];
+                value = llvm::ConstantInt::get(layout->tagType, variant.caseValue);
+            }
+            else
+            {
+                // the analyzer already checked that every label folds.
+                semantic::ConstantEvaluator evaluator;
+                value = llvm::cast<llvm::ConstantInt>(compileConstant(evaluator.evaluate(label, subjectType).value()));
+            }
+            switchInst->addCase(value, caseBlocks[i]);
+        }
+    }
+
+    for (std::size_t i = 0; i < cases.size(); ++i)
+    {
+        const ASTSwitchCase &switchCase = cases[i];
+        builder_.SetInsertPoint(caseBlocks[i]);
+        SCOPE->pushLevel();
+
+        // `case Enum.Variant(a, b):` copies the payload into locals a and b.
+        if (layout && switchCase.getLabels().size() == 1 && switchCase.getLabels().front()->getType() == ASTNode::NodeType::FunctionCall)
+        {
+            ASTFunctionCall *pattern = static_cast<ASTFunctionCall *>(switchCase.getLabels().front());
+            unsigned index = getLabelVariant(pattern)->getFieldIndex();
+            const CodeGenLLVM_EnumLayout::Variant &variant = layout->variants[index];
+            const std::vector<const semantic::Type *> &payload = subjectType->getVariants()[index].payload;
+            llvm::Value *payloadAddress = getVariantPayloadAddress(subjectAddress, *layout);
+
+            for (std::size_t j = 0; j < pattern->getArguments().size(); ++j)
+            {
+                ASTIdentifier *name = static_cast<ASTIdentifier *>(pattern->getArguments()[j]);
+                std::shared_ptr<CodeGenLLVM_Type> itemType = compileType(payload[j], name);
+                llvm::Value *itemAddress = builder_.CreateStructGEP(variant.payloadType, payloadAddress, variant.elements[j]);
+                llvm::Value *item = builder_.CreateLoad(itemType->getLLVMType(), itemAddress, name->getName());
+                llvm::AllocaInst *alloca = createZeroInitializedAlloca(name->getName(), itemType, item, switchCase.getLineNumber());
+
+                auto value = std::make_shared<CodeGenLLVM_Value>(alloca, typeTable_.getPointerType(itemType));
+                SCOPE->setRecord(name->getSymbol(), std::make_shared<CodeGenLLVM_EValue>(value, CodeGenLLVM_EValue::ValueCategory::LValue));
+            }
+        }
+
+        // `break` leaves the switch, `continue` still goes to the enclosing loop.
+        loops_.push_back(LoopTargets{loops_.empty() ? nullptr : loops_.back().continueBlock, endBlock});
+        if (switchCase.getBody())
+        {
+            compileBranch(scopeOpt, switchCase.getBody(), endBlock);
+        }
+        else
+        {
+            builder_.CreateBr(endBlock);
+        }
+        loops_.pop_back();
+        SCOPE->popLevel();
+    }
+
+    // when every case leaves the function or the loop, nothing follows the switch.
+    if (llvm::pred_empty(endBlock))
+    {
+        endBlock->eraseFromParent();
+        return;
+    }
+    builder_.SetInsertPoint(endBlock);
+}
+
+void CodeGenLLVM_Module::compileReturnStatement(OptionalScopePtr scopeOpt, ASTNodePtr nodePtr)
+{
+    ASTReturnStatement *returnStmt = static_cast<ASTReturnStatement *>(nodePtr);
+
+    if (!returnStmt->getExpr().has_value())
+    {
+        builder_.CreateRetVoid();
+        return;
+    }
+
+    ASTNodePtr value = returnStmt->getExpr().value();
+
+    // a reference is returned as the address of the object.
+    if (returnType_->is(semantic::Type::Kind::Reference))
+    {
+        builder_.CreateRet(compileExpr(scopeOpt, value)->asValue()->getLLVMValue());
+        return;
+    }
+    builder_.CreateRet(compileRValue(scopeOpt, value, returnType_)->getLLVMValue());
+}
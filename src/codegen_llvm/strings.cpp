@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <vector>
+#include "codegen_llvm/compiler.hpp"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/GlobalVariable.h"
+
+// Every literal with the same contents is emitted once. Nothing can compare
+// the addresses of literals, so they are unnamed_addr: LLVM puts them in a
+// mergeable string section of the object file, where the linker also folds
+// the copies of other modules.
+llvm::Constant *CodeGenLLVM_Module::getStringConstant(const std::string &value)
+{
+    auto found = strings_.find(value);
+    if (found != strings_.end())
+    {
+        return found->second;
+    }
+
+    llvm::Constant *data = llvm::ConstantDataArray::getString(context_, value, true);
+    llvm::GlobalVariable *global = new llvm::GlobalVariable(
+        *module_,
+        data->getType(),
+        true,
+        llvm::GlobalValue::PrivateLinkage,
+        data,
+        ".str");
+    global->setAlignment(llvm::Align(1));
+    global->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+
+    strings_.emplace(value, global);
+    return global;
+}
+
+// A literal that ends another one, like "world" in "hello world", becomes a
+// pointer into the longer one. Sorted by their reversed contents, a string
+// comes right before the strings it ends, so one pass finds them all.
+void CodeGenLLVM_Module::mergeStringSuffixes()
+{
+    struct Entry
+    {
+        std::string reversed;
+        llvm::GlobalVariable *global;
+    };
+
+    std::vector<Entry> entries;
+    for (const auto &[value, global] : strings_)
+    {
+        entries.push_back(Entry{std::string(value.rbegin(), value.rend()), global});
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry &lhs, const Entry &rhs)
+              { return lhs.reversed < rhs.reversed; });
+
+    // the longest string each one ends, which holds the bytes of both.
+    std::vector<const Entry *> owners(entries.size());
+    for (std::size_t i = entries.size(); i-- > 0;)
+    {
+        bool isSuffix = i + 1 < entries.size() && entries[i + 1].reversed.starts_with(entries[i].reversed);
+        owners[i] = isSuffix ? owners[i + 1] : &entries[i];
+    }
+
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        if (owners[i] == &entries[i])
+        {
+            continue;
+        }
+
+        std::uint64_t offset = owners[i]->reversed.size() - entries[i].reversed.size();
+        llvm::Constant *tail = llvm::ConstantExpr::getInBoundsGetElementPtr(
+            builder_.getInt8Ty(), owners[i]->global, builder_.getInt64(offset));
+        entries[i].global->replaceAllUsesWith(tail);
+        entries[i].global->eraseFromParent();
+    }
+    strings_.clear();
+}
@@ -2,78 +2,175 @@
 #include "ast/ast.hpp"
 #include "codegen_llvm/compiler.hpp"
 #include "codegen_llvm/types.hpp"
+#include "codegen_llvm/diag.hpp"
+#include "semantic/types.hpp"
 #include <llvm/IR/IRBuilder.h>
 #include "llvm/IR/Type.h"
 
-std::shared_ptr<CodeGenLLVM_Type> CodeGenLLVM_Module::compileType(ASTNodePtr node)
+CodeGenLLVM_TypeTable::CodeGenLLVM_TypeTable(llvm::LLVMContext &context)
 {
-    ASTTypeSpecifier *typeSpecifier = static_cast<ASTTypeSpecifier *>(node);
-    switch (typeSpecifier->getTypeValue())
+    auto add = [this](llvm::Type *llvmType, TypeKind kind)
     {
-    case ASTTypeSpecifier::ASTInternalType::Int:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getInt32Ty(context_), CodeGenLLVM_Type::TypeKind::Int);
-    case ASTTypeSpecifier::ASTInternalType::Int8:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getInt8Ty(context_), CodeGenLLVM_Type::TypeKind::Int8);
-    case ASTTypeSpecifier::ASTInternalType::Int16:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getInt16Ty(context_), CodeGenLLVM_Type::TypeKind::Int16);
-    case ASTTypeSpecifier::ASTInternalType::Int32:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getInt32Ty(context_), CodeGenLLVM_Type::TypeKind::Int32);
-    case ASTTypeSpecifier::ASTInternalType::Int64:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getInt64Ty(context_), CodeGenLLVM_Type::TypeKind::Int64);
-    case ASTTypeSpecifier::ASTInternalType::Int128:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getInt128Ty(context_), CodeGenLLVM_Type::TypeKind::Int128);
-    case ASTTypeSpecifier::ASTInternalType::UInt:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getInt32Ty(context_), CodeGenLLVM_Type::TypeKind::UInt);
-    case ASTTypeSpecifier::ASTInternalType::UInt8:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getInt8Ty(context_), CodeGenLLVM_Type::TypeKind::UInt8);
-    case ASTTypeSpecifier::ASTInternalType::UInt16:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getInt16Ty(context_), CodeGenLLVM_Type::TypeKind::UInt16);
-    case ASTTypeSpecifier::ASTInternalType::UInt32:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getInt32Ty(context_), CodeGenLLVM_Type::TypeKind::UInt32);
-    case ASTTypeSpecifier::ASTInternalType::UInt64:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getInt64Ty(context_), CodeGenLLVM_Type::TypeKind::UInt64);
-    case ASTTypeSpecifier::ASTInternalType::UInt128:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getInt128Ty(context_), CodeGenLLVM_Type::TypeKind::UInt128);
-    case ASTTypeSpecifier::ASTInternalType::Void:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getVoidTy(context_), CodeGenLLVM_Type::TypeKind::Void);
-    case ASTTypeSpecifier::ASTInternalType::Char:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getInt8Ty(context_), CodeGenLLVM_Type::TypeKind::Char);
-    case ASTTypeSpecifier::ASTInternalType::Byte:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getInt8Ty(context_), CodeGenLLVM_Type::TypeKind::Byte);
-    case ASTTypeSpecifier::ASTInternalType::Bool:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getInt1Ty(context_), CodeGenLLVM_Type::TypeKind::Bool);
-    case ASTTypeSpecifier::ASTInternalType::Float32:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getFloatTy(context_), CodeGenLLVM_Type::TypeKind::Float32);
-    case ASTTypeSpecifier::ASTInternalType::Float64:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getDoubleTy(context_), CodeGenLLVM_Type::TypeKind::Float64);
-    case ASTTypeSpecifier::ASTInternalType::Float128:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getFP128Ty(context_), CodeGenLLVM_Type::TypeKind::Float128);
-    case ASTTypeSpecifier::ASTInternalType::Pointer:
+        primitives_[static_cast<std::size_t>(kind)] = std::make_shared<CodeGenLLVM_Type>(llvmType, kind);
+    };
+
+    add(llvm::Type::getInt8Ty(context), TypeKind::Int8);
+    add(llvm::Type::getInt16Ty(context), TypeKind::Int16);
+    add(llvm::Type::getInt32Ty(context), TypeKind::Int32);
+    add(llvm::Type::getInt64Ty(context), TypeKind::Int64);
+    add(llvm::Type::getInt128Ty(context), TypeKind::Int128);
+    add(llvm::Type::getInt8Ty(context), TypeKind::UInt8);
+    add(llvm::Type::getInt16Ty(context), TypeKind::UInt16);
+    add(llvm::Type::getInt32Ty(context), TypeKind::UInt32);
+    add(llvm::Type::getInt64Ty(context), TypeKind::UInt64);
+    add(llvm::Type::getInt128Ty(context), TypeKind::UInt128);
+    add(llvm::Type::getInt32Ty(context), TypeKind::Int);
+    add(llvm::Type::getInt32Ty(context), TypeKind::UInt);
+    add(llvm::Type::getFloatTy(context), TypeKind::Float32);
+    add(llvm::Type::getDoubleTy(context), TypeKind::Float64);
+    add(llvm::Type::getFP128Ty(context), TypeKind::Float128);
+    add(llvm::Type::getInt8Ty(context), TypeKind::Char);
+    add(llvm::Type::getInt8Ty(context), TypeKind::Byte);
+    add(llvm::Type::getInt1Ty(context), TypeKind::Bool);
+    add(llvm::Type::getVoidTy(context), TypeKind::Void);
+    add(llvm::PointerType::getUnqual(context), TypeKind::String);
+}
+
+const std::shared_ptr<CodeGenLLVM_Type> &CodeGenLLVM_TypeTable::getDerivedType(const std::shared_ptr<CodeGenLLVM_Type> &base, TypeKind kind)
+{
+    auto &slot = derived_[DerivedKey{base.get(), kind}];
+    if (!slot)
     {
-        auto pointeeType = compileType(typeSpecifier->getInner());
-        return CodeGenLLVM_Type::createPointerType(pointeeType);
+        slot = std::make_shared<CodeGenLLVM_Type>(base, kind);
     }
-    case ASTTypeSpecifier::ASTInternalType::Reference:
+    return slot;
+}
+
+const std::shared_ptr<CodeGenLLVM_Type> &CodeGenLLVM_TypeTable::getPointerType(const std::shared_ptr<CodeGenLLVM_Type> &pointee)
+{
+    return getDerivedType(pointee, TypeKind::Pointer);
+}
+
+const std::shared_ptr<CodeGenLLVM_Type> &CodeGenLLVM_TypeTable::getReferenceType(const std::shared_ptr<CodeGenLLVM_Type> &pointee)
+{
+    return getDerivedType(pointee, TypeKind::Reference);
+}
+
+const std::shared_ptr<CodeGenLLVM_Type> &CodeGenLLVM_TypeTable::getConstType(const std::shared_ptr<CodeGenLLVM_Type> &type)
+{
+    if (type->isConst())
     {
-        auto pointeeType = compileType(typeSpecifier->getInner());
-        return CodeGenLLVM_Type::createReferenceType(pointeeType);
+        return type;
     }
-    case ASTTypeSpecifier::ASTInternalType::Const:
+
+    auto &slot = constVariants_[type.get()];
+    if (!slot)
     {
-        auto innerType = compileType(typeSpecifier->getInner());
-        innerType->setConst();
-        return innerType;
+        if (auto nested = type->getNestedType())
+        {
+            slot = std::make_shared<CodeGenLLVM_Type>(nested, type->getKind(), true);
+        }
+        else
+        {
+            slot = std::make_shared<CodeGenLLVM_Type>(type->getLLVMType(), type->getKind(), true);
+        }
     }
-    case ASTTypeSpecifier::ASTInternalType::String:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::PointerType::getUnqual(context_), CodeGenLLVM_Type::TypeKind::String);
-    case ASTTypeSpecifier::ASTInternalType::Identifier:
+    return slot;
+}
+
+std::shared_ptr<CodeGenLLVM_Type> CodeGenLLVM_Module::compileType(ASTNodePtr node)
+{
+    return compileType(node->getSemanticType(), node);
+}
+
+std::shared_ptr<CodeGenLLVM_Type> CodeGenLLVM_Module::compileType(const semantic::Type *type, ASTNodePtr node)
+{
+    using Kind = semantic::Type::Kind;
+    std::shared_ptr<CodeGenLLVM_Type> codegenType = nullptr;
+
+    switch (type->getKind())
     {
-        // TODO: Implement identifier lookup in symbol table
-        std::cerr << "Identifier lookup in type compilation not implemented yet." << std::endl;
-        exit(1);
-    }
-    break;
+    case Kind::Int8:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::Int8);
+        break;
+    case Kind::Int16:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::Int16);
+        break;
+    case Kind::Int32:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::Int32);
+        break;
+    case Kind::Int64:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::Int64);
+        break;
+    case Kind::Int128:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::Int128);
+        break;
+    case Kind::UInt8:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::UInt8);
+        break;
+    case Kind::UInt16:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::UInt16);
+        break;
+    case Kind::UInt32:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::UInt32);
+        break;
+    case Kind::UInt64:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::UInt64);
+        break;
+    case Kind::UInt128:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::UInt128);
+        break;
+    case Kind::Int:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::Int);
+        break;
+    case Kind::UInt:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::UInt);
+        break;
+    case Kind::Float32:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::Float32);
+        break;
+    case Kind::Float64:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::Float64);
+        break;
+    case Kind::Float128:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::Float128);
+        break;
+    case Kind::Char:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::Char);
+        break;
+    case Kind::Byte:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::Byte);
+        break;
+    case Kind::Bool:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::Bool);
+        break;
+    case Kind::Void:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::Void);
+        break;
+    case Kind::String:
+        codegenType = typeTable_.getPrimitiveType(CodeGenLLVM_Type::TypeKind::String);
+        break;
+    case Kind::Pointer:
+        codegenType = typeTable_.getPointerType(compileType(type->getElementType(), node));
+        break;
+    case Kind::Reference:
+        codegenType = typeTable_.getReferenceType(compileType(type->getElementType(), node));
+        break;
+    case Kind::Struct:
+        codegenType = getStructLayout(type, node).type;
+        break;
+    case Kind::Enum:
+        codegenType = getEnumLayout(type, node).type;
+        break;
     default:
-        return std::make_shared<CodeGenLLVM_Type>(llvm::Type::getVoidTy(context_), CodeGenLLVM_Type::TypeKind::Void);
+        DISPLAY_DIAG_AT(node, "Type '" + type->toString() + "' is not supported by code generation yet.");
+        break;
+    }
+
+    // const is a qualifier on the semantic type, the codegen type table keeps it as a variant.
+    if (type->isConst())
+    {
+        return typeTable_.getConstType(codegenType);
     }
+    return codegenType;
 }
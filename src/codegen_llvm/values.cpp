@@ -1,6 +1,7 @@
 #include <memory>
 #include "codegen_llvm/values.hpp"
 #include "codegen_llvm/compiler.hpp"
+#include "semantic/constant.hpp"
 
 llvm::Value *CodeGenLLVM_Module::createZeroInitializedValue(std::shared_ptr<CodeGenLLVM_Type> type, std::size_t lineNumber)
 {
@@ -35,7 +36,9 @@ llvm::Value *CodeGenLLVM_Module::createZeroInitializedValue(std::shared_ptr<Code
         return llvm::ConstantPointerNull::get(
             llvm::cast<llvm::PointerType>(type->getLLVMType()));
 
+    // an enum of all zero bits is its first variant, see getEnumLayout.
     case TypeKind::Struct:
+    case TypeKind::Enum:
     case TypeKind::Function:
         return llvm::Constant::getNullValue(type->getLLVMType());
 
@@ -55,3 +58,12 @@ llvm::Value *CodeGenLLVM_Module::createZeroInitializedValue(std::shared_ptr<Code
         return nullptr;
     }
 }
+
+llvm::Constant *CodeGenLLVM_Module::compileConstant(const semantic::ConstantValue &value)
+{
+    if (value.isInteger())
+    {
+        return llvm::ConstantInt::get(context_, value.getInteger());
+    }
+    return llvm::ConstantFP::get(context_, value.getFloat());
+}
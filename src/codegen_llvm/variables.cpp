@@ -5,155 +5,102 @@
 #include "codegen_llvm/scope.hpp"
 #include "codegen_llvm/types.hpp"
 #include "codegen_llvm/values.hpp"
+#include "codegen_llvm/diag.hpp"
+#include "semantic/constant.hpp"
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/GlobalVariable.h>
 #include <llvm/IR/Instructions.h>
 
-llvm::GlobalVariable *createStringForGlobalVariable(
-    ASTNodePtr initializer,
-    llvm::LLVMContext &context_,
-    std::unique_ptr<llvm::Module> &module_);
-
 void CodeGenLLVM_Module::compileGlobalVariableDeclaration(ASTNodePtr node)
 {
     ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(node);
     ASTAccessSpecifier accessSpecifier = varDecl->getAccessSpecifier();
-    std::string varName = varDecl->getName();
+    Symbol varName = varDecl->getSymbol();
 
-    std::shared_ptr<CodeGenLLVM_EValue> initializer = nullptr;
+    llvm::Constant *constantInitializer = nullptr;
     std::shared_ptr<CodeGenLLVM_Type> codegenType = nullptr;
     llvm::GlobalValue::LinkageTypes linkage = llvm::GlobalValue::InternalLinkage;
     bool isConstType = false;
 
-    if (globalVarTable_.find(varName) != globalVarTable_.end())
-    {
-        DISPLAY_DIAG(varDecl->getLineNumber(), "Global variable '" + varName + "' is already defined in this module.");
-    }
-
-    if (varDecl->getTypeValue().has_value())
-    {
-        ASTTypeSpecifier *varType = static_cast<ASTTypeSpecifier *>(varDecl->getTypeValue().value());
-        codegenType = compileType(varType);
-        isConstType = codegenType->isConst();
-    }
+    // the analyzer has already resolved the type, from the specifier or the initializer.
+    codegenType = compileType(varDecl);
+    isConstType = codegenType->isConst();
 
     if (varDecl->getInitializer().has_value())
     {
-        // cannot use `CreateGlobalStringPtr` to create a string literal
-        // because it will be a global variable, not a string literal
-        // that is why we override string construction here.
+        // the variable holds the address of the pooled literal.
         if (varDecl->getInitializer().value()->getType() == ASTNode::NodeType::StringLiteral)
         {
-            // constInit = createStringForGlobalVariable(varDecl->getInitializer().value(), context_, module_);
-            // codegenType = compileType(varDecl->getInitializer().value());
-            // FIXME
+            constantInitializer = getStringConstant(static_cast<ASTStringLiteral *>(varDecl->getInitializer().value())->getValue());
         }
         else
         {
-            initializer = compileExpr(std::nullopt, varDecl->getInitializer().value());
-        }
-    }
-
-    if (!varDecl->getTypeValue().has_value())
-    {
-        if (initializer)
-        {
-            // determine variable type from initializer
-            codegenType = initializer->asValue()->getValueType();
-            isConstType = codegenType->isConst();
-        }
-        else
-        {
-            DISPLAY_DIAG(varDecl->getLineNumber(), "Global variable type is not specified and initializer is not a constant.");
+            // the analyzer has checked that the initializer folds, so no code runs before main.
+            semantic::ConstantEvaluator evaluator;
+            std::optional<semantic::ConstantValue> value = evaluator.evaluate(varDecl->getInitializer().value(), varDecl->getSemanticType());
+            if (!value.has_value())
+            {
+                DISPLAY_DIAG_AT(evaluator.getErrorNode(), evaluator.getError());
+            }
+            constantInitializer = compileConstant(value.value());
         }
     }
 
     bool exported = false;
 
-    if (accessSpecifier == ASTAccessSpecifier::Default || accessSpecifier == ASTAccessSpecifier::Private)
-    {
-        linkage = llvm::GlobalValue::InternalLinkage;
-    }
-    else if (accessSpecifier == ASTAccessSpecifier::Public)
+    if (accessSpecifier == ASTAccessSpecifier::Public)
     {
         exported = true;
         linkage = llvm::GlobalValue::ExternalLinkage;
     }
-    else
-    {
-        DISPLAY_DIAG(varDecl->getLineNumber(), "Unsupported access specifier for global variable: " + formatAccessSpecifier(accessSpecifier));
-    }
 
-    if (varDecl->getStorageClassSpecifier().has_value())
+    // an extern variable is only declared here, another module defines it.
+    bool isExtern = varDecl->isExtern();
+    if (isExtern)
     {
-        ASTStorageClassSpecifier storageClassSpecifier = varDecl->getStorageClassSpecifier().value();
-
-        if (storageClassSpecifier == ASTStorageClassSpecifier::Extern)
-        {
-            if (initializer != nullptr)
-            {
-                DISPLAY_DIAG(varDecl->getLineNumber(), "Extern storage class specifier cannot have an initializer.");
-            }
-
-            linkage = llvm::GlobalValue::ExternalLinkage;
-        }
-        else if (storageClassSpecifier == ASTStorageClassSpecifier::Inline)
-        {   
-            DISPLAY_DIAG(varDecl->getLineNumber(), "Inline storage class specifier is not supported for global variables.");
-        }
+        linkage = llvm::GlobalValue::ExternalLinkage;
     }
 
-    llvm::Value *valueInitializer = nullptr;
-    if (initializer)
+    if (!constantInitializer && !isExtern)
     {
-        valueInitializer = initializer->asValue()->getLLVMValue();
-    }
-    else
-    {
-        valueInitializer = createZeroInitializedValue(codegenType, varDecl->getLineNumber());
+        constantInitializer = llvm::cast<llvm::Constant>(createZeroInitializedValue(codegenType, varDecl->getLineNumber()));
     }
 
-    llvm::Constant *constantInitializer = llvm::dyn_cast<llvm::Constant>(valueInitializer);
-    if (!constantInitializer)
+    auto threadLocalMode = llvm::GlobalVariable::ThreadLocalMode::NotThreadLocal;
+    if (varDecl->isThreadLocal())
     {
-        DISPLAY_DIAG(varDecl->getLineNumber(), "Global variable initializer is not a constant.");
+        threadLocalMode = getThreadLocalMode(!isExtern);
     }
 
-    // REVIEW Consider to make it smarter when adding multi-threading features.
-    auto threadLocalMode = llvm::GlobalVariable::ThreadLocalMode::NotThreadLocal;
-
     llvm::GlobalVariable *globalVar = new llvm::GlobalVariable(
         *module_,
         codegenType->getLLVMType(),
         isConstType,
         linkage,
         constantInitializer,
-        varName,
+        varName.str(),
         nullptr,
         threadLocalMode,
         0);
+    // an `align(N)` struct asks for more than the ABI alignment of its type.
+    globalVar->setAlignment(getTypeAlignment(codegenType->getLLVMType()));
 
     globalVarTable_[varName] = GlobalVarTableItem(globalVar, codegenType, exported);
 }
 
-llvm::GlobalVariable *createStringForGlobalVariable(
-    ASTNodePtr initializer,
-    llvm::LLVMContext &context_,
-    std::unique_ptr<llvm::Module> &module_)
+// An executable reaches its own thread locals at a fixed offset from the
+// thread pointer, and those of the libraries loaded with it through one GOT
+// load. A shared library, like code loaded by the JIT, may arrive after the
+// threads started and asks __tls_get_addr; LLVM relaxes that to one call per
+// function for variables that never leave the library. Objects, assembly and
+// IR are taken to be linked into an executable.
+llvm::GlobalValue::ThreadLocalMode CodeGenLLVM_Module::getThreadLocalMode(bool isDefinition) const
 {
-    ASTStringLiteral *stringLiteral = static_cast<ASTStringLiteral *>(initializer);
-    llvm::Constant *strConstant = llvm::ConstantDataArray::getString(context_, stringLiteral->getValue(), true);
-    llvm::GlobalVariable *strVar = new llvm::GlobalVariable(
-        *module_.get(),
-        strConstant->getType(),
-        true,
-        llvm::GlobalValue::PrivateLinkage,
-        strConstant,
-        ".str");
-
-    strVar->setAlignment(llvm::MaybeAlign(1));
-    strVar->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
-    return strVar;
+    if (!outputKind_.has_value() || outputKind_.value() == CodeGenLLVM_OutputKind::DynamicLibrary)
+    {
+        return llvm::GlobalValue::GeneralDynamicTLSModel;
+    }
+    return isDefinition ? llvm::GlobalValue::LocalExecTLSModel : llvm::GlobalValue::InitialExecTLSModel;
 }
 
 void CodeGenLLVM_Module::compileVariableDeclaration(OptionalScopePtr scopeOpt, ASTNodePtr nodePtr)
@@ -161,52 +108,31 @@ void CodeGenLLVM_Module::compileVariableDeclaration(OptionalScopePtr scopeOpt, A
     ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(nodePtr);
     SCOPE_REQUIRED(varDecl->getLineNumber());
 
-    std::shared_ptr<CodeGenLLVM_Type> codegenType = nullptr;
+    const semantic::Type *varType = varDecl->getSemanticType();
+    std::shared_ptr<CodeGenLLVM_Type> codegenType = compileType(varDecl);
     llvm::AllocaInst *alloca = nullptr;
-    std::shared_ptr<CodeGenLLVM_EValue> initializer = nullptr;
 
-    if (varDecl->getTypeValue().has_value())
+    std::optional<llvm::Value *> initializerValue = std::nullopt;
+    if (varDecl->getInitializer().has_value())
     {
-        ASTTypeSpecifier *varType = static_cast<ASTTypeSpecifier *>(varDecl->getTypeValue().value());
-        codegenType = compileType(varType);
+        ASTNodePtr initializer = varDecl->getInitializer().value();
 
-        if (varDecl->getInitializer().has_value())
+        // a reference is initialized with the address of the object it binds to.
+        if (varType->is(semantic::Type::Kind::Reference))
         {
-            initializer = compileExpr(scopeOpt, varDecl->getInitializer().value());
-        }
-    }
-    else
-    {
-        if (varDecl->getInitializer().has_value())
-        {
-            initializer = compileExpr(scopeOpt, varDecl->getInitializer().value());
-            codegenType = initializer->asValue()->getValueType();
+            initializerValue = compileExpr(scopeOpt, initializer)->asValue()->getLLVMValue();
         }
         else
-        {   
-            DISPLAY_DIAG(varDecl->getLineNumber(), "Variable type is not specified and initializer is not a constant.");
+        {
+            initializerValue = compileRValue(scopeOpt, initializer, varType)->getLLVMValue();
         }
     }
 
-    std::optional<llvm::Value *> initializerValue = std::nullopt;
-    if (initializer)
-    {
-        initializerValue = initializer->asValue()->getLLVMValue();
-    }
-
     alloca = createZeroInitializedAlloca(varDecl->getName(), codegenType, initializerValue, varDecl->getLineNumber());
 
-    // TODO Jump into appropriate block of the function to declare the variable correctly.
-    // builder.SetInsertPoint(&func->getEntryBlock(), func->getEntryBlock().begin());
-
-    if (SCOPE->getRecord(varDecl->getName()).has_value())
-    {   
-        DISPLAY_DIAG(varDecl->getLineNumber(), "Variable '" + varDecl->getName() + "' is already declared in the current scope.");
-    }
-
     // add variable to local scope
-    auto allocaInnerType = CodeGenLLVM_Type::createPointerType(codegenType);
+    auto allocaInnerType = typeTable_.getPointerType(codegenType);
     auto value = std::make_shared<CodeGenLLVM_Value>(alloca, allocaInnerType);
     auto evalue = std::make_shared<CodeGenLLVM_EValue>(value, CodeGenLLVM_EValue::ValueCategory::LValue);
-    SCOPE->setRecord(varDecl->getName(), evalue);
+    SCOPE->setRecord(varDecl->getSymbol(), evalue);
 }
\ No newline at end of file
@@ -1,26 +1,48 @@
-%{
+%code requires {
     #include <variant>
     #include "ast/ast.hpp"
+    #include "util/source_range.hpp"
 
-    char* yyerrormsg;
-    extern int yylineno;
-    int yylex(void);
-    int yyerror(const char *s);
-    extern ASTNode* astProgram = nullptr;
-%}
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void *yyscan_t;
+    #endif
 
-%code requires {
-    #include "ast/ast.hpp"
+    class ParserContext;
 
-    using EnumData = std::variant<ASTEnumVariant, std::pair<std::string, std::optional<ASTNodePtr>>, ASTFunctionDefinition>;
+    using EnumData = std::variant<ASTEnumVariant, std::pair<Symbol, std::optional<ASTNodePtr>>, ASTFunctionDefinition>;
 }
 
-%token IMPORT TYPEDEF FUNCTION EXTERN INLINE HASH 
+%code {
+    #include "parser/parser.hpp"
+
+    int yylex(YYSTYPE *yylval_param, YYLTYPE *yylloc_param, yyscan_t yyscanner);
+    int yyget_lineno(yyscan_t yyscanner);
+    void yyerror(YYLTYPE *loc, yyscan_t scanner, ParserContext *ctx, const char *msg);
+
+    // a rule spans from the start of its first symbol to the end of its last one. empty rules
+    // get an empty range right after the previous symbol.
+    #define YYLLOC_DEFAULT(Current, Rhs, N)                             \
+        do                                                              \
+        {                                                               \
+            if (N)                                                      \
+            {                                                           \
+                (Current).begin = YYRHSLOC(Rhs, 1).begin;               \
+                (Current).end = YYRHSLOC(Rhs, N).end;                   \
+            }                                                           \
+            else                                                        \
+            {                                                           \
+                (Current).begin = (Current).end = YYRHSLOC(Rhs, 0).end; \
+            }                                                           \
+        } while (0)
+}
+
+%token IMPORT TYPEDEF FUNCTION EXTERN INLINE THREAD_LOCAL HASH 
 %token CLASS PUBLIC PRIVATE INTERFACE ABSTRACT VIRTUAL OVERRIDE PROTECTED
 %token UINT128 VOID CHAR BYTE STRING FLOAT32 FLOAT64 FLOAT128 BOOL ERROR 
 %token INT INT8 INT16 INT32 INT64 INT128 UINT UINT8 UINT16 UINT32 UINT64
 %token CASE DEFAULT IF ELSE SWITCH WHILE DO FOR CONTINUE BREAK RETURN
-%token PTR_OP INC_OP DEC_OP LEFT_OP RIGHT_OP LE_OP GE_OP EQ_OP NE_OP
+%token SCOPE_OP PTR_OP INC_OP DEC_OP LEFT_OP RIGHT_OP LE_OP GE_OP EQ_OP NE_OP
 %token AND_OP OR_OP MUL_ASSIGN DIV_ASSIGN MOD_ASSIGN ADD_ASSIGN
 %token XOR_ASSIGN OR_ASSIGN STRUCT ENUM ELLIPSIS CONST
 %token SUB_ASSIGN LEFT_ASSIGN RIGHT_ASSIGN AND_ASSIGN 
@@ -28,14 +50,14 @@
 
 %union {
     std::pair<std::vector<ASTStructField>, std::vector<ASTFunctionDefinition>>* structMembersAndMethods;
-    std::vector<std::pair<std::string, ASTNodePtr>>* fieldInitializerList;
-    std::pair<std::string, ASTNodePtr>* structFieldInitPair;
+    std::vector<std::pair<Symbol, ASTNodePtr>>* fieldInitializerList;
+    std::pair<Symbol, ASTNodePtr>* structFieldInitPair;
     std::vector<ASTEnumVariantItem>* enumVariantItemsList;
     ASTAssignment::Operator assignmentOperator;
     ASTFunctionParameters* paramsListPtr;
     ASTStorageClassSpecifier storageClassSpecifier;
     ASTUnaryExpression::Operator unaryOperator;
-    std::vector<std::string>* stringListPtr;
+    std::vector<Symbol>* symbolListPtr;
     std::vector<ASTNodePtr>* nodeListPtr;
     std::vector<EnumData>* enumDataList;
     ASTEnumVariantItem* enumVariantItem;
@@ -43,19 +65,24 @@
     ASTTypeSpecifier* typeSpecifier;
     ASTFunctionDefinition* funcDef;
     ASTStructField* structField;
+    ASTStructAttribute* structAttribute;
+    std::vector<ASTStructAttribute>* structAttributeList;
+    ASTSwitchCase* switchCase;
+    std::vector<ASTSwitchCase>* switchCaseList;
     EnumData* enumData;
     ASTNodePtr node;
     float fval;
     double dval;
-    char* sval;
-    int ival;
+    Symbol symbol;
+    std::string* sval;
+    ASTIntegerLiteral::Value ival;
 }
 
 %token <ival> INTEGER_CONSTANT
 %token <fval> FLOAT_CONSTANT  
 %token <dval> DOUBLE_CONSTANT  
 %token <sval> STRING_CONSTANT 
-%token <sval> IDENTIFIER      
+%token <symbol> IDENTIFIER      
 
 %type <structMembersAndMethods> struct_declaration_list
 %type <storageClassSpecifier> storage_class_specifier
@@ -66,9 +93,14 @@
 %type <typeSpecifier> primitive_type_specifier
 %type <paramsListPtr> parameter_list_optional
 %type <structFieldInitPair> struct_init_field
-%type <stringListPtr> import_submodules_list
+%type <symbolListPtr> import_submodules_list qualified_symbol_list
 %type <nodeListPtr> argument_expression_list
 %type <structField> struct_field_declaration
+%type <structAttribute> struct_attribute
+%type <structAttributeList> struct_attribute_list struct_attributes
+%type <switchCase> switch_case
+%type <switchCaseList> switch_case_list
+%type <nodeListPtr> case_label_list
 %type <funcDef> struct_method_declaration
 %type <enumVariantItem> enum_variant_item
 %type <accessSpecifier> access_specifier
@@ -107,7 +139,6 @@
 %type <node> function_declaration
 %type <node> declaration
 %type <node> declaration_local
-%type <node> declaration_list
 %type <node> assignment_expression
 %type <node> postfix_expression
 %type <node> compound_statement
@@ -123,47 +154,62 @@
 %type <node> jump_statement
 %type <node> selection_statement
 
+%define api.pure full
+%define api.location.type {util::SourceRange}
 %define parse.error verbose
+%locations
+%param {yyscan_t scanner}
+%parse-param {ParserContext *ctx}
 %start translation_unit
 
+/* Known conflicts, 4 shift/reduce and 3 reduce/reduce; keep new rules from adding to them:
+   the dangling else, '||' without a precedence, '{' '}' as an empty struct or an empty field
+   list, a qualified call matched by two rules, and '(' IDENTIFIER read as an expression
+   rather than a cast to a named type. %expect cannot pin them since the reduce/reduce
+   conflicts would need a GLR parser. */
+
 %initial-action
 {
-    astProgram = new ASTProgram();
+    ctx->setProgram(new ASTProgram());
 }
 
 %%
 
 import_specifier
-    : IMPORT import_submodules_list ';'                                         { $$ = new ASTImportStatement(*$2, yylineno); delete $2; }
+    : IMPORT import_submodules_list ';'                                         { $$ = ctx->make<ASTImportStatement>(@$, *$2, yyget_lineno(scanner)); delete $2; }
     ;
 
 import_submodules_list
-    : IDENTIFIER                                                                { $$ = new std::vector<std::string>(); $$->push_back($1); free($1);  }
-    | import_submodules_list ':' ':' IDENTIFIER                                 { if ($$) $$->push_back($4); free($4); }
+    : IDENTIFIER                                                                { $$ = new std::vector<Symbol>(); $$->push_back($1);  }
+    | import_submodules_list SCOPE_OP IDENTIFIER                                { if ($$) $$->push_back($3); }
+    ;
+
+qualified_symbol_list
+    : import_submodules_list SCOPE_OP IDENTIFIER                                { $$ = $1; $$->push_back($3); }
     ;
 
 primary_expression
-    : IDENTIFIER                                                                { $$ = new ASTIdentifier($1, yylineno); free($1); }
-    | STRING_CONSTANT                                                           { $$ = new ASTStringLiteral($1); free($1); }
-    | INTEGER_CONSTANT                                                          { $$ = new ASTIntegerLiteral($1); }
-    | FLOAT_CONSTANT                                                            { $$ = new ASTFloatLiteral($1); }
-    | DOUBLE_CONSTANT                                                           { $$ = new ASTFloatLiteral($1); }
-    | TRUE_VAL                                                                  { $$ = new ASTBoolLiteral(true); }
-    | FALSE_VAL                                                                 { $$ = new ASTBoolLiteral(false); }
+    : IDENTIFIER                                                                { $$ = ctx->make<ASTIdentifier>(@1, $1, yyget_lineno(scanner)); }
+    | STRING_CONSTANT                                                           { $$ = ctx->make<ASTStringLiteral>(@$, std::move(*$1)); delete $1; }
+    | INTEGER_CONSTANT                                                          { $$ = ctx->make<ASTIntegerLiteral>(@$, $1); }
+    | FLOAT_CONSTANT                                                            { $$ = ctx->make<ASTFloatLiteral>(@$, $1, true); }
+    | DOUBLE_CONSTANT                                                           { $$ = ctx->make<ASTFloatLiteral>(@$, $1, false); }
+    | TRUE_VAL                                                                  { $$ = ctx->make<ASTBoolLiteral>(@$, true); }
+    | FALSE_VAL                                                                 { $$ = ctx->make<ASTBoolLiteral>(@$, false); }
     | '(' expression ')'                                                        { $$ = $2; }
     ;
 
 imported_symbol_access
-    : import_submodules_list                                                    {
-                                                                                    $$ = new ASTImportedSymbolAccess(*$1, yylineno);
+    : qualified_symbol_list                                                     {
+                                                                                    $$ = ctx->make<ASTImportedSymbolAccess>(@1, *$1, yyget_lineno(scanner));
                                                                                     delete $1;
                                                                                 }
-    | import_submodules_list '(' ')'                                            { 
-                                                                                    $$ = new ASTFunctionCall(new ASTImportedSymbolAccess(*$1, yylineno), {}, yylineno);
+    | qualified_symbol_list '(' ')'                                             { 
+                                                                                    $$ = ctx->make<ASTFunctionCall>(@$, ctx->make<ASTImportedSymbolAccess>(@1, *$1, yyget_lineno(scanner)), std::vector<ASTNodePtr>{}, yyget_lineno(scanner));
                                                                                     delete $1;
                                                                                 }
-    | import_submodules_list '(' argument_expression_list ')'                   { 
-                                                                                    $$ = new ASTFunctionCall(new ASTImportedSymbolAccess(*$1, yylineno), *$3, yylineno);
+    | qualified_symbol_list '(' argument_expression_list ')'                    { 
+                                                                                    $$ = ctx->make<ASTFunctionCall>(@$, ctx->make<ASTImportedSymbolAccess>(@1, *$1, yyget_lineno(scanner)), *$3, yyget_lineno(scanner));
                                                                                     delete $1;
                                                                                     delete $3;
                                                                                 }
@@ -171,20 +217,19 @@ imported_symbol_access
 
 postfix_expression
     : primary_expression                                                        { $$ = $1; }
-    | postfix_expression '[' expression ']'                                     // TODO Array Index Access
-    | postfix_expression '(' ')'                                                { $$ = new ASTFunctionCall($1, {}, yylineno); }
+    | postfix_expression '[' expression ']'                                     { $$ = ctx->make<ASTIndexAccess>(@$, $1, $3, yyget_lineno(scanner)); }
+    | postfix_expression '(' ')'                                                { $$ = ctx->make<ASTFunctionCall>(@$, $1, std::vector<ASTNodePtr>{}, yyget_lineno(scanner)); }
     | postfix_expression '(' argument_expression_list ')'                       {
-                                                                                    $$ = new ASTFunctionCall($1, *$3, yylineno);
+                                                                                    $$ = ctx->make<ASTFunctionCall>(@$, $1, *$3, yyget_lineno(scanner));
                                                                                     delete $3;
                                                                                 }
-    | postfix_expression '.' IDENTIFIER                                         { $$ = new ASTFieldAccess($1, $3, yylineno); free($3); }
+    | postfix_expression '.' IDENTIFIER                                         { $$ = ctx->make<ASTFieldAccess>(@$, $1, $3, yyget_lineno(scanner)); }
     | postfix_expression PTR_OP IDENTIFIER                                      {
-                                                                                    ASTFieldAccess fieldAccess($1, $3, yylineno);
-                                                                                    $$ = new ASTPointerFieldAccess(fieldAccess, yylineno);
-                                                                                    free($3);
+                                                                                    ASTFieldAccess fieldAccess($1, $3, yyget_lineno(scanner));
+                                                                                    $$ = ctx->make<ASTPointerFieldAccess>(@$, fieldAccess, yyget_lineno(scanner));
                                                                                 }
-    | postfix_expression INC_OP                                                 { $$ = new ASTUnaryExpression(ASTUnaryExpression::Operator::PostIncrement, $1, yylineno); }
-    | postfix_expression DEC_OP                                                 { $$ = new ASTUnaryExpression(ASTUnaryExpression::Operator::PostDecrement, $1, yylineno); }
+    | postfix_expression INC_OP                                                 { $$ = ctx->make<ASTUnaryExpression>(@$, ASTUnaryExpression::Operator::PostIncrement, $1, yyget_lineno(scanner)); }
+    | postfix_expression DEC_OP                                                 { $$ = ctx->make<ASTUnaryExpression>(@$, ASTUnaryExpression::Operator::PostDecrement, $1, yyget_lineno(scanner)); }
     | imported_symbol_access                                                    { $$ = $1; }
     | struct_init_specifier                                                     { $$ = $1; }
     ;
@@ -196,9 +241,9 @@ argument_expression_list
 
 unary_expression
     : postfix_expression                                                            { $$ = $1; }
-    | INC_OP unary_expression                                                       { $$ = new ASTUnaryExpression(ASTUnaryExpression::Operator::PreIncrement, $2, yylineno); }
-    | DEC_OP unary_expression                                                       { $$ = new ASTUnaryExpression(ASTUnaryExpression::Operator::PreDecrement, $2, yylineno); }
-    | unary_operator cast_expression                                                { $$ = new ASTUnaryExpression($1, $2, yylineno); }
+    | INC_OP unary_expression                                                       { $$ = ctx->make<ASTUnaryExpression>(@$, ASTUnaryExpression::Operator::PreIncrement, $2, yyget_lineno(scanner)); }
+    | DEC_OP unary_expression                                                       { $$ = ctx->make<ASTUnaryExpression>(@$, ASTUnaryExpression::Operator::PreDecrement, $2, yyget_lineno(scanner)); }
+    | unary_operator cast_expression                                                { $$ = ctx->make<ASTUnaryExpression>(@$, $1, $2, yyget_lineno(scanner)); }
     ;
 
 unary_operator
@@ -213,77 +258,76 @@ unary_operator
 cast_expression
     : unary_expression                                                              { $$ = $1; }
     | '(' type_specifier ')' cast_expression                                        { 
-                                                                                        $$ = new ASTCastExpression(*$2, $4, yylineno);
-                                                                                        delete $2;
+                                                                                        $$ = ctx->make<ASTCastExpression>(@$, *$2, $4, yyget_lineno(scanner));
                                                                                     }
     ;
 
 multiplicative_expression
     : cast_expression                                                               { $$ = $1; }
-    | multiplicative_expression '*' cast_expression                                 { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::Multiply, $3, yylineno); }
-    | multiplicative_expression '/' cast_expression                                 { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::Divide, $3, yylineno); }
-    | multiplicative_expression '%' cast_expression                                 { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::Remainder, $3, yylineno); }
+    | multiplicative_expression '*' cast_expression                                 { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::Multiply, $3, yyget_lineno(scanner)); }
+    | multiplicative_expression '/' cast_expression                                 { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::Divide, $3, yyget_lineno(scanner)); }
+    | multiplicative_expression '%' cast_expression                                 { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::Remainder, $3, yyget_lineno(scanner)); }
     ;
 
 additive_expression
     : multiplicative_expression                                                     { $$ = $1; }
-    | additive_expression '+' multiplicative_expression                             { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::Add, $3, yylineno); }
-    | additive_expression '-' multiplicative_expression                             { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::Subtract, $3, yylineno); }
+    | additive_expression '+' multiplicative_expression                             { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::Add, $3, yyget_lineno(scanner)); }
+    | additive_expression '-' multiplicative_expression                             { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::Subtract, $3, yyget_lineno(scanner)); }
     ;
 
 shift_expression
     : additive_expression                                                           { $$ = $1; }
-    | shift_expression LEFT_OP additive_expression                                  { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::LeftShift, $3, yylineno); }
-    | shift_expression RIGHT_OP additive_expression                                 { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::RightShift, $3, yylineno); }
+    | shift_expression LEFT_OP additive_expression                                  { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::LeftShift, $3, yyget_lineno(scanner)); }
+    | shift_expression RIGHT_OP additive_expression                                 { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::RightShift, $3, yyget_lineno(scanner)); }
     ;
 
 relational_expression
     : shift_expression                                                              { $$ = $1; }
-    | relational_expression '<' shift_expression                                    { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::LessThan, $3, yylineno); }
-    | relational_expression '>' shift_expression                                    { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::GreaterThan, $3, yylineno); }
-    | relational_expression LE_OP shift_expression                                  { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::LessEqual, $3, yylineno); }
-    | relational_expression GE_OP shift_expression                                  { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::GreaterEqual, $3, yylineno); }
+    | relational_expression '<' shift_expression                                    { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::LessThan, $3, yyget_lineno(scanner)); }
+    | relational_expression '>' shift_expression                                    { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::GreaterThan, $3, yyget_lineno(scanner)); }
+    | relational_expression LE_OP shift_expression                                  { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::LessEqual, $3, yyget_lineno(scanner)); }
+    | relational_expression GE_OP shift_expression                                  { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::GreaterEqual, $3, yyget_lineno(scanner)); }
     ;
 
 equality_expression
     : relational_expression                                                         { $$ = $1; }
-    | equality_expression EQ_OP relational_expression                               { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::Equal, $3, yylineno); }    
-    | equality_expression NE_OP relational_expression                               { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::NotEqual, $3, yylineno); }
+    | equality_expression EQ_OP relational_expression                               { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::Equal, $3, yyget_lineno(scanner)); }    
+    | equality_expression NE_OP relational_expression                               { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::NotEqual, $3, yyget_lineno(scanner)); }
     ;
 
 and_expression
     : equality_expression                                                           { $$ = $1; }
-    | and_expression '&' equality_expression                                        { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::BitwiseAnd, $3, yylineno); }
+    | and_expression '&' equality_expression                                        { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::BitwiseAnd, $3, yyget_lineno(scanner)); }
     ;
 
 exclusive_or_expression
     : and_expression                                                                { $$ = $1; }
-    | exclusive_or_expression '^' and_expression                                    { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::BitwiseXor, $3, yylineno); }
+    | exclusive_or_expression '^' and_expression                                    { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::BitwiseXor, $3, yyget_lineno(scanner)); }
     ;
 
 inclusive_or_expression
     : exclusive_or_expression                                                       { $$ = $1; }
-    | inclusive_or_expression '|' exclusive_or_expression                           { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::BitwiseOr, $3, yylineno); }
+    | inclusive_or_expression '|' exclusive_or_expression                           { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::BitwiseOr, $3, yyget_lineno(scanner)); }
     ;
 
 logical_and_expression
     : inclusive_or_expression                                                       { $$ = $1; }
-    | logical_and_expression AND_OP inclusive_or_expression                         { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::LogicalAnd, $3, yylineno); }
+    | logical_and_expression AND_OP inclusive_or_expression                         { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::LogicalAnd, $3, yyget_lineno(scanner)); }
     ;
 
 logical_or_expression
     : logical_and_expression                                                        { $$ = $1; }
-    | logical_or_expression OR_OP logical_or_expression                             { $$ = new ASTBinaryExpression($1, ASTBinaryExpression::Operator::LogicalOr, $3, yylineno); }
+    | logical_or_expression OR_OP logical_or_expression                             { $$ = ctx->make<ASTBinaryExpression>(@$, $1, ASTBinaryExpression::Operator::LogicalOr, $3, yyget_lineno(scanner)); }
     ;
 
 conditional_expression
     : logical_or_expression                                                         { $$ = $1; }
-    | logical_or_expression '?' expression ':' conditional_expression               { $$ = new ASTConditionalExpression($1, $3, $5, yylineno); }
+    | logical_or_expression '?' expression ':' conditional_expression               { $$ = ctx->make<ASTConditionalExpression>(@$, $1, $3, $5, yyget_lineno(scanner)); }
     ;
 
 assignment_expression
     : conditional_expression                                                        { $$ = $1; }
-    | unary_expression assignment_operator assignment_expression                    { $$ = new ASTAssignment($1, $2, $3, yylineno); }
+    | unary_expression assignment_operator assignment_expression                    { $$ = ctx->make<ASTAssignment>(@$, $1, $2, $3, yyget_lineno(scanner)); }
     ;
 
 assignment_operator
@@ -319,6 +363,8 @@ declaration_local
 storage_class_specifier
     : EXTERN                         { $$ = ASTStorageClassSpecifier::Extern; }
     | INLINE                         { $$ = ASTStorageClassSpecifier::Inline; }
+    | THREAD_LOCAL                   { $$ = ASTStorageClassSpecifier::ThreadLocal; }
+    | EXTERN THREAD_LOCAL            { $$ = ASTStorageClassSpecifier::ExternThreadLocal; }
     ;
 
 access_specifier
@@ -331,58 +377,71 @@ access_specifier
     ;
 
 typedef_specifier
-    : access_specifier TYPEDEF IDENTIFIER '=' type_specifier ';'                { $$ = new ASTTypeDefStatement($3, *$5, yylineno, $1); free($3); delete $5; }
-    | TYPEDEF IDENTIFIER '=' type_specifier ';'                                 { $$ = new ASTTypeDefStatement($2, *$4, yylineno); free($2); delete $4; }
+    : access_specifier TYPEDEF IDENTIFIER '=' type_specifier ';'                { $$ = ctx->make<ASTTypeDefStatement>(@$, $3, *$5, yyget_lineno(scanner), $1); }
+    | TYPEDEF IDENTIFIER '=' type_specifier ';'                                 { $$ = ctx->make<ASTTypeDefStatement>(@$, $2, *$4, yyget_lineno(scanner)); }
     ;
 
 struct_specifier
-    : STRUCT IDENTIFIER '{' struct_declaration_list '}'                         { $$ = new ASTStructDefinition($2, $4->first, $4->second, yylineno); free($2); }
-    | STRUCT '{' struct_declaration_list '}'                                    { $$ = new ASTStructDefinition(std::nullopt, $3->first, $3->second, yylineno); }
-    | STRUCT IDENTIFIER '{'  '}'                                                { $$ = new ASTStructDefinition($2, {}, {}, yylineno); free($2); }
-    | STRUCT IDENTIFIER ';'                                                     { $$ = new ASTStructDefinition($2, {}, {}, yylineno); free($2); }
+    : STRUCT IDENTIFIER '{' struct_declaration_list '}'                         { $$ = ctx->make<ASTStructDefinition>(@$, $2, $4->first, $4->second, yyget_lineno(scanner)); }
+    | STRUCT '{' struct_declaration_list '}'                                    { $$ = ctx->make<ASTStructDefinition>(@$, std::nullopt, $3->first, $3->second, yyget_lineno(scanner)); }
+    | STRUCT IDENTIFIER '{'  '}'                                                { $$ = ctx->make<ASTStructDefinition>(@$, $2, std::vector<ASTStructField>{}, std::vector<ASTFunctionDefinition>{}, yyget_lineno(scanner)); }
+    | STRUCT IDENTIFIER ';'                                                     { $$ = ctx->make<ASTStructDefinition>(@$, $2, std::vector<ASTStructField>{}, std::vector<ASTFunctionDefinition>{}, yyget_lineno(scanner)); }
+    | STRUCT struct_attributes IDENTIFIER '{' struct_declaration_list '}'       { $$ = ctx->make<ASTStructDefinition>(@$, $3, $5->first, $5->second, yyget_lineno(scanner), ASTAccessSpecifier::Default, *$2); delete $2; }
+    | STRUCT struct_attributes '{' struct_declaration_list '}'                  { $$ = ctx->make<ASTStructDefinition>(@$, std::nullopt, $4->first, $4->second, yyget_lineno(scanner), ASTAccessSpecifier::Default, *$2); delete $2; }
+    ;
+
+struct_attributes
+    : '[' '[' struct_attribute_list ']' ']'                                     { $$ = $3; }
+    ;
+
+struct_attribute_list
+    : struct_attribute                                                          { $$ = new std::vector<ASTStructAttribute>{ *$1 }; }
+    | struct_attribute_list ',' struct_attribute                                { $$->push_back(*$3); }
+    ;
+
+struct_attribute
+    : IDENTIFIER                                                                { $$ = ctx->make<ASTStructAttribute>(@$, $1, std::nullopt, yyget_lineno(scanner)); }
+    | IDENTIFIER '(' constant_expression ')'                                    { $$ = ctx->make<ASTStructAttribute>(@$, $1, $3, yyget_lineno(scanner)); }
     ;
 
 struct_declaration_list
     :                                                                           { $$ = new std::pair<std::vector<ASTStructField>, std::vector<ASTFunctionDefinition>>(); }
     | struct_declaration_list struct_field_declaration                          {   
                                                                                     $$->first.push_back(*$2);
-                                                                                    delete $2;
                                                                                 }
     | struct_declaration_list struct_method_declaration                         {
                                                                                     $$->second.push_back(*$2);
-                                                                                    delete $2;
                                                                                 }
     ;
 
 struct_field_declaration
-    : access_specifier IDENTIFIER type_specifier ';'                            { $$ = new ASTStructField($2, *$3, yylineno, $1); free($2); delete $3; } 
-    | IDENTIFIER type_specifier ';'                                             { $$ = new ASTStructField($1, *$2, yylineno); free($1); delete $2; }
+    : access_specifier IDENTIFIER type_specifier ';'                            { $$ = ctx->make<ASTStructField>(@$, $2, *$3, yyget_lineno(scanner), $1); } 
+    | IDENTIFIER type_specifier ';'                                             { $$ = ctx->make<ASTStructField>(@$, $1, *$2, yyget_lineno(scanner)); }
     ;
 
 struct_method_declaration
-    : access_specifier function_definition                                      { $$ = static_cast<ASTFunctionDefinition *>($2); }
-    | function_definition                                                       { $$ = static_cast<ASTFunctionDefinition *>($1); }
+    : function_definition                                                       { $$ = static_cast<ASTFunctionDefinition *>($1); }
     ;
 
 struct_init_specifier
-    : IDENTIFIER '{' '}'                                                        { $$ = new ASTStructInitialization($1, {}, yylineno); free($1); }
-    | IDENTIFIER '{' field_initializer_list '}'                                 { $$ = new ASTStructInitialization($1, *$3, yylineno); free($1); delete $3; }
+    : IDENTIFIER '{' '}'                                                        { $$ = ctx->make<ASTStructInitialization>(@$, $1, std::vector<std::pair<Symbol, ASTNodePtr>>{}, yyget_lineno(scanner)); }
+    | IDENTIFIER '{' field_initializer_list '}'                                 { $$ = ctx->make<ASTStructInitialization>(@$, $1, *$3, yyget_lineno(scanner)); delete $3; }
     ;
 
 field_initializer_list
-    : struct_init_field                                                         { $$ = new std::vector<std::pair<std::string, ASTNodePtr>>{*$1}; delete $1;  }
+    : struct_init_field                                                         { $$ = new std::vector<std::pair<Symbol, ASTNodePtr>>{*$1}; delete $1;  }
     | field_initializer_list ';' struct_init_field                              { $$->push_back(*$3); delete $3; }
     ;
 
 struct_init_field
-    : IDENTIFIER ':' assignment_expression                                      { $$ = new std::pair<std::string, ASTNodePtr>($1, $3); free($1); }
+    : IDENTIFIER ':' assignment_expression                                      { $$ = new std::pair<Symbol, ASTNodePtr>($1, $3); }
     ;
 
 enum_specifier
     : ENUM '{' enumerator_list '}'                                              { 
                                                                                     std::vector<ASTEnumVariant> variants;
                                                                                     std::vector<ASTFunctionDefinition> methods;
-                                                                                    std::vector<std::pair<std::string, std::optional<ASTNodePtr>>> fields;
+                                                                                    std::vector<std::pair<Symbol, std::optional<ASTNodePtr>>> fields;
 
                                                                                     for (auto& data : *$3) {
                                                                                         if (std::holds_alternative<ASTEnumVariant>(data)) {
@@ -390,19 +449,19 @@ enum_specifier
                                                                                         } else if (std::holds_alternative<ASTFunctionDefinition>(data)) {
                                                                                             methods.push_back(std::get<ASTFunctionDefinition>(data));
                                                                                         } 
-                                                                                        else if (std::holds_alternative<std::pair<std::string, std::optional<ASTNodePtr>>>(data)) {
-                                                                                            auto pair = std::get<std::pair<std::string, std::optional<ASTNodePtr>>>(data);
+                                                                                        else if (std::holds_alternative<std::pair<Symbol, std::optional<ASTNodePtr>>>(data)) {
+                                                                                            auto pair = std::get<std::pair<Symbol, std::optional<ASTNodePtr>>>(data);
                                                                                             fields.push_back(pair);
                                                                                         }
                                                                                     }
 
-                                                                                    $$ = new ASTEnumDefinition(std::nullopt, variants, fields, methods, yylineno); 
+                                                                                    $$ = ctx->make<ASTEnumDefinition>(@$, std::nullopt, variants, fields, methods, yyget_lineno(scanner)); 
                                                                                     delete $3;
                                                                                 }
     | ENUM IDENTIFIER '{' enumerator_list '}'                                   {
                                                                                     std::vector<ASTEnumVariant> variants;
                                                                                     std::vector<ASTFunctionDefinition> methods;
-                                                                                    std::vector<std::pair<std::string, std::optional<ASTNodePtr>>> fields;
+                                                                                    std::vector<std::pair<Symbol, std::optional<ASTNodePtr>>> fields;
 
                                                                                     for (auto& data : *$4) {
                                                                                         if (std::holds_alternative<ASTEnumVariant>(data)) {
@@ -410,17 +469,16 @@ enum_specifier
                                                                                         } else if (std::holds_alternative<ASTFunctionDefinition>(data)) {
                                                                                             methods.push_back(std::get<ASTFunctionDefinition>(data));
                                                                                         }
-                                                                                        else if (std::holds_alternative<std::pair<std::string, std::optional<ASTNodePtr>>>(data)) {
-                                                                                            auto pair = std::get<std::pair<std::string, std::optional<ASTNodePtr>>>(data);
+                                                                                        else if (std::holds_alternative<std::pair<Symbol, std::optional<ASTNodePtr>>>(data)) {
+                                                                                            auto pair = std::get<std::pair<Symbol, std::optional<ASTNodePtr>>>(data);
                                                                                             fields.push_back(pair);
                                                                                         }
                                                                                     }
 
-                                                                                    $$ = new ASTEnumDefinition($2, variants, fields, methods, yylineno); 
-                                                                                    free($2);
+                                                                                    $$ = ctx->make<ASTEnumDefinition>(@$, $2, variants, fields, methods, yyget_lineno(scanner)); 
                                                                                     delete $4;
                                                                                 }
-    | ENUM IDENTIFIER ';'                                                       { $$ = new ASTEnumDefinition($2, {}, {}, {}, yylineno); free($2); }
+    | ENUM IDENTIFIER ';'                                                       { $$ = ctx->make<ASTEnumDefinition>(@$, $2, std::vector<ASTEnumVariant>{}, std::vector<std::pair<Symbol, std::optional<ASTNodePtr>>>{}, std::vector<ASTFunctionDefinition>{}, yyget_lineno(scanner)); }
     ;
 
 enumerator_list     
@@ -430,42 +488,36 @@ enumerator_list
     | enumerator_list function_definition                                       {   
                                                                                     auto method = static_cast<ASTFunctionDefinition *>($2);
                                                                                     $$->push_back(*method);
-                                                                                    delete $2;
                                                                                 }                                                    
     ;
 
 enumerator
     : IDENTIFIER                                            { 
-                                                                auto unnamedField = new std::pair<std::string, std::optional<ASTNodePtr>>($1, std::nullopt);
+                                                                auto unnamedField = new std::pair<Symbol, std::optional<ASTNodePtr>>($1, std::nullopt);
                                                                 $$ = new EnumData(*unnamedField);
-                                                                free($1);
                                                             }
     | IDENTIFIER '=' constant_expression                    { 
-                                                                auto field = std::pair<std::string, std::optional<ASTNodePtr>>{$1, $3};
+                                                                auto field = std::pair<Symbol, std::optional<ASTNodePtr>>{$1, $3};
                                                                 $$ = new EnumData(field);
-                                                                free($1);
                                                             }
     | IDENTIFIER '(' enum_variant_items_list ')'            {
-                                                                ASTEnumVariant enumVariant($1, *$3, yylineno);
+                                                                ASTEnumVariant enumVariant($1, *$3, yyget_lineno(scanner));
                                                                 $$ = new EnumData(enumVariant);
-                                                                free($1);
                                                                 delete $3;
                                                             }
     ;
 
 enum_variant_item
-    : type_specifier                                        { $$ = new ASTEnumVariantItem(std::nullopt, *$1, yylineno); delete $1; }
-    | IDENTIFIER type_specifier                             { $$ = new ASTEnumVariantItem($1, *$2, yylineno); free($1); delete $2; }
+    : type_specifier                                        { $$ = ctx->make<ASTEnumVariantItem>(@$, std::nullopt, *$1, yyget_lineno(scanner)); }
+    | IDENTIFIER type_specifier                             { $$ = ctx->make<ASTEnumVariantItem>(@$, $1, *$2, yyget_lineno(scanner)); }
     ;   
 
 enum_variant_items_list
     : enum_variant_item                                         {   
                                                                     $$ = new std::vector<ASTEnumVariantItem>{ *$1 };
-                                                                    delete $1;
                                                                 }
     | enum_variant_items_list ',' enum_variant_item             { 
                                                                     $$->push_back(*$3);
-                                                                    delete $3;
                                                                 }
     ;
 
@@ -478,60 +530,57 @@ type_specifier
 base_type
     : primitive_type_specifier
     | IDENTIFIER                                        {   
-                                                            $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Identifier, new ASTIdentifier($1, yylineno)); 
-                                                            free($1);
+                                                            $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Identifier, ctx->make<ASTIdentifier>(@1, $1, yyget_lineno(scanner))); 
                                                         }
     ;
 
 qualified_type_specifier
-    : CONST base_type                                   { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Const, $2); }
+    : CONST base_type                                   { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Const, $2); }
     | base_type                                         { $$ = $1; }
     ;
 
 pointer_type
     : type_specifier '*'
-        { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Pointer, $1); }
+        { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Pointer, $1); }
     ;
 
 address_type
     : type_specifier '&'
-        { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Reference, $1); }
+        { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Reference, $1); }
     ;
 
 primitive_type_specifier
-    : INT                           { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Int); }
-    | INT8                          { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Int8); }
-    | INT16                         { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Int16); }
-    | INT32                         { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Int32); }
-    | INT64                         { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Int64); }
-    | INT128                        { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Int128); }
-    | UINT                          { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::UInt); }
-    | UINT8                         { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::UInt8); }
-    | UINT16                        { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::UInt16); }
-    | UINT32                        { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::UInt32); }
-    | UINT64                        { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::UInt64); }
-    | UINT128                       { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::UInt128); }
-    | VOID                          { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Void); }
-    | CHAR                          { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Char); }
-    | BYTE                          { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Byte); }
-    | STRING                        { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::String); }
-    | FLOAT32                       { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Float32); }
-    | FLOAT64                       { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Float64); }
-    | FLOAT128                      { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Float128); }
-    | BOOL                          { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Bool); }
-    | ERROR                         { $$ = new ASTTypeSpecifier(ASTTypeSpecifier::ASTInternalType::Error); }
+    : INT                           { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Int); }
+    | INT8                          { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Int8); }
+    | INT16                         { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Int16); }
+    | INT32                         { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Int32); }
+    | INT64                         { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Int64); }
+    | INT128                        { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Int128); }
+    | UINT                          { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::UInt); }
+    | UINT8                         { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::UInt8); }
+    | UINT16                        { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::UInt16); }
+    | UINT32                        { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::UInt32); }
+    | UINT64                        { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::UInt64); }
+    | UINT128                       { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::UInt128); }
+    | VOID                          { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Void); }
+    | CHAR                          { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Char); }
+    | BYTE                          { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Byte); }
+    | STRING                        { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::String); }
+    | FLOAT32                       { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Float32); }
+    | FLOAT64                       { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Float64); }
+    | FLOAT128                      { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Float128); }
+    | BOOL                          { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Bool); }
+    | ERROR                         { $$ = ctx->make<ASTTypeSpecifier>(@$, ASTTypeSpecifier::ASTInternalType::Error); }
     ;
     
 parameter_list
     : parameter_declaration                                     {   
                                                                     ASTFunctionParameter* param = static_cast<ASTFunctionParameter*>($1);
-                                                                    $$ = new ASTFunctionParameters({ *param });
-                                                                    delete $1;
+                                                                    $$ = ctx->make<ASTFunctionParameters>(@$, std::vector<ASTFunctionParameter>{ *param });
                                                                 }
     | parameter_list ',' parameter_declaration                  { 
                                                                     ASTFunctionParameter* param = static_cast<ASTFunctionParameter*>($3);
                                                                     $$->addParameter(*param); 
-                                                                    delete $3;
                                                                 }
     | parameter_list ',' type_specifier ELLIPSIS                {
                                                                     $$->setVariadic($3);
@@ -542,31 +591,24 @@ parameter_list
     ;
 
 parameter_declaration
-    : IDENTIFIER type_specifier                                  { $$ = new ASTFunctionParameter($1, *$2); free($1); delete $2; }
-    | IDENTIFIER type_specifier '=' assignment_expression        { $$ = new ASTFunctionParameter($1, *$2, $4); free($1); delete $2; }
+    : IDENTIFIER type_specifier                                  { $$ = ctx->make<ASTFunctionParameter>(@$, $1, *$2); }
+    | IDENTIFIER type_specifier '=' assignment_expression        { $$ = ctx->make<ASTFunctionParameter>(@$, $1, *$2, $4); }
     ;
 
 statement
     : compound_statement        
+    | declaration
     | expression_statement      
     | selection_statement
     | iteration_statement
     | jump_statement
+    | error ';'                                             { $$ = nullptr; yyerrok; }
     ;
 
 compound_statement                                              
-    : '{' '}'                                               { $$ = new ASTStatementList(yylineno); }
+    : '{' '}'                                               { $$ = ctx->make<ASTStatementList>(@$, yyget_lineno(scanner)); }
     | '{' statement_list '}'                                { $$ = $2; }
-    | '{' declaration_list '}'                              { $$ = $2; }
-    | '{' expression_statement '}'                          { $$ = new ASTStatementList($2, yylineno); }
-    | '{' declaration_list statement_list '}'               { 
-                                                                ASTStatementList* list = static_cast<ASTStatementList*>($2);
-                                                                $$ = list;
-                                                            }
-    | '{' declaration_list expression_statement '}'         {
-                                                                ASTStatementList* list = static_cast<ASTStatementList*>($2);
-                                                                list->addStatement($3);
-                                                            }
+    | '{' error '}'                                         { $$ = ctx->make<ASTStatementList>(@$, yyget_lineno(scanner)); yyerrok; }
     ;
 
 declaration
@@ -576,23 +618,8 @@ declaration
     | variable_declaration             { $$ = $1; }
     ;
 
-declaration_list
-    : declaration                                           { $$ = new ASTStatementList($1, yylineno); }
-    | declaration_list declaration                          {
-                                                                if ($$) 
-                                                                {
-                                                                    ASTStatementList* list = static_cast<ASTStatementList *>($$);
-                                                                    list->addStatement($2);
-                                                                } 
-                                                                else 
-                                                                {
-                                                                    $$ = new ASTStatementList($2, yylineno);
-                                                                }
-                                                            }
-    ;
-
 statement_list  
-    : statement                                         { $$ = new ASTStatementList($1, yylineno); }
+    : statement                                         { $$ = ctx->make<ASTStatementList>(@$, $1, yyget_lineno(scanner)); }
     | statement_list statement                          { 
                                                             if ($$) 
                                                             {
@@ -601,7 +628,7 @@ statement_list
                                                             } 
                                                             else 
                                                             {
-                                                                $$ = new ASTStatementList($2, yylineno);
+                                                                $$ = ctx->make<ASTStatementList>(@$, $2, yyget_lineno(scanner));
                                                             }
                                                         }
     ;
@@ -612,43 +639,51 @@ expression_statement
     ;
 
 selection_statement
-    : IF '(' expression ')' statement                                               { $$ = new ASTIfStatement($3, $5, yylineno); }
-    | IF '(' expression ')' statement ELSE statement                                { $$ = new ASTIfStatement($3, $5, yylineno, $7); }
-    | SWITCH '(' expression ')' statement
+    : IF '(' expression ')' statement                                               { $$ = ctx->make<ASTIfStatement>(@$, $3, $5, yyget_lineno(scanner)); }
+    | IF '(' expression ')' statement ELSE statement                                { $$ = ctx->make<ASTIfStatement>(@$, $3, $5, yyget_lineno(scanner), $7); }
+    | SWITCH '(' expression ')' '{' switch_case_list '}'                             { $$ = ctx->make<ASTSwitchStatement>(@$, $3, *$6, yyget_lineno(scanner)); delete $6; }
+    | SWITCH '(' expression ')' '{' '}'                                             { $$ = ctx->make<ASTSwitchStatement>(@$, $3, std::vector<ASTSwitchCase>{}, yyget_lineno(scanner)); }
+    ;
+
+switch_case_list
+    : switch_case                                                                   { $$ = new std::vector<ASTSwitchCase>{ *$1 }; }
+    | switch_case_list switch_case                                                  { $$->push_back(*$2); }
+    ;
+
+switch_case
+    : CASE case_label_list ':' statement                                            { $$ = ctx->make<ASTSwitchCase>(@$, *$2, $4, yyget_lineno(scanner)); delete $2; }
+    | DEFAULT ':' statement                                                         { $$ = ctx->make<ASTSwitchCase>(@$, std::vector<ASTNodePtr>{}, $3, yyget_lineno(scanner)); }
+    ;
+
+case_label_list
+    : constant_expression                                                           { $$ = new std::vector<ASTNodePtr>{ $1 }; }
+    | case_label_list ',' constant_expression                                       { $$->push_back($3); }
     ;
 
 iteration_statement
-    : FOR '(' expression ')' statement                                              { $$ = new ASTForStatement(std::nullopt, $3, std::nullopt, $5, yylineno); }
-    | FOR '(' variable_declaration expression_statement ')' statement               { $$ = new ASTForStatement($3, $4, std::nullopt, $6, yylineno); }
-    | FOR '(' variable_declaration expression_statement expression ')' statement    { $$ = new ASTForStatement($3, $4, $5, $7, yylineno); }
+    : FOR '(' expression ')' statement                                              { $$ = ctx->make<ASTForStatement>(@$, std::nullopt, $3, std::nullopt, $5, yyget_lineno(scanner)); }
+    | FOR '(' variable_declaration expression_statement ')' statement               { $$ = ctx->make<ASTForStatement>(@$, $3, $4, std::nullopt, $6, yyget_lineno(scanner)); }
+    | FOR '(' variable_declaration expression_statement expression ')' statement    { $$ = ctx->make<ASTForStatement>(@$, $3, $4, $5, $7, yyget_lineno(scanner)); }
     ;
 
 jump_statement
-    : CONTINUE ';'                                  { $$ = new ASTContinueStatement(yylineno); }
-    | BREAK ';'                                     { $$ = new ASTBreakStatement(yylineno); }
-    | RETURN ';'                                    { $$ = new ASTReturnStatement(std::nullopt, yylineno); }
-    | RETURN expression ';'                         { $$ = new ASTReturnStatement($2, yylineno); }
+    : CONTINUE ';'                                  { $$ = ctx->make<ASTContinueStatement>(@$, yyget_lineno(scanner)); }
+    | BREAK ';'                                     { $$ = ctx->make<ASTBreakStatement>(@$, yyget_lineno(scanner)); }
+    | RETURN ';'                                    { $$ = ctx->make<ASTReturnStatement>(@$, std::nullopt, yyget_lineno(scanner)); }
+    | RETURN expression ';'                         { $$ = ctx->make<ASTReturnStatement>(@$, $2, yyget_lineno(scanner)); }
     ;
 
 
 
 translation_unit
     : /* empty */                                   
-    | import_specifier                              {   
-                                                        ASTProgram* program = static_cast<ASTProgram*>(astProgram);
-                                                        program->getStatementList()->addStatement($1);
-                                                    }
     | translation_unit import_specifier             {   
-                                                        ASTProgram* program = static_cast<ASTProgram*>(astProgram);
-                                                        program->getStatementList()->addStatement($2);
-                                                    }
-    | external_declaration                          { 
-                                                        ASTProgram* program = static_cast<ASTProgram*>(astProgram);
-                                                        program->getStatementList()->addStatement($1);
+                                                        ASTProgram* program = ctx->getProgram();
+                                                        if ($2) program->getStatementList()->addStatement($2);
                                                     }
     | translation_unit external_declaration         { 
-                                                        ASTProgram* program = static_cast<ASTProgram*>(astProgram);
-                                                        program->getStatementList()->addStatement($2);
+                                                        ASTProgram* program = ctx->getProgram();
+                                                        if ($2) program->getStatementList()->addStatement($2);
                                                     }
     ;
 
@@ -657,65 +692,61 @@ external_declaration
     | function_declaration                                                  { $$ = $1; }    
     | global_variable_declaration                                           { $$ = $1; }
     | declaration                                                           { $$ = $1; }
+    | error ';'                                                             { $$ = nullptr; yyerrok; }
+    | error '}'                                                             { $$ = nullptr; yyerrok; }
     ;
 
 function_definition
-    : storage_class_specifier access_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' compound_statement                    { $$ = new ASTFunctionDefinition(new ASTIdentifier($4, yylineno), *$6, nullptr, $8, yylineno, $2, $1); free($4); delete $6; }
-    | storage_class_specifier access_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier compound_statement     { $$ = new ASTFunctionDefinition(new ASTIdentifier($4, yylineno), *$6, $8, $9, yylineno, $2, $1); free($4); delete $6; }
-    | access_specifier storage_class_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' compound_statement                    { $$ = new ASTFunctionDefinition(new ASTIdentifier($4, yylineno), *$6, std::nullopt, $8, yylineno, $1, $2); free($4); delete $6; }
-    | access_specifier storage_class_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier compound_statement     { $$ = new ASTFunctionDefinition(new ASTIdentifier($4, yylineno), *$6, $8, $9, yylineno, $1, $2); free($4); delete $6; }
-    | access_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' compound_statement                                           { $$ = new ASTFunctionDefinition(new ASTIdentifier($3, yylineno), *$5, std::nullopt, $7, yylineno, $1); free($3); delete $5; }
-    | access_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier compound_statement                            { $$ = new ASTFunctionDefinition(new ASTIdentifier($3, yylineno), *$5, $7, $8, yylineno, $1); free($3); delete $5; }
-    | storage_class_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' compound_statement                    { $$ = new ASTFunctionDefinition(new ASTIdentifier($3, yylineno), *$5, std::nullopt, $7, yylineno, ASTAccessSpecifier::Default, $1); free($3); delete $5; }
-    | storage_class_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier compound_statement     { $$ = new ASTFunctionDefinition(new ASTIdentifier($3, yylineno), *$5, $7, $8, yylineno, ASTAccessSpecifier::Default, $1); free($3); delete $5; }
-    | FUNCTION IDENTIFIER '(' parameter_list_optional ')' compound_statement                                            { $$ = new ASTFunctionDefinition(new ASTIdentifier($2, yylineno), *$4, std::nullopt, $6, yylineno); free($2); delete $4; }
-    | FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier compound_statement                             { $$ = new ASTFunctionDefinition(new ASTIdentifier($2, yylineno), *$4, $6, $7, yylineno); free($2); delete $4; }
+    : storage_class_specifier access_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' compound_statement                    { $$ = ctx->make<ASTFunctionDefinition>(@$, ctx->make<ASTIdentifier>(@4, $4, yyget_lineno(scanner)), *$6, std::nullopt, $8, yyget_lineno(scanner), $2, $1); }
+    | storage_class_specifier access_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier compound_statement     { $$ = ctx->make<ASTFunctionDefinition>(@$, ctx->make<ASTIdentifier>(@4, $4, yyget_lineno(scanner)), *$6, $8, $9, yyget_lineno(scanner), $2, $1); }
+    | access_specifier storage_class_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' compound_statement                    { $$ = ctx->make<ASTFunctionDefinition>(@$, ctx->make<ASTIdentifier>(@4, $4, yyget_lineno(scanner)), *$6, std::nullopt, $8, yyget_lineno(scanner), $1, $2); }
+    | access_specifier storage_class_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier compound_statement     { $$ = ctx->make<ASTFunctionDefinition>(@$, ctx->make<ASTIdentifier>(@4, $4, yyget_lineno(scanner)), *$6, $8, $9, yyget_lineno(scanner), $1, $2); }
+    | access_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' compound_statement                                           { $$ = ctx->make<ASTFunctionDefinition>(@$, ctx->make<ASTIdentifier>(@3, $3, yyget_lineno(scanner)), *$5, std::nullopt, $7, yyget_lineno(scanner), $1); }
+    | access_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier compound_statement                            { $$ = ctx->make<ASTFunctionDefinition>(@$, ctx->make<ASTIdentifier>(@3, $3, yyget_lineno(scanner)), *$5, $7, $8, yyget_lineno(scanner), $1); }
+    | storage_class_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' compound_statement                    { $$ = ctx->make<ASTFunctionDefinition>(@$, ctx->make<ASTIdentifier>(@3, $3, yyget_lineno(scanner)), *$5, std::nullopt, $7, yyget_lineno(scanner), ASTAccessSpecifier::Default, $1); }
+    | storage_class_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier compound_statement     { $$ = ctx->make<ASTFunctionDefinition>(@$, ctx->make<ASTIdentifier>(@3, $3, yyget_lineno(scanner)), *$5, $7, $8, yyget_lineno(scanner), ASTAccessSpecifier::Default, $1); }
+    | FUNCTION IDENTIFIER '(' parameter_list_optional ')' compound_statement                                            { $$ = ctx->make<ASTFunctionDefinition>(@$, ctx->make<ASTIdentifier>(@2, $2, yyget_lineno(scanner)), *$4, std::nullopt, $6, yyget_lineno(scanner)); }
+    | FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier compound_statement                             { $$ = ctx->make<ASTFunctionDefinition>(@$, ctx->make<ASTIdentifier>(@2, $2, yyget_lineno(scanner)), *$4, $6, $7, yyget_lineno(scanner)); }
     ;
 
 function_declaration
-    :
-    // : storage_class_specifier access_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' ';'                    { $$ = new ASTFunctionDeclaration(new ASTIdentifier($4, yylineno), *$6, nullptr, $2, $1, yylineno); free($4); delete $6; }
-    // | storage_class_specifier access_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier ';'     { $$ = new ASTFunctionDeclaration(new ASTIdentifier($4, yylineno), *$6, $8, $2, $1, yylineno); free($4); delete $6; }
-    // | access_specifier storage_class_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' ';'                    { $$ = new ASTFunctionDeclaration(new ASTIdentifier($4, yylineno), *$6, nullptr, $1, $2, yylineno); free($4); delete $6; }
-    // | access_specifier storage_class_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier ';'     { $$ = new ASTFunctionDeclaration(new ASTIdentifier($4, yylineno), *$6, $8, $1, $2, yylineno); free($4); delete $6; }
-    // | access_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' ';'                                            { $$ = new ASTFunctionDeclaration(new ASTIdentifier($3, yylineno), *$5, nullptr, $1, yylineno); free($3); delete $5; }
-    // | access_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier ';'                             { $$ = new ASTFunctionDeclaration(new ASTIdentifier($3, yylineno), *$5, $7,      $1, yylineno); free($3); delete $5; }
-    // | storage_class_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' ';'                    { $$ = new ASTFunctionDeclaration(new ASTIdentifier($3, yylineno), *$5, nullptr, ASTAccessSpecifier::Default, $1, yylineno); free($3); delete $5; }
-    // | storage_class_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier ';'     { $$ = new ASTFunctionDeclaration(new ASTIdentifier($3, yylineno), *$5, $7, ASTAccessSpecifier::Default, $1, yylineno); free($3); delete $5; }
-    // | FUNCTION IDENTIFIER '(' parameter_list_optional ')' ';'                                            { $$ = new ASTFunctionDeclaration(new ASTIdentifier($2, yylineno), *$4, nullptr, yylineno); free($2); delete $4; }
-    // | FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier ';'                             { $$ = new ASTFunctionDeclaration(new ASTIdentifier($2, yylineno), *$4, $6, yylineno); free($2); delete $4; }
+    : storage_class_specifier access_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' ';'                    { $$ = ctx->make<ASTFunctionDeclaration>(@$, ctx->make<ASTIdentifier>(@4, $4, yyget_lineno(scanner)), *$6, std::nullopt, yyget_lineno(scanner), $2, $1); }
+    | storage_class_specifier access_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier ';'     { $$ = ctx->make<ASTFunctionDeclaration>(@$, ctx->make<ASTIdentifier>(@4, $4, yyget_lineno(scanner)), *$6, $8, yyget_lineno(scanner), $2, $1); }
+    | access_specifier storage_class_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' ';'                    { $$ = ctx->make<ASTFunctionDeclaration>(@$, ctx->make<ASTIdentifier>(@4, $4, yyget_lineno(scanner)), *$6, std::nullopt, yyget_lineno(scanner), $1, $2); }
+    | access_specifier storage_class_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier ';'     { $$ = ctx->make<ASTFunctionDeclaration>(@$, ctx->make<ASTIdentifier>(@4, $4, yyget_lineno(scanner)), *$6, $8, yyget_lineno(scanner), $1, $2); }
+    | storage_class_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' ';'                                     { $$ = ctx->make<ASTFunctionDeclaration>(@$, ctx->make<ASTIdentifier>(@3, $3, yyget_lineno(scanner)), *$5, std::nullopt, yyget_lineno(scanner), ASTAccessSpecifier::Default, $1); }
+    | storage_class_specifier FUNCTION IDENTIFIER '(' parameter_list_optional ')' type_specifier ';'                      { $$ = ctx->make<ASTFunctionDeclaration>(@$, ctx->make<ASTIdentifier>(@3, $3, yyget_lineno(scanner)), *$5, $7, yyget_lineno(scanner), ASTAccessSpecifier::Default, $1); }
     ;
 
 parameter_list_optional
-    : /* empty */                                                           { $$ = new ASTFunctionParameters({}); }
+    : /* empty */                                                           { $$ = ctx->make<ASTFunctionParameters>(@$, std::vector<ASTFunctionParameter>{}); }
     | parameter_list                                                        { $$ = $1; }
     ;
 
 variable_declaration 
-    : HASH IDENTIFIER ':' type_specifier ';'                                { $$ = new ASTVariableDeclaration($2, $4, yylineno); free($2); }
-    | HASH IDENTIFIER '=' assignment_expression ';'                         { $$ = new ASTVariableDeclaration($2, std::nullopt, yylineno, $4); free($2); }
-    | HASH IDENTIFIER ':' type_specifier '=' assignment_expression ';'      { $$ = new ASTVariableDeclaration($2, $4, yylineno, $6); free($2); }
+    : HASH IDENTIFIER ':' type_specifier ';'                                { $$ = ctx->make<ASTVariableDeclaration>(@$, $2, $4, yyget_lineno(scanner)); }
+    | HASH IDENTIFIER '=' assignment_expression ';'                         { $$ = ctx->make<ASTVariableDeclaration>(@$, $2, std::nullopt, yyget_lineno(scanner), $4); }
+    | HASH IDENTIFIER ':' type_specifier '=' assignment_expression ';'      { $$ = ctx->make<ASTVariableDeclaration>(@$, $2, $4, yyget_lineno(scanner), $6); }
     ;
 
 global_variable_declaration 
-    : IDENTIFIER ':' type_specifier ';'                                                                         { $$ = new ASTGlobalVariableDeclaration($1, $3, std::nullopt, yylineno); free($1); }
-    | IDENTIFIER '=' assignment_expression ';'                                                                  { $$ = new ASTGlobalVariableDeclaration($1, std::nullopt, $3, yylineno); free($1); }
-    | IDENTIFIER ':' type_specifier '=' assignment_expression ';'                                               { $$ = new ASTGlobalVariableDeclaration($1, $3, $5, yylineno); free($1); }
-    | access_specifier IDENTIFIER ':' type_specifier ';'                                                        { $$ = new ASTGlobalVariableDeclaration($2, $4, std::nullopt, yylineno); free($2); }
-    | access_specifier IDENTIFIER '=' assignment_expression ';'                                                 { $$ = new ASTGlobalVariableDeclaration($2, std::nullopt, $4, yylineno); free($2); }
-    | access_specifier IDENTIFIER ':' type_specifier '=' assignment_expression ';'                              { $$ = new ASTGlobalVariableDeclaration($2, $4, $6, yylineno); free($2); }
-    | access_specifier storage_class_specifier IDENTIFIER ':' type_specifier ';'                                { $$ = new ASTGlobalVariableDeclaration($3, $5, std::nullopt, yylineno, $1, $2); free($3); }
-    | access_specifier storage_class_specifier IDENTIFIER '=' assignment_expression ';'                         { $$ = new ASTGlobalVariableDeclaration($3, std::nullopt, $5, yylineno, $1, $2); free($3); }
-    | access_specifier storage_class_specifier IDENTIFIER ':' type_specifier '=' assignment_expression ';'      { $$ = new ASTGlobalVariableDeclaration($3, $5, $7, yylineno, $1, $2); free($3); }
-    | storage_class_specifier IDENTIFIER ':' type_specifier ';'                                                 { $$ = new ASTGlobalVariableDeclaration($2, $4, std::nullopt, yylineno, ASTAccessSpecifier::Default, $1); free($2); }
-    | storage_class_specifier IDENTIFIER '=' assignment_expression ';'                                          { $$ = new ASTGlobalVariableDeclaration($2, std::nullopt, $4, yylineno, ASTAccessSpecifier::Default, $1); free($2); }
-    | storage_class_specifier IDENTIFIER ':' type_specifier '=' assignment_expression ';'                       { $$ = new ASTGlobalVariableDeclaration($2, $4, $6, yylineno, ASTAccessSpecifier::Default, $1); free($2); }
+    : IDENTIFIER ':' type_specifier ';'                                                                         { $$ = ctx->make<ASTGlobalVariableDeclaration>(@$, $1, $3, std::nullopt, yyget_lineno(scanner)); }
+    | IDENTIFIER '=' assignment_expression ';'                                                                  { $$ = ctx->make<ASTGlobalVariableDeclaration>(@$, $1, std::nullopt, $3, yyget_lineno(scanner)); }
+    | IDENTIFIER ':' type_specifier '=' assignment_expression ';'                                               { $$ = ctx->make<ASTGlobalVariableDeclaration>(@$, $1, $3, $5, yyget_lineno(scanner)); }
+    | access_specifier IDENTIFIER ':' type_specifier ';'                                                        { $$ = ctx->make<ASTGlobalVariableDeclaration>(@$, $2, $4, std::nullopt, yyget_lineno(scanner)); }
+    | access_specifier IDENTIFIER '=' assignment_expression ';'                                                 { $$ = ctx->make<ASTGlobalVariableDeclaration>(@$, $2, std::nullopt, $4, yyget_lineno(scanner)); }
+    | access_specifier IDENTIFIER ':' type_specifier '=' assignment_expression ';'                              { $$ = ctx->make<ASTGlobalVariableDeclaration>(@$, $2, $4, $6, yyget_lineno(scanner)); }
+    | access_specifier storage_class_specifier IDENTIFIER ':' type_specifier ';'                                { $$ = ctx->make<ASTGlobalVariableDeclaration>(@$, $3, $5, std::nullopt, yyget_lineno(scanner), $1, $2); }
+    | access_specifier storage_class_specifier IDENTIFIER '=' assignment_expression ';'                         { $$ = ctx->make<ASTGlobalVariableDeclaration>(@$, $3, std::nullopt, $5, yyget_lineno(scanner), $1, $2); }
+    | access_specifier storage_class_specifier IDENTIFIER ':' type_specifier '=' assignment_expression ';'      { $$ = ctx->make<ASTGlobalVariableDeclaration>(@$, $3, $5, $7, yyget_lineno(scanner), $1, $2); }
+    | storage_class_specifier IDENTIFIER ':' type_specifier ';'                                                 { $$ = ctx->make<ASTGlobalVariableDeclaration>(@$, $2, $4, std::nullopt, yyget_lineno(scanner), ASTAccessSpecifier::Default, $1); }
+    | storage_class_specifier IDENTIFIER '=' assignment_expression ';'                                          { $$ = ctx->make<ASTGlobalVariableDeclaration>(@$, $2, std::nullopt, $4, yyget_lineno(scanner), ASTAccessSpecifier::Default, $1); }
+    | storage_class_specifier IDENTIFIER ':' type_specifier '=' assignment_expression ';'                       { $$ = ctx->make<ASTGlobalVariableDeclaration>(@$, $2, $4, $6, yyget_lineno(scanner), ASTAccessSpecifier::Default, $1); }
     ;                   
 
 %%
 
-int yyerror(const char *msg)
+void yyerror(YYLTYPE *loc, yyscan_t scanner, ParserContext *ctx, const char *msg)
 {
-    yyerrormsg = (char *) msg;
-    return 1;
+    ctx->reportError(msg);
 }
@@ -3,38 +3,123 @@
 #include "lexer/lexer.hpp"
 #include "util/util.hpp"
 
-std::pair<std::shared_ptr<std::string>, ASTProgram *> parseProgram(const std::string &inputFile)
+ParserContext::ParserContext(const std::string &fileName, bool lexOnly, util::DiagnosticEngine *diagnostics)
+    : fileName_(fileName), scanner_(nullptr), program_(nullptr), diagnostics_(diagnostics), errorMsg_(), errorLineNumber_(0), errorCount_(0), tokenRange_(), lexOnly_(lexOnly)
 {
-    astProgram = nullptr;
-    yyin = nullptr;
-    yyin = fopen(inputFile.c_str(), "r");
-    if (!yyin)
+    if (yylex_init_extra(this, &scanner_) != 0)
     {
-        std::cerr << "(Error) Could not open file '" << inputFile << "'." << std::endl;
+        std::cerr << "(Error) Could not initialize lexer for file '" << fileName_ << "'." << std::endl;
         std::exit(1);
     }
+}
 
-    set_lex_only_option(0);
-    yyfilename = (char *)inputFile.c_str();
+ParserContext::~ParserContext()
+{
+    yylex_destroy(scanner_);
+    delete program_;
+}
 
-    const std::string fileContent = util::readFileContent(inputFile);
+void ParserContext::setInput(FILE *input)
+{
+    yyset_in(input, scanner_);
+}
 
-    if (yyparse() != 0)
+void ParserContext::setInput(std::shared_ptr<util::SourceBuffer> source)
+{
+    source_ = std::move(source);
+    if (!yy_scan_buffer(source_->getScanBuffer(), source_->getScanBufferSize(), scanner_))
     {
-        std::string errorMsg = yyerrormsg;
-        util::displayErrorPanel(inputFile, fileContent, yylineno, errorMsg);
+        std::cerr << "(Error) Could not initialize lexer buffer for file '" << fileName_ << "'." << std::endl;
         std::exit(1);
     }
+}
 
-    fclose(yyin);
-    yylex_destroy();
+int ParserContext::parse()
+{
+    int result = yyparse(scanner_, this);
+    yyrestore_hold_char(scanner_);
 
-    if (!astProgram)
+    if (program_)
+    {
+        program_->setRange(util::SourceRange{0, tokenRange_.end});
+        program_->setFileId(source_ ? source_->getFileId() : 0);
+    }
+
+    // the parser returns success after recovering from errors.
+    return hasError() ? 1 : result;
+}
+
+int ParserContext::lex(YYSTYPE *lval)
+{
+    YYLTYPE lloc;
+    return yylex(lval, &lloc, scanner_);
+}
+
+const char *ParserContext::getTokenText() const
+{
+    return yyget_text(scanner_);
+}
+
+int ParserContext::getLineNumber() const
+{
+    return yyget_lineno(scanner_);
+}
+
+void ParserContext::setProgram(ASTProgram *program)
+{
+    delete program_;
+    program_ = program;
+}
+
+ASTProgram *ParserContext::releaseProgram()
+{
+    ASTProgram *program = program_;
+    program_ = nullptr;
+    return program;
+}
+
+void ParserContext::reportError(const std::string &msg)
+{
+    if (errorCount_++ == 0)
+    {
+        errorMsg_ = msg;
+        errorLineNumber_ = getLineNumber();
+    }
+
+    if (diagnostics_)
+    {
+        diagnostics_->error(source_, getLineNumber(), msg, getTokenRange());
+    }
+}
+
+std::pair<std::shared_ptr<util::SourceBuffer>, ASTProgram *> parseProgram(std::shared_ptr<util::SourceBuffer> source, util::DiagnosticEngine &diagnostics)
+{
+    const std::string &inputFile = source->getFileName();
+
+    ParserContext ctx(inputFile, false, &diagnostics);
+    ctx.setInput(source);
+
+    if (ctx.parse() != 0)
+    {
+        if (!ctx.hasError())
+        {
+            diagnostics.error(source, ctx.getLineNumber(), "Parser stopped unexpectedly.");
+        }
+        return std::make_pair(source, nullptr);
+    }
+
+    ASTProgram *program = ctx.releaseProgram();
+    if (!program)
     {
         std::cerr << "(Error) ASTProgram is not initialized correctly." << std::endl;
         std::cerr << "        File: " << inputFile << std::endl;
         std::exit(1);
     }
 
-    return std::make_pair(std::make_shared<std::string>(fileContent), (ASTProgram *)astProgram);
+    return std::make_pair(source, program);
+}
+
+std::pair<std::shared_ptr<util::SourceBuffer>, ASTProgram *> parseProgram(const std::string &inputFile, util::DiagnosticEngine &diagnostics)
+{
+    return parseProgram(util::SourceBuffer::open(inputFile), diagnostics);
 }
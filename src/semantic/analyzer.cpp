@@ -0,0 +1,1003 @@
+#include <functional>
+#include <unordered_set>
+#include "ast/ast.hpp"
+#include "semantic/analyzer.hpp"
+#include "semantic/constant.hpp"
+#include "llvm/Support/MathExtras.h"
+
+namespace semantic
+{
+    const std::string formatDeclarationKind(Declaration::Kind kind)
+    {
+        switch (kind)
+        {
+        case Declaration::Kind::GlobalVariable:
+            return "Global variable";
+        case Declaration::Kind::LocalVariable:
+            return "Variable";
+        case Declaration::Kind::Parameter:
+            return "Parameter";
+        case Declaration::Kind::Function:
+            return "Function";
+        case Declaration::Kind::TypeAlias:
+            return "Type";
+        case Declaration::Kind::Struct:
+            return "Struct";
+        case Declaration::Kind::Enum:
+            return "Enum";
+        default:
+            return "Declaration";
+        }
+    }
+
+    Declaration *Module::createDeclaration(Declaration::Kind kind, Symbol name, const Type *type, const ASTNode *node)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return &declarations_.emplace_back(Declaration{kind, name, type, node});
+    }
+
+    Declaration *Module::addGlobal(Declaration *declaration)
+    {
+        auto [it, inserted] = globals_.emplace(declaration->name, declaration);
+        return inserted ? nullptr : it->second;
+    }
+
+    Declaration *Module::lookupGlobal(Symbol name) const
+    {
+        auto it = globals_.find(name);
+        return it == globals_.end() ? nullptr : it->second;
+    }
+
+    const Declaration *LocalScope::lookup(Symbol name) const
+    {
+        for (auto it = declarations_.rbegin(); it != declarations_.rend(); ++it)
+        {
+            if ((*it)->name == name)
+            {
+                return *it;
+            }
+        }
+        return nullptr;
+    }
+
+    bool LocalScope::isDeclaredInCurrentLevel(Symbol name) const
+    {
+        for (std::size_t i = levels_.back(); i < declarations_.size(); ++i)
+        {
+            if (declarations_[i]->name == name)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Analyzer::error(const ASTNode *node, const std::string &message)
+    {
+        ++errorCount_;
+        diagnostics_.error(source_, node->getRange(), message);
+    }
+
+    const Declaration *Analyzer::lookup(FunctionState *fn, Symbol name)
+    {
+        if (fn)
+        {
+            if (const Declaration *local = fn->scope.lookup(name))
+            {
+                return local;
+            }
+        }
+        return module_.lookupGlobal(name);
+    }
+
+    // Module level names are visible in the whole module regardless of where
+    // they are declared, so they are all collected before anything is resolved.
+    void Analyzer::analyzeProgram(ASTProgram *program)
+    {
+        for (ASTNodePtr statement : program->getStatementList()->getStatements())
+        {
+            if (statement)
+            {
+                declareGlobal(statement);
+            }
+        }
+
+        for (Declaration *declaration : globals_)
+        {
+            resolveDeclaration(declaration);
+        }
+
+        for (Declaration *declaration : globals_)
+        {
+            if (declaration->kind == Declaration::Kind::Struct)
+            {
+                checkStructCycles(declaration);
+                checkSoaColumns(declaration);
+            }
+        }
+
+        // Bodies only read module level declarations from here on.
+        for (Declaration *declaration : globals_)
+        {
+            if (declaration->kind == Declaration::Kind::Function)
+            {
+                analyzeFunctionBody(declaration);
+            }
+        }
+    }
+
+    Declaration *Analyzer::declare(Declaration::Kind kind, Symbol name, const ASTNode *node, const Type *type)
+    {
+        Declaration *declaration = module_.createDeclaration(kind, name, type, node);
+        if (module_.addGlobal(declaration))
+        {
+            error(node, formatDeclarationKind(kind) + " '" + name.str() + "' is already defined in this module.");
+            return nullptr;
+        }
+
+        globals_.push_back(declaration);
+        resolveStates_[declaration] = ResolveState::Unresolved;
+        return declaration;
+    }
+
+    void Analyzer::declareGlobal(ASTNodePtr node)
+    {
+        switch (node->getType())
+        {
+        case ASTNode::NodeType::ImportStatement:
+            break;
+        case ASTNode::NodeType::TypeDefStatement:
+        {
+            ASTTypeDefStatement *typeDef = static_cast<ASTTypeDefStatement *>(node);
+            declare(Declaration::Kind::TypeAlias, typeDef->getSymbol(), typeDef);
+        }
+        break;
+        case ASTNode::NodeType::StructDefinition:
+        {
+            ASTStructDefinition *structDef = static_cast<ASTStructDefinition *>(node);
+            if (!structDef->getName().has_value())
+            {
+                error(structDef, "Struct definition at module level must have a name.");
+                break;
+            }
+
+            Symbol name = structDef->getName().value();
+            declare(Declaration::Kind::Struct, name, structDef, types_.createStructType(name, structDef));
+        }
+        break;
+        case ASTNode::NodeType::EnumDefinition:
+        {
+            ASTEnumDefinition *enumDef = static_cast<ASTEnumDefinition *>(node);
+            if (!enumDef->getName().has_value())
+            {
+                error(enumDef, "Enum definition at module level must have a name.");
+                break;
+            }
+
+            Symbol name = enumDef->getName().value();
+            declare(Declaration::Kind::Enum, name, enumDef, types_.createEnumType(name, enumDef));
+        }
+        break;
+        case ASTNode::NodeType::FunctionDefinition:
+        {
+            ASTFunctionDefinition *funcDef = static_cast<ASTFunctionDefinition *>(node);
+            ASTIdentifier *funcName = static_cast<ASTIdentifier *>(funcDef->getExpr());
+            if (Declaration *declaration = declare(Declaration::Kind::Function, funcName->getSymbol(), funcDef))
+            {
+                funcName->setDeclaration(declaration);
+            }
+        }
+        break;
+        case ASTNode::NodeType::FunctionDeclaration:
+        {
+            ASTFunctionDeclaration *funcDecl = static_cast<ASTFunctionDeclaration *>(node);
+            ASTIdentifier *funcName = static_cast<ASTIdentifier *>(funcDecl->getExpr());
+            if (Declaration *declaration = declare(Declaration::Kind::Function, funcName->getSymbol(), funcDecl))
+            {
+                funcName->setDeclaration(declaration);
+            }
+        }
+        break;
+        case ASTNode::NodeType::GlobalVariableDeclaration:
+        {
+            ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(node);
+            declare(Declaration::Kind::GlobalVariable, varDecl->getSymbol(), varDecl);
+        }
+        break;
+        case ASTNode::NodeType::VariableDeclaration:
+            error(node, "Variables declared with '#' are local to a function, global variables are declared without it.");
+            break;
+        default:
+            error(node, "Only declarations are allowed at module level.");
+            break;
+        }
+    }
+
+    void Analyzer::resolveDeclaration(Declaration *declaration)
+    {
+        ResolveState &state = resolveStates_[declaration];
+        if (state == ResolveState::Resolved)
+        {
+            return;
+        }
+
+        if (state == ResolveState::Resolving)
+        {
+            error(declaration->node, formatDeclarationKind(declaration->kind) + " '" + declaration->name.str() + "' depends on itself.");
+            declaration->type = types_.getInvalidType();
+            state = ResolveState::Resolved;
+            return;
+        }
+
+        state = ResolveState::Resolving;
+
+        switch (declaration->kind)
+        {
+        case Declaration::Kind::TypeAlias:
+            resolveTypeAlias(declaration);
+            break;
+        case Declaration::Kind::Struct:
+            resolveStruct(declaration);
+            break;
+        case Declaration::Kind::Enum:
+            resolveEnum(declaration);
+            break;
+        case Declaration::Kind::Function:
+            resolveFunction(declaration);
+            break;
+        case Declaration::Kind::GlobalVariable:
+            resolveGlobalVariable(declaration);
+            break;
+        default:
+            break;
+        }
+
+        state = ResolveState::Resolved;
+    }
+
+    void Analyzer::resolveTypeAlias(Declaration *declaration)
+    {
+        const ASTTypeDefStatement *typeDef = static_cast<const ASTTypeDefStatement *>(declaration->node);
+        const Type *type = resolveType(nullptr, &typeDef->getTypeSpecifier());
+
+        // a cycle through this alias already set the type and reported it.
+        if (!declaration->type)
+        {
+            declaration->type = type;
+        }
+        typeDef->setSemanticType(declaration->type);
+    }
+
+    void Analyzer::resolveStruct(Declaration *declaration)
+    {
+        const ASTStructDefinition *structDef = static_cast<const ASTStructDefinition *>(declaration->node);
+        Type *structType = const_cast<Type *>(declaration->type);
+        std::vector<Type::Field> fields;
+
+        for (const ASTStructField &member : structDef->getMembers())
+        {
+            const Type *fieldType = resolveType(nullptr, &member.getTypeSpecifier());
+            member.setSemanticType(fieldType);
+
+            bool duplicate = false;
+            for (const Type::Field &field : fields)
+            {
+                duplicate = duplicate || field.name == member.getSymbol();
+            }
+
+            if (duplicate)
+            {
+                error(&member, "Field '" + member.getName() + "' is already declared in struct '" + declaration->name.str() + "'.");
+                continue;
+            }
+
+            if (fieldType->is(Type::Kind::Void))
+            {
+                error(&member, "Field '" + member.getName() + "' cannot have type 'void'.");
+                fieldType = types_.getInvalidType();
+            }
+
+            fields.push_back(Type::Field{member.getSymbol(), fieldType});
+        }
+
+        // methods are not resolved until code generation supports them.
+        structType->setFields(std::move(fields));
+        structType->setLayout(resolveStructLayout(structDef));
+        structDef->setSemanticType(structType);
+    }
+
+    Type::Layout Analyzer::resolveStructLayout(const ASTStructDefinition *structDef)
+    {
+        // the largest alignment LLVM can express.
+        constexpr std::uint64_t maxAlignment = std::uint64_t(1) << 29;
+        Type::Layout layout;
+        std::unordered_set<Symbol> seen;
+
+        for (const ASTStructAttribute &attribute : structDef->getAttributes())
+        {
+            const std::string &name = attribute.getName();
+            if (!seen.insert(attribute.getSymbol()).second)
+            {
+                error(&attribute, "Attribute '" + name + "' is given more than once.");
+                continue;
+            }
+
+            if (name == "packed" || name == "reorder")
+            {
+                if (attribute.getArgument().has_value())
+                {
+                    error(&attribute, "Attribute '" + name + "' takes no argument.");
+                }
+                (name == "packed" ? layout.packed : layout.reorder) = true;
+            }
+            else if (name == "align")
+            {
+                std::optional<std::uint64_t> alignment = evaluateAttributeArgument(attribute);
+                if (!alignment.has_value())
+                {
+                    continue;
+                }
+
+                if (!llvm::isPowerOf2_64(alignment.value()) || alignment.value() > maxAlignment)
+                {
+                    error(attribute.getArgument().value(), "Alignment must be a power of two no larger than " + std::to_string(maxAlignment) + ".");
+                    continue;
+                }
+                layout.alignment = alignment.value();
+            }
+            else if (name == "soa")
+            {
+                std::optional<std::uint64_t> capacity = evaluateAttributeArgument(attribute);
+                if (!capacity.has_value())
+                {
+                    continue;
+                }
+
+                if (capacity.value() == 0)
+                {
+                    error(attribute.getArgument().value(), "A soa struct must hold at least one row.");
+                    continue;
+                }
+                layout.soaCapacity = capacity.value();
+            }
+            else
+            {
+                error(&attribute, "Unknown struct attribute '" + name + "', expected 'packed', 'align', 'reorder' or 'soa'.");
+            }
+        }
+
+        // packing already leaves no padding to save.
+        if (layout.packed && layout.reorder)
+        {
+            error(structDef, "A struct cannot be both packed and reordered.");
+            layout.reorder = false;
+        }
+
+        // columns hold elements of a single type, they have no padding to remove.
+        if (layout.soaCapacity && (layout.packed || layout.reorder))
+        {
+            error(structDef, "A soa struct cannot also be packed or reordered.");
+            layout.packed = false;
+            layout.reorder = false;
+        }
+        return layout;
+    }
+
+    // The argument of `align(N)` or `soa(N)`: a constant, non-negative integer.
+    std::optional<std::uint64_t> Analyzer::evaluateAttributeArgument(const ASTStructAttribute &attribute)
+    {
+        const std::string &name = attribute.getName();
+        if (!attribute.getArgument().has_value())
+        {
+            error(&attribute, "Attribute '" + name + "' requires an argument, e.g. '" + name + "(16)'.");
+            return std::nullopt;
+        }
+
+        ASTNodePtr argument = attribute.getArgument().value();
+        const Type *argumentType = analyzeExpr(nullptr, argument);
+        if (argumentType->isInvalid())
+        {
+            return std::nullopt;
+        }
+        if (!argumentType->isInteger())
+        {
+            error(argument, "Argument of '" + name + "' must be an integer, got '" + argumentType->toString() + "'.");
+            return std::nullopt;
+        }
+
+        ConstantEvaluator evaluator;
+        std::optional<ConstantValue> value = evaluator.evaluate(argument, argumentType);
+        if (!value.has_value())
+        {
+            error(evaluator.getErrorNode(), evaluator.getError());
+            return std::nullopt;
+        }
+
+        const llvm::APInt &integer = value->getInteger();
+        if ((argumentType->isSigned() && integer.isNegative()) || integer.getActiveBits() > 64)
+        {
+            error(argument, "Argument of '" + name + "' is out of range.");
+            return std::nullopt;
+        }
+        return integer.getZExtValue();
+    }
+
+    void Analyzer::resolveEnum(Declaration *declaration)
+    {
+        const ASTEnumDefinition *enumDef = static_cast<const ASTEnumDefinition *>(declaration->node);
+        Type *enumType = const_cast<Type *>(declaration->type);
+        std::vector<Type::Variant> variants;
+        std::int64_t nextDiscriminant = 0;
+
+        auto isDeclared = [&variants](Symbol name)
+        {
+            for (const Type::Variant &variant : variants)
+            {
+                if (variant.name == name)
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        for (const auto &[name, value] : enumDef->getFields())
+        {
+            if (isDeclared(name))
+            {
+                error(enumDef, "Variant '" + name.str() + "' is already declared in enum '" + declaration->name.str() + "'.");
+                continue;
+            }
+
+            if (value.has_value())
+            {
+                const Type *valueType = analyzeExpr(nullptr, value.value());
+                if (!valueType->isInteger() && !valueType->isInvalid())
+                {
+                    error(value.value(), "Value of enumerator '" + name.str() + "' must be an integer, found '" + valueType->toString() + "'.");
+                }
+                else if (valueType->isInteger())
+                {
+                    ConstantEvaluator evaluator;
+                    std::optional<ConstantValue> discriminant = evaluator.evaluate(value.value(), types_.getPrimitiveType(Type::Kind::Int64));
+                    if (!discriminant.has_value())
+                    {
+                        error(evaluator.getErrorNode(), evaluator.getError());
+                    }
+                    else
+                    {
+                        nextDiscriminant = discriminant->getInteger().getSExtValue();
+                    }
+                }
+            }
+
+            variants.push_back(Type::Variant{name, {}, nextDiscriminant++});
+        }
+
+        for (const ASTEnumVariant &variant : enumDef->getVariants())
+        {
+            if (isDeclared(variant.getSymbol()))
+            {
+                error(enumDef, "Variant '" + variant.getName() + "' is already declared in enum '" + declaration->name.str() + "'.");
+                continue;
+            }
+
+            std::vector<const Type *> payload;
+            for (const ASTEnumVariantItem &item : variant.getItems())
+            {
+                const Type *itemType = resolveType(nullptr, &item.getTypeSpecifier());
+                if (itemType->is(Type::Kind::Void))
+                {
+                    error(&item.getTypeSpecifier(), "Variant '" + variant.getName() + "' cannot hold a value of type 'void'.");
+                    itemType = types_.getInvalidType();
+                }
+                payload.push_back(itemType);
+            }
+
+            variants.push_back(Type::Variant{variant.getSymbol(), std::move(payload), nextDiscriminant++});
+        }
+
+        // the tag tells the variants apart, so no two can share a value.
+        for (std::size_t i = 0; i < variants.size(); ++i)
+        {
+            for (std::size_t j = 0; j < i; ++j)
+            {
+                if (variants[i].discriminant == variants[j].discriminant)
+                {
+                    error(enumDef, "Variant '" + variants[i].name.str() + "' has the same value " + std::to_string(variants[i].discriminant) + " as '" + variants[j].name.str() + "'.");
+                    break;
+                }
+            }
+        }
+
+        enumType->setVariants(std::move(variants));
+        enumDef->setSemanticType(enumType);
+    }
+
+    // A struct holding itself by value, directly or through other structs and
+    // enums, would be of infinite size.
+    void Analyzer::checkStructCycles(Declaration *declaration)
+    {
+        const Type *root = declaration->type;
+        std::unordered_set<const Type *> visited;
+
+        std::function<bool(const Type *)> contains = [&](const Type *type) -> bool
+        {
+            type = type->getUnqualified();
+            if (type == root)
+            {
+                return true;
+            }
+            if (!visited.insert(type).second)
+            {
+                return false;
+            }
+
+            if (type->is(Type::Kind::Struct))
+            {
+                for (const Type::Field &field : type->getFields())
+                {
+                    if (contains(field.type))
+                    {
+                        return true;
+                    }
+                }
+            }
+            else if (type->is(Type::Kind::Enum))
+            {
+                for (const Type::Variant &variant : type->getVariants())
+                {
+                    for (const Type *item : variant.payload)
+                    {
+                        if (contains(item))
+                        {
+                            return true;
+                        }
+                    }
+                }
+            }
+            return false;
+        };
+
+        for (const Type::Field &field : root->getFields())
+        {
+            if (contains(field.type))
+            {
+                error(declaration->node, "Struct '" + declaration->name.str() + "' contains itself by value, use a pointer instead.");
+                return;
+            }
+        }
+    }
+
+    // A reference is never null, and enum layouts store other variants in that
+    // value. So memory that starts out zero must not hold one, directly or
+    // inside a struct or an enum payload.
+    bool Analyzer::holdsReference(const Type *type)
+    {
+        std::unordered_set<const Type *> visited;
+
+        std::function<bool(const Type *)> holds = [&](const Type *type) -> bool
+        {
+            type = type->getUnqualified();
+            if (type->is(Type::Kind::Reference))
+            {
+                return true;
+            }
+            if (!visited.insert(type).second)
+            {
+                return false;
+            }
+
+            for (const Type::Field &field : type->getFields())
+            {
+                if (holds(field.type))
+                {
+                    return true;
+                }
+            }
+            for (const Type::Variant &variant : type->getVariants())
+            {
+                for (const Type *item : variant.payload)
+                {
+                    if (holds(item))
+                    {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        };
+
+        return holds(type);
+    }
+
+    // The columns of a soa struct start out zero.
+    void Analyzer::checkSoaColumns(Declaration *declaration)
+    {
+        const Type *structType = declaration->type;
+        if (!structType->getLayout().soaCapacity)
+        {
+            return;
+        }
+
+        const ASTStructDefinition *structDef = static_cast<const ASTStructDefinition *>(declaration->node);
+        for (const ASTStructField &member : structDef->getMembers())
+        {
+            if (member.getSemanticType() && holdsReference(member.getSemanticType()))
+            {
+                error(&member, "Field '" + member.getName() + "' of soa struct '" + declaration->name.str() + "' cannot hold a reference.");
+            }
+        }
+    }
+
+    const ASTFunctionParameters &Analyzer::getFunctionParameters(const Declaration *function)
+    {
+        if (function->node->getType() == ASTNode::NodeType::FunctionDeclaration)
+        {
+            return static_cast<const ASTFunctionDeclaration *>(function->node)->getParameters();
+        }
+        return static_cast<const ASTFunctionDefinition *>(function->node)->getParameters();
+    }
+
+    void Analyzer::resolveFunction(Declaration *declaration)
+    {
+        const ASTNode *node = declaration->node;
+        const ASTFunctionParameters &params = getFunctionParameters(declaration);
+        std::optional<ASTTypeSpecifier *> returnTypeSpecifier;
+        std::optional<ASTStorageClassSpecifier> storageClass;
+
+        if (node->getType() == ASTNode::NodeType::FunctionDeclaration)
+        {
+            const ASTFunctionDeclaration *funcDecl = static_cast<const ASTFunctionDeclaration *>(node);
+            returnTypeSpecifier = funcDecl->getReturnType();
+            storageClass = funcDecl->getStorageClassSpecifier();
+
+            // the body lives in another module, or in a C library.
+            if (!storageClass.has_value() || (storageClass.value() != ASTStorageClassSpecifier::Extern && storageClass.value() != ASTStorageClassSpecifier::ExternThreadLocal))
+            {
+                error(funcDecl, "Function declaration without a body must be extern.");
+            }
+        }
+        else
+        {
+            const ASTFunctionDefinition *funcDef = static_cast<const ASTFunctionDefinition *>(node);
+            returnTypeSpecifier = funcDef->getReturnType();
+            storageClass = funcDef->getStorageClassSpecifier();
+
+            if (storageClass.has_value() && storageClass.value() == ASTStorageClassSpecifier::Extern)
+            {
+                error(funcDef, "Function definition cannot get an extern storage class.");
+            }
+        }
+
+        if (storageClass == ASTStorageClassSpecifier::ThreadLocal || storageClass == ASTStorageClassSpecifier::ExternThreadLocal)
+        {
+            error(node, "Thread local storage class specifier is only supported for global variables.");
+        }
+
+        // a missing specifier, or one the parser left empty, means the function returns nothing.
+        const Type *returnType = types_.getPrimitiveType(Type::Kind::Void);
+        if (returnTypeSpecifier.has_value() && returnTypeSpecifier.value())
+        {
+            returnType = resolveType(nullptr, returnTypeSpecifier.value());
+        }
+
+        // the JIT and the C runtime both call main as `int main()`, so any other return type would be read back wrong.
+        // `int` is 32 bits wide, like int32.
+        bool isMainReturnType = returnType->is(Type::Kind::Void) || returnType->is(Type::Kind::Int32) || returnType->is(Type::Kind::Int);
+        if (declaration->name.str() == "main" && !isMainReturnType && !returnType->isInvalid())
+        {
+            error(node, "Function 'main' must return 'int', 'int32' or nothing, found '" + returnType->toString() + "'.");
+        }
+
+        std::vector<const Type *> paramTypes;
+        for (std::size_t i = 0; i < params.getList().size(); ++i)
+        {
+            const ASTFunctionParameter &param = params.getList()[i];
+            const Type *paramType = resolveType(nullptr, &param.getParamType());
+            param.setSemanticType(paramType);
+
+            for (std::size_t j = 0; j < i; ++j)
+            {
+                if (params.getList()[j].getParamSymbol() == param.getParamSymbol())
+                {
+                    error(&param, "Parameter '" + param.getParamName() + "' is already declared in function '" + declaration->name.str() + "'.");
+                    break;
+                }
+            }
+
+            if (paramType->is(Type::Kind::Void))
+            {
+                error(&param, "Parameter '" + param.getParamName() + "' cannot have type 'void'.");
+                paramType = types_.getInvalidType();
+            }
+
+            if (param.getDefaultValue())
+            {
+                const Type *valueType = analyzeExpr(nullptr, param.getDefaultValue());
+                checkAssignable(param.getDefaultValue(), valueType, paramType, "for the default value of parameter '" + param.getParamName() + "'");
+            }
+            else if (i > 0 && params.getList()[i - 1].getDefaultValue())
+            {
+                error(&param, "Parameter '" + param.getParamName() + "' must have a default value because the parameters before it have one.");
+            }
+
+            paramTypes.push_back(paramType);
+        }
+
+        bool isVariadic = params.getIsVariadic();
+        if (params.getTypedVariadic().has_value())
+        {
+            resolveType(nullptr, params.getTypedVariadic().value());
+            isVariadic = true;
+        }
+
+        declaration->type = types_.getFunctionType(returnType, paramTypes, isVariadic);
+        node->setSemanticType(declaration->type);
+    }
+
+    void Analyzer::resolveGlobalVariable(Declaration *declaration)
+    {
+        const ASTGlobalVariableDeclaration *varDecl = static_cast<const ASTGlobalVariableDeclaration *>(declaration->node);
+        const std::string &name = varDecl->getName();
+        const Type *varType = nullptr;
+
+        ASTAccessSpecifier accessSpecifier = varDecl->getAccessSpecifier();
+        if (accessSpecifier != ASTAccessSpecifier::Default && accessSpecifier != ASTAccessSpecifier::Private && accessSpecifier != ASTAccessSpecifier::Public)
+        {
+            error(varDecl, "Unsupported access specifier for global variable: " + formatAccessSpecifier(accessSpecifier));
+        }
+
+        if (varDecl->getStorageClassSpecifier().has_value())
+        {
+            ASTStorageClassSpecifier storageClass = varDecl->getStorageClassSpecifier().value();
+            if (varDecl->isExtern() && varDecl->getInitializer().has_value())
+            {
+                error(varDecl, "Extern storage class specifier cannot have an initializer.");
+            }
+            else if (storageClass == ASTStorageClassSpecifier::Inline)
+            {
+                error(varDecl, "Inline storage class specifier is not supported for global variables.");
+            }
+        }
+
+        if (varDecl->getTypeValue().has_value())
+        {
+            varType = resolveType(nullptr, varDecl->getTypeValue().value());
+        }
+
+        if (varDecl->getInitializer().has_value())
+        {
+            ASTNodePtr initializer = varDecl->getInitializer().value();
+            const Type *initType = analyzeExpr(nullptr, initializer);
+
+            if (varType)
+            {
+                checkAssignable(initializer, initType, varType, "in the initialization of '" + name + "'");
+            }
+            else
+            {
+                varType = initType;
+            }
+        }
+
+        if (!varType)
+        {
+            error(varDecl, "Global variable '" + name + "' needs a type or an initializer.");
+            varType = types_.getInvalidType();
+        }
+        else if (varType->is(Type::Kind::Void))
+        {
+            error(varDecl, "Global variable '" + name + "' cannot have type 'void'.");
+            varType = types_.getInvalidType();
+        }
+        else if (varType->is(Type::Kind::Reference))
+        {
+            error(varDecl, "Global variable '" + name + "' cannot be a reference.");
+            varType = types_.getInvalidType();
+        }
+        else if (holdsReference(varType))
+        {
+            // struct and enum values are not constants, so the global would start out zero.
+            error(varDecl, "Global variable '" + name + "' cannot hold a reference.");
+            varType = types_.getInvalidType();
+        }
+
+        if (!declaration->type)
+        {
+            declaration->type = varType;
+        }
+        varDecl->setSemanticType(declaration->type);
+
+        // globals are emitted as static data, so their initializer is folded at compile time.
+        // string literals are emitted as data of their own.
+        if (varDecl->getInitializer().has_value() && !declaration->type->isInvalid())
+        {
+            ASTNodePtr initializer = varDecl->getInitializer().value();
+            if (initializer->getType() != ASTNode::NodeType::StringLiteral && !initializer->getSemanticType()->isInvalid())
+            {
+                ConstantEvaluator evaluator;
+                if (!evaluator.evaluate(initializer, declaration->type))
+                {
+                    error(evaluator.getErrorNode(), evaluator.getError());
+                }
+            }
+        }
+    }
+
+    // Parameters live in the outermost level of the body, so the body cannot redeclare them.
+    void Analyzer::analyzeFunctionBody(const Declaration *declaration)
+    {
+        if (declaration->node->getType() != ASTNode::NodeType::FunctionDefinition || !declaration->type->is(Type::Kind::Function))
+        {
+            return;
+        }
+
+        const ASTFunctionDefinition *funcDef = static_cast<const ASTFunctionDefinition *>(declaration->node);
+
+        FunctionState fn{declaration, declaration->type->getReturnType(), LocalScope()};
+
+        const std::vector<ASTFunctionParameter> &params = funcDef->getParameters().getList();
+        const std::vector<const Type *> &paramTypes = declaration->type->getParamTypes();
+        for (std::size_t i = 0; i < params.size(); ++i)
+        {
+            if (!fn.scope.isDeclaredInCurrentLevel(params[i].getParamSymbol()))
+            {
+                fn.scope.declare(module_.createDeclaration(Declaration::Kind::Parameter, params[i].getParamSymbol(), paramTypes[i], &params[i]));
+            }
+        }
+
+        ASTStatementList *body = static_cast<ASTStatementList *>(funcDef->getBody());
+        analyzeStmts(fn, body->getStatements());
+
+        // like in C, main returns 0 when it ends without a return.
+        bool returnsValue = !fn.returnType->is(Type::Kind::Void) && !fn.returnType->isInvalid();
+        if (returnsValue && declaration->name.str() != "main" && completesNormally(body))
+        {
+            error(funcDef, "Function '" + declaration->name.str() + "' does not return a value on every path.");
+        }
+    }
+
+    const Type *Analyzer::resolveType(FunctionState *fn, const ASTTypeSpecifier *typeSpecifier)
+    {
+        using InternalType = ASTTypeSpecifier::ASTInternalType;
+        const Type *type = nullptr;
+
+        switch (typeSpecifier->getTypeValue())
+        {
+        case InternalType::Int:
+            type = types_.getPrimitiveType(Type::Kind::Int);
+            break;
+        case InternalType::Int8:
+            type = types_.getPrimitiveType(Type::Kind::Int8);
+            break;
+        case InternalType::Int16:
+            type = types_.getPrimitiveType(Type::Kind::Int16);
+            break;
+        case InternalType::Int32:
+            type = types_.getPrimitiveType(Type::Kind::Int32);
+            break;
+        case InternalType::Int64:
+            type = types_.getPrimitiveType(Type::Kind::Int64);
+            break;
+        case InternalType::Int128:
+            type = types_.getPrimitiveType(Type::Kind::Int128);
+            break;
+        case InternalType::UInt:
+            type = types_.getPrimitiveType(Type::Kind::UInt);
+            break;
+        case InternalType::UInt8:
+            type = types_.getPrimitiveType(Type::Kind::UInt8);
+            break;
+        case InternalType::UInt16:
+            type = types_.getPrimitiveType(Type::Kind::UInt16);
+            break;
+        case InternalType::UInt32:
+            type = types_.getPrimitiveType(Type::Kind::UInt32);
+            break;
+        case InternalType::UInt64:
+            type = types_.getPrimitiveType(Type::Kind::UInt64);
+            break;
+        case InternalType::UInt128:
+            type = types_.getPrimitiveType(Type::Kind::UInt128);
+            break;
+        case InternalType::Void:
+            type = types_.getPrimitiveType(Type::Kind::Void);
+            break;
+        case InternalType::Char:
+            type = types_.getPrimitiveType(Type::Kind::Char);
+            break;
+        case InternalType::Byte:
+            type = types_.getPrimitiveType(Type::Kind::Byte);
+            break;
+        case InternalType::String:
+            type = types_.getPrimitiveType(Type::Kind::String);
+            break;
+        case InternalType::Float32:
+            type = types_.getPrimitiveType(Type::Kind::Float32);
+            break;
+        case InternalType::Float64:
+            type = types_.getPrimitiveType(Type::Kind::Float64);
+            break;
+        case InternalType::Float128:
+            type = types_.getPrimitiveType(Type::Kind::Float128);
+            break;
+        case InternalType::Bool:
+            type = types_.getPrimitiveType(Type::Kind::Bool);
+            break;
+        case InternalType::Error:
+            type = types_.getPrimitiveType(Type::Kind::Error);
+            break;
+        case InternalType::Identifier:
+        {
+            ASTIdentifier *identifier = static_cast<ASTIdentifier *>(typeSpecifier->getInner());
+            type = resolveTypeName(fn, identifier->getSymbol(), identifier);
+        }
+        break;
+        case InternalType::Const:
+            type = types_.getConstType(resolveType(fn, static_cast<ASTTypeSpecifier *>(typeSpecifier->getInner())));
+            break;
+        case InternalType::Pointer:
+        case InternalType::Reference:
+        {
+            const Type *inner = resolveType(fn, static_cast<ASTTypeSpecifier *>(typeSpecifier->getInner()));
+            if (inner->is(Type::Kind::Reference))
+            {
+                error(typeSpecifier, "Cannot declare a pointer or reference to the reference type '" + inner->toString() + "'.");
+                type = types_.getInvalidType();
+            }
+            else if (typeSpecifier->getTypeValue() == InternalType::Pointer)
+            {
+                type = types_.getPointerType(inner);
+            }
+            else
+            {
+                type = types_.getReferenceType(inner);
+            }
+        }
+        break;
+        default:
+            type = types_.getInvalidType();
+            break;
+        }
+
+        typeSpecifier->setSemanticType(type);
+        return type;
+    }
+
+    const Type *Analyzer::resolveTypeName(FunctionState *fn, Symbol name, const ASTNode *node)
+    {
+        const Declaration *declaration = lookup(fn, name);
+        if (!declaration)
+        {
+            error(node, "Unknown type '" + name.str() + "'.");
+            return types_.getInvalidType();
+        }
+
+        if (node->getType() == ASTNode::NodeType::Identifier)
+        {
+            static_cast<const ASTIdentifier *>(node)->setDeclaration(declaration);
+        }
+
+        if (!declaration->isType())
+        {
+            error(node, "'" + name.str() + "' is not a type.");
+            return types_.getInvalidType();
+        }
+
+        // structs and enums have their type from the start, their bodies may refer back to them.
+        // aliases are only declared at module level.
+        if (declaration->kind == Declaration::Kind::TypeAlias)
+        {
+            resolveDeclaration(module_.lookupGlobal(name));
+        }
+        return declaration->type;
+    }
+
+    bool analyzeProgram(ASTProgram *program, Module &module, std::shared_ptr<util::SourceBuffer> source, util::DiagnosticEngine &diagnostics)
+    {
+        Analyzer analyzer(module, std::move(source), diagnostics);
+        analyzer.analyzeProgram(program);
+        return analyzer.getErrorCount() == 0;
+    }
+} // namespace semantic
@@ -0,0 +1,387 @@
+#include <algorithm>
+#include "llvm/ADT/APSInt.h"
+#include "llvm/ADT/StringExtras.h"
+#include "ast/ast.hpp"
+#include "semantic/constant.hpp"
+#include "semantic/declaration.hpp"
+
+namespace semantic
+{
+    const llvm::fltSemantics &getFloatSemantics(const Type *type)
+    {
+        switch (type->getUnqualified()->getKind())
+        {
+        case Type::Kind::Float32:
+            return llvm::APFloat::IEEEsingle();
+        case Type::Kind::Float64:
+            return llvm::APFloat::IEEEdouble();
+        default:
+            return llvm::APFloat::IEEEquad();
+        }
+    }
+
+    std::nullopt_t ConstantEvaluator::fail(const ASTNode *node, const std::string &message)
+    {
+        // keep the innermost reason, it points closest to the offending expression.
+        if (!errorNode_)
+        {
+            errorNode_ = node;
+            error_ = message;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<ConstantValue> ConstantEvaluator::evaluate(const ASTNode *node, const Type *type)
+    {
+        std::optional<ConstantValue> value = evaluateExpr(node);
+        if (!value)
+        {
+            return std::nullopt;
+        }
+        return convert(node, value.value(), type);
+    }
+
+    std::optional<ConstantValue> ConstantEvaluator::convert(const ASTNode *node, const ConstantValue &value, const Type *type)
+    {
+        const Type *from = value.getType();
+        type = type->getUnqualified();
+
+        if (type->is(Type::Kind::Bool))
+        {
+            return ConstantValue(type, llvm::APInt(1, value.isTrue()));
+        }
+
+        if (type->isInteger())
+        {
+            unsigned width = type->getBitWidth();
+            if (value.isInteger())
+            {
+                const llvm::APInt &integer = value.getInteger();
+                return ConstantValue(type, from->isSigned() ? integer.sextOrTrunc(width) : integer.zextOrTrunc(width));
+            }
+
+            llvm::APSInt result(width, !type->isSigned());
+            bool isExact = false;
+            if (value.getFloat().convertToInteger(result, llvm::APFloat::rmTowardZero, &isExact) & llvm::APFloat::opInvalidOp)
+            {
+                return fail(node, "Value does not fit in '" + type->toString() + "'.");
+            }
+            return ConstantValue(type, llvm::APInt(result));
+        }
+
+        if (type->isFloat())
+        {
+            llvm::APFloat result(getFloatSemantics(type));
+            if (value.isInteger())
+            {
+                result.convertFromAPInt(value.getInteger(), from->isSigned(), llvm::APFloat::rmNearestTiesToEven);
+            }
+            else
+            {
+                bool losesInfo = false;
+                result = value.getFloat();
+                result.convert(getFloatSemantics(type), llvm::APFloat::rmNearestTiesToEven, &losesInfo);
+            }
+            return ConstantValue(type, result);
+        }
+
+        return fail(node, "Expression is not a constant.");
+    }
+
+    std::optional<ConstantValue> ConstantEvaluator::evaluateExpr(const ASTNode *node)
+    {
+        const Type *type = node->getSemanticType();
+        if (!type || type->isInvalid())
+        {
+            return fail(node, "Expression is not a constant.");
+        }
+
+        switch (node->getType())
+        {
+        case ASTNode::NodeType::IntegerLiteral:
+            // the literal's type is wide enough for its value, nothing is cut off.
+            return ConstantValue(type, static_cast<const ASTIntegerLiteral *>(node)->getValue().zextOrTrunc(type->getBitWidth()));
+        case ASTNode::NodeType::FloatLiteral:
+        {
+            // the value is exact at the literal's own precision, convert() rounds it to the target once.
+            const ASTFloatLiteral *literal = static_cast<const ASTFloatLiteral *>(node);
+            if (literal->isFloat32())
+            {
+                return ConstantValue(type, llvm::APFloat(static_cast<float>(literal->getValue())));
+            }
+            return ConstantValue(type, llvm::APFloat(literal->getValue()));
+        }
+        case ASTNode::NodeType::BoolLiteral:
+            return ConstantValue(type, llvm::APInt(1, static_cast<const ASTBoolLiteral *>(node)->getValue()));
+        case ASTNode::NodeType::Identifier:
+            return evaluateIdentifier(node);
+        case ASTNode::NodeType::UnaryExpression:
+            return evaluateUnary(node);
+        case ASTNode::NodeType::BinaryExpression:
+            return evaluateBinary(node);
+        case ASTNode::NodeType::CastExpression:
+            return evaluate(static_cast<const ASTCastExpression *>(node)->getExpression(), type);
+        case ASTNode::NodeType::ConditionalExpression:
+            return evaluateConditional(node);
+        default:
+            return fail(node, "Expression is not a constant.");
+        }
+    }
+
+    // Only const globals have the same value everywhere, so only they can be folded.
+    std::optional<ConstantValue> ConstantEvaluator::evaluateIdentifier(const ASTNode *node)
+    {
+        const ASTIdentifier *identifier = static_cast<const ASTIdentifier *>(node);
+        const Declaration *declaration = identifier->getDeclaration();
+
+        if (!declaration || declaration->kind != Declaration::Kind::GlobalVariable || !declaration->type->isConst())
+        {
+            return fail(node, "'" + identifier->getName() + "' is not a constant, only const globals can be used in constant expressions.");
+        }
+
+        const ASTGlobalVariableDeclaration *varDecl = static_cast<const ASTGlobalVariableDeclaration *>(declaration->node);
+        if (varDecl->isExtern())
+        {
+            return fail(node, "'" + identifier->getName() + "' is defined in another module and is not a constant here.");
+        }
+
+        if (std::find(evaluating_.begin(), evaluating_.end(), varDecl) != evaluating_.end())
+        {
+            return fail(node, "'" + identifier->getName() + "' depends on itself.");
+        }
+
+        const Type *type = declaration->type->getUnqualified();
+        if (!varDecl->getInitializer().has_value())
+        {
+            if (type->isFloat())
+            {
+                return ConstantValue(type, llvm::APFloat::getZero(getFloatSemantics(type)));
+            }
+            if (type->isInteger() || type->is(Type::Kind::Bool))
+            {
+                return ConstantValue(type, llvm::APInt(type->getBitWidth(), 0));
+            }
+            return fail(node, "'" + identifier->getName() + "' is not a constant.");
+        }
+
+        evaluating_.push_back(varDecl);
+        std::optional<ConstantValue> value = evaluate(varDecl->getInitializer().value(), type);
+        evaluating_.pop_back();
+        return value;
+    }
+
+    std::optional<ConstantValue> ConstantEvaluator::evaluateUnary(const ASTNode *node)
+    {
+        using Operator = ASTUnaryExpression::Operator;
+        const ASTUnaryExpression *expr = static_cast<const ASTUnaryExpression *>(node);
+        const Type *type = expr->getSemanticType()->getUnqualified();
+
+        std::optional<ConstantValue> operand = evaluateExpr(expr->getOperand());
+        if (!operand)
+        {
+            return std::nullopt;
+        }
+
+        switch (expr->getOperator())
+        {
+        case Operator::Plus:
+            return convert(expr, operand.value(), type);
+        case Operator::Negate:
+            if (operand->isInteger())
+            {
+                return ConstantValue(type, -operand->getInteger());
+            }
+            else
+            {
+                llvm::APFloat value = operand->getFloat();
+                value.changeSign();
+                return ConstantValue(type, value);
+            }
+        case Operator::BitwiseNot:
+            return ConstantValue(type, ~operand->getInteger());
+        case Operator::LogicalNot:
+            return ConstantValue(type, llvm::APInt(1, !operand->isTrue()));
+        default:
+            return fail(expr, "Operator '" + expr->getOperatorString() + "' is not allowed in a constant expression.");
+        }
+    }
+
+    std::optional<ConstantValue> ConstantEvaluator::evaluateBinary(const ASTNode *node)
+    {
+        using Operator = ASTBinaryExpression::Operator;
+        const ASTBinaryExpression *expr = static_cast<const ASTBinaryExpression *>(node);
+        const Type *type = expr->getSemanticType()->getUnqualified();
+        Operator op = expr->getOperator();
+
+        std::optional<ConstantValue> lhs = evaluateExpr(expr->getLeft());
+        if (!lhs)
+        {
+            return std::nullopt;
+        }
+
+        // the right operand of `&&` and `||` is only evaluated when it decides the result.
+        if (op == Operator::LogicalAnd || op == Operator::LogicalOr)
+        {
+            if (lhs->isTrue() == (op == Operator::LogicalOr))
+            {
+                return ConstantValue(type, llvm::APInt(1, lhs->isTrue()));
+            }
+
+            std::optional<ConstantValue> rhs = evaluateExpr(expr->getRight());
+            if (!rhs)
+            {
+                return std::nullopt;
+            }
+            return ConstantValue(type, llvm::APInt(1, rhs->isTrue()));
+        }
+
+        std::optional<ConstantValue> rhs = evaluateExpr(expr->getRight());
+        if (!rhs)
+        {
+            return std::nullopt;
+        }
+
+        // pointer arithmetic has no value before the program is loaded.
+        if (!type->isArithmetic() && !type->is(Type::Kind::Bool))
+        {
+            return fail(expr, "Expression is not a constant.");
+        }
+
+        if (op == Operator::LeftShift || op == Operator::RightShift)
+        {
+            std::optional<ConstantValue> value = convert(expr->getLeft(), lhs.value(), type);
+            if (!value)
+            {
+                return std::nullopt;
+            }
+
+            const llvm::APInt &amount = rhs->getInteger();
+            bool isSigned = rhs->getType()->isSigned();
+            if ((isSigned && amount.isNegative()) || amount.uge(type->getBitWidth()))
+            {
+                return fail(expr->getRight(), "Shift amount " + llvm::toString(amount, 10, isSigned) + " is out of range for '" + type->toString() + "'.");
+            }
+
+            unsigned shift = static_cast<unsigned>(amount.getZExtValue());
+            const llvm::APInt &integer = value->getInteger();
+            if (op == Operator::LeftShift)
+            {
+                return ConstantValue(type, integer.shl(shift));
+            }
+            return ConstantValue(type, type->isSigned() ? integer.ashr(shift) : integer.lshr(shift));
+        }
+
+        // both operands are brought to a common type first, as in generated code.
+        const Type *operandType = getCommonArithmeticType(lhs->getType(), rhs->getType());
+        lhs = convert(expr->getLeft(), lhs.value(), operandType);
+        rhs = convert(expr->getRight(), rhs.value(), operandType);
+        if (!lhs || !rhs)
+        {
+            return std::nullopt;
+        }
+
+        if (operandType->isFloat())
+        {
+            llvm::APFloat a = lhs->getFloat();
+            const llvm::APFloat &b = rhs->getFloat();
+            llvm::APFloat::cmpResult order = a.compare(b);
+            auto rm = llvm::APFloat::rmNearestTiesToEven;
+
+            switch (op)
+            {
+            case Operator::Add:
+                a.add(b, rm);
+                return ConstantValue(type, a);
+            case Operator::Subtract:
+                a.subtract(b, rm);
+                return ConstantValue(type, a);
+            case Operator::Multiply:
+                a.multiply(b, rm);
+                return ConstantValue(type, a);
+            case Operator::Divide:
+                a.divide(b, rm);
+                return ConstantValue(type, a);
+            case Operator::Equal:
+                return ConstantValue(type, llvm::APInt(1, order == llvm::APFloat::cmpEqual));
+            case Operator::NotEqual:
+                return ConstantValue(type, llvm::APInt(1, order != llvm::APFloat::cmpEqual));
+            case Operator::LessThan:
+                return ConstantValue(type, llvm::APInt(1, order == llvm::APFloat::cmpLessThan));
+            case Operator::LessEqual:
+                return ConstantValue(type, llvm::APInt(1, order == llvm::APFloat::cmpLessThan || order == llvm::APFloat::cmpEqual));
+            case Operator::GreaterThan:
+                return ConstantValue(type, llvm::APInt(1, order == llvm::APFloat::cmpGreaterThan));
+            case Operator::GreaterEqual:
+                return ConstantValue(type, llvm::APInt(1, order == llvm::APFloat::cmpGreaterThan || order == llvm::APFloat::cmpEqual));
+            default:
+                return fail(expr, "Operator '" + expr->getOperatorString() + "' is not allowed in a constant expression.");
+            }
+        }
+
+        const llvm::APInt &a = lhs->getInteger();
+        const llvm::APInt &b = rhs->getInteger();
+        bool isSigned = operandType->isSigned();
+
+        switch (op)
+        {
+        case Operator::Add:
+            return ConstantValue(type, a + b);
+        case Operator::Subtract:
+            return ConstantValue(type, a - b);
+        case Operator::Multiply:
+            return ConstantValue(type, a * b);
+        case Operator::Divide:
+        case Operator::Remainder:
+        {
+            if (b.isZero())
+            {
+                return fail(expr, "Division by zero in constant expression.");
+            }
+
+            if (op == Operator::Remainder)
+            {
+                return ConstantValue(type, isSigned ? a.srem(b) : a.urem(b));
+            }
+
+            // the minimum value divided by -1 wraps around like the hardware does.
+            bool overflow = false;
+            return ConstantValue(type, isSigned ? a.sdiv_ov(b, overflow) : a.udiv(b));
+        }
+        case Operator::BitwiseAnd:
+            return ConstantValue(type, a & b);
+        case Operator::BitwiseOr:
+            return ConstantValue(type, a | b);
+        case Operator::BitwiseXor:
+            return ConstantValue(type, a ^ b);
+        case Operator::Equal:
+            return ConstantValue(type, llvm::APInt(1, a == b));
+        case Operator::NotEqual:
+            return ConstantValue(type, llvm::APInt(1, a != b));
+        case Operator::LessThan:
+            return ConstantValue(type, llvm::APInt(1, isSigned ? a.slt(b) : a.ult(b)));
+        case Operator::LessEqual:
+            return ConstantValue(type, llvm::APInt(1, isSigned ? a.sle(b) : a.ule(b)));
+        case Operator::GreaterThan:
+            return ConstantValue(type, llvm::APInt(1, isSigned ? a.sgt(b) : a.ugt(b)));
+        case Operator::GreaterEqual:
+            return ConstantValue(type, llvm::APInt(1, isSigned ? a.sge(b) : a.uge(b)));
+        default:
+            return fail(expr, "Operator '" + expr->getOperatorString() + "' is not allowed in a constant expression.");
+        }
+    }
+
+    std::optional<ConstantValue> ConstantEvaluator::evaluateConditional(const ASTNode *node)
+    {
+        const ASTConditionalExpression *expr = static_cast<const ASTConditionalExpression *>(node);
+
+        std::optional<ConstantValue> condition = evaluateExpr(expr->getCondition());
+        if (!condition)
+        {
+            return std::nullopt;
+        }
+
+        // like at runtime, only the selected branch has to be constant.
+        ASTNodePtr branch = condition->isTrue() ? expr->getTrueExpression() : expr->getFalseExpression();
+        return evaluate(branch, expr->getSemanticType());
+    }
+} // namespace semantic
@@ -0,0 +1,1077 @@
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include "ast/ast.hpp"
+#include "semantic/analyzer.hpp"
+#include "semantic/constant.hpp"
+
+namespace semantic
+{
+    // A reference behaves like the value it refers to.
+    static const Type *getValueType(const Type *type)
+    {
+        return type->is(Type::Kind::Reference) ? type->getElementType() : type;
+    }
+
+    bool Analyzer::isAssignable(const Type *from, const Type *to) const
+    {
+        if (from->isInvalid() || to->isInvalid())
+        {
+            return true;
+        }
+
+        from = getValueType(from)->getUnqualified();
+        to = to->getUnqualified();
+        if (from == to)
+        {
+            return true;
+        }
+
+        // numbers convert implicitly, lowering inserts the casts.
+        if (from->isArithmetic() && to->isArithmetic())
+        {
+            return true;
+        }
+
+        // a pointer may add const to what it points to, but never drop it.
+        if (from->is(Type::Kind::Pointer) && to->is(Type::Kind::Pointer))
+        {
+            const Type *fromElement = from->getElementType();
+            const Type *toElement = to->getElementType();
+            return fromElement->getUnqualified() == toElement->getUnqualified() && (toElement->isConst() || !fromElement->isConst());
+        }
+
+        return false;
+    }
+
+    // `int` unless the value needs more bits, like a C literal it never wraps.
+    const Type *Analyzer::getIntegerLiteralType(const llvm::APInt &value)
+    {
+        unsigned activeBits = value.getActiveBits();
+        if (activeBits < 32)
+        {
+            return types_.getPrimitiveType(Type::Kind::Int);
+        }
+        if (activeBits < 64)
+        {
+            return types_.getPrimitiveType(Type::Kind::Int64);
+        }
+        if (activeBits < 128)
+        {
+            return types_.getPrimitiveType(Type::Kind::Int128);
+        }
+        return types_.getPrimitiveType(Type::Kind::UInt128);
+    }
+
+    // An integer literal, or a negated one, converted to an integer type that
+    // cannot hold its value is reported instead of being truncated.
+    bool Analyzer::checkLiteralFits(const ASTNode *node, const Type *to)
+    {
+        bool isNegated = false;
+        if (node->getType() == ASTNode::NodeType::UnaryExpression)
+        {
+            const ASTUnaryExpression *unary = static_cast<const ASTUnaryExpression *>(node);
+            if (unary->getOperator() != ASTUnaryExpression::Operator::Negate)
+            {
+                return true;
+            }
+            node = unary->getOperand();
+            isNegated = true;
+        }
+
+        to = to->getUnqualified();
+        if (node->getType() != ASTNode::NodeType::IntegerLiteral || !to->isInteger())
+        {
+            return true;
+        }
+
+        llvm::APInt value = static_cast<const ASTIntegerLiteral *>(node)->getValue();
+        unsigned width = to->getBitWidth();
+        bool fits;
+        if (!isNegated)
+        {
+            fits = value.getActiveBits() <= (to->isSigned() ? width - 1 : width);
+        }
+        else
+        {
+            // the most negative value has one more step than the largest positive one.
+            fits = value.isZero() || (to->isSigned() && value.ule(llvm::APInt::getOneBitSet(128, width - 1)));
+        }
+
+        if (!fits)
+        {
+            llvm::SmallString<40> digits;
+            value.toStringUnsigned(digits);
+            error(node, "Integer literal '" + std::string(isNegated ? "-" : "") + digits.str().str() + "' does not fit in '" + to->toString() + "'.");
+        }
+        return fits;
+    }
+
+    bool Analyzer::checkAssignable(const ASTNode *node, const Type *from, const Type *to, const std::string &context)
+    {
+        if (isAssignable(from, to))
+        {
+            return checkLiteralFits(node, to);
+        }
+
+        error(node, "Cannot convert '" + from->toString() + "' to '" + to->toString() + "' " + context + ".");
+        return false;
+    }
+
+    bool Analyzer::checkBindable(const ASTNode *node, const Type *from, const Type *reference, const std::string &context)
+    {
+        if (from->isInvalid() || reference->isInvalid())
+        {
+            return true;
+        }
+
+        if (!isLValue(node))
+        {
+            error(node, "Cannot bind a reference to a temporary value " + context + ".");
+            return false;
+        }
+
+        if (isPackedField(node))
+        {
+            error(node, "Cannot bind a reference to a field of a packed struct " + context + ".");
+            return false;
+        }
+
+        const Type *referee = reference->getElementType();
+        from = getValueType(from);
+        if (from->getUnqualified() != referee->getUnqualified() || (from->isConst() && !referee->isConst()))
+        {
+            error(node, "Cannot bind '" + reference->toString() + "' to a value of type '" + from->toString() + "' " + context + ".");
+            return false;
+        }
+        return true;
+    }
+
+    // A field of a packed struct can sit at any offset, so its address is not
+    // aligned for its type and must not escape as a pointer or a reference.
+    // Neither may anything stored inside such a field, so the whole chain of
+    // field accesses and soa rows is checked, up to the first pointer.
+    bool Analyzer::isPackedField(const ASTNode *node) const
+    {
+        while (true)
+        {
+            bool throughPointer = node->getType() == ASTNode::NodeType::PointerFieldAccess;
+            const ASTFieldAccess *fieldAccess = nullptr;
+            switch (node->getType())
+            {
+            case ASTNode::NodeType::FieldAccess:
+                fieldAccess = static_cast<const ASTFieldAccess *>(node);
+                break;
+            case ASTNode::NodeType::PointerFieldAccess:
+                fieldAccess = &static_cast<const ASTPointerFieldAccess *>(node)->getFieldAccess();
+                break;
+            case ASTNode::NodeType::IndexAccess:
+                // indexing a pointer reaches a separate object, a soa row lies inside the struct.
+                if (!isSoaRow(node))
+                {
+                    return false;
+                }
+                node = static_cast<const ASTIndexAccess *>(node)->getOperand();
+                continue;
+            default:
+                return false;
+            }
+
+            if (fieldAccess->getFieldIndex() < 0)
+            {
+                return false;
+            }
+
+            const Type *structType = getValueType(fieldAccess->getOperand()->getSemanticType());
+            if (structType->is(Type::Kind::Pointer))
+            {
+                structType = structType->getElementType();
+            }
+            if (structType->getUnqualified()->is(Type::Kind::Struct) && structType->getLayout().packed)
+            {
+                return true;
+            }
+            if (throughPointer)
+            {
+                return false;
+            }
+            node = fieldAccess->getOperand();
+        }
+    }
+
+    bool Analyzer::isLValue(const ASTNode *node) const
+    {
+        switch (node->getType())
+        {
+        case ASTNode::NodeType::Identifier:
+        {
+            const Declaration *declaration = static_cast<const ASTIdentifier *>(node)->getDeclaration();
+            return declaration && declaration->isVariable();
+        }
+        case ASTNode::NodeType::UnaryExpression:
+            return static_cast<const ASTUnaryExpression *>(node)->getOperator() == ASTUnaryExpression::Operator::Dereference;
+        case ASTNode::NodeType::FieldAccess:
+            return isLValue(static_cast<const ASTFieldAccess *>(node)->getOperand());
+        case ASTNode::NodeType::PointerFieldAccess:
+            return true;
+        case ASTNode::NodeType::IndexAccess:
+            // a row is stored wherever the soa struct it belongs to is.
+            return !isSoaRow(node) || isLValue(static_cast<const ASTIndexAccess *>(node)->getOperand());
+        default:
+            return false;
+        }
+    }
+
+    bool Analyzer::isSoaRow(const ASTNode *node) const
+    {
+        if (node->getType() != ASTNode::NodeType::IndexAccess)
+        {
+            return false;
+        }
+
+        const Type *operand = getValueType(static_cast<const ASTIndexAccess *>(node)->getOperand()->getSemanticType());
+        return operand && operand->getUnqualified()->is(Type::Kind::Struct) && operand->getLayout().soaCapacity != 0;
+    }
+
+    bool Analyzer::checkModifiable(const ASTNode *node, const Type *type)
+    {
+        if (type->isInvalid())
+        {
+            return true;
+        }
+
+        if (!isLValue(node))
+        {
+            error(node, "Expression is not assignable.");
+            return false;
+        }
+
+        if (type->isConst())
+        {
+            error(node, "Cannot assign to a value of const type '" + type->toString() + "'.");
+            return false;
+        }
+        return true;
+    }
+
+    const Type *Analyzer::analyzeExpr(FunctionState *fn, ASTNodePtr node)
+    {
+        const Type *type = nullptr;
+
+        switch (node->getType())
+        {
+        case ASTNode::NodeType::IntegerLiteral:
+            type = getIntegerLiteralType(static_cast<const ASTIntegerLiteral *>(node)->getValue());
+            break;
+        case ASTNode::NodeType::FloatLiteral:
+            type = types_.getPrimitiveType(static_cast<const ASTFloatLiteral *>(node)->isFloat32() ? Type::Kind::Float32 : Type::Kind::Float64);
+            break;
+        case ASTNode::NodeType::StringLiteral:
+            type = types_.getPrimitiveType(Type::Kind::String);
+            break;
+        case ASTNode::NodeType::BoolLiteral:
+            type = types_.getPrimitiveType(Type::Kind::Bool);
+            break;
+        case ASTNode::NodeType::Identifier:
+            type = analyzeIdentifier(fn, node);
+            break;
+        case ASTNode::NodeType::BinaryExpression:
+            type = analyzeBinaryExpression(fn, node);
+            break;
+        case ASTNode::NodeType::UnaryExpression:
+            type = analyzeUnaryExpression(fn, node);
+            break;
+        case ASTNode::NodeType::AssignmentExpression:
+            type = analyzeAssignment(fn, node);
+            break;
+        case ASTNode::NodeType::ConditionalExpression:
+            type = analyzeConditionalExpression(fn, node);
+            break;
+        case ASTNode::NodeType::CastExpression:
+            type = analyzeCastExpression(fn, node);
+            break;
+        case ASTNode::NodeType::FunctionCall:
+            type = analyzeFunctionCall(fn, node);
+            break;
+        case ASTNode::NodeType::FieldAccess:
+            type = analyzeFieldAccess(fn, node, static_cast<ASTFieldAccess *>(node), false);
+            break;
+        case ASTNode::NodeType::PointerFieldAccess:
+            type = analyzeFieldAccess(fn, node, &static_cast<ASTPointerFieldAccess *>(node)->getFieldAccess(), true);
+            break;
+        case ASTNode::NodeType::StructInitialization:
+            type = analyzeStructInitialization(fn, node);
+            break;
+        case ASTNode::NodeType::IndexAccess:
+            type = analyzeIndexAccess(fn, node, false);
+            break;
+        case ASTNode::NodeType::ImportedSymbolAccess:
+            // symbols of other modules are bound when modules are linked and are not checked here.
+            type = types_.getInvalidType();
+            break;
+        default:
+            error(node, "Expected an expression.");
+            type = types_.getInvalidType();
+            break;
+        }
+
+        node->setSemanticType(type);
+        return type;
+    }
+
+    const Type *Analyzer::analyzeIdentifier(FunctionState *fn, ASTNodePtr node)
+    {
+        ASTIdentifier *identifier = static_cast<ASTIdentifier *>(node);
+        const Declaration *declaration = lookup(fn, identifier->getSymbol());
+
+        if (!declaration)
+        {
+            error(identifier, "Use of undeclared identifier '" + identifier->getName() + "'.");
+            return types_.getInvalidType();
+        }
+
+        identifier->setDeclaration(declaration);
+        if (declaration->isType())
+        {
+            error(identifier, "'" + identifier->getName() + "' is a type, not a value.");
+            return types_.getInvalidType();
+        }
+
+        // only module level initializers can see a global before it is resolved.
+        if (!declaration->type)
+        {
+            resolveDeclaration(module_.lookupGlobal(identifier->getSymbol()));
+        }
+        return getValueType(declaration->type);
+    }
+
+    // Enums compare their payloads item by item, so every item must support `==`.
+    bool Analyzer::isEqualityComparable(const Type *type)
+    {
+        std::unordered_set<const Type *> visited;
+
+        std::function<bool(const Type *)> comparable = [&](const Type *type) -> bool
+        {
+            type = type->getUnqualified();
+            if (type->isArithmetic() || type->is(Type::Kind::Bool) || type->is(Type::Kind::String) || type->is(Type::Kind::Pointer))
+            {
+                return true;
+            }
+            if (!type->is(Type::Kind::Enum))
+            {
+                return false;
+            }
+            if (!visited.insert(type).second)
+            {
+                return true;
+            }
+
+            for (const Type::Variant &variant : type->getVariants())
+            {
+                for (const Type *item : variant.payload)
+                {
+                    if (!comparable(item))
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        };
+
+        return comparable(type);
+    }
+
+    const Type *Analyzer::analyzeBinaryExpression(FunctionState *fn, ASTNodePtr node)
+    {
+        using Operator = ASTBinaryExpression::Operator;
+        ASTBinaryExpression *expr = static_cast<ASTBinaryExpression *>(node);
+        const Type *lhs = getValueType(analyzeExpr(fn, expr->getLeft()))->getUnqualified();
+        const Type *rhs = getValueType(analyzeExpr(fn, expr->getRight()))->getUnqualified();
+        const Type *boolType = types_.getPrimitiveType(Type::Kind::Bool);
+
+        if (lhs->isInvalid() || rhs->isInvalid())
+        {
+            return types_.getInvalidType();
+        }
+
+        bool arithmetic = lhs->isArithmetic() && rhs->isArithmetic();
+        bool integer = lhs->isInteger() && rhs->isInteger();
+        bool pointers = lhs->is(Type::Kind::Pointer) && rhs->is(Type::Kind::Pointer) &&
+                        lhs->getElementType()->getUnqualified() == rhs->getElementType()->getUnqualified();
+
+        switch (expr->getOperator())
+        {
+        case Operator::Add:
+            if (lhs->is(Type::Kind::Pointer) && rhs->isInteger())
+            {
+                return lhs;
+            }
+            if (lhs->isInteger() && rhs->is(Type::Kind::Pointer))
+            {
+                return rhs;
+            }
+            if (arithmetic)
+            {
+                return getCommonArithmeticType(lhs, rhs);
+            }
+            break;
+        case Operator::Subtract:
+            if (lhs->is(Type::Kind::Pointer) && rhs->isInteger())
+            {
+                return lhs;
+            }
+            if (pointers)
+            {
+                return types_.getPrimitiveType(Type::Kind::Int64);
+            }
+            if (arithmetic)
+            {
+                return getCommonArithmeticType(lhs, rhs);
+            }
+            break;
+        case Operator::Multiply:
+        case Operator::Divide:
+            if (arithmetic)
+            {
+                return getCommonArithmeticType(lhs, rhs);
+            }
+            break;
+        case Operator::Remainder:
+            if (integer)
+            {
+                return getCommonArithmeticType(lhs, rhs);
+            }
+            break;
+        case Operator::LeftShift:
+        case Operator::RightShift:
+            if (integer)
+            {
+                return lhs;
+            }
+            break;
+        case Operator::BitwiseAnd:
+        case Operator::BitwiseXor:
+        case Operator::BitwiseOr:
+            if (integer)
+            {
+                return getCommonArithmeticType(lhs, rhs);
+            }
+            if (lhs->is(Type::Kind::Bool) && rhs->is(Type::Kind::Bool))
+            {
+                return boolType;
+            }
+            break;
+        case Operator::Equal:
+        case Operator::NotEqual:
+            if (arithmetic || pointers)
+            {
+                return boolType;
+            }
+            if (lhs == rhs && (lhs->is(Type::Kind::Bool) || lhs->is(Type::Kind::String)))
+            {
+                return boolType;
+            }
+            if (lhs == rhs && lhs->is(Type::Kind::Enum))
+            {
+                if (!isEqualityComparable(lhs))
+                {
+                    error(expr, "Enum '" + lhs->getName().str() + "' cannot be compared, its payloads hold values without '" + expr->getOperatorString() + "'.");
+                    return types_.getInvalidType();
+                }
+                return boolType;
+            }
+            break;
+        case Operator::LessThan:
+        case Operator::LessEqual:
+        case Operator::GreaterThan:
+        case Operator::GreaterEqual:
+            if (arithmetic || pointers)
+            {
+                return boolType;
+            }
+            break;
+        case Operator::LogicalAnd:
+        case Operator::LogicalOr:
+            if (lhs->isScalar() && rhs->isScalar())
+            {
+                return boolType;
+            }
+            break;
+        default:
+            break;
+        }
+
+        error(expr, "Invalid operands to binary '" + expr->getOperatorString() + "' ('" + lhs->toString() + "' and '" + rhs->toString() + "').");
+        return types_.getInvalidType();
+    }
+
+    const Type *Analyzer::analyzeUnaryExpression(FunctionState *fn, ASTNodePtr node)
+    {
+        using Operator = ASTUnaryExpression::Operator;
+        ASTUnaryExpression *expr = static_cast<ASTUnaryExpression *>(node);
+        const Type *operand = getValueType(analyzeExpr(fn, expr->getOperand()));
+
+        if (operand->isInvalid())
+        {
+            return operand;
+        }
+
+        switch (expr->getOperator())
+        {
+        case Operator::Plus:
+        case Operator::Negate:
+            if (operand->isArithmetic())
+            {
+                return operand->getUnqualified();
+            }
+            break;
+        case Operator::LogicalNot:
+            if (operand->isScalar())
+            {
+                return types_.getPrimitiveType(Type::Kind::Bool);
+            }
+            break;
+        case Operator::BitwiseNot:
+            if (operand->isInteger())
+            {
+                return operand->getUnqualified();
+            }
+            break;
+        case Operator::AddressOf:
+            if (!isLValue(expr->getOperand()))
+            {
+                error(expr, "Cannot take the address of a temporary value.");
+                return types_.getInvalidType();
+            }
+            if (isPackedField(expr->getOperand()))
+            {
+                error(expr, "Cannot take the address of a field of a packed struct.");
+                return types_.getInvalidType();
+            }
+            return types_.getPointerType(operand);
+        case Operator::Dereference:
+            if (operand->is(Type::Kind::Pointer))
+            {
+                return operand->getElementType();
+            }
+            break;
+        case Operator::PreIncrement:
+        case Operator::PreDecrement:
+        case Operator::PostIncrement:
+        case Operator::PostDecrement:
+            if (!checkModifiable(expr->getOperand(), operand))
+            {
+                return types_.getInvalidType();
+            }
+            if (operand->isArithmetic() || operand->is(Type::Kind::Pointer))
+            {
+                return operand->getUnqualified();
+            }
+            break;
+        default:
+            break;
+        }
+
+        error(expr, "Invalid operand to unary '" + expr->getOperatorString() + "' ('" + operand->toString() + "').");
+        return types_.getInvalidType();
+    }
+
+    const Type *Analyzer::analyzeAssignment(FunctionState *fn, ASTNodePtr node)
+    {
+        using Operator = ASTAssignment::Operator;
+        ASTAssignment *expr = static_cast<ASTAssignment *>(node);
+        const Type *lhs = getValueType(analyzeExpr(fn, expr->getLeft()));
+        const Type *rhs = getValueType(analyzeExpr(fn, expr->getRight()));
+
+        if (!checkModifiable(expr->getLeft(), lhs) || lhs->isInvalid() || rhs->isInvalid())
+        {
+            return types_.getInvalidType();
+        }
+
+        const Type *target = lhs->getUnqualified();
+        const Type *value = rhs->getUnqualified();
+        bool valid = true;
+
+        switch (expr->getOperator())
+        {
+        case Operator::Assign:
+            checkAssignable(expr->getRight(), rhs, lhs, "in assignment");
+            return target;
+        case Operator::AddAssign:
+        case Operator::SubtractAssign:
+            valid = (target->isArithmetic() && value->isArithmetic()) || (target->is(Type::Kind::Pointer) && value->isInteger());
+            break;
+        case Operator::MultiplyAssign:
+        case Operator::DivideAssign:
+            valid = target->isArithmetic() && value->isArithmetic();
+            break;
+        case Operator::RemainderAssign:
+        case Operator::LeftShiftAssign:
+        case Operator::RightShiftAssign:
+            valid = target->isInteger() && value->isInteger();
+            break;
+        case Operator::BitwiseAndAssign:
+        case Operator::BitwiseXorAssign:
+        case Operator::BitwiseOrAssign:
+            valid = (target->isInteger() && value->isInteger()) || (target->is(Type::Kind::Bool) && value->is(Type::Kind::Bool));
+            break;
+        default:
+            break;
+        }
+
+        if (!valid)
+        {
+            error(expr, "Invalid operands to '" + expr->getOperatorString() + "' ('" + lhs->toString() + "' and '" + rhs->toString() + "').");
+        }
+        return target;
+    }
+
+    const Type *Analyzer::analyzeConditionalExpression(FunctionState *fn, ASTNodePtr node)
+    {
+        ASTConditionalExpression *expr = static_cast<ASTConditionalExpression *>(node);
+
+        const Type *condition = getValueType(analyzeExpr(fn, expr->getCondition()));
+        if (!condition->isScalar() && !condition->isInvalid())
+        {
+            error(expr->getCondition(), "Condition must be a bool, number or pointer, found '" + condition->toString() + "'.");
+        }
+
+        const Type *whenTrue = getValueType(analyzeExpr(fn, expr->getTrueExpression()))->getUnqualified();
+        const Type *whenFalse = getValueType(analyzeExpr(fn, expr->getFalseExpression()))->getUnqualified();
+
+        if (whenTrue->isInvalid() || whenFalse->isInvalid())
+        {
+            return types_.getInvalidType();
+        }
+        if (whenTrue == whenFalse)
+        {
+            return whenTrue;
+        }
+        if (whenTrue->isArithmetic() && whenFalse->isArithmetic())
+        {
+            return getCommonArithmeticType(whenTrue, whenFalse);
+        }
+        if (whenTrue->is(Type::Kind::Pointer) && whenFalse->is(Type::Kind::Pointer))
+        {
+            if (isAssignable(whenFalse, whenTrue))
+            {
+                return whenTrue;
+            }
+            if (isAssignable(whenTrue, whenFalse))
+            {
+                return whenFalse;
+            }
+        }
+
+        error(expr, "Incompatible operand types in conditional expression ('" + whenTrue->toString() + "' and '" + whenFalse->toString() + "').");
+        return types_.getInvalidType();
+    }
+
+    const Type *Analyzer::analyzeCastExpression(FunctionState *fn, ASTNodePtr node)
+    {
+        ASTCastExpression *expr = static_cast<ASTCastExpression *>(node);
+        const Type *from = getValueType(analyzeExpr(fn, expr->getExpression()))->getUnqualified();
+        const Type *to = resolveType(fn, &expr->getTargetType());
+        const Type *target = to->getUnqualified();
+
+        if (from->isInvalid() || to->isInvalid())
+        {
+            return to;
+        }
+
+        bool fromNumber = from->isArithmetic() || from->is(Type::Kind::Bool);
+        bool toNumber = target->isArithmetic() || target->is(Type::Kind::Bool);
+        bool fromPointer = from->is(Type::Kind::Pointer);
+        bool toPointer = target->is(Type::Kind::Pointer);
+
+        bool allowed = from == target ||
+                       (fromNumber && toNumber) ||
+                       (fromPointer && toPointer) ||
+                       (fromPointer && target->isInteger()) ||
+                       (from->isInteger() && toPointer);
+
+        if (!allowed)
+        {
+            error(expr, "Cannot cast '" + from->toString() + "' to '" + to->toString() + "'.");
+        }
+        return to;
+    }
+
+    const Type *Analyzer::analyzeFunctionCall(FunctionState *fn, ASTNodePtr node)
+    {
+        ASTFunctionCall *call = static_cast<ASTFunctionCall *>(node);
+        ASTNodePtr callee = call->getExpr();
+        const std::vector<ASTNodePtr> &arguments = call->getArguments();
+
+        // `Enum.Variant(...)` builds a variant with a payload.
+        if (callee->getType() == ASTNode::NodeType::FieldAccess)
+        {
+            ASTFieldAccess *fieldAccess = static_cast<ASTFieldAccess *>(callee);
+            if (lookupEnumType(fn, fieldAccess->getOperand()))
+            {
+                const Type *type = analyzeEnumVariant(fn, fieldAccess, &arguments);
+                callee->setSemanticType(type);
+                return type;
+            }
+        }
+
+        const Type *calleeType = analyzeExpr(fn, callee);
+        if (calleeType->isInvalid() || !calleeType->is(Type::Kind::Function))
+        {
+            if (!calleeType->isInvalid())
+            {
+                error(callee, "Called value of type '" + calleeType->toString() + "' is not a function.");
+            }
+
+            for (ASTNodePtr argument : arguments)
+            {
+                analyzeExpr(fn, argument);
+            }
+            return types_.getInvalidType();
+        }
+
+        const std::vector<const Type *> &paramTypes = calleeType->getParamTypes();
+        const Type *variadicType = nullptr;
+        std::string funcName = "function";
+        std::size_t required = paramTypes.size();
+
+        // trailing parameters with a default value may be left out.
+        if (callee->getType() == ASTNode::NodeType::Identifier)
+        {
+            const Declaration *declaration = static_cast<ASTIdentifier *>(callee)->getDeclaration();
+            funcName = "'" + declaration->name.str() + "'";
+
+            if (declaration->kind == Declaration::Kind::Function)
+            {
+                const ASTFunctionParameters &parameters = getFunctionParameters(declaration);
+                const std::vector<ASTFunctionParameter> &params = parameters.getList();
+                if (parameters.getTypedVariadic().has_value())
+                {
+                    variadicType = parameters.getTypedVariadic().value()->getSemanticType();
+                }
+
+                required = 0;
+                for (std::size_t i = 0; i < params.size(); ++i)
+                {
+                    if (!params[i].getDefaultValue())
+                    {
+                        required = i + 1;
+                    }
+                }
+            }
+        }
+
+        if (arguments.size() < required)
+        {
+            std::string expected = required == paramTypes.size() ? std::to_string(required) : "at least " + std::to_string(required);
+            error(call, "Too few arguments in call to " + funcName + ", expected " + expected + ", got " + std::to_string(arguments.size()) + ".");
+        }
+        else if (arguments.size() > paramTypes.size() && !calleeType->isVariadic())
+        {
+            std::string expected = required == paramTypes.size() ? std::to_string(paramTypes.size()) : "at most " + std::to_string(paramTypes.size());
+            error(call, "Too many arguments in call to " + funcName + ", expected " + expected + ", got " + std::to_string(arguments.size()) + ".");
+        }
+
+        for (std::size_t i = 0; i < arguments.size(); ++i)
+        {
+            const Type *argumentType = analyzeExpr(fn, arguments[i]);
+            if (i >= paramTypes.size())
+            {
+                if (variadicType)
+                {
+                    checkAssignable(arguments[i], argumentType, variadicType, "for variadic argument " + std::to_string(i + 1) + " of " + funcName);
+                }
+                continue;
+            }
+
+            std::string context = "for argument " + std::to_string(i + 1) + " of " + funcName;
+            if (paramTypes[i]->is(Type::Kind::Reference))
+            {
+                checkBindable(arguments[i], argumentType, paramTypes[i], context);
+            }
+            else
+            {
+                checkAssignable(arguments[i], argumentType, paramTypes[i], context);
+            }
+        }
+
+        return getValueType(calleeType->getReturnType());
+    }
+
+    // An enum named on the left of `.` selects one of its variants.
+    const Type *Analyzer::lookupEnumType(FunctionState *fn, ASTNodePtr node)
+    {
+        if (node->getType() != ASTNode::NodeType::Identifier)
+        {
+            return nullptr;
+        }
+
+        ASTIdentifier *identifier = static_cast<ASTIdentifier *>(node);
+        const Declaration *declaration = lookup(fn, identifier->getSymbol());
+        if (!declaration || !declaration->isType())
+        {
+            return nullptr;
+        }
+
+        const Type *type = resolveTypeName(fn, identifier->getSymbol(), identifier);
+        if (!type->getUnqualified()->is(Type::Kind::Enum))
+        {
+            return nullptr;
+        }
+
+        identifier->setSemanticType(type);
+        return type;
+    }
+
+    const Type *Analyzer::analyzeEnumVariant(FunctionState *fn, const ASTFieldAccess *fieldAccess, const std::vector<ASTNodePtr> *arguments)
+    {
+        const Type *enumType = fieldAccess->getOperand()->getSemanticType()->getUnqualified();
+        const std::string variantName = enumType->getName().str() + "." + fieldAccess->getFieldName();
+        int index = enumType->findVariant(fieldAccess->getFieldSymbol());
+
+        if (index < 0)
+        {
+            error(fieldAccess, "Enum '" + enumType->getName().str() + "' has no variant '" + fieldAccess->getFieldName() + "'.");
+            if (arguments)
+            {
+                for (ASTNodePtr argument : *arguments)
+                {
+                    analyzeExpr(fn, argument);
+                }
+            }
+            return types_.getInvalidType();
+        }
+
+        fieldAccess->setFieldIndex(index);
+        const std::vector<const Type *> &payload = enumType->getVariants()[index].payload;
+        std::size_t count = arguments ? arguments->size() : 0;
+
+        if (count != payload.size())
+        {
+            error(fieldAccess, "Variant '" + variantName + "' holds " + std::to_string(payload.size()) + " value(s), got " + std::to_string(count) + ".");
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const Type *argumentType = analyzeExpr(fn, (*arguments)[i]);
+            if (i >= payload.size())
+            {
+                continue;
+            }
+
+            std::string context = "for value " + std::to_string(i + 1) + " of '" + variantName + "'";
+            if (payload[i]->is(Type::Kind::Reference))
+            {
+                checkBindable((*arguments)[i], argumentType, payload[i], context);
+            }
+            else
+            {
+                checkAssignable((*arguments)[i], argumentType, payload[i], context);
+            }
+        }
+
+        return enumType;
+    }
+
+    const Type *Analyzer::analyzeFieldAccess(FunctionState *fn, const ASTNode *node, const ASTFieldAccess *fieldAccess, bool throughPointer)
+    {
+        if (!throughPointer && lookupEnumType(fn, fieldAccess->getOperand()))
+        {
+            return analyzeEnumVariant(fn, fieldAccess, nullptr);
+        }
+
+        // a row of a soa struct is only valid as the operand of a field access.
+        ASTNodePtr operandNode = fieldAccess->getOperand();
+        const Type *operand = nullptr;
+        if (!throughPointer && operandNode->getType() == ASTNode::NodeType::IndexAccess)
+        {
+            operand = analyzeIndexAccess(fn, operandNode, true);
+            operandNode->setSemanticType(operand);
+        }
+        else
+        {
+            operand = analyzeExpr(fn, operandNode);
+        }
+        operand = getValueType(operand);
+        const std::string &fieldName = fieldAccess->getFieldName();
+        if (operand->isInvalid())
+        {
+            return operand;
+        }
+
+        const Type *structType = operand;
+        if (throughPointer)
+        {
+            if (!operand->is(Type::Kind::Pointer))
+            {
+                error(node, "Type '" + operand->toString() + "' is not a pointer, use '.' to access field '" + fieldName + "'.");
+                return types_.getInvalidType();
+            }
+            structType = operand->getElementType();
+        }
+        else if (operand->is(Type::Kind::Pointer) && operand->getElementType()->getUnqualified()->is(Type::Kind::Struct))
+        {
+            error(node, "Type '" + operand->toString() + "' is a pointer, use '->' to access field '" + fieldName + "'.");
+            return types_.getInvalidType();
+        }
+
+        if (!structType->getUnqualified()->is(Type::Kind::Struct))
+        {
+            error(node, "Cannot access field '" + fieldName + "' of non-struct type '" + structType->toString() + "'.");
+            return types_.getInvalidType();
+        }
+
+        int index = structType->findField(fieldAccess->getFieldSymbol());
+        if (index < 0)
+        {
+            error(node, "Struct '" + structType->getName().str() + "' has no field '" + fieldName + "'.");
+            return types_.getInvalidType();
+        }
+
+        if (structType->getLayout().soaCapacity && (throughPointer || !isSoaRow(operandNode)))
+        {
+            error(node, "Field '" + fieldName + "' of soa struct '" + structType->getName().str() + "' is a column, select a row first, e.g. 'table[i]." + fieldName + "'.");
+            return types_.getInvalidType();
+        }
+
+        fieldAccess->setFieldIndex(index);
+        const Type *fieldType = structType->getFields()[index].type;
+
+        // fields of a const struct are const too.
+        if (structType->isConst())
+        {
+            fieldType = types_.getConstType(fieldType);
+        }
+
+        if (throughPointer)
+        {
+            fieldAccess->setSemanticType(fieldType);
+        }
+        return fieldType;
+    }
+
+    const Type *Analyzer::analyzeStructInitialization(FunctionState *fn, ASTNodePtr node)
+    {
+        ASTStructInitialization *init = static_cast<ASTStructInitialization *>(node);
+        const Type *structType = resolveTypeName(fn, init->getStructSymbol(), init)->getUnqualified();
+
+        if (!structType->isInvalid() && !structType->is(Type::Kind::Struct))
+        {
+            error(init, "'" + init->getStructName() + "' is not a struct type.");
+            structType = types_.getInvalidType();
+        }
+
+        // the columns of a soa struct start out zero, rows are filled in one by one.
+        if (structType->getLayout().soaCapacity && !init->getFieldInitializers().empty())
+        {
+            error(init, "Soa struct '" + init->getStructName() + "' cannot be initialized field by field, assign to 'table[i].field' instead.");
+            structType = types_.getInvalidType();
+        }
+
+        std::vector<bool> initialized(structType->getFields().size(), false);
+        for (const auto &[fieldName, value] : init->getFieldInitializers())
+        {
+            const Type *valueType = analyzeExpr(fn, value);
+            if (structType->isInvalid())
+            {
+                continue;
+            }
+
+            int index = structType->findField(fieldName);
+            if (index < 0)
+            {
+                error(value, "Struct '" + structType->getName().str() + "' has no field '" + fieldName.str() + "'.");
+                continue;
+            }
+
+            if (initialized[index])
+            {
+                error(value, "Field '" + fieldName.str() + "' is initialized more than once.");
+                continue;
+            }
+
+            initialized[index] = true;
+            const Type *fieldType = structType->getFields()[index].type;
+            std::string context = "for field '" + fieldName.str() + "' of '" + structType->getName().str() + "'";
+            if (fieldType->is(Type::Kind::Reference))
+            {
+                checkBindable(value, valueType, fieldType, context);
+            }
+            else
+            {
+                checkAssignable(value, valueType, fieldType, context);
+            }
+        }
+
+        // fields left out are zero, which a reference never is.
+        for (std::size_t i = 0; i < initialized.size(); ++i)
+        {
+            const Type::Field &field = structType->getFields()[i];
+            if (!initialized[i] && holdsReference(field.type))
+            {
+                error(init, "Field '" + field.name.str() + "' of '" + structType->getName().str() + "' holds a reference and must be initialized.");
+            }
+        }
+
+        return structType;
+    }
+
+    // `pointer[i]` is `*(pointer + i)`. `table[i]` selects a row of a soa
+    // struct, which has no storage of its own: `asRow` is set when the caller
+    // accesses a field of it, anything else is an error.
+    const Type *Analyzer::analyzeIndexAccess(FunctionState *fn, ASTNodePtr node, bool asRow)
+    {
+        ASTIndexAccess *access = static_cast<ASTIndexAccess *>(node);
+        const Type *operand = getValueType(analyzeExpr(fn, access->getOperand()));
+        const Type *index = getValueType(analyzeExpr(fn, access->getIndex()));
+
+        if (!index->isInvalid() && !index->isInteger())
+        {
+            error(access->getIndex(), "Index must be an integer, got '" + index->toString() + "'.");
+        }
+        if (operand->isInvalid())
+        {
+            return operand;
+        }
+
+        if (operand->is(Type::Kind::Pointer))
+        {
+            if (operand->getElementType()->getUnqualified()->is(Type::Kind::Void))
+            {
+                error(node, "Cannot index a pointer to 'void'.");
+                return types_.getInvalidType();
+            }
+            return operand->getElementType();
+        }
+
+        std::uint64_t capacity = operand->getLayout().soaCapacity;
+        if (!operand->getUnqualified()->is(Type::Kind::Struct) || capacity == 0)
+        {
+            error(node, "Type '" + operand->toString() + "' cannot be indexed.");
+            return types_.getInvalidType();
+        }
+
+        if (!asRow)
+        {
+            error(node, "A row of soa struct '" + operand->getName().str() + "' is not a value, access one of its fields.");
+            return types_.getInvalidType();
+        }
+
+        // an index known at compile time is checked against the number of rows.
+        if (index->isInteger())
+        {
+            ConstantEvaluator evaluator;
+            std::optional<ConstantValue> value = evaluator.evaluate(access->getIndex(), index);
+            if (value.has_value())
+            {
+                const llvm::APInt &row = value->getInteger();
+                if ((index->isSigned() && row.isNegative()) || row.getActiveBits() > 64 || row.getZExtValue() >= capacity)
+                {
+                    error(access->getIndex(), "Row index is out of range for soa struct '" + operand->getName().str() + "' of " + std::to_string(capacity) + " rows.");
+                }
+            }
+        }
+        return operand;
+    }
+} // namespace semantic
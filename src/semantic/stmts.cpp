@@ -0,0 +1,476 @@
+#include "ast/ast.hpp"
+#include "semantic/analyzer.hpp"
+#include "semantic/constant.hpp"
+#include "llvm/ADT/StringExtras.h"
+
+namespace semantic
+{
+    void Analyzer::analyzeStmt(FunctionState &fn, ASTNodePtr node)
+    {
+        switch (node->getType())
+        {
+        case ASTNode::NodeType::StatementList:
+            fn.scope.pushLevel();
+            analyzeStmts(fn, static_cast<ASTStatementList *>(node)->getStatements());
+            fn.scope.popLevel();
+            break;
+        case ASTNode::NodeType::VariableDeclaration:
+            analyzeVariableDeclaration(fn, node);
+            break;
+        case ASTNode::NodeType::ReturnStatement:
+            analyzeReturnStatement(fn, node);
+            break;
+        case ASTNode::NodeType::IfStatement:
+            analyzeIfStatement(fn, node);
+            break;
+        case ASTNode::NodeType::ForStatement:
+            analyzeForStatement(fn, node);
+            break;
+        case ASTNode::NodeType::SwitchStatement:
+            analyzeSwitchStatement(fn, node);
+            break;
+        case ASTNode::NodeType::BreakStatement:
+            if (fn.loopDepth == 0 && fn.switchDepth == 0)
+            {
+                error(node, "'break' is only allowed inside a loop or a switch.");
+            }
+            break;
+        case ASTNode::NodeType::ContinueStatement:
+            if (fn.loopDepth == 0)
+            {
+                error(node, "'continue' is only allowed inside a loop.");
+            }
+            break;
+        case ASTNode::NodeType::TypeDefStatement:
+        case ASTNode::NodeType::StructDefinition:
+        case ASTNode::NodeType::EnumDefinition:
+            error(node, "Types can only be declared at module level.");
+            break;
+        default:
+            analyzeExpr(&fn, node);
+            break;
+        }
+    }
+
+    void Analyzer::analyzeStmts(FunctionState &fn, const ASTNodeList &nodes)
+    {
+        for (ASTNodePtr node : nodes)
+        {
+            if (node)
+            {
+                analyzeStmt(fn, node);
+            }
+        }
+    }
+
+    void Analyzer::analyzeVariableDeclaration(FunctionState &fn, ASTNodePtr node)
+    {
+        ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(node);
+        const Type *varType = nullptr;
+
+        if (varDecl->getTypeValue().has_value())
+        {
+            varType = resolveType(&fn, varDecl->getTypeValue().value());
+        }
+
+        // the initializer is checked before the name is declared, so it cannot refer to the variable itself.
+        if (varDecl->getInitializer().has_value())
+        {
+            ASTNodePtr initializer = varDecl->getInitializer().value();
+            const Type *initType = analyzeExpr(&fn, initializer);
+
+            if (varType && varType->is(Type::Kind::Reference))
+            {
+                checkBindable(initializer, initType, varType, "in the initialization of '" + varDecl->getName() + "'");
+            }
+            else if (varType)
+            {
+                checkAssignable(initializer, initType, varType, "in the initialization of '" + varDecl->getName() + "'");
+            }
+            else
+            {
+                varType = initType;
+            }
+        }
+        else if (varType && varType->is(Type::Kind::Reference))
+        {
+            error(varDecl, "Reference '" + varDecl->getName() + "' must be initialized.");
+        }
+        else if (varType && holdsReference(varType))
+        {
+            error(varDecl, "Variable '" + varDecl->getName() + "' holds a reference and must be initialized.");
+        }
+
+        if (!varType)
+        {
+            error(varDecl, "Variable '" + varDecl->getName() + "' needs a type or an initializer.");
+            varType = types_.getInvalidType();
+        }
+        else if (varType->is(Type::Kind::Void))
+        {
+            error(varDecl, "Variable '" + varDecl->getName() + "' cannot have type 'void'.");
+            varType = types_.getInvalidType();
+        }
+
+        if (fn.scope.isDeclaredInCurrentLevel(varDecl->getSymbol()))
+        {
+            error(varDecl, "Variable '" + varDecl->getName() + "' is already declared in the current scope.");
+            return;
+        }
+
+        varDecl->setSemanticType(varType);
+        fn.scope.declare(module_.createDeclaration(Declaration::Kind::LocalVariable, varDecl->getSymbol(), varType, varDecl));
+    }
+
+    // A `break` that leaves the loop or switch `node` is part of, i.e. one not
+    // nested in a loop or switch of its own.
+    static bool hasBreak(const ASTNode *node)
+    {
+        if (!node)
+        {
+            return false;
+        }
+
+        switch (node->getType())
+        {
+        case ASTNode::NodeType::BreakStatement:
+            return true;
+        case ASTNode::NodeType::StatementList:
+            for (ASTNodePtr statement : static_cast<const ASTStatementList *>(node)->getStatements())
+            {
+                if (hasBreak(statement))
+                {
+                    return true;
+                }
+            }
+            return false;
+        case ASTNode::NodeType::IfStatement:
+        {
+            const ASTIfStatement *ifStmt = static_cast<const ASTIfStatement *>(node);
+            return hasBreak(ifStmt->getThenBranch()) || (ifStmt->getElseBranch().has_value() && hasBreak(ifStmt->getElseBranch().value()));
+        }
+        default:
+            return false;
+        }
+    }
+
+    // Whether control can reach the end of `node`. It follows the blocks code
+    // generation emits: a loop without a condition only ends through a
+    // `break`, and a switch with a default, or with a case for every variant
+    // of its enum, only ends when one of its cases does.
+    bool Analyzer::completesNormally(const ASTNode *node) const
+    {
+        if (!node)
+        {
+            return true;
+        }
+
+        switch (node->getType())
+        {
+        case ASTNode::NodeType::ReturnStatement:
+        case ASTNode::NodeType::BreakStatement:
+        case ASTNode::NodeType::ContinueStatement:
+            return false;
+        case ASTNode::NodeType::StatementList:
+            for (ASTNodePtr statement : static_cast<const ASTStatementList *>(node)->getStatements())
+            {
+                if (statement && !completesNormally(statement))
+                {
+                    return false;
+                }
+            }
+            return true;
+        case ASTNode::NodeType::IfStatement:
+        {
+            const ASTIfStatement *ifStmt = static_cast<const ASTIfStatement *>(node);
+            return !ifStmt->getElseBranch().has_value() || completesNormally(ifStmt->getThenBranch()) || completesNormally(ifStmt->getElseBranch().value());
+        }
+        case ASTNode::NodeType::ForStatement:
+        {
+            const ASTForStatement *forStmt = static_cast<const ASTForStatement *>(node);
+            bool hasCondition = forStmt->getCondition().has_value() && forStmt->getCondition().value();
+            return hasCondition || hasBreak(forStmt->getBody());
+        }
+        case ASTNode::NodeType::SwitchStatement:
+        {
+            const ASTSwitchStatement *switchStmt = static_cast<const ASTSwitchStatement *>(node);
+            const Type *subject = switchStmt->getSubject()->getSemanticType();
+            if (subject && subject->is(Type::Kind::Reference))
+            {
+                subject = subject->getElementType();
+            }
+
+            bool hasDefault = false;
+            std::size_t labels = 0;
+            for (const ASTSwitchCase &switchCase : switchStmt->getCases())
+            {
+                if (completesNormally(switchCase.getBody()) || hasBreak(switchCase.getBody()))
+                {
+                    return true;
+                }
+                hasDefault |= switchCase.isDefault();
+                labels += switchCase.getLabels().size();
+            }
+
+            bool exhaustive = subject && subject->getUnqualified()->is(Type::Kind::Enum) && labels == subject->getUnqualified()->getVariants().size();
+            return !hasDefault && !exhaustive;
+        }
+        default:
+            return true;
+        }
+    }
+
+    void Analyzer::analyzeReturnStatement(FunctionState &fn, ASTNodePtr node)
+    {
+        ASTReturnStatement *returnStmt = static_cast<ASTReturnStatement *>(node);
+        const std::string &funcName = fn.function->name.str();
+
+        if (!returnStmt->getExpr().has_value())
+        {
+            if (!fn.returnType->is(Type::Kind::Void) && !fn.returnType->isInvalid())
+            {
+                error(returnStmt, "Function '" + funcName + "' must return a value of type '" + fn.returnType->toString() + "'.");
+            }
+            return;
+        }
+
+        ASTNodePtr value = returnStmt->getExpr().value();
+        const Type *valueType = analyzeExpr(&fn, value);
+
+        if (fn.returnType->is(Type::Kind::Void))
+        {
+            error(value, "Function '" + funcName + "' does not return a value.");
+        }
+        else if (fn.returnType->is(Type::Kind::Reference))
+        {
+            checkBindable(value, valueType, fn.returnType, "in the return value of '" + funcName + "'");
+        }
+        else
+        {
+            checkAssignable(value, valueType, fn.returnType, "in the return value of '" + funcName + "'");
+        }
+    }
+
+    void Analyzer::analyzeCondition(FunctionState &fn, ASTNodePtr node)
+    {
+        const Type *type = analyzeExpr(&fn, node);
+        if (!type->isScalar() && !type->isInvalid())
+        {
+            error(node, "Condition must be a bool, number or pointer, found '" + type->toString() + "'.");
+        }
+    }
+
+    void Analyzer::analyzeIfStatement(FunctionState &fn, ASTNodePtr node)
+    {
+        ASTIfStatement *ifStmt = static_cast<ASTIfStatement *>(node);
+        analyzeCondition(fn, ifStmt->getCondition());
+
+        // a branch gets a level of its own even when it is not a block.
+        fn.scope.pushLevel();
+        analyzeStmt(fn, ifStmt->getThenBranch());
+        fn.scope.popLevel();
+
+        if (ifStmt->getElseBranch().has_value())
+        {
+            fn.scope.pushLevel();
+            analyzeStmt(fn, ifStmt->getElseBranch().value());
+            fn.scope.popLevel();
+        }
+    }
+
+    void Analyzer::analyzeForStatement(FunctionState &fn, ASTNodePtr node)
+    {
+        ASTForStatement *forStmt = static_cast<ASTForStatement *>(node);
+
+        // the loop variable is visible in the header and the body only.
+        fn.scope.pushLevel();
+
+        if (forStmt->getInitializer().has_value() && forStmt->getInitializer().value())
+        {
+            analyzeStmt(fn, forStmt->getInitializer().value());
+        }
+
+        if (forStmt->getCondition().has_value() && forStmt->getCondition().value())
+        {
+            analyzeCondition(fn, forStmt->getCondition().value());
+        }
+
+        if (forStmt->getIncrement().has_value() && forStmt->getIncrement().value())
+        {
+            analyzeExpr(&fn, forStmt->getIncrement().value());
+        }
+
+        ++fn.loopDepth;
+        fn.scope.pushLevel();
+        analyzeStmt(fn, forStmt->getBody());
+        fn.scope.popLevel();
+        --fn.loopDepth;
+
+        fn.scope.popLevel();
+    }
+
+    // Labels are constants of the switched type, or variants of the switched
+    // enum, so code generation can dispatch with a single jump table.
+    void Analyzer::analyzeSwitchStatement(FunctionState &fn, ASTNodePtr node)
+    {
+        ASTSwitchStatement *switchStmt = static_cast<ASTSwitchStatement *>(node);
+        const Type *subject = analyzeExpr(&fn, switchStmt->getSubject());
+        if (subject->is(Type::Kind::Reference))
+        {
+            subject = subject->getElementType();
+        }
+        subject = subject->getUnqualified();
+        bool isEnum = subject->is(Type::Kind::Enum);
+
+        if (!subject->isInvalid() && !isEnum && !subject->isInteger())
+        {
+            error(switchStmt->getSubject(), "Switch value must be an integer or an enum, found '" + subject->toString() + "'.");
+            subject = types_.getInvalidType();
+        }
+
+        std::vector<llvm::APInt> values;
+        std::vector<bool> covered(isEnum ? subject->getVariants().size() : 0, false);
+        bool hasDefault = false;
+
+        for (const ASTSwitchCase &switchCase : switchStmt->getCases())
+        {
+            if (switchCase.isDefault() && hasDefault)
+            {
+                error(&switchCase, "A switch can only have one default case.");
+            }
+            hasDefault |= switchCase.isDefault();
+
+            std::vector<const Declaration *> bindings;
+            for (ASTNodePtr label : switchCase.getLabels())
+            {
+                if (isEnum)
+                {
+                    std::size_t bound = bindings.size();
+                    int index = analyzeVariantLabel(fn, label, subject, bindings);
+                    if (bindings.size() > bound && switchCase.getLabels().size() > 1)
+                    {
+                        error(label, "A case that binds a payload cannot have other labels.");
+                    }
+                    if (index < 0)
+                    {
+                        continue;
+                    }
+                    if (covered[index])
+                    {
+                        error(label, "Variant '" + subject->getVariants()[index].name.str() + "' is already handled by another case.");
+                    }
+                    covered[index] = true;
+                    continue;
+                }
+
+                const Type *labelType = analyzeExpr(&fn, label);
+                if (subject->isInvalid() || !checkAssignable(label, labelType, subject, "in a case label"))
+                {
+                    continue;
+                }
+
+                ConstantEvaluator evaluator;
+                std::optional<ConstantValue> value = evaluator.evaluate(label, subject);
+                if (!value.has_value())
+                {
+                    error(evaluator.getErrorNode(), "Case label must be a constant: " + evaluator.getError());
+                    continue;
+                }
+
+                for (const llvm::APInt &seen : values)
+                {
+                    if (seen == value->getInteger())
+                    {
+                        error(label, "Value " + llvm::toString(seen, 10, subject->isSigned()) + " is already handled by another case.");
+                        break;
+                    }
+                }
+                values.push_back(value->getInteger());
+            }
+
+            // the bindings of a case are only visible in its body.
+            ++fn.switchDepth;
+            fn.scope.pushLevel();
+            for (const Declaration *binding : bindings)
+            {
+                fn.scope.declare(binding);
+            }
+            if (switchCase.getBody())
+            {
+                analyzeStmt(fn, switchCase.getBody());
+            }
+            fn.scope.popLevel();
+            --fn.switchDepth;
+        }
+    }
+
+    // `Enum.Variant`, or `Enum.Variant(a, b)` which also binds the payload.
+    // Returns the index of the variant, or -1.
+    int Analyzer::analyzeVariantLabel(FunctionState &fn, ASTNodePtr label, const Type *enumType, std::vector<const Declaration *> &bindings)
+    {
+        ASTFunctionCall *pattern = nullptr;
+        ASTNodePtr variantNode = label;
+        if (label->getType() == ASTNode::NodeType::FunctionCall)
+        {
+            pattern = static_cast<ASTFunctionCall *>(label);
+            variantNode = pattern->getExpr();
+        }
+
+        const Type *labelEnum = nullptr;
+        ASTFieldAccess *variantAccess = nullptr;
+        if (variantNode->getType() == ASTNode::NodeType::FieldAccess)
+        {
+            variantAccess = static_cast<ASTFieldAccess *>(variantNode);
+            labelEnum = lookupEnumType(&fn, variantAccess->getOperand());
+        }
+
+        if (!labelEnum)
+        {
+            error(label, "Case of a switch over enum '" + enumType->getName().str() + "' must name one of its variants.");
+            return -1;
+        }
+        if (labelEnum->getUnqualified() != enumType)
+        {
+            error(label, "Variant of enum '" + labelEnum->getName().str() + "' cannot match a value of enum '" + enumType->getName().str() + "'.");
+            return -1;
+        }
+
+        int index = enumType->findVariant(variantAccess->getFieldSymbol());
+        if (index < 0)
+        {
+            error(variantAccess, "Enum '" + enumType->getName().str() + "' has no variant '" + variantAccess->getFieldName() + "'.");
+            return -1;
+        }
+        variantAccess->setFieldIndex(index);
+        variantAccess->setSemanticType(enumType);
+        label->setSemanticType(enumType);
+
+        if (!pattern)
+        {
+            return index;
+        }
+
+        const std::vector<const Type *> &payload = enumType->getVariants()[index].payload;
+        const std::vector<ASTNodePtr> &names = pattern->getArguments();
+        if (names.size() != payload.size())
+        {
+            error(pattern, "Variant '" + enumType->getName().str() + "." + variantAccess->getFieldName() + "' holds " + std::to_string(payload.size()) + " value(s), got " + std::to_string(names.size()) + " name(s).");
+        }
+
+        for (std::size_t i = 0; i < names.size() && i < payload.size(); ++i)
+        {
+            if (names[i]->getType() != ASTNode::NodeType::Identifier)
+            {
+                error(names[i], "Payload of a variant can only be bound to a name.");
+                continue;
+            }
+
+            ASTIdentifier *name = static_cast<ASTIdentifier *>(names[i]);
+            const Declaration *binding = module_.createDeclaration(Declaration::Kind::LocalVariable, name->getSymbol(), payload[i], name);
+            name->setDeclaration(binding);
+            name->setSemanticType(payload[i]);
+            bindings.push_back(binding);
+        }
+        return index;
+    }
+} // namespace semantic
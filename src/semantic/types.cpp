@@ -0,0 +1,295 @@
+#include "semantic/types.hpp"
+
+namespace semantic
+{
+    int Type::findField(Symbol name) const
+    {
+        const std::vector<Field> &fields = getFields();
+        for (std::size_t i = 0; i < fields.size(); ++i)
+        {
+            if (fields[i].name == name)
+            {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    int Type::findVariant(Symbol name) const
+    {
+        const std::vector<Variant> &variants = getVariants();
+        for (std::size_t i = 0; i < variants.size(); ++i)
+        {
+            if (variants[i].name == name)
+            {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    bool Type::isInteger() const
+    {
+        switch (kind_)
+        {
+        case Kind::Int8:
+        case Kind::Int16:
+        case Kind::Int32:
+        case Kind::Int64:
+        case Kind::Int128:
+        case Kind::UInt8:
+        case Kind::UInt16:
+        case Kind::UInt32:
+        case Kind::UInt64:
+        case Kind::UInt128:
+        case Kind::Int:
+        case Kind::UInt:
+        case Kind::Char:
+        case Kind::Byte:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool Type::isSigned() const
+    {
+        switch (kind_)
+        {
+        case Kind::Int8:
+        case Kind::Int16:
+        case Kind::Int32:
+        case Kind::Int64:
+        case Kind::Int128:
+        case Kind::Int:
+        case Kind::Char:
+            return true;
+        default:
+            return isFloat();
+        }
+    }
+
+    bool Type::isFloat() const
+    {
+        return kind_ == Kind::Float32 || kind_ == Kind::Float64 || kind_ == Kind::Float128;
+    }
+
+    unsigned Type::getBitWidth() const
+    {
+        switch (kind_)
+        {
+        case Kind::Int8:
+        case Kind::UInt8:
+        case Kind::Char:
+        case Kind::Byte:
+            return 8;
+        case Kind::Int16:
+        case Kind::UInt16:
+            return 16;
+        case Kind::Int32:
+        case Kind::UInt32:
+        case Kind::Int:
+        case Kind::UInt:
+        case Kind::Float32:
+            return 32;
+        case Kind::Int64:
+        case Kind::UInt64:
+        case Kind::Float64:
+            return 64;
+        case Kind::Int128:
+        case Kind::UInt128:
+        case Kind::Float128:
+            return 128;
+        case Kind::Bool:
+            return 1;
+        default:
+            return 0;
+        }
+    }
+
+    std::string Type::toString() const
+    {
+        std::string result = isConst_ ? "const " : "";
+
+        switch (kind_)
+        {
+        case Kind::Int8:
+            return result + "int8";
+        case Kind::Int16:
+            return result + "int16";
+        case Kind::Int32:
+            return result + "int32";
+        case Kind::Int64:
+            return result + "int64";
+        case Kind::Int128:
+            return result + "int128";
+        case Kind::UInt8:
+            return result + "uint8";
+        case Kind::UInt16:
+            return result + "uint16";
+        case Kind::UInt32:
+            return result + "uint32";
+        case Kind::UInt64:
+            return result + "uint64";
+        case Kind::UInt128:
+            return result + "uint128";
+        case Kind::Int:
+            return result + "int";
+        case Kind::UInt:
+            return result + "uint";
+        case Kind::Float32:
+            return result + "float32";
+        case Kind::Float64:
+            return result + "float64";
+        case Kind::Float128:
+            return result + "float128";
+        case Kind::Char:
+            return result + "char";
+        case Kind::Byte:
+            return result + "byte";
+        case Kind::Bool:
+            return result + "bool";
+        case Kind::Void:
+            return result + "void";
+        case Kind::String:
+            return result + "string";
+        case Kind::Error:
+            return result + "error";
+        case Kind::Pointer:
+            return result + element_->toString() + "*";
+        case Kind::Reference:
+            return result + element_->toString() + "&";
+        case Kind::Struct:
+        case Kind::Enum:
+            return result + name_.str();
+        case Kind::Function:
+        {
+            result += "fn(";
+            const std::vector<const Type *> &params = getParamTypes();
+            for (std::size_t i = 0; i < params.size(); ++i)
+            {
+                result += (i == 0 ? "" : ", ") + params[i]->toString();
+            }
+            if (isVariadic())
+            {
+                result += params.empty() ? "..." : ", ...";
+            }
+            return result + ") " + element_->toString();
+        }
+        default:
+            return "<invalid>";
+        }
+    }
+
+    const Type *getCommonArithmeticType(const Type *lhs, const Type *rhs)
+    {
+        lhs = lhs->getUnqualified();
+        rhs = rhs->getUnqualified();
+
+        if (lhs->isFloat() != rhs->isFloat())
+        {
+            return lhs->isFloat() ? lhs : rhs;
+        }
+
+        if (lhs->getBitWidth() != rhs->getBitWidth())
+        {
+            return lhs->getBitWidth() > rhs->getBitWidth() ? lhs : rhs;
+        }
+
+        return lhs->isSigned() && !rhs->isSigned() ? rhs : lhs;
+    }
+
+    TypeTable::TypeTable()
+    {
+        for (std::size_t i = 0; i <= static_cast<std::size_t>(Type::Kind::Invalid); ++i)
+        {
+            Type::Kind kind = static_cast<Type::Kind>(i);
+            switch (kind)
+            {
+            case Type::Kind::Pointer:
+            case Type::Kind::Reference:
+            case Type::Kind::Struct:
+            case Type::Kind::Enum:
+            case Type::Kind::Function:
+                primitives_[i] = nullptr;
+                break;
+            default:
+                primitives_[i] = &types_.emplace_back(kind);
+                break;
+            }
+        }
+    }
+
+    const Type *TypeTable::getPointerType(const Type *pointee)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Type *&slot = derived_[{pointee, Type::Kind::Pointer}];
+        if (!slot)
+        {
+            slot = &types_.emplace_back(Type::Kind::Pointer, pointee);
+        }
+        return slot;
+    }
+
+    const Type *TypeTable::getReferenceType(const Type *referee)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Type *&slot = derived_[{referee, Type::Kind::Reference}];
+        if (!slot)
+        {
+            slot = &types_.emplace_back(Type::Kind::Reference, referee);
+        }
+        return slot;
+    }
+
+    const Type *TypeTable::getConstType(const Type *type)
+    {
+        if (type->isConst() || type->isInvalid())
+        {
+            return type;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Type *&slot = constVariants_[type];
+        if (!slot)
+        {
+            Type &variant = types_.emplace_back(*type);
+            variant.isConst_ = true;
+            variant.unqualified_ = type;
+            slot = &variant;
+        }
+        return slot;
+    }
+
+    const Type *TypeTable::getFunctionType(const Type *returnType, const std::vector<const Type *> &params, bool isVariadic)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Type *&slot = functions_[{returnType, params, isVariadic}];
+        if (!slot)
+        {
+            Type &function = types_.emplace_back(Type::Kind::Function, returnType);
+            function.params_ = params;
+            function.isVariadic_ = isVariadic;
+            slot = &function;
+        }
+        return slot;
+    }
+
+    Type *TypeTable::createStructType(Symbol name, const ASTNode *declaration)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Type &type = types_.emplace_back(Type::Kind::Struct);
+        type.name_ = name;
+        type.declaration_ = declaration;
+        return &type;
+    }
+
+    Type *TypeTable::createEnumType(Symbol name, const ASTNode *declaration)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Type &type = types_.emplace_back(Type::Kind::Enum);
+        type.name_ = name;
+        type.declaration_ = declaration;
+        return &type;
+    }
+} // namespace semantic
@@ -3,40 +3,61 @@
 #include <format>
 #include <unistd.h>
 #include "util/util.hpp"
+#include "util/line_table.hpp"
 
 const int errorPanelScope = 3;
 
 namespace util
 {
-    void displayErrorPanel(const std::string &fileName, const std::string &fileContent, const int errorLineNumber, const std::string &errorMsg)
+    void displayErrorPanel(const std::string &fileName, std::string_view fileContent, const int errorLineNumber, const std::string &errorMsg)
     {
-        std::vector<std::string> lines = util::split(fileContent, '\n');
-        int startLine = std::max(1, errorLineNumber - errorPanelScope);
-        int endLine = std::min(static_cast<int>(lines.size()), errorLineNumber + errorPanelScope);
+        displayErrorPanel(fileName, LineTable(fileContent), errorLineNumber, errorMsg);
+    }
+
+    void displayErrorPanel(const std::string &fileName, const LineTable &lines, const int errorLineNumber, const std::string &errorMsg)
+    {
+        displayDiagnosticPanel(fileName, lines, errorLineNumber, SourceRange(), "Error", errorMsg);
+    }
+
+    void displayDiagnosticPanel(const std::string &fileName, const LineTable &lines, const int lineNumber, SourceRange range, const std::string &severity, const std::string &msg)
+    {
+        int startLine = std::max(1, lineNumber - errorPanelScope);
+        int endLine = std::min(static_cast<int>(lines.getLineCount()), lineNumber + errorPanelScope);
 
-        std::cout << "\n";
+        // the whole panel goes to stderr, so a redirected stream never splits it.
+        std::cerr << "\n";
         for (int i = startLine; i <= endLine; ++i)
         {
-            if (i == errorLineNumber)
+            if (i == lineNumber)
             {
                 if (isatty(fileno(stderr)))
                 {
-                    util::printColoredText(std::format("{:<3}| {}", i, lines[i - 1]), "white", "red");
+                    util::printColoredText(std::format("{:<3}| {}", i, lines.getLine(i)), "white", "red", std::cerr);
                 }
                 else
                 {
-                    std::cerr << std::format("{:<3}| {}", i, lines[i - 1]) << std::endl;
+                    std::cerr << std::format("{:<3}| {}", i, lines.getLine(i)) << std::endl;
+                }
+
+                // underline the offending range when it starts on the highlighted line,
+                // which includes the position just past its last character.
+                std::size_t lineOffset = lines.getLineOffset(i);
+                std::size_t lineLength = lines.getLine(i).size();
+                if (range.hasPosition() && range.begin >= lineOffset && range.begin <= lineOffset + lineLength)
+                {
+                    std::size_t column = range.begin - lineOffset;
+                    // an empty range, e.g. of an empty rule, still gets its caret.
+                    std::size_t length = std::max<std::size_t>(1, std::min<std::size_t>(range.getLength(), lineLength - column));
+                    std::cerr << std::format("{:<3}| {}^{}", "", std::string(column, ' '), std::string(length - 1, '~')) << std::endl;
                 }
             }
             else
             {
-                std::cerr << std::format("{:<3}| {}", i, lines[i - 1]) << std::endl;
+                std::cerr << std::format("{:<3}| {}", i, lines.getLine(i)) << std::endl;
             }
         }
 
-        std::cout << "\n"
-                  << "(Error) " << fileName << ":" << errorLineNumber << "  " << errorMsg << std::endl;
-
-        std::exit(1);
+        std::cerr << "\n"
+                  << "(" << severity << ") " << fileName << ":" << lineNumber << "  " << msg << std::endl;
     }
 }
@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include "util/util.hpp"
+#include "util/diagnostics.hpp"
+
+namespace util
+{
+    // modules are compiled concurrently, so the order diagnostics arrive in is not deterministic.
+    static void sortBySource(std::vector<Diagnostic> &diagnostics)
+    {
+        std::stable_sort(diagnostics.begin(), diagnostics.end(), [](const Diagnostic &lhs, const Diagnostic &rhs)
+                         {
+                             if (lhs.source->getFileName() != rhs.source->getFileName())
+                             {
+                                 return lhs.source->getFileName() < rhs.source->getFileName();
+                             }
+                             return lhs.lineNumber < rhs.lineNumber; });
+    }
+
+    void DiagnosticEngine::report(DiagnosticSeverity severity, std::shared_ptr<SourceBuffer> source, int lineNumber, const std::string &message, SourceRange range)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        diagnostics_.push_back(Diagnostic{severity, std::move(source), lineNumber, range, message});
+
+        if (severity == DiagnosticSeverity::Warning)
+        {
+            ++warningCount_;
+            return;
+        }
+
+        ++errorCount_;
+        if (errorLimit_ != 0 && errorCount_ >= errorLimit_)
+        {
+            flushLocked();
+            std::cerr << "(Error) Too many errors emitted, stopping now (--error-limit=" << errorLimit_ << ")." << std::endl;
+            std::exit(1);
+        }
+    }
+
+    void DiagnosticEngine::error(std::shared_ptr<SourceBuffer> source, int lineNumber, const std::string &message, SourceRange range)
+    {
+        report(DiagnosticSeverity::Error, std::move(source), lineNumber, message, range);
+    }
+
+    void DiagnosticEngine::error(std::shared_ptr<SourceBuffer> source, SourceRange range, const std::string &message)
+    {
+        int lineNumber = static_cast<int>(source->getLineTable().getLineNumber(range.begin));
+        report(DiagnosticSeverity::Error, std::move(source), lineNumber, message, range);
+    }
+
+    void DiagnosticEngine::warning(std::shared_ptr<SourceBuffer> source, int lineNumber, const std::string &message, SourceRange range)
+    {
+        report(DiagnosticSeverity::Warning, std::move(source), lineNumber, message, range);
+    }
+
+    std::size_t DiagnosticEngine::getErrorCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return errorCount_;
+    }
+
+    std::size_t DiagnosticEngine::getWarningCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return warningCount_;
+    }
+
+    std::vector<Diagnostic> DiagnosticEngine::getDiagnostics()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<Diagnostic> diagnostics = diagnostics_;
+        sortBySource(diagnostics);
+        return diagnostics;
+    }
+
+    void DiagnosticEngine::flushLocked()
+    {
+        sortBySource(diagnostics_);
+
+        for (const Diagnostic &diagnostic : diagnostics_)
+        {
+            const char *severity = diagnostic.severity == DiagnosticSeverity::Error ? "Error" : "Warning";
+            displayDiagnosticPanel(diagnostic.source->getFileName(), diagnostic.source->getLineTable(), diagnostic.lineNumber, diagnostic.range, severity, diagnostic.message);
+        }
+        diagnostics_.clear();
+    }
+
+    void DiagnosticEngine::flush()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flushLocked();
+    }
+
+    void DiagnosticEngine::abort()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            flushLocked();
+        }
+        std::exit(1);
+    }
+
+    void DiagnosticEngine::exitOnErrors()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flushLocked();
+
+        if (errorCount_ > 0)
+        {
+            std::cerr << "(Error) " << errorCount_ << (errorCount_ == 1 ? " error" : " errors");
+            if (warningCount_ > 0)
+            {
+                std::cerr << " and " << warningCount_ << (warningCount_ == 1 ? " warning" : " warnings");
+            }
+            std::cerr << " generated." << std::endl;
+            std::exit(1);
+        }
+    }
+} // namespace util
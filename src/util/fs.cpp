@@ -1,5 +1,7 @@
 #include <iostream>
 #include <cstdlib>
+#include <algorithm>
+#include <filesystem>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include "util/util.hpp"
@@ -25,27 +27,6 @@ namespace util
         }
     }
 
-    std::string readFileContent(const std::string &inputFile)
-    {
-        FILE *file = fopen(inputFile.c_str(), "r");
-        if (!file)
-        {
-            std::cerr << "(Error) Could not open file '" << inputFile << "'." << std::endl;
-            std::exit(1);
-        }
-
-        std::string fileContent;
-        char buffer[1024];
-        size_t bytes_read;
-
-        while ((bytes_read = fread(buffer, 1, sizeof(buffer), file)) > 0)
-        {
-            fileContent.append(buffer, bytes_read);
-        }
-
-        return fileContent;
-    }
-
     std::string getFileNameWithStem(const std::string &filePath)
     {
         size_t lastSlashPos = filePath.rfind('/');
@@ -96,6 +77,48 @@ namespace util
         }
     }
 
+    std::vector<std::string> collectSourceFiles(const std::string &directory)
+    {
+        std::vector<std::string> sourceFiles;
+        std::error_code ec;
+
+        for (auto it = std::filesystem::recursive_directory_iterator(directory, ec); !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+        {
+            if (it->is_regular_file() && hasFileExtension(it->path().string(), ".cyr"))
+            {
+                sourceFiles.push_back(it->path().string());
+            }
+        }
+
+        if (ec)
+        {
+            std::cerr << "(Error) Could not read directory '" << directory << "': " << ec.message() << std::endl;
+            std::exit(1);
+        }
+
+        // keep module order stable between builds
+        std::sort(sourceFiles.begin(), sourceFiles.end());
+        return sourceFiles;
+    }
+
+    std::string getModuleNameFromPath(const std::string &rootDirectory, const std::string &filePath)
+    {
+        std::filesystem::path relativePath = std::filesystem::relative(filePath, rootDirectory);
+        relativePath.replace_extension();
+
+        std::string moduleName;
+        for (const auto &part : relativePath)
+        {
+            if (!moduleName.empty())
+            {
+                moduleName += "::";
+            }
+            moduleName += part.string();
+        }
+
+        return moduleName;
+    }
+
     void isValidModuleName(const std::string &moduleName, const std::string &fileName)
     {
         for (char c : moduleName)
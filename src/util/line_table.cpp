@@ -0,0 +1,47 @@
+#include <algorithm>
+#include <cstring>
+#include "util/line_table.hpp"
+
+namespace util
+{
+    LineTable::LineTable(std::string_view text) : text_(text)
+    {
+        lineOffsets_.push_back(0);
+
+        // memchr is vectorized by every libc we build against, which keeps this
+        // scan close to memory bandwidth even for multi-megabyte sources.
+        const char *begin = text.data();
+        const char *end = begin + text.size();
+        for (const char *cursor = begin; cursor < end;)
+        {
+            const char *newline = static_cast<const char *>(std::memchr(cursor, '\n', end - cursor));
+            if (!newline)
+            {
+                break;
+            }
+            lineOffsets_.push_back(newline + 1 - begin);
+            cursor = newline + 1;
+        }
+    }
+
+    std::string_view LineTable::getLine(std::size_t lineNumber) const
+    {
+        if (lineNumber == 0 || lineNumber > lineOffsets_.size())
+        {
+            return std::string_view();
+        }
+
+        std::size_t start = lineOffsets_[lineNumber - 1];
+        std::size_t end = lineNumber < lineOffsets_.size() ? lineOffsets_[lineNumber] - 1 : text_.size();
+        if (end > start && text_[end - 1] == '\r')
+        {
+            --end;
+        }
+        return text_.substr(start, end - start);
+    }
+
+    std::size_t LineTable::getLineNumber(std::size_t offset) const
+    {
+        return std::upper_bound(lineOffsets_.begin(), lineOffsets_.end(), offset) - lineOffsets_.begin();
+    }
+} // namespace util
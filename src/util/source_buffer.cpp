@@ -0,0 +1,89 @@
+#include <iostream>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "util/source_buffer.hpp"
+
+namespace util
+{
+    // id 0 is left for trees that were not parsed from a buffer.
+    static std::atomic<std::uint32_t> nextFileId = 1;
+
+    SourceBuffer::SourceBuffer(std::string fileName, char *data, std::size_t size, std::size_t mappedSize, bool mapped)
+        : fileName_(std::move(fileName)), fileId_(nextFileId.fetch_add(1, std::memory_order_relaxed)), data_(data), size_(size), mappedSize_(mappedSize), mapped_(mapped)
+    {
+    }
+
+    std::shared_ptr<SourceBuffer> SourceBuffer::open(const std::string &fileName)
+    {
+        int fd = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+        {
+            std::cerr << "(Error) Could not open file '" << fileName << "'." << std::endl;
+            std::exit(1);
+        }
+
+        std::size_t size = static_cast<std::size_t>(st.st_size);
+        std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        std::size_t mappedSize = (size + 2 + pageSize - 1) / pageSize * pageSize;
+
+        // reserve zeroed memory for the file plus the terminating NULs, then map the file over
+        // its beginning. bytes past EOF read as zero, whether they fall on the file's last page
+        // or on the anonymous page behind it.
+        void *region = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (region == MAP_FAILED)
+        {
+            std::cerr << "(Error) Could not map file '" << fileName << "'." << std::endl;
+            std::exit(1);
+        }
+
+        if (size > 0 && mmap(region, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+        {
+            std::cerr << "(Error) Could not map file '" << fileName << "'." << std::endl;
+            std::exit(1);
+        }
+        ::close(fd);
+
+        return std::shared_ptr<SourceBuffer>(new SourceBuffer(fileName, static_cast<char *>(region), size, mappedSize, true));
+    }
+
+    std::shared_ptr<SourceBuffer> SourceBuffer::fromString(const std::string &fileName, std::string_view content)
+    {
+        char *data = static_cast<char *>(std::malloc(content.size() + 2));
+        if (!data)
+        {
+            std::cerr << "(Error) Failed to allocate memory for '" << fileName << "'." << std::endl;
+            std::exit(1);
+        }
+
+        std::memcpy(data, content.data(), content.size());
+        data[content.size()] = '\0';
+        data[content.size() + 1] = '\0';
+
+        return std::shared_ptr<SourceBuffer>(new SourceBuffer(fileName, data, content.size(), content.size() + 2, false));
+    }
+
+    const LineTable &SourceBuffer::getLineTable() const
+    {
+        std::call_once(lineTableOnce_, [this]()
+                       { lineTable_ = std::make_unique<LineTable>(getText()); });
+        return *lineTable_;
+    }
+
+    SourceBuffer::~SourceBuffer()
+    {
+        if (mapped_)
+        {
+            munmap(data_, mappedSize_);
+        }
+        else
+        {
+            std::free(data_);
+        }
+    }
+} // namespace util
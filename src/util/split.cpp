@@ -1,16 +1,16 @@
 #include <iostream>
 #include <vector>
-#include <sstream>
+#include <string_view>
 
 namespace util
 {
-    std::vector<std::string> split(const std::string &str, char delimiter)
+    std::vector<std::string_view> split(std::string_view str, char delimiter)
     {
-        std::vector<std::string> tokens;
+        std::vector<std::string_view> tokens;
         size_t start = 0;
         size_t end = str.find(delimiter);
 
-        while (end != std::string::npos)
+        while (end != std::string_view::npos)
         {
             tokens.push_back(str.substr(start, end - start));
             start = end + 1;
@@ -21,18 +21,20 @@ namespace util
      * @param text The string to print to the console.
      * @param foregroundColor The color of the text.  Defaults to white.
      * @param backgroundColor The color of the background. Defaults to black.
+     * @param stream The stream to print to, std::cout or std::cerr.
      */
     void printColoredText(const std::string &text,
                           const std::string &foregroundColor,
-                          const std::string &backgroundColor)
+                          const std::string &backgroundColor,
+                          std::ostream &stream)
     {
 #ifdef _WIN32
         // Windows implementation using SetConsoleTextAttribute
-        HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+        HANDLE hConsole = GetStdHandle(&stream == &std::cerr ? STD_ERROR_HANDLE : STD_OUTPUT_HANDLE);
         if (hConsole == INVALID_HANDLE_VALUE)
         {
             std::cerr << "(Error) Could not get console handle." << std::endl;
-            std::cout << text << std::endl; // Print without color on error.
+            stream << text << std::endl; // Print without color on error.
             return;
         }
 
@@ -74,11 +76,11 @@ namespace util
         if (!SetConsoleTextAttribute(hConsole, colorCode))
         {
             std::cerr << "(Error) Could not set console text attributes. Error Code: " << GetLastError() << std::endl;
-            std::cout << text << std::endl; // Print without color on error.
+            stream << text << std::endl; // Print without color on error.
             return;
         }
 
-        std::cout << text << std::endl;
+        stream << text << std::endl;
 
         // Reset to default color (white on black)
         SetConsoleTextAttribute(hConsole, FOREGROUND_WHITE | BACKGROUND_BLACK);
@@ -120,7 +122,7 @@ namespace util
         else if (backgroundColor == "white")
             backgroundCode = "47";
 
-        std::cout << "\033[" << foregroundCode << ";" << backgroundCode << "m" << text << "\033[0m" << std::endl;
+        stream << "\033[" << foregroundCode << ";" << backgroundCode << "m" << text << "\033[0m" << std::endl;
 #endif
     }
 } // namespace util
\ No newline at end of file
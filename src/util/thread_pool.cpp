@@ -0,0 +1,141 @@
+#include "util/thread_pool.hpp"
+
+namespace util
+{
+    namespace
+    {
+        thread_local const ThreadPool *currentPool = nullptr;
+        thread_local std::size_t currentWorkerIndex = 0;
+    }
+
+    ThreadPool::ThreadPool(std::size_t workerCount)
+        : queuedTasks_(0), pendingTasks_(0), nextQueue_(0), stopping_(false)
+    {
+        if (workerCount == 0)
+        {
+            workerCount = 1;
+        }
+
+        for (std::size_t i = 0; i < workerCount; ++i)
+        {
+            queues_.push_back(std::make_unique<WorkerQueue>());
+        }
+
+        for (std::size_t i = 0; i < workerCount; ++i)
+        {
+            workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wakeCondition_.notify_all();
+
+        for (auto &worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    std::size_t ThreadPool::defaultWorkerCount()
+    {
+        std::size_t count = std::thread::hardware_concurrency();
+        return count == 0 ? 1 : count;
+    }
+
+    void ThreadPool::submit(Task task)
+    {
+        std::size_t queueIndex;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++queuedTasks_;
+            ++pendingTasks_;
+
+            // tasks spawned by a worker stay on its own deque to keep locality,
+            // tasks from outside are spread round-robin.
+            queueIndex = currentPool == this ? currentWorkerIndex : nextQueue_++ % queues_.size();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queues_[queueIndex]->mutex);
+            queues_[queueIndex]->tasks.push_back(std::move(task));
+        }
+
+        wakeCondition_.notify_one();
+    }
+
+    void ThreadPool::wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        doneCondition_.wait(lock, [this]()
+                            { return pendingTasks_ == 0; });
+    }
+
+    bool ThreadPool::popTask(std::size_t workerIndex, Task &task)
+    {
+        {
+            WorkerQueue &own = *queues_[workerIndex];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+
+        for (std::size_t i = 1; i < queues_.size(); ++i)
+        {
+            WorkerQueue &victim = *queues_[(workerIndex + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void ThreadPool::workerLoop(std::size_t workerIndex)
+    {
+        currentPool = this;
+        currentWorkerIndex = workerIndex;
+
+        while (true)
+        {
+            Task task;
+            if (popTask(workerIndex, task))
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    --queuedTasks_;
+                }
+
+                task(workerIndex);
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--pendingTasks_ == 0)
+                {
+                    doneCondition_.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            wakeCondition_.wait(lock, [this]()
+                                { return stopping_ || queuedTasks_ > 0; });
+
+            if (stopping_ && queuedTasks_ == 0)
+            {
+                return;
+            }
+        }
+    }
+} // namespace util
@@ -0,0 +1,434 @@
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+#include "codegen_llvm/compiler.hpp"
+#include "parser_test.hpp"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/CFG.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Operator.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/raw_ostream.h"
+
+static llvm::BasicBlock *findBlock(llvm::Function *func, llvm::StringRef name)
+{
+    for (llvm::BasicBlock &block : *func)
+    {
+        if (block.getName() == name)
+        {
+            return &block;
+        }
+    }
+    return nullptr;
+}
+
+TEST(CodeGenTest, ShortCircuitsLogicalOperators)
+{
+    std::string input = "fn both(a bool, b bool) bool {\n"
+                        "    return a && b;\n"
+                        "}\n"
+                        "fn either(a bool, b bool) bool {\n"
+                        "    return a || b;\n"
+                        "}";
+    std::unique_ptr<LoweredProgram> result = quickLower(input);
+    ASSERT_NE(result->module, nullptr);
+    ASSERT_FALSE(llvm::verifyModule(*result->module->getModule(), &llvm::errs()));
+
+    struct Case
+    {
+        const char *function;
+        const char *rhsBlock;
+        const char *endBlock;
+        bool skipped;
+    };
+    for (const Case &test : {Case{"both", "and.rhs", "and.end", false}, Case{"either", "or.rhs", "or.end", true}})
+    {
+        llvm::Function *func = result->module->getModule()->getFunction(test.function);
+        ASSERT_NE(func, nullptr);
+        llvm::BasicBlock *entry = &func->getEntryBlock();
+        llvm::BasicBlock *rhs = findBlock(func, test.rhsBlock);
+        llvm::BasicBlock *end = findBlock(func, test.endBlock);
+        ASSERT_NE(rhs, nullptr);
+        ASSERT_NE(end, nullptr);
+
+        // the right operand is only evaluated on one edge out of the entry block.
+        llvm::BranchInst *branch = llvm::dyn_cast<llvm::BranchInst>(entry->getTerminator());
+        ASSERT_NE(branch, nullptr);
+        ASSERT_TRUE(branch->isConditional());
+        ASSERT_EQ(branch->getSuccessor(test.skipped ? 1 : 0), rhs);
+        ASSERT_EQ(branch->getSuccessor(test.skipped ? 0 : 1), end);
+
+        // when it is skipped, the left operand alone decides the result.
+        llvm::PHINode *phi = llvm::dyn_cast<llvm::PHINode>(&end->front());
+        ASSERT_NE(phi, nullptr);
+        ASSERT_EQ(phi->getNumIncomingValues(), 2);
+        llvm::ConstantInt *decided = llvm::dyn_cast<llvm::ConstantInt>(phi->getIncomingValueForBlock(entry));
+        ASSERT_NE(decided, nullptr);
+        ASSERT_EQ(decided->isOne(), test.skipped);
+        ASSERT_NE(phi->getBasicBlockIndex(rhs), -1);
+    }
+}
+
+TEST(CodeGenTest, ComparesStringsAndEnumsByValue)
+{
+    std::string input = "enum Token { End, Number(int64), Word(string) }\n"
+                        "fn sameText(a string, b string) bool {\n"
+                        "    return a == b;\n"
+                        "}\n"
+                        "fn sameToken(a Token, b Token) bool {\n"
+                        "    return a != b;\n"
+                        "}";
+    std::unique_ptr<LoweredProgram> result = quickLower(input);
+    ASSERT_NE(result->module, nullptr);
+    ASSERT_FALSE(llvm::verifyModule(*result->module->getModule(), &llvm::errs()));
+
+    // strings compare their characters, which takes a call unless the pointers decide.
+    llvm::Function *strcmp = result->module->getModule()->getFunction("strcmp");
+    ASSERT_NE(strcmp, nullptr);
+    llvm::Function *sameText = result->module->getModule()->getFunction("sameText");
+    ASSERT_NE(findBlock(sameText, "str.cmp"), nullptr);
+    ASSERT_NE(findBlock(sameText, "str.end"), nullptr);
+
+    // the Word payload holds a string, so comparing tokens compares strings too.
+    bool callsStrcmp = false;
+    for (llvm::User *user : strcmp->users())
+    {
+        llvm::CallInst *call = llvm::dyn_cast<llvm::CallInst>(user);
+        callsStrcmp |= call && call->getFunction()->getName() == "sameToken";
+    }
+    ASSERT_TRUE(callsStrcmp);
+}
+
+TEST(CodeGenTest, LowersForLoopsInCanonicalShape)
+{
+    std::string input = "fn sum(limit int32) int32 {\n"
+                        "    #total: int32 = 0;\n"
+                        "    for (#i: int32 = 0; i < limit; i += 1) {\n"
+                        "        if (i == 3) { continue; }\n"
+                        "        if (total > 100) { break; }\n"
+                        "        total += i;\n"
+                        "    }\n"
+                        "    return total;\n"
+                        "}";
+    std::unique_ptr<LoweredProgram> result = quickLower(input);
+    ASSERT_NE(result->module, nullptr);
+    ASSERT_FALSE(llvm::verifyModule(*result->module->getModule(), &llvm::errs()));
+
+    llvm::Function *func = result->module->getModule()->getFunction("sum");
+    ASSERT_NE(func, nullptr);
+    llvm::BasicBlock *headerBlock = findBlock(func, "for.cond");
+    llvm::BasicBlock *latchBlock = findBlock(func, "for.inc");
+    llvm::BasicBlock *exitBlock = findBlock(func, "for.end");
+    ASSERT_NE(headerBlock, nullptr);
+    ASSERT_NE(latchBlock, nullptr);
+    ASSERT_NE(exitBlock, nullptr);
+
+    // a preheader, one latch holding the only back edge and one exit block, the
+    // shape the loop passes expect without running loop-simplify first.
+    llvm::DominatorTree dominators(*func);
+    llvm::LoopInfo loops(dominators);
+    ASSERT_EQ(loops.getTopLevelLoops().size(), 1);
+    llvm::Loop *loop = loops.getTopLevelLoops()[0];
+    ASSERT_EQ(loop->getHeader(), headerBlock);
+    ASSERT_EQ(loop->getLoopLatch(), latchBlock);
+    ASSERT_EQ(loop->getLoopPreheader(), &func->getEntryBlock());
+    ASSERT_EQ(loop->getExitBlock(), exitBlock);
+
+    // continue and the end of the body reach the latch, break and the condition the exit.
+    ASSERT_EQ(llvm::pred_size(latchBlock), 2);
+    ASSERT_EQ(llvm::pred_size(exitBlock), 2);
+}
+
+TEST(CodeGenTest, LowersFloatLiteralsAtTheirOwnPrecision)
+{
+    std::string input = "fn scale(x float64) float64 {\n"
+                        "    return x * 0.1;\n"
+                        "}\n"
+                        "fn scaleSingle(x float32) float32 {\n"
+                        "    return x * 0.1f;\n"
+                        "}";
+    std::unique_ptr<LoweredProgram> result = quickLower(input);
+    ASSERT_NE(result->module, nullptr);
+    ASSERT_FALSE(llvm::verifyModule(*result->module->getModule(), &llvm::errs()));
+
+    // each multiplies by the literal in its own type, with no conversion in between.
+    for (const char *name : {"scale", "scaleSingle"})
+    {
+        llvm::Function *func = result->module->getModule()->getFunction(name);
+        ASSERT_NE(func, nullptr);
+        llvm::BinaryOperator *multiply = nullptr;
+        for (llvm::Instruction &instruction : func->getEntryBlock())
+        {
+            ASSERT_FALSE(llvm::isa<llvm::FPExtInst>(instruction) || llvm::isa<llvm::FPTruncInst>(instruction));
+            if (instruction.getOpcode() == llvm::Instruction::FMul)
+            {
+                multiply = llvm::cast<llvm::BinaryOperator>(&instruction);
+            }
+        }
+        ASSERT_NE(multiply, nullptr);
+        llvm::ConstantFP *literal = llvm::dyn_cast<llvm::ConstantFP>(multiply->getOperand(1));
+        ASSERT_NE(literal, nullptr);
+        ASSERT_EQ(literal->getType(), func->getReturnType());
+        if (literal->getType()->isDoubleTy())
+        {
+            ASSERT_EQ(literal->getValueAPF().convertToDouble(), 0.1);
+        }
+        else
+        {
+            ASSERT_EQ(literal->getValueAPF().convertToFloat(), 0.1f);
+        }
+    }
+}
+
+TEST(CodeGenTest, PlacesEveryAllocaInTheEntryBlock)
+{
+    std::string input = "fn run(limit int32) int32 {\n"
+                        "    #total: int32 = 0;\n"
+                        "    for (#i: int32 = 0; i < limit; i += 1) {\n"
+                        "        #square: int32 = i * i;\n"
+                        "        if (square > 10) {\n"
+                        "            #half: int32;\n"
+                        "            half = square / 2;\n"
+                        "            total += half;\n"
+                        "        }\n"
+                        "    }\n"
+                        "    return total;\n"
+                        "}";
+    std::unique_ptr<LoweredProgram> result = quickLower(input);
+    ASSERT_NE(result->module, nullptr);
+    ASSERT_FALSE(llvm::verifyModule(*result->module->getModule(), &llvm::errs()));
+
+    llvm::Function *func = result->module->getModule()->getFunction("run");
+    ASSERT_NE(func, nullptr);
+    llvm::BasicBlock *entry = &func->getEntryBlock();
+
+    std::map<std::string, llvm::AllocaInst *> allocas;
+    for (llvm::BasicBlock &block : *func)
+    {
+        for (llvm::Instruction &instruction : block)
+        {
+            // the placeholder marking where allocas go is gone once the function is done.
+            ASSERT_NE(instruction.getName(), "allocapt");
+            if (llvm::AllocaInst *alloca = llvm::dyn_cast<llvm::AllocaInst>(&instruction))
+            {
+                ASSERT_EQ(&block, entry);
+                allocas[alloca->getName().str()] = alloca;
+            }
+        }
+    }
+    ASSERT_EQ(allocas.size(), 5);
+
+    // the stores stay where the locals are declared, and an initializer replaces the zero.
+    auto getStores = [](llvm::AllocaInst *alloca)
+    {
+        std::vector<llvm::StoreInst *> stores;
+        for (llvm::User *user : alloca->users())
+        {
+            if (llvm::StoreInst *store = llvm::dyn_cast<llvm::StoreInst>(user))
+            {
+                stores.push_back(store);
+            }
+        }
+        return stores;
+    };
+    ASSERT_EQ(getStores(allocas.at("square")).size(), 1);
+    ASSERT_NE(getStores(allocas.at("square"))[0]->getParent(), entry);
+    ASSERT_EQ(getStores(allocas.at("half")).size(), 2);
+    for (llvm::StoreInst *store : getStores(allocas.at("half")))
+    {
+        ASSERT_NE(store->getParent(), entry);
+    }
+}
+
+TEST(CodeGenTest, PoolsStringLiteralsAndTheirSuffixes)
+{
+    std::string input = "greeting: string = \"hello world\";\n"
+                        "fn main() {\n"
+                        "    #first = \"hello world\";\n"
+                        "    #tail = \"world\";\n"
+                        "    #second = \"hello world\";\n"
+                        "}";
+    std::unique_ptr<LoweredProgram> result = quickLower(input);
+    ASSERT_NE(result->module, nullptr);
+    ASSERT_FALSE(llvm::verifyModule(*result->module->getModule(), &llvm::errs()));
+    llvm::Module *module = result->module->getModule();
+
+    std::vector<llvm::GlobalVariable *> strings;
+    for (llvm::GlobalVariable &global : module->globals())
+    {
+        if (global.getName().starts_with(".str"))
+        {
+            strings.push_back(&global);
+        }
+    }
+    ASSERT_EQ(strings.size(), 1);
+    llvm::GlobalVariable *pooled = strings[0];
+    ASSERT_TRUE(pooled->isConstant());
+    ASSERT_TRUE(pooled->hasGlobalUnnamedAddr());
+    llvm::ConstantDataArray *data = llvm::dyn_cast<llvm::ConstantDataArray>(pooled->getInitializer());
+    ASSERT_NE(data, nullptr);
+    ASSERT_EQ(data->getAsString(), llvm::StringRef("hello world\0", 12));
+
+    ASSERT_EQ(module->getGlobalVariable("greeting", true)->getInitializer(), pooled);
+
+    // every local is stored its literal once, at its declaration.
+    std::map<std::string, llvm::Value *> stored;
+    for (llvm::Instruction &instruction : module->getFunction("main")->getEntryBlock())
+    {
+        if (llvm::StoreInst *store = llvm::dyn_cast<llvm::StoreInst>(&instruction))
+        {
+            stored[store->getPointerOperand()->getName().str()] = store->getValueOperand();
+        }
+    }
+    ASSERT_EQ(stored.at("first"), pooled);
+    ASSERT_EQ(stored.at("second"), pooled);
+
+    // "world" ends "hello world", so it points into it instead of having bytes of its own.
+    llvm::GEPOperator *tail = llvm::dyn_cast<llvm::GEPOperator>(stored.at("tail"));
+    ASSERT_NE(tail, nullptr);
+    ASSERT_TRUE(tail->isInBounds());
+    ASSERT_EQ(tail->getPointerOperand(), pooled);
+    ASSERT_EQ(tail->getNumIndices(), 1);
+    llvm::ConstantInt *offset = llvm::dyn_cast<llvm::ConstantInt>(tail->getOperand(1));
+    ASSERT_NE(offset, nullptr);
+    ASSERT_EQ(offset->getZExtValue(), 6);
+}
+
+TEST(CodeGenTest, SwitchesOverEnumsWithOneInstruction)
+{
+    std::string input = "enum Shape { Empty, Circle(float64), Rect(float64, float64) }\n"
+                        "fn area(shape Shape) float64 {\n"
+                        "    switch (shape) {\n"
+                        "    case Shape.Empty: return 0.0;\n"
+                        "    case Shape.Circle(radius): return radius * radius;\n"
+                        "    case Shape.Rect(width, height): return width * height;\n"
+                        "    }\n"
+                        "    return 0.0;\n"
+                        "}\n"
+                        "fn isEmpty(shape Shape) bool {\n"
+                        "    switch (shape) {\n"
+                        "    case Shape.Empty: return true;\n"
+                        "    }\n"
+                        "    return false;\n"
+                        "}";
+    std::unique_ptr<LoweredProgram> result = quickLower(input);
+    ASSERT_NE(result->module, nullptr);
+    ASSERT_FALSE(llvm::verifyModule(*result->module->getModule(), &llvm::errs()));
+
+    auto findSwitches = [](llvm::Function *func)
+    {
+        std::vector<llvm::SwitchInst *> switches;
+        for (llvm::BasicBlock &block : *func)
+        {
+            if (llvm::SwitchInst *switchInst = llvm::dyn_cast<llvm::SwitchInst>(block.getTerminator()))
+            {
+                switches.push_back(switchInst);
+            }
+        }
+        return switches;
+    };
+
+    // every variant has a case, so the default can never be taken.
+    llvm::Function *area = result->module->getModule()->getFunction("area");
+    ASSERT_NE(area, nullptr);
+    std::vector<llvm::SwitchInst *> switches = findSwitches(area);
+    ASSERT_EQ(switches.size(), 1);
+    llvm::SwitchInst *switchInst = switches[0];
+    ASSERT_EQ(switchInst->getNumCases(), 3);
+    llvm::BasicBlock *defaultBlock = switchInst->getDefaultDest();
+    ASSERT_EQ(defaultBlock->getName(), "switch.unreachable");
+    ASSERT_EQ(defaultBlock->size(), 1);
+    ASSERT_TRUE(llvm::isa<llvm::UnreachableInst>(defaultBlock->front()));
+
+    // the payload of Rect is read from its own view of the storage into the bound locals.
+    llvm::BasicBlock *rectBlock = switchInst->findCaseValue(llvm::ConstantInt::get(llvm::cast<llvm::IntegerType>(switchInst->getCondition()->getType()), 2))->getCaseSuccessor();
+    llvm::StructType *rectType = llvm::StructType::getTypeByName(area->getContext(), "enum.Shape.Rect");
+    ASSERT_NE(rectType, nullptr);
+    std::map<std::string, llvm::LoadInst *> loads;
+    for (llvm::Instruction &instruction : *rectBlock)
+    {
+        if (llvm::LoadInst *load = llvm::dyn_cast<llvm::LoadInst>(&instruction))
+        {
+            loads[load->getName().str()] = load;
+        }
+    }
+    for (const char *name : {"width", "height"})
+    {
+        ASSERT_EQ(loads.count(name), 1);
+        llvm::LoadInst *load = loads.at(name);
+        ASSERT_TRUE(load->getType()->isDoubleTy());
+        llvm::GEPOperator *address = llvm::dyn_cast<llvm::GEPOperator>(load->getPointerOperand());
+        ASSERT_NE(address, nullptr);
+        ASSERT_EQ(address->getSourceElementType(), rectType);
+
+        bool stored = false;
+        for (llvm::User *user : load->users())
+        {
+            llvm::StoreInst *store = llvm::dyn_cast<llvm::StoreInst>(user);
+            stored |= store && llvm::isa<llvm::AllocaInst>(store->getPointerOperand());
+        }
+        ASSERT_TRUE(stored);
+    }
+
+    // with a variant left out, it falls through to the end of the switch.
+    llvm::Function *isEmpty = result->module->getModule()->getFunction("isEmpty");
+    ASSERT_NE(isEmpty, nullptr);
+    switches = findSwitches(isEmpty);
+    ASSERT_EQ(switches.size(), 1);
+    ASSERT_EQ(switches[0]->getNumCases(), 1);
+    ASSERT_EQ(switches[0]->getDefaultDest()->getName(), "switch.end");
+    ASSERT_EQ(findBlock(isEmpty, "switch.unreachable"), nullptr);
+}
+
+TEST(CodeGenTest, PicksTheThreadLocalModelForTheOutput)
+{
+    std::string input = "thread_local hits: int64 = 0;\n"
+                        "extern thread_local shared: int32;\n"
+                        "fn touch() {\n"
+                        "    hits = hits + shared;\n"
+                        "}";
+
+    struct Case
+    {
+        std::optional<CodeGenLLVM_OutputKind> outputKind;
+        llvm::GlobalValue::ThreadLocalMode definition;
+        llvm::GlobalValue::ThreadLocalMode declaration;
+    };
+    // an executable knows where its own thread locals are, the JIT has to ask at run time.
+    for (const Case &test : {Case{CodeGenLLVM_OutputKind::Executable, llvm::GlobalValue::LocalExecTLSModel, llvm::GlobalValue::InitialExecTLSModel},
+                             Case{std::nullopt, llvm::GlobalValue::GeneralDynamicTLSModel, llvm::GlobalValue::GeneralDynamicTLSModel}})
+    {
+        std::unique_ptr<LoweredProgram> result = quickLower(input, test.outputKind);
+        ASSERT_NE(result->module, nullptr);
+        ASSERT_FALSE(llvm::verifyModule(*result->module->getModule(), &llvm::errs()));
+        llvm::Module *module = result->module->getModule();
+
+        llvm::GlobalVariable *hits = module->getGlobalVariable("hits");
+        llvm::GlobalVariable *shared = module->getGlobalVariable("shared");
+        ASSERT_NE(hits, nullptr);
+        ASSERT_NE(shared, nullptr);
+        ASSERT_FALSE(hits->isDeclaration());
+        ASSERT_TRUE(shared->isDeclaration());
+        ASSERT_EQ(hits->getThreadLocalMode(), test.definition);
+        ASSERT_EQ(shared->getThreadLocalMode(), test.declaration);
+
+        // every use of either goes through the address of the current thread.
+        for (llvm::GlobalVariable *global : {hits, shared})
+        {
+            ASSERT_FALSE(global->use_empty());
+            for (llvm::User *user : global->users())
+            {
+                llvm::IntrinsicInst *address = llvm::dyn_cast<llvm::IntrinsicInst>(user);
+                ASSERT_NE(address, nullptr);
+                ASSERT_EQ(address->getIntrinsicID(), llvm::Intrinsic::threadlocal_address);
+                ASSERT_EQ(address->getFunction()->getName(), "touch");
+            }
+        }
+    }
+}
@@ -0,0 +1,99 @@
+#include <thread>
+#include <vector>
+#include "ast/ast.hpp"
+#include "parser/parser.hpp"
+#include "parser_test.hpp"
+
+TEST(ParserContextTest, ConcurrentParsing)
+{
+    const std::size_t threadCount = 8;
+    std::vector<ASTProgram *> programs(threadCount, nullptr);
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 0; i < threadCount; ++i)
+    {
+        threads.emplace_back([i, &programs]()
+                             {
+                                 std::string input = "fn f" + std::to_string(i) + "() { #a = " + std::to_string(i) + "; }";
+                                 programs[i] = static_cast<ASTProgram *>(quickParse(input)); });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (std::size_t i = 0; i < threadCount; ++i)
+    {
+        ASTProgram *program = programs[i];
+        ASTNodeList statementsList = program->getStatementList()->getStatements();
+        ASSERT_EQ(statementsList.size(), 1);
+
+        ASTFunctionDefinition *function = static_cast<ASTFunctionDefinition *>(statementsList[0]);
+        ASSERT_EQ(function->getType(), ASTNode::NodeType::FunctionDefinition);
+
+        ASTIdentifier *identifier = static_cast<ASTIdentifier *>(function->getExpr());
+        ASSERT_EQ(identifier->getName(), "f" + std::to_string(i));
+
+        delete program;
+    }
+}
+
+TEST(ParserContextTest, RepeatedIdentifiersShareSymbol)
+{
+    std::string input = "fn same() {} fn same() {} fn other() {}";
+    ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
+    ASTNodeList statementsList = program->getStatementList()->getStatements();
+    ASSERT_EQ(statementsList.size(), 3);
+
+    Symbol symbols[3];
+    for (std::size_t i = 0; i < statementsList.size(); ++i)
+    {
+        ASTFunctionDefinition *function = static_cast<ASTFunctionDefinition *>(statementsList[i]);
+        symbols[i] = static_cast<ASTIdentifier *>(function->getExpr())->getSymbol();
+    }
+
+    ASSERT_EQ(symbols[0], symbols[1]);
+    ASSERT_NE(symbols[0], symbols[2]);
+    ASSERT_EQ(symbols[0], Symbol::intern("same"));
+    ASSERT_EQ(&symbols[0].str(), &symbols[1].str());
+
+    delete program;
+}
+
+TEST(ParserContextTest, RecoversFromSyntaxErrors)
+{
+    std::string input = "fn a() { #x = ; }\n"
+                        "fn b() { #y = 1 }\n"
+                        "fn c() {}";
+    ParserContext ctx("unit-test");
+    ctx.setInput(util::SourceBuffer::fromString("unit-test", input));
+
+    ASSERT_NE(ctx.parse(), 0);
+    ASSERT_EQ(ctx.getErrorCount(), 2);
+    ASSERT_EQ(ctx.getErrorLineNumber(), 1);
+}
+
+TEST(ParserContextTest, NodesCarrySourceRanges)
+{
+    std::string input = "fn main() {\n    #value = 40 + 2;\n}";
+    ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
+    ASTNodeList statementsList = program->getStatementList()->getStatements();
+    ASSERT_EQ(statementsList.size(), 1);
+
+    auto text = [&input](const ASTNode *node)
+    {
+        return input.substr(node->getRange().begin, node->getRange().getLength());
+    };
+
+    ASTFunctionDefinition *function = static_cast<ASTFunctionDefinition *>(statementsList[0]);
+    ASSERT_EQ(text(function), input);
+    ASSERT_EQ(text(function->getExpr()), "main");
+
+    ASTStatementList *body = static_cast<ASTStatementList *>(function->getBody());
+    ASTVariableDeclaration *variable = static_cast<ASTVariableDeclaration *>(body->getStatements()[0]);
+    ASSERT_EQ(text(variable), "#value = 40 + 2;");
+    ASSERT_EQ(text(variable->getInitializer().value()), "40 + 2");
+
+    delete program;
+}
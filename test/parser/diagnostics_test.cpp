@@ -0,0 +1,47 @@
+#include <string>
+#include "util/line_table.hpp"
+#include "util/source_range.hpp"
+#include "util/util.hpp"
+
+static std::string renderPanel(const std::string &text, int lineNumber, util::SourceRange range)
+{
+    util::LineTable lines(text);
+    testing::internal::CaptureStderr();
+    util::displayDiagnosticPanel("unit-test", lines, lineNumber, range, "Error", "Message.");
+    return testing::internal::GetCapturedStderr();
+}
+
+TEST(DiagnosticsTest, UnderlinesTheRangeOnItsLine)
+{
+    std::string text = "fn main() {\n"
+                       "    #value = 1 + true;\n"
+                       "}";
+    std::string expected = "\n"
+                           "1  | fn main() {\n"
+                           "2  |     #value = 1 + true;\n"
+                           "   |              ^~~~~~~~\n"
+                           "3  | }\n"
+                           "\n"
+                           "(Error) unit-test:2  Message.\n";
+    ASSERT_EQ(renderPanel(text, 2, util::SourceRange{25, 33}), expected);
+}
+
+TEST(DiagnosticsTest, PutsACaretAtEmptyRanges)
+{
+    std::string text = "fn main() {\n"
+                       "    #value = ;\n"
+                       "}";
+    std::string caretLine = "   |              ^\n";
+
+    // an empty range inside the line, e.g. of an empty grammar rule.
+    std::string panel = renderPanel(text, 2, util::SourceRange{25, 25});
+    ASSERT_NE(panel.find("2  |     #value = ;\n" + caretLine), std::string::npos);
+
+    // an empty range just past the last character of the line.
+    panel = renderPanel(text, 2, util::SourceRange{26, 26});
+    ASSERT_NE(panel.find("2  |     #value = ;\n   |               ^\n"), std::string::npos);
+
+    // a default-constructed range has no position, so nothing is underlined.
+    panel = renderPanel(text, 1, util::SourceRange());
+    ASSERT_EQ(panel.find('^'), std::string::npos);
+}
@@ -11,8 +11,8 @@ TEST(ParserExpressionTest, SimpleBinaryExpression)
     ASSERT_EQ(program->getType(), ASTNode::NodeType::Program);
     ASSERT_EQ(statementsList.size(), 1);
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
-    ASSERT_EQ(varDecl->getType(), ASTNode::NodeType::VariableDeclaration);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
+    ASSERT_EQ(varDecl->getType(), ASTNode::NodeType::GlobalVariableDeclaration);
     ASSERT_EQ(varDecl->getName(), "my_var");
 
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
@@ -40,8 +40,8 @@ TEST(ParserExpressionTest, BinaryExpressionWithSubtraction)
     ASSERT_EQ(program->getType(), ASTNode::NodeType::Program);
     ASSERT_EQ(statementsList.size(), 1);
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
-    ASSERT_EQ(varDecl->getType(), ASTNode::NodeType::VariableDeclaration);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
+    ASSERT_EQ(varDecl->getType(), ASTNode::NodeType::GlobalVariableDeclaration);
     ASSERT_EQ(varDecl->getName(), "my_var");
 
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
@@ -69,8 +69,8 @@ TEST(ParserExpressionTest, BinaryExpressionWithMultiplication)
     ASSERT_EQ(program->getType(), ASTNode::NodeType::Program);
     ASSERT_EQ(statementsList.size(), 1);
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
-    ASSERT_EQ(varDecl->getType(), ASTNode::NodeType::VariableDeclaration);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
+    ASSERT_EQ(varDecl->getType(), ASTNode::NodeType::GlobalVariableDeclaration);
     ASSERT_EQ(varDecl->getName(), "my_var");
 
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
@@ -98,8 +98,8 @@ TEST(ParserExpressionTest, BinaryExpressionWithDivision)
     ASSERT_EQ(program->getType(), ASTNode::NodeType::Program);
     ASSERT_EQ(statementsList.size(), 1);
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
-    ASSERT_EQ(varDecl->getType(), ASTNode::NodeType::VariableDeclaration);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
+    ASSERT_EQ(varDecl->getType(), ASTNode::NodeType::GlobalVariableDeclaration);
     ASSERT_EQ(varDecl->getName(), "my_var");
 
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
@@ -127,8 +127,8 @@ TEST(ParserExpressionTest, BinaryExpressionWithRemainder)
     ASSERT_EQ(program->getType(), ASTNode::NodeType::Program);
     ASSERT_EQ(statementsList.size(), 1);
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
-    ASSERT_EQ(varDecl->getType(), ASTNode::NodeType::VariableDeclaration);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
+    ASSERT_EQ(varDecl->getType(), ASTNode::NodeType::GlobalVariableDeclaration);
     ASSERT_EQ(varDecl->getName(), "my_var");
 
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
@@ -153,7 +153,7 @@ TEST(ParserExpressionTest, BinaryExpressionWithEqual)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTBinaryExpression *binaryExpr = static_cast<ASTBinaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(binaryExpr->getOperator(), ASTBinaryExpression::Operator::Equal);
@@ -167,7 +167,7 @@ TEST(ParserExpressionTest, BinaryExpressionWithNotEqual)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTBinaryExpression *binaryExpr = static_cast<ASTBinaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(binaryExpr->getOperator(), ASTBinaryExpression::Operator::NotEqual);
@@ -181,7 +181,7 @@ TEST(ParserExpressionTest, BinaryExpressionWithLessThan)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTBinaryExpression *binaryExpr = static_cast<ASTBinaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(binaryExpr->getOperator(), ASTBinaryExpression::Operator::LessThan);
@@ -195,7 +195,7 @@ TEST(ParserExpressionTest, BinaryExpressionWithLessEqual)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTBinaryExpression *binaryExpr = static_cast<ASTBinaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(binaryExpr->getOperator(), ASTBinaryExpression::Operator::LessEqual);
@@ -209,7 +209,7 @@ TEST(ParserExpressionTest, BinaryExpressionWithGreaterThan)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTBinaryExpression *binaryExpr = static_cast<ASTBinaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(binaryExpr->getOperator(), ASTBinaryExpression::Operator::GreaterThan);
@@ -223,7 +223,7 @@ TEST(ParserExpressionTest, BinaryExpressionWithGreaterEqual)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTBinaryExpression *binaryExpr = static_cast<ASTBinaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(binaryExpr->getOperator(), ASTBinaryExpression::Operator::GreaterEqual);
@@ -237,7 +237,7 @@ TEST(ParserExpressionTest, BinaryExpressionWithLogicalAnd)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTBinaryExpression *binaryExpr = static_cast<ASTBinaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(binaryExpr->getOperator(), ASTBinaryExpression::Operator::LogicalAnd);
@@ -251,7 +251,7 @@ TEST(ParserExpressionTest, BinaryExpressionWithLogicalOr)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTBinaryExpression *binaryExpr = static_cast<ASTBinaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(binaryExpr->getOperator(), ASTBinaryExpression::Operator::LogicalOr);
@@ -265,7 +265,7 @@ TEST(ParserExpressionTest, UnaryExpressionNegate)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTUnaryExpression *unaryExpr = static_cast<ASTUnaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(unaryExpr->getOperator(), ASTUnaryExpression::Operator::Negate);
@@ -282,7 +282,7 @@ TEST(ParserExpressionTest, UnaryExpressionLogicalNot)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTUnaryExpression *unaryExpr = static_cast<ASTUnaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(unaryExpr->getOperator(), ASTUnaryExpression::Operator::LogicalNot);
@@ -296,7 +296,7 @@ TEST(ParserExpressionTest, UnaryExpressionBitwiseNot)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTUnaryExpression *unaryExpr = static_cast<ASTUnaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(unaryExpr->getOperator(), ASTUnaryExpression::Operator::BitwiseNot);
@@ -313,7 +313,7 @@ TEST(ParserExpressionTest, UnaryExpressionPlus)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTUnaryExpression *unaryExpr = static_cast<ASTUnaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(unaryExpr->getOperator(), ASTUnaryExpression::Operator::Plus);
@@ -330,14 +330,14 @@ TEST(ParserExpressionTest, UnaryExpressionDereference)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTUnaryExpression *unaryExpr = static_cast<ASTUnaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(unaryExpr->getOperator(), ASTUnaryExpression::Operator::Dereference);
 
-    ASTImportedSymbolAccess *operand = static_cast<ASTImportedSymbolAccess *>(unaryExpr->getOperand());
-    ASSERT_EQ(operand->getSymbolPath().size(), 1);
-    ASSERT_EQ(operand->getSymbolPath()[0], "ptr");
+    ASTIdentifier *operand = static_cast<ASTIdentifier *>(unaryExpr->getOperand());
+    ASSERT_EQ(operand->getType(), ASTNode::NodeType::Identifier);
+    ASSERT_EQ(operand->getName(), "ptr");
 
     delete program;
 }
@@ -348,14 +348,14 @@ TEST(ParserExpressionTest, UnaryExpressionPreIncrement)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTUnaryExpression *unaryExpr = static_cast<ASTUnaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(unaryExpr->getOperator(), ASTUnaryExpression::Operator::PreIncrement);
 
-    ASTImportedSymbolAccess *operand = static_cast<ASTImportedSymbolAccess *>(unaryExpr->getOperand());
-    ASSERT_EQ(operand->getSymbolPath().size(), 1);
-    ASSERT_EQ(operand->getSymbolPath()[0], "i");
+    ASTIdentifier *operand = static_cast<ASTIdentifier *>(unaryExpr->getOperand());
+    ASSERT_EQ(operand->getType(), ASTNode::NodeType::Identifier);
+    ASSERT_EQ(operand->getName(), "i");
 
     delete program;
 }
@@ -366,14 +366,14 @@ TEST(ParserExpressionTest, UnaryExpressionPreDecrement)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTUnaryExpression *unaryExpr = static_cast<ASTUnaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(unaryExpr->getOperator(), ASTUnaryExpression::Operator::PreDecrement);
 
-    ASTImportedSymbolAccess *operand = static_cast<ASTImportedSymbolAccess *>(unaryExpr->getOperand());
-    ASSERT_EQ(operand->getSymbolPath().size(), 1);
-    ASSERT_EQ(operand->getSymbolPath()[0], "j");
+    ASTIdentifier *operand = static_cast<ASTIdentifier *>(unaryExpr->getOperand());
+    ASSERT_EQ(operand->getType(), ASTNode::NodeType::Identifier);
+    ASSERT_EQ(operand->getName(), "j");
 
     delete program;
 }
@@ -384,14 +384,14 @@ TEST(ParserExpressionTest, UnaryExpressionPostIncrement)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTUnaryExpression *unaryExpr = static_cast<ASTUnaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(unaryExpr->getOperator(), ASTUnaryExpression::Operator::PostIncrement);
 
-    ASTImportedSymbolAccess *operand = static_cast<ASTImportedSymbolAccess *>(unaryExpr->getOperand());
-    ASSERT_EQ(operand->getSymbolPath().size(), 1);
-    ASSERT_EQ(operand->getSymbolPath()[0], "k");
+    ASTIdentifier *operand = static_cast<ASTIdentifier *>(unaryExpr->getOperand());
+    ASSERT_EQ(operand->getType(), ASTNode::NodeType::Identifier);
+    ASSERT_EQ(operand->getName(), "k");
 
     delete program;
 }
@@ -402,14 +402,14 @@ TEST(ParserExpressionTest, UnaryExpressionPostDecrement)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTUnaryExpression *unaryExpr = static_cast<ASTUnaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(unaryExpr->getOperator(), ASTUnaryExpression::Operator::PostDecrement);
 
-    ASTImportedSymbolAccess *operand = static_cast<ASTImportedSymbolAccess *>(unaryExpr->getOperand());
-    ASSERT_EQ(operand->getSymbolPath().size(), 1);
-    ASSERT_EQ(operand->getSymbolPath()[0], "l");
+    ASTIdentifier *operand = static_cast<ASTIdentifier *>(unaryExpr->getOperand());
+    ASSERT_EQ(operand->getType(), ASTNode::NodeType::Identifier);
+    ASSERT_EQ(operand->getName(), "l");
 
     delete program;
 }
@@ -420,7 +420,7 @@ TEST(ParserExpressionTest, NestedBinaryExpression)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTBinaryExpression *outerBinaryExpr = static_cast<ASTBinaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(outerBinaryExpr->getOperator(), ASTBinaryExpression::Operator::Multiply);
@@ -446,7 +446,7 @@ TEST(ParserExpressionTest, ComplexExpression)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTBinaryExpression *divideExpr = static_cast<ASTBinaryExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(divideExpr->getOperator(), ASTBinaryExpression::Operator::Divide);
@@ -472,15 +472,15 @@ TEST(ParserExpressionTest, CastExpressionToFloat)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTCastExpression *castExpr = static_cast<ASTCastExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(castExpr->getType(), ASTNode::NodeType::CastExpression);
     ASSERT_EQ(castExpr->getTargetType().getTypeValue(), ASTTypeSpecifier::ASTInternalType::Float32);
 
-    ASTImportedSymbolAccess *operand = static_cast<ASTImportedSymbolAccess *>(castExpr->getExpression());
-    ASSERT_EQ(operand->getSymbolPath().size(), 1);
-    ASSERT_EQ(operand->getSymbolPath()[0], "my_int");
+    ASTIdentifier *operand = static_cast<ASTIdentifier *>(castExpr->getExpression());
+    ASSERT_EQ(operand->getType(), ASTNode::NodeType::Identifier);
+    ASSERT_EQ(operand->getName(), "my_int");
 
     delete program;
 }
@@ -491,7 +491,7 @@ TEST(ParserExpressionTest, NestedCastExpression)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTCastExpression *outerCastExpr = static_cast<ASTCastExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(outerCastExpr->getType(), ASTNode::NodeType::CastExpression);
@@ -501,9 +501,9 @@ TEST(ParserExpressionTest, NestedCastExpression)
     ASSERT_EQ(innerCastExpr->getType(), ASTNode::NodeType::CastExpression);
     ASSERT_EQ(innerCastExpr->getTargetType().getTypeValue(), ASTTypeSpecifier::ASTInternalType::Float32);
 
-    ASTImportedSymbolAccess *operand = static_cast<ASTImportedSymbolAccess *>(innerCastExpr->getExpression());
-    ASSERT_EQ(operand->getSymbolPath().size(), 1);
-    ASSERT_EQ(operand->getSymbolPath()[0], "my_double");
+    ASTIdentifier *operand = static_cast<ASTIdentifier *>(innerCastExpr->getExpression());
+    ASSERT_EQ(operand->getType(), ASTNode::NodeType::Identifier);
+    ASSERT_EQ(operand->getName(), "my_double");
 
     delete program;
 }
@@ -514,7 +514,7 @@ TEST(ParserExpressionTest, CastExpressionWithBinaryExpression)
     ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
     ASTNodeList statementsList = program->getStatementList()->getStatements();
 
-    ASTVariableDeclaration *varDecl = static_cast<ASTVariableDeclaration *>(statementsList[0]);
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
     ASSERT_EQ(varDecl->getInitializer().has_value(), true);
     ASTCastExpression *castExpr = static_cast<ASTCastExpression *>(varDecl->getInitializer().value());
     ASSERT_EQ(castExpr->getType(), ASTNode::NodeType::CastExpression);
@@ -526,3 +526,37 @@ TEST(ParserExpressionTest, CastExpressionWithBinaryExpression)
 
     delete program;
 }
+
+TEST(ParserExpressionTest, QualifiedSymbolAccess)
+{
+    std::string input = "my_var = -std::math::pi;";
+    ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
+    ASTNodeList statementsList = program->getStatementList()->getStatements();
+
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
+    ASSERT_EQ(varDecl->getInitializer().has_value(), true);
+    ASTUnaryExpression *unaryExpr = static_cast<ASTUnaryExpression *>(varDecl->getInitializer().value());
+    ASSERT_EQ(unaryExpr->getOperator(), ASTUnaryExpression::Operator::Negate);
+
+    ASTImportedSymbolAccess *operand = static_cast<ASTImportedSymbolAccess *>(unaryExpr->getOperand());
+    ASSERT_EQ(operand->getType(), ASTNode::NodeType::ImportedSymbolAccess);
+    ASSERT_EQ(operand->getSymbolPath().size(), 3);
+    ASSERT_EQ(operand->getSymbolPath()[2], "pi");
+
+    delete program;
+}
+
+TEST(ParserExpressionTest, UnescapesStringLiterals)
+{
+    std::string input = "my_var = \"tab\\there\\n\\\"q\\\" \\x41\\101\\0end\";";
+    ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
+    ASTNodeList statementsList = program->getStatementList()->getStatements();
+    ASSERT_EQ(statementsList.size(), 1);
+
+    ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
+    ASTStringLiteral *literal = static_cast<ASTStringLiteral *>(varDecl->getInitializer().value());
+    ASSERT_EQ(literal->getType(), ASTNode::NodeType::StringLiteral);
+    ASSERT_EQ(literal->getValue(), std::string("tab\there\n\"q\" AA\0end", 19));
+
+    delete program;
+}
@@ -171,3 +171,21 @@ TEST(ParserFunctionTest, FunctionWithBody)
     delete program;
 }
 
+
+TEST(ParserFunctionTest, FunctionWithDeclarationsBetweenStatements)
+{
+    std::string input = "fn main() { #a = 1; a = 2; #b = a; return b; }";
+    ASTProgram *program = static_cast<ASTProgram *>(quickParse(input));
+    ASTNodeList statementsList = program->getStatementList()->getStatements();
+
+    ASTFunctionDefinition *function = static_cast<ASTFunctionDefinition *>(statementsList[0]);
+    ASTStatementList *body = static_cast<ASTStatementList *>(function->getBody());
+    ASSERT_EQ(body->getStatements().size(), 4);
+
+    ASSERT_EQ(body->getStatements()[0]->getType(), ASTNode::NodeType::VariableDeclaration);
+    ASSERT_EQ(body->getStatements()[1]->getType(), ASTNode::NodeType::AssignmentExpression);
+    ASSERT_EQ(body->getStatements()[2]->getType(), ASTNode::NodeType::VariableDeclaration);
+    ASSERT_EQ(body->getStatements()[3]->getType(), ASTNode::NodeType::ReturnStatement);
+
+    delete program;
+}
@@ -0,0 +1,213 @@
+#include <string>
+#include "codegen_llvm/compiler.hpp"
+#include "parser_test.hpp"
+#include "llvm/IR/DataLayout.h"
+#include "llvm/IR/DerivedTypes.h"
+
+TEST(LayoutTest, ReordersFieldsByAlignment)
+{
+    std::string input = "struct Plain {\n"
+                        "    flag bool;\n"
+                        "    value float64;\n"
+                        "    count int32;\n"
+                        "}\n"
+                        "struct [[reorder]] Sample {\n"
+                        "    flag bool;\n"
+                        "    value float64;\n"
+                        "    count int32;\n"
+                        "}";
+    std::unique_ptr<LoweredProgram> result = quickLower(input);
+    ASSERT_NE(result->module, nullptr);
+
+    std::string expected = "struct Plain: size 24, align 8, 11 bytes of padding (45%)\n"
+                           "    0: flag bool (size 1, align 1)\n"
+                           "    1: hole of 7 bytes\n"
+                           "    8: value float64 (size 8, align 8)\n"
+                           "    16: count int32 (size 4, align 4)\n"
+                           "    20: tail padding of 4 bytes\n"
+                           "struct Sample [[reorder]]: size 16, align 8, 3 bytes of padding (18%)\n"
+                           "    0: value float64 (size 8, align 8)\n"
+                           "    8: count int32 (size 4, align 4)\n"
+                           "    12: flag bool (size 1, align 1)\n"
+                           "    13: tail padding of 3 bytes\n";
+    ASSERT_EQ(result->module->getLayoutReport(), expected);
+}
+
+TEST(LayoutTest, PadsPackedStructsOnlyToTheirAlignment)
+{
+    std::string input = "struct [[packed]] Header {\n"
+                        "    tag uint8;\n"
+                        "    length uint32;\n"
+                        "}\n"
+                        "struct [[packed, align(16)]] Aligned {\n"
+                        "    tag uint8;\n"
+                        "    length uint32;\n"
+                        "}";
+    std::unique_ptr<LoweredProgram> result = quickLower(input);
+    ASSERT_NE(result->module, nullptr);
+
+    std::string expected = "struct Header [[packed]]: size 5, align 1, 0 bytes of padding (0%)\n"
+                           "    0: tag uint8 (size 1, align 1)\n"
+                           "    1: length uint32 (size 4, align 1)\n"
+                           "struct Aligned [[packed, align(16)]]: size 16, align 16, 11 bytes of padding (68%)\n"
+                           "    0: tag uint8 (size 1, align 1)\n"
+                           "    1: length uint32 (size 4, align 1)\n"
+                           "    5: tail padding of 11 bytes\n";
+    ASSERT_EQ(result->module->getLayoutReport(), expected);
+
+    // the tail beyond what LLVM pads on its own is an explicit element.
+    const llvm::DataLayout &dataLayout = result->module->getModule()->getDataLayout();
+    llvm::StructType *aligned = llvm::StructType::getTypeByName(result->module->getModule()->getContext(), "struct.Aligned");
+    ASSERT_NE(aligned, nullptr);
+    ASSERT_EQ(dataLayout.getTypeAllocSize(aligned), 16);
+}
+
+TEST(LayoutTest, PadsOverAlignedStructsExplicitly)
+{
+    std::string input = "struct [[align(32)]] Wide {\n"
+                        "    value int64;\n"
+                        "}\n"
+                        "struct Holder {\n"
+                        "    tag uint8;\n"
+                        "    wide Wide;\n"
+                        "}";
+    std::unique_ptr<LoweredProgram> result = quickLower(input);
+    ASSERT_NE(result->module, nullptr);
+
+    std::string expected = "struct Wide [[align(32)]]: size 32, align 32, 24 bytes of padding (75%)\n"
+                           "    0: value int64 (size 8, align 8)\n"
+                           "    8: tail padding of 24 bytes\n"
+                           "struct Holder: size 64, align 32, 31 bytes of padding (48%)\n"
+                           "    0: tag uint8 (size 1, align 1)\n"
+                           "    1: hole of 31 bytes\n"
+                           "    32: wide Wide (size 32, align 32)\n";
+    ASSERT_EQ(result->module->getLayoutReport(), expected);
+
+    // LLVM only aligns Wide to 8, so the offsets above must come from padding elements.
+    const llvm::DataLayout &dataLayout = result->module->getModule()->getDataLayout();
+    llvm::LLVMContext &context = result->module->getModule()->getContext();
+    llvm::StructType *wide = llvm::StructType::getTypeByName(context, "struct.Wide");
+    llvm::StructType *holder = llvm::StructType::getTypeByName(context, "struct.Holder");
+    ASSERT_NE(wide, nullptr);
+    ASSERT_NE(holder, nullptr);
+    ASSERT_EQ(dataLayout.getTypeAllocSize(wide), 32);
+    ASSERT_EQ(dataLayout.getTypeAllocSize(holder), 64);
+    ASSERT_EQ(holder->getNumElements(), 3);
+    ASSERT_EQ(holder->getElementType(2), wide);
+    ASSERT_EQ(dataLayout.getStructLayout(holder)->getElementOffset(2), 32);
+}
+
+TEST(LayoutTest, StartsSoaColumnsOnTheStructAlignment)
+{
+    std::string input = "struct [[soa(4), align(64)]] Particles {\n"
+                        "    x float64;\n"
+                        "    flag bool;\n"
+                        "}";
+    std::unique_ptr<LoweredProgram> result = quickLower(input);
+    ASSERT_NE(result->module, nullptr);
+
+    std::string expected = "struct Particles [[align(64), soa(4)]]: size 128, align 64, 92 bytes of padding (71%)\n"
+                           "    0: x column of 4 float64 (size 32, align 64)\n"
+                           "    32: hole of 32 bytes\n"
+                           "    64: flag column of 4 bool (size 4, align 64)\n"
+                           "    68: tail padding of 60 bytes\n";
+    ASSERT_EQ(result->module->getLayoutReport(), expected);
+
+    const llvm::DataLayout &dataLayout = result->module->getModule()->getDataLayout();
+    llvm::StructType *particles = llvm::StructType::getTypeByName(result->module->getModule()->getContext(), "struct.Particles");
+    ASSERT_NE(particles, nullptr);
+    ASSERT_EQ(dataLayout.getTypeAllocSize(particles), 128);
+    ASSERT_EQ(dataLayout.getStructLayout(particles)->getElementOffset(2), 64);
+}
+
+static const CodeGenLLVM_EnumLayout &findEnumLayout(LoweredProgram &result, std::string_view name)
+{
+    const semantic::Declaration *declaration = result.analyzed->module.lookupGlobal(Symbol::intern(name));
+    // every enum is laid out when the module is lowered, so the node is never needed.
+    return result.module->getEnumLayout(declaration->type, nullptr);
+}
+
+TEST(LayoutTest, StoresOptionalReferencesInTheirNullValue)
+{
+    std::string input = "enum Maybe { None, Some(int64&) }";
+    std::unique_ptr<LoweredProgram> result = quickLower(input);
+    ASSERT_NE(result->module, nullptr);
+
+    const CodeGenLLVM_EnumLayout &layout = findEnumLayout(*result, "Maybe");
+    const llvm::DataLayout &dataLayout = result->module->getModule()->getDataLayout();
+    ASSERT_EQ(layout.kind, CodeGenLLVM_EnumLayout::Kind::Niche);
+    ASSERT_EQ(layout.size, dataLayout.getPointerSize());
+    ASSERT_EQ(layout.alignment, dataLayout.getPointerABIAlignment(0).value());
+    ASSERT_EQ(dataLayout.getTypeAllocSize(layout.type->getLLVMType()), dataLayout.getPointerSize());
+
+    // None is the null reference, Some any other.
+    ASSERT_EQ(layout.dataful, 1);
+    ASSERT_TRUE(layout.niche.isPointer);
+    ASSERT_EQ(layout.niche.offset, 0);
+    ASSERT_EQ(layout.niche.start, 0);
+    ASSERT_EQ(layout.niche.count, 1);
+    ASSERT_EQ(layout.variants[0].caseValue, 0);
+    ASSERT_EQ(layout.variants[1].caseValue, 1);
+    ASSERT_FALSE(layout.spareNiche.has_value());
+}
+
+TEST(LayoutTest, WidensTheTagToTheRangeOfDiscriminants)
+{
+    std::string input = "enum Code { Ok, Value(int32), Far = 1000 }";
+    std::unique_ptr<LoweredProgram> result = quickLower(input);
+    ASSERT_NE(result->module, nullptr);
+
+    const CodeGenLLVM_EnumLayout &layout = findEnumLayout(*result, "Code");
+    ASSERT_EQ(layout.kind, CodeGenLLVM_EnumLayout::Kind::Tagged);
+    ASSERT_EQ(layout.tagType->getBitWidth(), 16);
+    ASSERT_EQ(layout.variants[0].caseValue, 0);
+    ASSERT_EQ(layout.variants[1].caseValue, 1);
+    ASSERT_EQ(layout.variants[2].caseValue, 1000);
+
+    // the payload follows the tag at its own alignment.
+    ASSERT_EQ(layout.payloadOffset, 4);
+    ASSERT_EQ(layout.size, 8);
+    ASSERT_EQ(layout.alignment, 4);
+    const llvm::DataLayout &dataLayout = result->module->getModule()->getDataLayout();
+    llvm::StructType *llvmType = llvm::cast<llvm::StructType>(layout.type->getLLVMType());
+    ASSERT_EQ(dataLayout.getTypeAllocSize(llvmType), 8);
+    ASSERT_EQ(dataLayout.getStructLayout(llvmType)->getElementOffset(layout.payloadElement), 4);
+
+    // the tags past Far are free for an enum holding this one.
+    ASSERT_TRUE(layout.spareNiche.has_value());
+    ASSERT_EQ(layout.spareNiche->start, 1001);
+    ASSERT_EQ(layout.spareNiche->count, 65535 - 1000);
+}
+
+TEST(LayoutTest, NestsEnumsInTheSpareTagsOfTheirPayload)
+{
+    std::string input = "enum Color { Red, Green, Blue }\n"
+                        "enum Paint { Clear, Solid(Color) }\n"
+                        "enum Layer { Hidden, Shown(Paint) }";
+    std::unique_ptr<LoweredProgram> result = quickLower(input);
+    ASSERT_NE(result->module, nullptr);
+
+    const CodeGenLLVM_EnumLayout &color = findEnumLayout(*result, "Color");
+    ASSERT_EQ(color.kind, CodeGenLLVM_EnumLayout::Kind::Tag);
+    ASSERT_EQ(color.size, 1);
+    ASSERT_TRUE(color.spareNiche.has_value());
+    ASSERT_EQ(color.spareNiche->start, 3);
+    ASSERT_EQ(color.spareNiche->count, 253);
+
+    // Clear takes the first spare tag of Color, Hidden the next one.
+    const CodeGenLLVM_EnumLayout &paint = findEnumLayout(*result, "Paint");
+    ASSERT_EQ(paint.kind, CodeGenLLVM_EnumLayout::Kind::Niche);
+    ASSERT_EQ(paint.size, 1);
+    ASSERT_EQ(paint.niche.start, 3);
+    ASSERT_TRUE(paint.spareNiche.has_value());
+    ASSERT_EQ(paint.spareNiche->start, 4);
+    ASSERT_EQ(paint.spareNiche->count, 252);
+
+    const CodeGenLLVM_EnumLayout &layer = findEnumLayout(*result, "Layer");
+    ASSERT_EQ(layer.kind, CodeGenLLVM_EnumLayout::Kind::Niche);
+    ASSERT_EQ(layer.size, 1);
+    ASSERT_FALSE(layer.niche.isPointer);
+    ASSERT_EQ(layer.niche.bits, 8);
+    ASSERT_EQ(layer.niche.start, 4);
+    ASSERT_EQ(layer.spareNiche->start, 5);
+}
@@ -7,46 +7,71 @@
 
 #include "function_test.cpp"
 #include "expression_test.cpp"
+#include "context_test.cpp"
+#include "semantic_test.cpp"
+#include "layout_test.cpp"
+#include "codegen_test.cpp"
+#include "diagnostics_test.cpp"
 
 const std::string unitTestFileName = "unit-test";
 
 ASTNodePtr quickParse(std::string input)
 {
-    yyin = nullptr;
-    astProgram = nullptr;
+    ParserContext ctx(unitTestFileName);
+    ctx.setInput(util::SourceBuffer::fromString(unitTestFileName, input));
 
-    yyin = fmemopen((void *)input.c_str(), input.size(), "r");
-    if (!yyin)
+    if (ctx.parse() != 0)
     {
-        std::cerr << "(Error) Could not open input stream." << std::endl;
+        util::displayErrorPanel(unitTestFileName, input, ctx.getErrorLineNumber(), ctx.getErrorMessage());
         std::exit(1);
     }
 
-    set_lex_only_option(0);
-    yyfilename = (char *)unitTestFileName.c_str();
-
-    if (yyparse() == 0)
+    ASTProgram *program = ctx.releaseProgram();
+    if (program == nullptr)
     {
-        if (astProgram == nullptr)
-        {
-            std::cerr << "(Error) ASTProgram is not initialized correctly.'" << std::endl;
-            std::exit(1);
-        }
-        fclose(yyin);
-        yylex_destroy();
-
-        return astProgram;
+        std::cerr << "(Error) ASTProgram is not initialized correctly.'" << std::endl;
+        std::exit(1);
     }
-    else
+
+    return program;
+}
+
+std::unique_ptr<AnalyzedProgram> quickAnalyze(std::string input)
+{
+    std::unique_ptr<AnalyzedProgram> result = std::make_unique<AnalyzedProgram>();
+    result->program = static_cast<ASTProgram *>(quickParse(input));
+    result->succeeded = semantic::analyzeProgram(result->program, result->module, util::SourceBuffer::fromString(unitTestFileName, input), result->diagnostics);
+    return result;
+}
+
+std::unique_ptr<LoweredProgram> quickLower(std::string input, std::optional<CodeGenLLVM_OutputKind> outputKind)
+{
+    std::unique_ptr<LoweredProgram> result = std::make_unique<LoweredProgram>();
+    result->analyzed = quickAnalyze(input);
+    if (!result->analyzed->succeeded)
     {
-        std::string errorMsg = yyerrormsg;
-        util::displayErrorPanel("unit-test", input, yylineno, errorMsg);
-        std::exit(1);
+        return result;
     }
 
-    fclose(yyin);
-    yylex_destroy();
-    return nullptr;
+    result->module = result->context.createModule(unitTestFileName, unitTestFileName, util::SourceBuffer::fromString(unitTestFileName, input), result->analyzed->diagnostics);
+    result->module->setOutputKind(outputKind);
+    // lowering consumes the program.
+    result->module->buildProgramIR(result->analyzed->program);
+    result->analyzed->program = nullptr;
+    return result;
+}
+
+std::vector<std::string> AnalyzedProgram::getErrors()
+{
+    std::vector<std::string> errors;
+    for (const util::Diagnostic &diagnostic : diagnostics.getDiagnostics())
+    {
+        if (diagnostic.severity == util::DiagnosticSeverity::Error)
+        {
+            errors.push_back(std::to_string(diagnostic.lineNumber) + ": " + diagnostic.message);
+        }
+    }
+    return errors;
 }
 
 int main(int argc, char **argv)
@@ -1,8 +1,43 @@
 #ifndef PARSER_TEST_HPP
 #define PARSER_TEST_HPP
 
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 #include "ast/ast.hpp"
+#include "codegen_llvm/compiler.hpp"
+#include "semantic/analyzer.hpp"
+#include "util/diagnostics.hpp"
 
 ASTNodePtr quickParse(std::string input);
 
+// A program parsed and run through the semantic stage, with what it produced.
+struct AnalyzedProgram
+{
+    ASTProgram *program = nullptr;
+    semantic::Module module;
+    util::DiagnosticEngine diagnostics;
+    bool succeeded = false;
+
+    ~AnalyzedProgram() { delete program; }
+
+    // Each error as "line: message", in source order.
+    std::vector<std::string> getErrors();
+};
+
+std::unique_ptr<AnalyzedProgram> quickAnalyze(std::string input);
+
+// An analyzed program lowered to LLVM IR for the host target, for the JIT
+// unless an output kind is given.
+struct LoweredProgram
+{
+    std::unique_ptr<AnalyzedProgram> analyzed;
+    CodeGenLLVM_Context context;
+    // Owned by the context, null if the analysis failed.
+    CodeGenLLVM_Module *module = nullptr;
+};
+
+std::unique_ptr<LoweredProgram> quickLower(std::string input, std::optional<CodeGenLLVM_OutputKind> outputKind = std::nullopt);
+
 #endif //PARSER_TEST_HPP
@@ -0,0 +1,502 @@
+#include "ast/ast.hpp"
+#include "semantic/analyzer.hpp"
+#include "semantic/constant.hpp"
+#include "util/diagnostics.hpp"
+#include "parser_test.hpp"
+
+TEST(SemanticTest, AnnotatesTypesAndDeclarations)
+{
+    std::string input = "counter: int64 = 1;\n"
+                        "fn main() {\n"
+                        "    #value = counter + 2;\n"
+                        "}";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_TRUE(result->succeeded);
+
+    ASTNodeList statementsList = result->program->getStatementList()->getStatements();
+    ASTFunctionDefinition *function = static_cast<ASTFunctionDefinition *>(statementsList[1]);
+    ASTStatementList *body = static_cast<ASTStatementList *>(function->getBody());
+    ASTVariableDeclaration *variable = static_cast<ASTVariableDeclaration *>(body->getStatements()[0]);
+    ASSERT_EQ(variable->getSemanticType()->getKind(), semantic::Type::Kind::Int64);
+
+    ASTBinaryExpression *sum = static_cast<ASTBinaryExpression *>(variable->getInitializer().value());
+    const semantic::Declaration *declaration = static_cast<ASTIdentifier *>(sum->getLeft())->getDeclaration();
+    ASSERT_NE(declaration, nullptr);
+    ASSERT_EQ(declaration->kind, semantic::Declaration::Kind::GlobalVariable);
+    ASSERT_EQ(declaration->node, statementsList[0]);
+
+    ASSERT_EQ(function->getSemanticType()->getReturnType()->getKind(), semantic::Type::Kind::Void);
+}
+
+TEST(SemanticTest, ReportsEveryError)
+{
+    std::string input = "fn main() {\n"
+                        "    #a: int32 = missing;\n"
+                        "    #b: bool* = 1;\n"
+                        "    break;\n"
+                        "}";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_FALSE(result->succeeded);
+    std::vector<std::string> expected = {
+        "2: Use of undeclared identifier 'missing'.",
+        "3: Cannot convert 'int' to 'bool*' in the initialization of 'b'.",
+        "4: 'break' is only allowed inside a loop or a switch.",
+    };
+    ASSERT_EQ(result->getErrors(), expected);
+}
+
+TEST(SemanticTest, RequiresMainToReturnInt32)
+{
+    std::string input = "fn main() int64 {\n"
+                        "    return 0;\n"
+                        "}";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_FALSE(result->succeeded);
+    std::vector<std::string> expected = {
+        "1: Function 'main' must return 'int', 'int32' or nothing, found 'int64'.",
+    };
+    ASSERT_EQ(result->getErrors(), expected);
+
+    ASSERT_TRUE(quickAnalyze("fn main() int32 {\n    return 0;\n}")->succeeded);
+    ASSERT_TRUE(quickAnalyze("fn main() int {\n    return 0;\n}")->succeeded);
+}
+
+TEST(SemanticTest, ResolvesFunctionsWithoutAReturnTypeAsVoid)
+{
+    std::string input = "inline public fn first() {}\n"
+                        "public inline fn second() {}\n"
+                        "fn main() {\n"
+                        "    first();\n"
+                        "    second();\n"
+                        "}";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_TRUE(result->succeeded);
+
+    ASTNodeList statementsList = result->program->getStatementList()->getStatements();
+    for (std::size_t i = 0; i < 2; ++i)
+    {
+        ASTFunctionDefinition *function = static_cast<ASTFunctionDefinition *>(statementsList[i]);
+        ASSERT_FALSE(function->getReturnType().has_value());
+        ASSERT_EQ(function->getSemanticType()->getReturnType()->getKind(), semantic::Type::Kind::Void);
+    }
+}
+
+TEST(SemanticTest, RequiresAReturnOnEveryPath)
+{
+    std::string input = "enum Sign { Negative, Zero, Positive }\n"
+                        "fn missing(value int32) int32 {\n"
+                        "    if (value > 0) { return 1; }\n"
+                        "}\n"
+                        "fn alsoMissing(value int32) int32 {\n"
+                        "    for (value > 0) { return 1; }\n"
+                        "}\n"
+                        "fn branches(value int32) int32 {\n"
+                        "    if (value > 0) { return 1; } else { return 0; }\n"
+                        "}\n"
+                        "fn covered(sign Sign) int32 {\n"
+                        "    switch (sign) {\n"
+                        "    case Sign.Negative: return -1;\n"
+                        "    case Sign.Zero: return 0;\n"
+                        "    case Sign.Positive: return 1;\n"
+                        "    }\n"
+                        "}\n"
+                        "fn main() int32 {\n"
+                        "}";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_FALSE(result->succeeded);
+    std::vector<std::string> expected = {
+        "2: Function 'missing' does not return a value on every path.",
+        "5: Function 'alsoMissing' does not return a value on every path.",
+    };
+    ASSERT_EQ(result->getErrors(), expected);
+}
+
+TEST(SemanticTest, FoldsConstantInitializers)
+{
+    std::string input = "base: const int128 = 1;\n"
+                        "big: int128 = (base << 100) - 1;\n"
+                        "wrapped: uint8 = (uint8) 250 + (uint8) 10;\n"
+                        "scale: float64 = base > 0 ? 2.5 : 0.5;";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_TRUE(result->succeeded);
+
+    auto evaluate = [&result](std::size_t index)
+    {
+        ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(result->program->getStatementList()->getStatements()[index]);
+        return semantic::ConstantEvaluator().evaluate(varDecl->getInitializer().value(), varDecl->getSemanticType()).value();
+    };
+
+    ASSERT_EQ(evaluate(1).getInteger(), llvm::APInt::getLowBitsSet(128, 100));
+    ASSERT_EQ(evaluate(2).getInteger().getZExtValue(), 4);
+    ASSERT_EQ(evaluate(3).getFloat().convertToDouble(), 2.5);
+}
+
+TEST(SemanticTest, KeepsIntegerLiteralsExact)
+{
+    std::string input = "big: int64 = 5000000000;\n"
+                        "mask: uint64 = 0xFFFFFFFF;\n"
+                        "huge: uint128 = 0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF;\n"
+                        "lowest: int32 = -2147483648;";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_TRUE(result->succeeded);
+
+    auto evaluate = [&result](std::size_t index)
+    {
+        ASTGlobalVariableDeclaration *varDecl = static_cast<ASTGlobalVariableDeclaration *>(result->program->getStatementList()->getStatements()[index]);
+        return semantic::ConstantEvaluator().evaluate(varDecl->getInitializer().value(), varDecl->getSemanticType()).value();
+    };
+
+    ASSERT_EQ(evaluate(0).getInteger().getSExtValue(), 5000000000);
+    ASSERT_EQ(evaluate(1).getInteger().getZExtValue(), 0xFFFFFFFFu);
+    ASSERT_TRUE(evaluate(2).getInteger().isAllOnes());
+    ASSERT_EQ(evaluate(3).getInteger().getSExtValue(), -2147483648);
+}
+
+TEST(SemanticTest, KeepsFloatLiteralsExact)
+{
+    std::string input = "tenth: float64 = 0.1;\n"
+                        "large: float64 = 1e300;\n"
+                        "narrowed: float32 = 0.1;\n"
+                        "single: float32 = 0.1f;\n"
+                        "hex: float64 = 0x1.8p1;";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_TRUE(result->succeeded);
+
+    ASTNodeList statementsList = result->program->getStatementList()->getStatements();
+    auto getInitializer = [&statementsList](std::size_t index)
+    {
+        return static_cast<ASTGlobalVariableDeclaration *>(statementsList[index])->getInitializer().value();
+    };
+    auto evaluate = [&statementsList, &getInitializer](std::size_t index)
+    {
+        return semantic::ConstantEvaluator().evaluate(getInitializer(index), statementsList[index]->getSemanticType()).value();
+    };
+
+    // a literal is a float64 unless it has an f suffix.
+    ASSERT_EQ(getInitializer(0)->getSemanticType()->getKind(), semantic::Type::Kind::Float64);
+    ASSERT_EQ(getInitializer(3)->getSemanticType()->getKind(), semantic::Type::Kind::Float32);
+
+    ASSERT_EQ(evaluate(0).getFloat().convertToDouble(), 0.1);
+    ASSERT_EQ(evaluate(1).getFloat().convertToDouble(), 1e300);
+    ASSERT_EQ(evaluate(2).getFloat().convertToFloat(), 0.1f);
+    ASSERT_EQ(evaluate(3).getFloat().convertToFloat(), 0.1f);
+    ASSERT_EQ(evaluate(4).getFloat().convertToDouble(), 3.0);
+}
+
+TEST(SemanticTest, RejectsIntegerLiteralsThatDoNotFit)
+{
+    std::string input = "small: int8 = 300;\n"
+                        "unsigned: uint32 = -1;\n"
+                        "fn main() {\n"
+                        "    #count: int32 = 3000000000;\n"
+                        "}";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_FALSE(result->succeeded);
+    std::vector<std::string> expected = {
+        "1: Integer literal '300' does not fit in 'int8'.",
+        "2: Integer literal '-1' does not fit in 'uint32'.",
+        "4: Integer literal '3000000000' does not fit in 'int32'.",
+    };
+    ASSERT_EQ(result->getErrors(), expected);
+}
+
+TEST(SemanticTest, RejectsNonConstantInitializers)
+{
+    std::string input = "counter: int32 = 1;\n"
+                        "copy: int32 = counter;\n"
+                        "ratio: int32 = 1 / 0;\n"
+                        "shifted: int64 = 1 << 64;";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_FALSE(result->succeeded);
+    std::vector<std::string> expected = {
+        "2: 'counter' is not a constant, only const globals can be used in constant expressions.",
+        "3: Division by zero in constant expression.",
+        "4: Shift amount 64 is out of range for 'int'.",
+    };
+    ASSERT_EQ(result->getErrors(), expected);
+}
+
+TEST(SemanticTest, ChecksCallsToExternFunctions)
+{
+    std::string input = "extern fn printf(format string, ...) int32;\n"
+                        "extern fn sum(count int32, int32 ...) int32;\n"
+                        "inline fn missing();\n"
+                        "fn scale(value float64, factor float64 = 2.0) float64 {\n"
+                        "    return value * factor;\n"
+                        "}\n"
+                        "fn main() {\n"
+                        "    printf(\"%d %f\", 1, 2.5);\n"
+                        "    sum(2, 1, \"three\");\n"
+                        "    scale(1.0);\n"
+                        "    scale();\n"
+                        "}";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_FALSE(result->succeeded);
+    std::vector<std::string> expected = {
+        "3: Function declaration without a body must be extern.",
+        "9: Cannot convert 'string' to 'int32' for variadic argument 3 of 'sum'.",
+        "11: Too few arguments in call to 'scale', expected at least 1, got 0.",
+    };
+    ASSERT_EQ(result->getErrors(), expected);
+
+    ASTFunctionDeclaration *printfDecl = static_cast<ASTFunctionDeclaration *>(result->program->getStatementList()->getStatements()[0]);
+    ASSERT_TRUE(printfDecl->getSemanticType()->isVariadic());
+    ASSERT_EQ(printfDecl->getSemanticType()->getReturnType()->getKind(), semantic::Type::Kind::Int32);
+}
+
+TEST(SemanticTest, ResolvesStructLayoutAttributes)
+{
+    std::string input = "struct [[packed, align(16)]] Header {\n"
+                        "    tag uint8;\n"
+                        "    length uint32;\n"
+                        "}\n"
+                        "struct [[reorder]] Sample {\n"
+                        "    flag bool;\n"
+                        "    value float64;\n"
+                        "}";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_TRUE(result->succeeded);
+
+    ASTNodeList statementsList = result->program->getStatementList()->getStatements();
+    const semantic::Type::Layout &header = statementsList[0]->getSemanticType()->getLayout();
+    ASSERT_TRUE(header.packed);
+    ASSERT_FALSE(header.reorder);
+    ASSERT_EQ(header.alignment, 16);
+
+    const semantic::Type::Layout &sample = statementsList[1]->getSemanticType()->getLayout();
+    ASSERT_FALSE(sample.packed);
+    ASSERT_TRUE(sample.reorder);
+    ASSERT_EQ(sample.alignment, 0);
+}
+
+TEST(SemanticTest, RejectsInvalidStructAttributes)
+{
+    std::string input = "struct [[aligned(8)]] First { value int32; }\n"
+                        "struct [[align(3)]] Second { value int32; }\n"
+                        "struct [[packed, reorder]] Third { value int32; }\n"
+                        "struct [[packed]] Fourth { value int32; }\n"
+                        "struct Inner { value int32; }\n"
+                        "struct [[packed]] Fifth { tag int8; inner Inner; }\n"
+                        "fn main() {\n"
+                        "    #fourth = Fourth { value: 1 };\n"
+                        "    #pointer = &fourth.value;\n"
+                        "    #fifth = Fifth { tag: 1 };\n"
+                        "    #nested = &fifth.inner.value;\n"
+                        "}";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_FALSE(result->succeeded);
+    std::vector<std::string> expected = {
+        "1: Unknown struct attribute 'aligned', expected 'packed', 'align', 'reorder' or 'soa'.",
+        "2: Alignment must be a power of two no larger than 536870912.",
+        "3: A struct cannot be both packed and reordered.",
+        "9: Cannot take the address of a field of a packed struct.",
+        "11: Cannot take the address of a field of a packed struct.",
+    };
+    ASSERT_EQ(result->getErrors(), expected);
+}
+
+TEST(SemanticTest, IndexesColumnsOfSoaStructs)
+{
+    std::string input = "struct [[soa(1024), align(64)]] Particles {\n"
+                        "    x float64;\n"
+                        "    y float64;\n"
+                        "}\n"
+                        "particles: Particles;\n"
+                        "fn main() {\n"
+                        "    particles[2].x = 1.5;\n"
+                        "    #sum: float64 = particles[3].y + particles[0].x;\n"
+                        "    #pointer: float64* = &particles[1].y;\n"
+                        "    #first: float64 = pointer[0];\n"
+                        "}";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_TRUE(result->succeeded);
+
+    ASTNodeList statementsList = result->program->getStatementList()->getStatements();
+    const semantic::Type::Layout &layout = statementsList[0]->getSemanticType()->getLayout();
+    ASSERT_EQ(layout.soaCapacity, 1024);
+    ASSERT_EQ(layout.alignment, 64);
+
+    ASTFunctionDefinition *function = static_cast<ASTFunctionDefinition *>(statementsList[2]);
+    ASTStatementList *body = static_cast<ASTStatementList *>(function->getBody());
+    ASTAssignment *assignment = static_cast<ASTAssignment *>(body->getStatements()[0]);
+    ASTFieldAccess *column = static_cast<ASTFieldAccess *>(assignment->getLeft());
+    ASSERT_EQ(column->getFieldIndex(), 0);
+    ASSERT_EQ(column->getOperand()->getType(), ASTNode::NodeType::IndexAccess);
+    ASSERT_EQ(column->getSemanticType()->getKind(), semantic::Type::Kind::Float64);
+}
+
+TEST(SemanticTest, RejectsWholeRowsOfSoaStructs)
+{
+    std::string input = "struct [[soa(4)]] Table { value int32; }\n"
+                        "struct [[soa(0)]] Empty { value int32; }\n"
+                        "struct [[soa(8), packed]] Packed { value int32; }\n"
+                        "table: Table;\n"
+                        "fn main() {\n"
+                        "    table.value = 1;\n"
+                        "    #row = table[1];\n"
+                        "    table[4].value = 2;\n"
+                        "    #copy = Table { value: 1 };\n"
+                        "}";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_FALSE(result->succeeded);
+    std::vector<std::string> expected = {
+        "2: A soa struct must hold at least one row.",
+        "3: A soa struct cannot also be packed or reordered.",
+        "6: Field 'value' of soa struct 'Table' is a column, select a row first, e.g. 'table[i].value'.",
+        "7: A row of soa struct 'Table' is not a value, access one of its fields.",
+        "8: Row index is out of range for soa struct 'Table' of 4 rows.",
+        "9: Soa struct 'Table' cannot be initialized field by field, assign to 'table[i].field' instead.",
+    };
+    ASSERT_EQ(result->getErrors(), expected);
+}
+
+TEST(SemanticTest, SwitchesOverEnumVariants)
+{
+    std::string input = "enum Shape { Empty = 4, Dot, Circle(float64), Rect(float64, float64) }\n"
+                        "fn area(shape Shape) float64 {\n"
+                        "    switch (shape) {\n"
+                        "    case Shape.Empty, Shape.Dot:\n"
+                        "        return 0.0;\n"
+                        "    case Shape.Circle(radius):\n"
+                        "        return 3.14 * radius * radius;\n"
+                        "    case Shape.Rect(width, height):\n"
+                        "        return width * height;\n"
+                        "    }\n"
+                        "    return 0.0;\n"
+                        "}\n"
+                        "fn classify(value int32) int32 {\n"
+                        "    switch (value) {\n"
+                        "    case 1, 2: return 10;\n"
+                        "    case 3 + 4: break;\n"
+                        "    default: return 0;\n"
+                        "    }\n"
+                        "    return 1;\n"
+                        "}";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_TRUE(result->succeeded);
+
+    ASTNodeList statementsList = result->program->getStatementList()->getStatements();
+    const std::vector<semantic::Type::Variant> &variants = statementsList[0]->getSemanticType()->getVariants();
+    ASSERT_EQ(variants.size(), 4);
+    ASSERT_EQ(variants[1].discriminant, 5);
+    ASSERT_EQ(variants[3].discriminant, 7);
+
+    ASTFunctionDefinition *function = static_cast<ASTFunctionDefinition *>(statementsList[1]);
+    ASTStatementList *body = static_cast<ASTStatementList *>(function->getBody());
+    ASTSwitchStatement *switchStmt = static_cast<ASTSwitchStatement *>(body->getStatements()[0]);
+    ASSERT_EQ(switchStmt->getCases().size(), 3);
+
+    ASTFunctionCall *pattern = static_cast<ASTFunctionCall *>(switchStmt->getCases()[1].getLabels()[0]);
+    ASSERT_EQ(static_cast<ASTFieldAccess *>(pattern->getExpr())->getFieldIndex(), 2);
+    ASTIdentifier *radius = static_cast<ASTIdentifier *>(pattern->getArguments()[0]);
+    ASSERT_NE(radius->getDeclaration(), nullptr);
+    ASSERT_EQ(radius->getDeclaration()->kind, semantic::Declaration::Kind::LocalVariable);
+    ASSERT_EQ(radius->getSemanticType()->getKind(), semantic::Type::Kind::Float64);
+}
+
+TEST(SemanticTest, RejectsInvalidSwitches)
+{
+    std::string input = "enum Color { Red, Green = 0 }\n"
+                        "enum Option { None, Some(int32) }\n"
+                        "fn main() {\n"
+                        "    #value: float64 = 1.0;\n"
+                        "    switch (value) { default: break; }\n"
+                        "    #count: int32 = 2;\n"
+                        "    switch (count) {\n"
+                        "    case 1: break;\n"
+                        "    case 1: break;\n"
+                        "    case count: break;\n"
+                        "    default: break;\n"
+                        "    default: break;\n"
+                        "    }\n"
+                        "    #option = Option.Some(3);\n"
+                        "    switch (option) {\n"
+                        "    case Option.None, Option.Some(x): break;\n"
+                        "    case Option.Some(a, b): break;\n"
+                        "    case 3: break;\n"
+                        "    }\n"
+                        "}";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_FALSE(result->succeeded);
+    std::vector<std::string> expected = {
+        "1: Variant 'Green' has the same value 0 as 'Red'.",
+        "5: Switch value must be an integer or an enum, found 'float64'.",
+        "9: Value 1 is already handled by another case.",
+        "10: Case label must be a constant: 'count' is not a constant, only const globals can be used in constant expressions.",
+        "12: A switch can only have one default case.",
+        "16: A case that binds a payload cannot have other labels.",
+        "17: Variant 'Option.Some' holds 1 value(s), got 2 name(s).",
+        "17: Variant 'Some' is already handled by another case.",
+        "18: Case of a switch over enum 'Option' must name one of its variants.",
+    };
+    ASSERT_EQ(result->getErrors(), expected);
+}
+
+TEST(SemanticTest, ComparesStringsAndEnums)
+{
+    std::string input = "struct Point { x int32; }\n"
+                        "enum Token { End, Number(int64), Word(string) }\n"
+                        "enum Shape { Empty, At(Point) }\n"
+                        "fn main() {\n"
+                        "    #same = \"a\" == \"b\";\n"
+                        "    #token = Token.Number(1) != Token.End;\n"
+                        "    #shape = Shape.Empty == Shape.Empty;\n"
+                        "}";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_FALSE(result->succeeded);
+    std::vector<std::string> expected = {
+        "7: Enum 'Shape' cannot be compared, its payloads hold values without '=='.",
+    };
+    ASSERT_EQ(result->getErrors(), expected);
+}
+
+TEST(SemanticTest, RequiresReferencesToBeInitialized)
+{
+    std::string input = "struct Handle { target int32&; }\n"
+                        "enum Option { Some(Handle), None }\n"
+                        "struct [[soa(4)]] Rows { target int32&; }\n"
+                        "shared: Handle;\n"
+                        "fn main() {\n"
+                        "    #value: int32 = 1;\n"
+                        "    #some = Option.Some(Handle { target: value });\n"
+                        "    #empty = Option.Some(Handle {});\n"
+                        "    #handle: Handle;\n"
+                        "    #option: Option;\n"
+                        "}";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_FALSE(result->succeeded);
+    std::vector<std::string> expected = {
+        "3: Field 'target' of soa struct 'Rows' cannot hold a reference.",
+        "4: Global variable 'shared' cannot hold a reference.",
+        "8: Field 'target' of 'Handle' holds a reference and must be initialized.",
+        "9: Variable 'handle' holds a reference and must be initialized.",
+        "10: Variable 'option' holds a reference and must be initialized.",
+    };
+    ASSERT_EQ(result->getErrors(), expected);
+}
+
+TEST(SemanticTest, ChecksThreadLocalGlobals)
+{
+    std::string input = "thread_local hits: int64 = 0;\n"
+                        "extern thread_local shared: int32;\n"
+                        "extern thread_local seeded: int32 = 1;\n"
+                        "thread_local fn work() {}\n"
+                        "fn main() {\n"
+                        "    hits = hits + shared;\n"
+                        "}";
+    std::unique_ptr<AnalyzedProgram> result = quickAnalyze(input);
+    ASSERT_FALSE(result->succeeded);
+    std::vector<std::string> expected = {
+        "3: Extern storage class specifier cannot have an initializer.",
+        "4: Thread local storage class specifier is only supported for global variables.",
+    };
+    ASSERT_EQ(result->getErrors(), expected);
+
+    ASTNodeList statementsList = result->program->getStatementList()->getStatements();
+    ASTGlobalVariableDeclaration *hits = static_cast<ASTGlobalVariableDeclaration *>(statementsList[0]);
+    ASSERT_TRUE(hits->isThreadLocal());
+    ASSERT_FALSE(hits->isExtern());
+    ASTGlobalVariableDeclaration *shared = static_cast<ASTGlobalVariableDeclaration *>(statementsList[1]);
+    ASSERT_TRUE(shared->isThreadLocal());
+    ASSERT_TRUE(shared->isExtern());
+}